@@ -0,0 +1,89 @@
+/* This is a command line benchmark that measures how the per-element mesh
+ * updates (normals, tessellations, quality and bounding box) scale with the
+ * number of threads used by PARALLEL_FOR. For each thread count it also prints
+ * a checksum of the updated attributes, which must not change across runs.
+ *
+ * usage: parallel_mesh_updates [max_threads] [n_reps]
+ *
+ * Enjoy!
+*/
+
+#include <cinolib/meshes/meshes.h>
+#include <cinolib/parallel_for.h>
+#include <cinolib/how_many_seconds.h>
+#include <iomanip>
+
+using namespace cinolib;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+double checksum(const Mesh & m)
+{
+    double sum = m.bbox().min.dot(vec3d(1,2,3)) + m.bbox().max.dot(vec3d(3,2,1));
+    for(uint vid=0; vid<m.num_verts(); ++vid) sum += m.vert_data(vid).normal.dot(vec3d(1,2,3));
+    for(uint pid=0; pid<m.num_polys(); ++pid) sum += m.poly_data(pid).quality;
+    return sum;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh, class Func>
+void benchmark(const std::string & name, Mesh & m, const uint max_threads, const uint n_reps, const Func & update)
+{
+    std::cout << "\n" << name << "\t" << m.num_verts() << "V / " << m.num_polys() << "P" << std::endl;
+    double t1 = 0;
+    for(uint nt=1; nt<=max_threads; nt*=2)
+    {
+        parallel_for_set_num_threads(nt);
+        update(); // warm up
+        std::chrono::high_resolution_clock::time_point t0 = std::chrono::high_resolution_clock::now();
+        for(uint i=0; i<n_reps; ++i) update();
+        std::chrono::high_resolution_clock::time_point t_end = std::chrono::high_resolution_clock::now();
+        double t = how_many_seconds(t0,t_end) / n_reps;
+        if(nt==1) t1 = t;
+        std::cout << "  threads: " << std::setw(2) << nt
+                  << "  time: "    << std::setw(10) << t << "s"
+                  << "  speedup: " << std::setw(6) << t1/t
+                  << "  checksum: "<< std::setprecision(17) << checksum(m) << std::setprecision(6) << std::endl;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+int main(int argc, char **argv)
+{
+    uint max_threads = (argc>1) ? atoi(argv[1]) : 32;
+    uint n_reps      = (argc>2) ? atoi(argv[2]) : 10;
+
+    std::string s = (argc>3) ? std::string(argv[3]) : std::string(DATA_PATH) + "/bunny.obj";
+    Trimesh<> tri(s.c_str());
+    benchmark("trimesh", tri, max_threads, n_reps, [&]()
+    {
+        tri.update_bbox();
+        tri.update_normals();
+        tri.update_p_tessellations();
+    });
+
+    s = (argc>4) ? std::string(argv[4]) : std::string(DATA_PATH) + "/sphere.mesh";
+    Tetmesh<> tet(s.c_str());
+    benchmark("tetmesh", tet, max_threads, n_reps, [&]()
+    {
+        tet.update_bbox();
+        tet.update_normals();
+        tet.update_f_tessellation();
+        tet.update_quality();
+    });
+
+    s = (argc>5) ? std::string(argv[5]) : std::string(DATA_PATH) + "/rockerarm.mesh";
+    Hexmesh<> hex(s.c_str());
+    benchmark("hexmesh", hex, max_threads, n_reps, [&]()
+    {
+        hex.update_bbox();
+        hex.update_normals();
+        hex.update_f_tessellation();
+        hex.update_quality();
+    });
+
+    return 0;
+}
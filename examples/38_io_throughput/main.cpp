@@ -0,0 +1,76 @@
+/* This is a command line benchmark that measures the throughput (in MB/s) of
+ * the OBJ, OFF and STL readers. Files are read a few times, so that the figure
+ * does not include the time spent by the OS to load the file from disk the
+ * first time.
+ *
+ * usage: io_throughput [n_reps] [file1 file2 ...]
+ *
+ * Enjoy!
+*/
+
+#include <cinolib/io/read_write.h>
+#include <cinolib/string_utilities.h>
+#include <cinolib/parallel_for.h>
+#include <cinolib/how_many_seconds.h>
+#include <sys/stat.h>
+
+using namespace cinolib;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+void read(const std::string & filename)
+{
+    std::vector<vec3d>             verts;
+    std::vector<std::vector<uint>> polys;
+
+    std::string ext = get_file_extension(filename);
+    if(ext.compare("OBJ")==0 || ext.compare("obj")==0)
+    {
+        read_OBJ(filename.c_str(), verts, polys);
+    }
+    else if(ext.compare("OFF")==0 || ext.compare("off")==0)
+    {
+        read_OFF(filename.c_str(), verts, polys);
+    }
+    else if(ext.compare("STL")==0 || ext.compare("stl")==0)
+    {
+        std::vector<uint> tris;
+        read_STL(filename.c_str(), verts, tris);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+int main(int argc, char **argv)
+{
+    uint n_reps = (argc>1) ? atoi(argv[1]) : 5;
+
+    std::vector<std::string> files;
+    for(int i=2; i<argc; ++i) files.push_back(argv[i]);
+    if(files.empty())
+    {
+        files.push_back(std::string(DATA_PATH) + "/bunny.obj");
+        files.push_back(std::string(DATA_PATH) + "/lion_vase_poly.off");
+    }
+
+    std::cout << "threads: " << parallel_for_num_threads() << std::endl;
+    for(const std::string & f : files)
+    {
+        struct stat st;
+        if(stat(f.c_str(), &st)!=0)
+        {
+            std::cout << "ERROR: could not open " << f << std::endl;
+            continue;
+        }
+        double mb = double(st.st_size)/(1024*1024);
+
+        read(f); // warm up (and load the file in the OS cache)
+        std::chrono::high_resolution_clock::time_point t0 = std::chrono::high_resolution_clock::now();
+        for(uint i=0; i<n_reps; ++i) read(f);
+        std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+        double t = how_many_seconds(t0,t1) / n_reps;
+
+        std::cout << get_file_name(f) << "\t" << mb << "MB\t" << t << "s\t" << mb/t << "MB/s" << std::endl;
+    }
+    return 0;
+}
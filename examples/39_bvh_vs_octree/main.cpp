@@ -0,0 +1,102 @@
+/* This is a command line benchmark that compares the Octree and the BVH on
+ * the same set of queries. Both structures are built from the triangles of
+ * a mesh, and are then used to answer closest point and ray queries for a
+ * set of random points, sampled within the (slightly enlarged) bounding box
+ * of the mesh. Queries are answered both one at a time and with the
+ * batched (parallel) interface, and throughput is reported in queries/s.
+ *
+ * usage: bvh_vs_octree [n_queries] [mesh]
+ *
+ * Enjoy!
+*/
+
+#include <cinolib/meshes/meshes.h>
+#include <cinolib/octree.h>
+#include <cinolib/bvh.h>
+#include <cinolib/parallel_for.h>
+#include <cinolib/how_many_seconds.h>
+#include <random>
+
+using namespace cinolib;
+
+typedef std::chrono::high_resolution_clock Time;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class SpatialIndex>
+void run(const char               * name,
+         const Trimesh<>          & m,
+         const std::vector<vec3d> & points,
+         const std::vector<vec3d> & dirs)
+{
+    Time::time_point t0 = Time::now();
+    SpatialIndex s;
+    s.build_from_mesh_polys(m);
+    Time::time_point t1 = Time::now();
+
+    double sum = 0.0;
+    for(const vec3d & p : points)
+    {
+        uint   id;
+        vec3d  pos;
+        double dist;
+        s.closest_point(p, id, pos, dist);
+        sum += std::sqrt(dist);
+    }
+    Time::time_point t2 = Time::now();
+
+    uint hits = 0;
+    for(uint i=0; i<points.size(); ++i)
+    {
+        uint   id;
+        double t;
+        if(s.intersects_ray(points.at(i), dirs.at(i), t, id) && t>=0) ++hits;
+    }
+    Time::time_point t3 = Time::now();
+
+    std::vector<uint>   ids;
+    std::vector<vec3d>  pos;
+    std::vector<double> dist;
+    s.closest_point(points, ids, pos, dist);
+    Time::time_point t4 = Time::now();
+
+    std::vector<double> t;
+    std::vector<int>    hit_ids;
+    s.intersects_ray(points, dirs, t, hit_ids);
+    Time::time_point t5 = Time::now();
+
+    double n = points.size();
+    std::cout << name << "\tbuild: " << how_many_seconds(t0,t1) << "s" << std::endl;
+    std::cout << "\tclosest point\tsingle: " << n/how_many_seconds(t1,t2) << " q/s"
+              << "\tbatched: " << n/how_many_seconds(t3,t4) << " q/s"
+              << "\t(avg dist: " << sum/n << ")" << std::endl;
+    std::cout << "\tray\t\tsingle: " << n/how_many_seconds(t2,t3) << " q/s"
+              << "\tbatched: " << n/how_many_seconds(t4,t5) << " q/s"
+              << "\t(hits: " << hits << ")" << std::endl;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+int main(int argc, char **argv)
+{
+    uint        n_queries = (argc>1) ? atoi(argv[1]) : 100000;
+    std::string s         = (argc>2) ? std::string(argv[2]) : std::string(DATA_PATH) + "/bunny.obj";
+    Trimesh<>   m(s.c_str());
+
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<double> rnd(-0.1, 1.1);
+    std::normal_distribution<double> gauss;
+    AABB bb = m.bbox();
+    std::vector<vec3d> points(n_queries), dirs(n_queries);
+    for(uint i=0; i<n_queries; ++i)
+    {
+        points.at(i) = bb.min + vec3d(rnd(rng)*bb.delta_x(), rnd(rng)*bb.delta_y(), rnd(rng)*bb.delta_z());
+        dirs.at(i)   = vec3d(gauss(rng), gauss(rng), gauss(rng));
+        dirs.at(i).normalize();
+    }
+
+    std::cout << "threads: " << parallel_for_num_threads() << ", queries: " << n_queries << std::endl;
+    run<Octree>("Octree", m, points, dirs);
+    run<BVH>   ("BVH",    m, points, dirs);
+    return 0;
+}
@@ -0,0 +1,11 @@
+TEMPLATE        = app
+TARGET          = $$PWD/../40_headless_remesher_demo
+QT             += core
+CONFIG         += c++11 release
+CONFIG         -= app_bundle
+INCLUDEPATH    += $$PWD/../../external/eigen
+INCLUDEPATH    += $$PWD/../../include
+SOURCES        += main.cpp
+DATA_PATH       = \\\"$$PWD/../data/\\\"
+DEFINES        += DATA_PATH=$$DATA_PATH
+LIBS           += -lpthread
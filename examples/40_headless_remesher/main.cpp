@@ -0,0 +1,96 @@
+/* This is a command line benchmark for the headless version of the isotropic
+ * remesher described in
+ *
+ *    A Remeshing Approach to Multiresolution Modeling
+ *    M.Botsch, L.Kobbelt
+ *    Symposium on Geomtry Processing, 2004
+ *
+ * Each input mesh is remeshed with a target edge length equal to its average
+ * edge length, reprojecting on the input surface either with the BVH or with
+ * the Octree. For each run the program reports running time, output size,
+ * edge length statistics (relative to the target length) and the average
+ * distance between the centroids of the output triangles and the input surface.
+ *
+ * usage: headless_remesher [n_iters] [mesh1 mesh2 ...]
+ *
+ * Enjoy!
+*/
+
+#include <cinolib/meshes/meshes.h>
+#include <cinolib/remesh_BotschKobbelt2004.h>
+#include <cinolib/parallel_for.h>
+#include <cinolib/how_many_seconds.h>
+
+using namespace cinolib;
+
+typedef std::chrono::high_resolution_clock Time;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class SpatialIndex>
+void run(const char * name, const Trimesh<> & input, const uint n_iters)
+{
+    RemesherOptions opt;
+    opt.n_iters            = n_iters;
+    opt.target_edge_length = input.edge_avg_length();
+
+    Trimesh<> m = input;
+    Time::time_point t0 = Time::now();
+    remesh_Botsch_Kobbelt_2004<SpatialIndex>(m, opt);
+    Time::time_point t1 = Time::now();
+
+    double l = opt.target_edge_length;
+    double min_l = inf_double, max_l = 0, dev = 0;
+    for(uint eid=0; eid<m.num_edges(); ++eid)
+    {
+        double e = m.edge_length(eid)/l;
+        min_l = std::min(min_l, e);
+        max_l = std::max(max_l, e);
+        dev  += (e-1)*(e-1);
+    }
+    dev = std::sqrt(dev/m.num_edges());
+
+    BVH bvh;
+    bvh.build_from_mesh_polys(input);
+    std::vector<uint>   ids;
+    std::vector<vec3d>  pos;
+    std::vector<double> dist;
+    std::vector<vec3d>  centroids(m.num_polys());
+    for(uint pid=0; pid<m.num_polys(); ++pid) centroids.at(pid) = m.poly_centroid(pid);
+    bvh.closest_point(centroids, ids, pos, dist);
+    double avg_dist = 0;
+    for(double d : dist) avg_dist += std::sqrt(d);
+    avg_dist /= dist.size();
+
+    std::cout << "\t" << name << "\t" << how_many_seconds(t0,t1) << "s"
+              << "\t" << m.num_polys() << " tris"
+              << "\tedge length (rel.) min/max/dev: " << min_l << "/" << max_l << "/" << dev
+              << "\tavg dist: " << avg_dist/l << " (rel.)" << std::endl;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+int main(int argc, char **argv)
+{
+    uint n_iters = (argc>1) ? atoi(argv[1]) : 5;
+
+    std::vector<std::string> meshes;
+    for(int i=2; i<argc; ++i) meshes.push_back(argv[i]);
+    if(meshes.empty())
+    {
+        meshes.push_back(std::string(DATA_PATH) + "/bunny.obj");
+        meshes.push_back(std::string(DATA_PATH) + "/Laurana.obj");
+        meshes.push_back(std::string(DATA_PATH) + "/3holes.obj");
+        meshes.push_back(std::string(DATA_PATH) + "/blub_triangulated.obj");
+    }
+
+    std::cout << "threads: " << parallel_for_num_threads() << ", iterations: " << n_iters << std::endl;
+    for(const std::string & s : meshes)
+    {
+        Trimesh<> m(s.c_str());
+        std::cout << s << " (" << m.num_polys() << " tris)" << std::endl;
+        run<BVH>   ("BVH",    m, n_iters);
+        run<Octree>("Octree", m, n_iters);
+    }
+    return 0;
+}
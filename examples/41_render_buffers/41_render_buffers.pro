@@ -0,0 +1,18 @@
+TEMPLATE        = app
+TARGET          = $$PWD/../41_render_buffers_demo
+QT             += core opengl
+CONFIG         += c++11 release
+CONFIG         -= app_bundle
+INCLUDEPATH    += $$PWD/../../external/eigen
+INCLUDEPATH    += $$PWD/../../include
+DEFINES        += CINOLIB_USES_OPENGL
+SOURCES        += main.cpp
+DATA_PATH       = \\\"$$PWD/../data/\\\"
+DEFINES        += DATA_PATH=$$DATA_PATH
+LIBS           += -lpthread
+
+# just for Linux
+unix:!macx {
+DEFINES += GL_GLEXT_PROTOTYPES
+LIBS    += -lGLU
+}
@@ -0,0 +1,111 @@
+/* This is a command line benchmark for the generation of the (CPU side)
+ * rendering data of drawable meshes. Buffers are generated from scratch
+ * with updateGL(), and then updated with updateGL_incremental() after
+ * moving a small fraction of the vertices and recoloring a small fraction
+ * of the elements. For volume meshes half of the mesh is hidden, so that
+ * also the inner faces exposed by the cut are rendered.
+ *
+ * No window (nor OpenGL context) is created: only the time spent to fill
+ * the buffers is measured.
+ *
+ * usage: render_buffers [n_reps] [changed fraction] [mesh1 mesh2 ...]
+ *
+ * Enjoy!
+*/
+
+#include <cinolib/meshes/meshes.h>
+#include <cinolib/parallel_for.h>
+#include <cinolib/how_many_seconds.h>
+#include <cinolib/string_utilities.h>
+#include <random>
+
+using namespace cinolib;
+
+typedef std::chrono::high_resolution_clock Time;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+void edit(Mesh & m, const double fraction, std::mt19937 & rng)
+{
+    std::uniform_real_distribution<double> U(-1,1);
+    double h = m.edge_avg_length()*0.01;
+    for(uint i=0; i<fraction*m.num_verts(); ++i)
+    {
+        uint vid = rng()%m.num_verts();
+        m.vert_move(vid, m.vert(vid) + vec3d(U(rng),U(rng),U(rng))*h);
+    }
+    for(uint i=0; i<fraction*m.num_polys(); ++i)
+    {
+        uint pid = rng()%m.num_polys();
+        m.poly_data(pid).color = Color::scatter(20, rng()%20);
+        m.mark_changed(CHANGES_POLY_DATA, pid);
+    }
+    m.update_normals_incremental();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+void run(Mesh & m, const uint n_reps, const double fraction)
+{
+    std::mt19937 rng(1);
+
+    Time::time_point t0 = Time::now();
+    for(uint i=0; i<n_reps; ++i) m.updateGL();
+    Time::time_point t1 = Time::now();
+
+    double t_inc = 0;
+    for(uint i=0; i<n_reps; ++i)
+    {
+        edit(m, fraction, rng);
+        Time::time_point t2 = Time::now();
+        m.updateGL_incremental();
+        Time::time_point t3 = Time::now();
+        t_inc += how_many_seconds(t2,t3);
+    }
+
+    std::cout << "\tfull update: "        << how_many_seconds(t0,t1)/n_reps << "s"
+              << "\tincremental update: " << t_inc/n_reps                    << "s" << std::endl;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+int main(int argc, char **argv)
+{
+    uint   n_reps   = (argc>1) ? atoi(argv[1]) : 10;
+    double fraction = (argc>2) ? atof(argv[2]) : 0.01;
+
+    std::vector<std::string> meshes;
+    for(int i=3; i<argc; ++i) meshes.push_back(argv[i]);
+    if(meshes.empty())
+    {
+        meshes.push_back(std::string(DATA_PATH) + "/bunny.obj");
+        meshes.push_back(std::string(DATA_PATH) + "/Laurana.obj");
+        meshes.push_back(std::string(DATA_PATH) + "/sphere.mesh");
+    }
+
+    std::cout << "threads: " << parallel_for_num_threads() << ", repetitions: " << n_reps
+              << ", changed elements: " << fraction*100 << "%" << std::endl;
+
+    for(const std::string & s : meshes)
+    {
+        std::string ext = get_file_extension(s);
+        if(ext=="mesh" || ext=="vtu" || ext=="vtk")
+        {
+            DrawablePolyhedralmesh<> m(s.c_str());
+            SlicerState state;
+            state.X_thresh = 0.5;
+            m.slice(state);
+            std::cout << s << " (" << m.num_polys() << " polys, " << m.num_faces() << " faces)" << std::endl;
+            run(m, n_reps, fraction);
+        }
+        else
+        {
+            DrawablePolygonmesh<> m(s.c_str());
+            std::cout << s << " (" << m.num_polys() << " polys)" << std::endl;
+            run(m, n_reps, fraction);
+        }
+    }
+    return 0;
+}
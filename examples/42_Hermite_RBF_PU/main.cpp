@@ -0,0 +1,95 @@
+/* This is a command line benchmark for the partition of unity version of Hermite
+ * RBF interpolation (see RBF_Hermite_PU.h). It takes in input one or more triangle
+ * meshes, and computes the function that interpolates their vertices and (per vertex)
+ * normals. The function is then evaluated on a regular grid that covers 1.5 times
+ * the bounding box of the mesh, as one would do to extract its zero level set.
+ *
+ * For each mesh the program reports construction and evaluation times, and the
+ * average value of the function at the input points (which should be zero). For
+ * small inputs the global (dense) Hermite RBF is computed too, and the percentage
+ * of grid points where the two functions have the same sign is reported.
+ *
+ * usage: Hermite_RBF_PU [grid_res] [mesh1 mesh2 ...]
+ *
+ * Enjoy!
+*/
+
+#include <cinolib/meshes/meshes.h>
+#include <cinolib/RBF_Hermite.h>
+#include <cinolib/RBF_Hermite_PU.h>
+#include <cinolib/RBF_kernels.h>
+#include <cinolib/parallel_for.h>
+#include <cinolib/how_many_seconds.h>
+
+using namespace cinolib;
+
+typedef std::chrono::high_resolution_clock Time;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class HRBF>
+ScalarField run(const char * name, const std::vector<vec3d> & points, const std::vector<vec3d> & normals, const std::vector<vec3d> & grid)
+{
+    Time::time_point t0 = Time::now();
+    HRBF f(points, normals);
+    Time::time_point t1 = Time::now();
+    ScalarField val = f.eval(grid);
+    Time::time_point t2 = Time::now();
+
+    ScalarField res = f.eval(points);
+    double avg_res = 0;
+    for(uint i=0; i<res.size(); ++i) avg_res += std::fabs(res[i]);
+    avg_res /= res.size();
+
+    std::cout << "\t" << name << "\tbuild: " << how_many_seconds(t0,t1) << "s"
+              << "\teval: "  << how_many_seconds(t1,t2) << "s"
+              << "\tavg |f| at input points: " << avg_res << std::endl;
+    return val;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+int main(int argc, char **argv)
+{
+    uint res = (argc>1) ? atoi(argv[1]) : 64;
+
+    std::vector<std::string> meshes;
+    for(int i=2; i<argc; ++i) meshes.push_back(argv[i]);
+    if(meshes.empty())
+    {
+        meshes.push_back(std::string(DATA_PATH) + "/sphere_coarse.obj");
+        meshes.push_back(std::string(DATA_PATH) + "/bunny.obj");
+        meshes.push_back(std::string(DATA_PATH) + "/blub_triangulated.obj");
+        meshes.push_back(std::string(DATA_PATH) + "/Laurana.obj");
+    }
+
+    std::cout << "threads: " << parallel_for_num_threads() << ", grid: " << res << "^3" << std::endl;
+    for(const std::string & s : meshes)
+    {
+        Trimesh<> m(s.c_str());
+        m.center_bbox();
+        m.normalize_bbox();
+
+        std::vector<vec3d> grid;
+        grid.reserve(res*res*res);
+        vec3d o = m.bbox().min - m.bbox().delta()*0.25;
+        vec3d d = m.bbox().delta()*(1.5/(res-1));
+        for(uint i=0; i<res; ++i)
+        for(uint j=0; j<res; ++j)
+        for(uint k=0; k<res; ++k)
+        {
+            grid.push_back(o + vec3d(i*d.x(), j*d.y(), k*d.z()));
+        }
+
+        std::cout << s << " (" << m.num_verts() << " points)" << std::endl;
+        ScalarField f_pu = run<Hermite_RBF_PU<CubicRBF>>("PU   ", m.vector_verts(), m.vector_vert_normals(), grid);
+        if(m.num_verts()<=3000)
+        {
+            ScalarField f = run<Hermite_RBF<CubicRBF>>("dense", m.vector_verts(), m.vector_vert_normals(), grid);
+            uint same = 0;
+            for(uint i=0; i<grid.size(); ++i) if((f[i]<0)==(f_pu[i]<0)) ++same;
+            std::cout << "\tsign agreement on the grid: " << 100.0*same/grid.size() << "%" << std::endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,111 @@
+/* This is a command line benchmark for the QEM based mesh decimation described in
+ *
+ *    Surface Simplification Using Quadric Error Metrics
+ *    M.Garland, P.S.Heckbert
+ *    SIGGRAPH 1997
+ *
+ * Each input mesh is first refined with n_refine rounds of 1:4 triangle splits
+ * (each round multiplies the number of triangles by four), and then decimated
+ * down to the given fraction of its triangles, both in serial and in parallel
+ * mode. For each run the program reports running time, output size, number of
+ * non manifold edges and vertices, and the genus of the output. Decimation should
+ * not change the topology: the Euler characteristic of the output (which also
+ * accounts for boundary loops) is checked against the one of the input.
+ *
+ * usage: QEM_decimation [n_refine] [ratio] [mesh1 mesh2 ...]
+ *
+ * Enjoy!
+*/
+
+#include <cinolib/meshes/meshes.h>
+#include <cinolib/QEM_decimation.h>
+#include <cinolib/parallel_for.h>
+#include <cinolib/how_many_seconds.h>
+
+using namespace cinolib;
+
+typedef std::chrono::high_resolution_clock Time;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// splits each triangle into four, adding a vertex at the midpoint of each edge
+Trimesh<> refine(const Trimesh<> & m)
+{
+    std::vector<vec3d> verts = m.vector_verts();
+    for(uint eid=0; eid<m.num_edges(); ++eid) verts.push_back(m.edge_sample_at(eid,0.5));
+
+    std::vector<uint> tris;
+    tris.reserve(12*m.num_polys());
+    for(uint pid=0; pid<m.num_polys(); ++pid)
+    {
+        uint v[3], e[3];
+        for(uint i=0; i<3; ++i)
+        {
+            v[i] = m.poly_vert_id(pid,i);
+            e[i] = m.num_verts() + m.poly_edge_id(pid, v[i], m.poly_vert_id(pid,(i+1)%3));
+        }
+        tris.insert(tris.end(), { v[0], e[0], e[2] });
+        tris.insert(tris.end(), { v[1], e[1], e[0] });
+        tris.insert(tris.end(), { v[2], e[2], e[1] });
+        tris.insert(tris.end(), { e[0], e[1], e[2] });
+    }
+    return Trimesh<>(verts, tris);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+void run(const char * name, const Trimesh<> & input, const uint target, const bool parallel)
+{
+    QEMDecimationOptions opt;
+    opt.target_num_polys = target;
+    opt.parallel         = parallel;
+
+    Trimesh<> m = input;
+    Time::time_point t0 = Time::now();
+    QEM_decimation(m, opt);
+    Time::time_point t1 = Time::now();
+
+    uint nm_edges = 0, nm_verts = 0;
+    for(uint eid=0; eid<m.num_edges(); ++eid) if(!m.edge_is_manifold(eid)) ++nm_edges;
+    for(uint vid=0; vid<m.num_verts(); ++vid) if(!m.vert_is_manifold(vid)) ++nm_verts;
+
+    bool same_topology = (m.Euler_characteristic() == input.Euler_characteristic());
+
+    std::cout << "\t" << name << "\t" << how_many_seconds(t0,t1) << "s"
+              << "\t" << m.num_polys() << " tris"
+              << "\tnon manifold edges/verts: " << nm_edges << "/" << nm_verts
+              << "\tgenus: " << m.genus()
+              << "\ttopology: " << (same_topology ? "preserved" : "CHANGED") << std::endl;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+int main(int argc, char **argv)
+{
+    uint   n_refine = (argc>1) ? atoi(argv[1]) : 2;
+    double ratio    = (argc>2) ? atof(argv[2]) : 0.1;
+
+    std::vector<std::string> meshes;
+    for(int i=3; i<argc; ++i) meshes.push_back(argv[i]);
+    if(meshes.empty())
+    {
+        meshes.push_back(std::string(DATA_PATH) + "/bunny.obj");
+        meshes.push_back(std::string(DATA_PATH) + "/Laurana.obj");
+        meshes.push_back(std::string(DATA_PATH) + "/3holes.obj");
+        meshes.push_back(std::string(DATA_PATH) + "/blub_triangulated.obj");
+    }
+
+    std::cout << "threads: " << parallel_for_num_threads() << ", refinements: " << n_refine << ", ratio: " << ratio << std::endl;
+    for(const std::string & s : meshes)
+    {
+        Trimesh<> m(s.c_str());
+        Time::time_point t0 = Time::now();
+        for(uint i=0; i<n_refine; ++i) m = refine(m);
+        Time::time_point t1 = Time::now();
+        std::cout << s << " (" << m.num_polys() << " tris, genus " << m.genus() << ", refined in " << how_many_seconds(t0,t1) << "s)" << std::endl;
+        uint target = std::max(4u, uint(ratio*m.num_polys()));
+        run("serial",   m, target, false);
+        run("parallel", m, target, true);
+    }
+    return 0;
+}
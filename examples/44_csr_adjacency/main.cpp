@@ -0,0 +1,148 @@
+/* This is a command line benchmark for the storage of mesh adjacency relations.
+ * By default relations such as v2v, v2e, v2p, e2p, p2e and p2p are stored as
+ * std::vector<std::vector<uint>>, which costs one heap allocation per element.
+ * Compiling with CINOLIB_USES_CSR_ADJACENCY stores them as AdjacencyLists, a
+ * CSR-like container that keeps all the lists in a few large blocks (see
+ * cinolib/adjacency_lists.h). Mesh algorithms are not aware of the difference.
+ *
+ * For each input mesh (refined with n_refine rounds of 1:4 triangle splits) the
+ * program reports:
+ *
+ *  - the memory used by each relation, stored in both ways
+ *  - the time to sweep all the relations, stored in both ways
+ *  - the memory used by all the relations of the mesh, and the time spent in
+ *    mesh construction, laplacian assembly and exhaustive dijkstra. These depend
+ *    on the storage the mesh has been compiled with (printed at startup), so
+ *    build the program twice (with and without the flag) to compare them
+ *
+ * usage: csr_adjacency [n_refine] [mesh1 mesh2 ...]
+ *
+ * Enjoy!
+*/
+
+#include <cinolib/meshes/meshes.h>
+#include <cinolib/adjacency_lists.h>
+#include <cinolib/laplacian.h>
+#include <cinolib/dijkstra.h>
+#include <cinolib/how_many_seconds.h>
+
+using namespace cinolib;
+
+typedef std::chrono::high_resolution_clock Time;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// splits each triangle into four, adding a vertex at the midpoint of each edge
+Trimesh<> refine(const Trimesh<> & m)
+{
+    std::vector<vec3d> verts = m.vector_verts();
+    for(uint eid=0; eid<m.num_edges(); ++eid) verts.push_back(m.edge_sample_at(eid,0.5));
+
+    std::vector<uint> tris;
+    tris.reserve(12*m.num_polys());
+    for(uint pid=0; pid<m.num_polys(); ++pid)
+    {
+        uint v[3], e[3];
+        for(uint i=0; i<3; ++i)
+        {
+            v[i] = m.poly_vert_id(pid,i);
+            e[i] = m.num_verts() + m.poly_edge_id(pid, v[i], m.poly_vert_id(pid,(i+1)%3));
+        }
+        tris.insert(tris.end(), { v[0], e[0], e[2] });
+        tris.insert(tris.end(), { v[1], e[1], e[0] });
+        tris.insert(tris.end(), { v[2], e[2], e[1] });
+        tris.insert(tris.end(), { e[0], e[1], e[2] });
+    }
+    return Trimesh<>(verts, tris);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// visits each list a few times, summing up the ids (so that the loop is not optimized away)
+template<class Lists>
+double sweep(const Lists & lists, uint64_t & checksum)
+{
+    Time::time_point t0 = Time::now();
+    for(uint i=0; i<10; ++i)
+    for(uint id=0; id<lists.size(); ++id)
+    for(uint nbr : lists[id]) checksum += nbr;
+    Time::time_point t1 = Time::now();
+    return how_many_seconds(t0,t1);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// copies a relation of the mesh in both containers, and compares them
+template<class Getter>
+void compare(const char * name, const uint n, Getter adj)
+{
+    std::vector<std::vector<uint>> vec(n);
+    for(uint id=0; id<n; ++id)
+    {
+        for(uint nbr : adj(id)) vec.at(id).push_back(nbr);
+    }
+    AdjacencyLists csr(vec);
+
+    uint64_t s0 = 0, s1 = 0;
+    double t_vec = sweep(vec, s0);
+    double t_csr = sweep(csr, s1);
+
+    std::cout << "\t" << name
+              << "\tmemory: " << memory_usage_in_bytes(vec)/1024 << "KB (vector) "
+                              << memory_usage_in_bytes(csr)/1024 << "KB (csr)"
+              << "\tsweep: "  << t_vec << "s (vector) " << t_csr << "s (csr)"
+              << ((s0==s1) ? "" : "\tCHECKSUM MISMATCH") << std::endl;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+int main(int argc, char **argv)
+{
+    uint n_refine = (argc>1) ? atoi(argv[1]) : 2;
+
+    std::vector<std::string> meshes;
+    for(int i=2; i<argc; ++i) meshes.push_back(argv[i]);
+    if(meshes.empty())
+    {
+        meshes.push_back(std::string(DATA_PATH) + "/bunny.obj");
+        meshes.push_back(std::string(DATA_PATH) + "/Laurana.obj");
+    }
+
+#ifdef CINOLIB_USES_CSR_ADJACENCY
+    std::cout << "mesh adjacency storage: csr";
+#else
+    std::cout << "mesh adjacency storage: vector";
+#endif
+    std::cout << ", refinements: " << n_refine << std::endl;
+
+    for(const std::string & s : meshes)
+    {
+        Trimesh<> m(s.c_str());
+        for(uint i=0; i<n_refine; ++i) m = refine(m);
+
+        Time::time_point t0 = Time::now();
+        Trimesh<> tmp(m.vector_verts(), m.vector_polys());
+        Time::time_point t1 = Time::now();
+        std::cout << s << " (" << m.num_verts() << " verts, " << m.num_polys() << " tris)" << std::endl;
+
+        compare("v2v", m.num_verts(), [&](const uint vid){ return m.adj_v2v(vid); });
+        compare("v2e", m.num_verts(), [&](const uint vid){ return m.adj_v2e(vid); });
+        compare("v2p", m.num_verts(), [&](const uint vid){ return m.adj_v2p(vid); });
+        compare("e2p", m.num_edges(), [&](const uint eid){ return m.adj_e2p(eid); });
+        compare("p2e", m.num_polys(), [&](const uint pid){ return m.adj_p2e(pid); });
+        compare("p2p", m.num_polys(), [&](const uint pid){ return m.adj_p2p(pid); });
+
+        Time::time_point t2 = Time::now();
+        Eigen::SparseMatrix<double> L = laplacian(m, COTANGENT);
+        Time::time_point t3 = Time::now();
+        std::vector<double> dist;
+        dijkstra_exhaustive(m, 0, dist);
+        Time::time_point t4 = Time::now();
+
+        std::cout << "\tmesh\tmemory: " << m.adjacency_memory_usage_in_bytes()/1024 << "KB"
+                  << "\tconstruction: " << how_many_seconds(t0,t1) << "s"
+                  << "\tlaplacian: "    << how_many_seconds(t2,t3) << "s (" << L.nonZeros() << " nnz)"
+                  << "\tdijkstra: "     << how_many_seconds(t3,t4) << "s" << std::endl;
+    }
+    return 0;
+}
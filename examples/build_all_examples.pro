@@ -52,3 +52,11 @@ SUBDIRS += 33_edge_collapse
 SUBDIRS += 34_Hermite_RBF               # requires Tetgen (http://wias-berlin.de/software/index.jsp?id=TetGen&lang=1)
 SUBDIRS += 35_Poisson_sampling
 SUBDIRS += 36_canonical_polygonal_schema
+SUBDIRS += 37_parallel_mesh_updates
+SUBDIRS += 38_io_throughput
+SUBDIRS += 39_bvh_vs_octree
+SUBDIRS += 40_headless_remesher
+SUBDIRS += 41_render_buffers
+SUBDIRS += 42_Hermite_RBF_PU
+SUBDIRS += 43_QEM_decimation
+SUBDIRS += 44_csr_adjacency
@@ -0,0 +1,946 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/QEM_decimation.h>
+#include <cinolib/parallel_for.h>
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <queue>
+
+namespace cinolib
+{
+
+// Internal machinery for QEM_decimation. Triangles are stored as triplets of
+// vids, and each vertex keeps a singly linked list of the corners incident to
+// it (corner c is vertex c%3 of triangle c/3). Dead triangles are removed from
+// the lists lazily. Bit k of tri_feat[t] flags edge (k,k+1) of t as a feature.
+class QEMDecimator
+{
+    public:
+
+        typedef std::array<double,10> Quadric; // E(p) = p^T A p + 2 b^T p + c, with A symmetric
+
+        struct Collapse
+        {
+            double cost = inf_double;
+            uint   v0   = 0;              // vertex that survives the collapse
+            uint   v1   = 0;              // vertex that collapses into v0
+            vec3d  pos  = vec3d(0,0,0);   // position of v0 after the collapse
+
+            // total order used both to sort collapses and to break ties
+            bool operator< (const Collapse & c) const
+            {
+                if(cost != c.cost) return cost < c.cost;
+                uint lo = std::min(v0,v1),   hi = std::max(v0,v1);
+                uint c_lo = std::min(c.v0,c.v1), c_hi = std::max(c.v0,c.v1);
+                return (lo != c_lo) ? lo < c_lo : hi < c_hi;
+            }
+        };
+
+        explicit QEMDecimator(const QEMDecimationOptions & opt) : opt(opt) {}
+
+        void init(const std::vector<vec3d>         & verts,
+                  const std::vector<uint>          & tris,
+                  const std::vector<unsigned char> & tri_feat);
+
+        void run();
+
+        void output(std::vector<vec3d> & verts,
+                    std::vector<uint>  & tris,
+                    std::vector<ipair> & feature_edges) const;
+
+    protected:
+
+        struct Ring
+        {
+            std::vector<uint> tris;  // alive triangles incident to the vertex
+            std::vector<uint> nbrs;  // adjacent vertices (sorted, unique)
+            std::vector<uint> feat;  // adjacent vertices along feature edges (sorted, unique)
+            bool on_boundary;
+        };
+
+        void gather        (const uint vid, Ring & r) const;
+        bool evaluate      (const uint v0, const uint v1, Collapse & c) const;
+        bool evaluate      (const uint v0, const Ring & r0, const uint v1, const Ring & r1, Collapse & c) const;
+        uint collapse      (const Collapse & c);
+        void purge         (const uint vid);
+        bool tri_has_vert  (const uint tid, const uint vid) const;
+        uint tri_third_vert(const uint tid, const uint v0, const uint v1) const;
+        uint tri_edge_bit  (const uint tid, const uint v0, const uint v1) const;
+        void run_serial();
+        void run_parallel();
+
+        // calls func on all the vertices in the one rings of the endpoints of c
+        // (with repetitions), stopping as soon as func returns false
+        template<class Func>
+        bool for_each_vert_in_footprint(const Collapse & c, const Func & func) const
+        {
+            for(uint v : { c.v0, c.v1 })
+            {
+                for(uint cid=head.at(v); cid!=NONE; cid=next.at(cid))
+                {
+                    uint tid = cid/3;
+                    if(!tri_alive.at(tid)) continue;
+                    for(uint k=0; k<3; ++k) if(!func(tris.at(3*tid+k))) return false;
+                }
+            }
+            return true;
+        }
+
+        QEMDecimationOptions       opt;
+        std::vector<vec3d>         pos;
+        std::vector<Quadric>       Q;
+        std::vector<uint>          tris;
+        std::vector<unsigned char> tri_alive;
+        std::vector<unsigned char> tri_feat;
+        std::vector<uint>          head;     // first corner of each vertex
+        std::vector<uint>          next;     // next corner of the same vertex
+        std::vector<unsigned char> v_alive;
+        std::vector<uint>          v_stamp;  // increased each time a vertex is modified
+        std::vector<uint>          v_round;  // (parallel mode) last round in which a vertex moved
+        std::vector<std::atomic<unsigned char>> v_dirty; // (parallel mode) one ring changed (1), vertex moved (2)
+        uint                       n_alive_tris;
+        uint                       round = 0;
+
+        enum : uint { NONE = 0xffffffff };
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+static void QEM_add_plane(QEMDecimator::Quadric & q, const vec3d & n, const vec3d & p, const double w)
+{
+    double d = -n.dot(p);
+    q[0] += w*n[0]*n[0]; q[1] += w*n[0]*n[1]; q[2] += w*n[0]*n[2];
+    q[3] += w*n[1]*n[1]; q[4] += w*n[1]*n[2]; q[5] += w*n[2]*n[2];
+    q[6] += w*d*n[0];    q[7] += w*d*n[1];    q[8] += w*d*n[2];
+    q[9] += w*d*d;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+static double QEM_eval(const QEMDecimator::Quadric & q, const vec3d & p)
+{
+    return     q[0]*p[0]*p[0] + q[3]*p[1]*p[1] + q[5]*p[2]*p[2] +
+           2.0*(q[1]*p[0]*p[1] + q[2]*p[0]*p[2] + q[4]*p[1]*p[2]) +
+           2.0*(q[6]*p[0]      + q[7]*p[1]      + q[8]*p[2]) + q[9];
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+static vec3d QEM_mul_A(const QEMDecimator::Quadric & q, const vec3d & p)
+{
+    return vec3d(q[0]*p[0] + q[1]*p[1] + q[2]*p[2],
+                 q[1]*p[0] + q[3]*p[1] + q[4]*p[2],
+                 q[2]*p[0] + q[4]*p[1] + q[5]*p[2]);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// point minimizing the quadric error. If A is (close to) singular the
+// minimizer is searched along the segment p0-p1 instead
+CINO_INLINE
+static vec3d QEM_optimal_pos(const QEMDecimator::Quadric & q, const vec3d & p0, const vec3d & p1)
+{
+    double c00 = q[3]*q[5] - q[4]*q[4];
+    double c01 = q[2]*q[4] - q[1]*q[5];
+    double c02 = q[1]*q[4] - q[2]*q[3];
+    double det = q[0]*c00 + q[1]*c01 + q[2]*c02;
+    double tr  = q[0] + q[3] + q[5];
+
+    if(std::fabs(det) > 1e-9*tr*tr*tr)
+    {
+        double c11 = q[0]*q[5] - q[2]*q[2];
+        double c12 = q[1]*q[2] - q[0]*q[4];
+        double c22 = q[0]*q[3] - q[1]*q[1];
+        vec3d  b(q[6], q[7], q[8]);
+        return vec3d(c00*b[0] + c01*b[1] + c02*b[2],
+                     c01*b[0] + c11*b[1] + c12*b[2],
+                     c02*b[0] + c12*b[1] + c22*b[2]) / -det;
+    }
+
+    vec3d  d   = p1 - p0;
+    vec3d  Ad  = QEM_mul_A(q,d);
+    double dAd = d.dot(Ad);
+    double t   = 0.5;
+    if(dAd > 0) t = std::min(1.0, std::max(0.0, -(Ad.dot(p0) + d.dot(vec3d(q[6],q[7],q[8])))/dAd));
+    return p0 + t*d;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// pseudo random (yet unique and deterministic) priority of an edge collapse
+CINO_INLINE
+static uint64_t QEM_priority(const QEMDecimator::Collapse & c)
+{
+    uint64_t x = (uint64_t(std::min(c.v0,c.v1)) << 32) | std::max(c.v0,c.v1);
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull; // splitmix64 finalizer (a bijection)
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// true if moving p to p_new flips (or degenerates) triangle <p,a,b>. Besides actual
+// flips, collapses that rotate the triangle normal by more than ~84 degrees, or that
+// shrink its area below 1/1000 of the original, are rejected, as they would leave
+// slivers (e.g. triangles with three nearly collinear vertices in flat regions)
+CINO_INLINE
+static bool QEM_flips(const vec3d & p, const vec3d & p_new, const vec3d & a, const vec3d & b)
+{
+    const double min_cos   = 0.1;
+    const double min_ratio = 1e-3;
+
+    double u[3], v[3], n[3], n_new[3];
+    for(uint i=0; i<3; ++i) { u[i] = a[i]-p[i]; v[i] = b[i]-p[i]; }
+    n[0] = u[1]*v[2] - u[2]*v[1];
+    n[1] = u[2]*v[0] - u[0]*v[2];
+    n[2] = u[0]*v[1] - u[1]*v[0];
+    for(uint i=0; i<3; ++i) { u[i] = a[i]-p_new[i]; v[i] = b[i]-p_new[i]; }
+    n_new[0] = u[1]*v[2] - u[2]*v[1];
+    n_new[1] = u[2]*v[0] - u[0]*v[2];
+    n_new[2] = u[0]*v[1] - u[1]*v[0];
+    double d      = n[0]*n_new[0] + n[1]*n_new[1] + n[2]*n_new[2];
+    double nn     = n[0]*n[0] + n[1]*n[1] + n[2]*n[2];
+    double nn_new = n_new[0]*n_new[0] + n_new[1]*n_new[1] + n_new[2]*n_new[2];
+    if(d <= 0) return true;
+    if(nn_new < min_ratio*min_ratio*nn) return true; // |n| is twice the triangle area
+    return d*d < min_cos*min_cos*nn*nn_new;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool QEMDecimator::tri_has_vert(const uint tid, const uint vid) const
+{
+    return tris[3*tid] == vid || tris[3*tid+1] == vid || tris[3*tid+2] == vid;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint QEMDecimator::tri_third_vert(const uint tid, const uint v0, const uint v1) const
+{
+    for(uint k=0; k<3; ++k)
+    {
+        uint vid = tris[3*tid+k];
+        if(vid != v0 && vid != v1) return vid;
+    }
+    assert(false);
+    return NONE;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint QEMDecimator::tri_edge_bit(const uint tid, const uint v0, const uint v1) const
+{
+    for(uint k=0; k<3; ++k)
+    {
+        uint a = tris[3*tid+k];
+        uint b = tris[3*tid+(k+1)%3];
+        if((a==v0 && b==v1) || (a==v1 && b==v0)) return 1u << k;
+    }
+    assert(false);
+    return 0;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void QEMDecimator::init(const std::vector<vec3d>         & verts,
+                        const std::vector<uint>          & tris,
+                        const std::vector<unsigned char> & tri_feat)
+{
+    uint nv = verts.size();
+    uint nt = tris.size()/3;
+
+    this->pos       = verts;
+    this->tris      = tris;
+    this->tri_feat  = tri_feat;
+    this->tri_alive = std::vector<unsigned char>(nt, 1);
+    this->n_alive_tris = nt;
+    v_alive = std::vector<unsigned char>(nv, 0);
+    v_stamp = std::vector<uint>(nv, 0);
+    v_round = std::vector<uint>(nv, 0);
+    v_dirty = std::vector<std::atomic<unsigned char>>(nv);
+    head    = std::vector<uint>(nv, NONE);
+    next    = std::vector<uint>(3*nt, NONE);
+    Q       = std::vector<Quadric>(nv);
+
+    for(uint c=0; c<3*nt; ++c)
+    {
+        uint vid   = tris[c];
+        next[c]    = head[vid];
+        head[vid]  = c;
+        v_alive[vid] = 1;
+    }
+
+    // vertex quadrics: area weighted planes of the incident triangles,
+    // plus constraint planes orthogonal to the incident feature edges
+    PARALLEL_FOR(0, nv, 1000, [&](uint vid)
+    {
+        v_dirty[vid].store(2, std::memory_order_relaxed);
+        Quadric & q = Q.at(vid);
+        q.fill(0);
+        if(!v_alive.at(vid)) return;
+
+        Ring r;
+        gather(vid, r);
+        for(uint tid : r.tris)
+        {
+            const vec3d & A = pos.at(this->tris.at(3*tid  ));
+            const vec3d & B = pos.at(this->tris.at(3*tid+1));
+            const vec3d & C = pos.at(this->tris.at(3*tid+2));
+            vec3d  n    = (B-A).cross(C-A);
+            double area = n.norm()*0.5;
+            if(area==0) continue;
+            n /= 2.0*area;
+            QEM_add_plane(q, n, A, area);
+
+            for(uint k=0; k<3; ++k)
+            {
+                uint a = this->tris.at(3*tid+k);
+                uint b = this->tris.at(3*tid+(k+1)%3);
+                if(a!=vid && b!=vid) continue;
+                uint other = (a==vid) ? b : a;
+                if(!std::binary_search(r.feat.begin(), r.feat.end(), other)) continue;
+                vec3d  e  = pos.at(b) - pos.at(a);
+                vec3d  m  = e.cross(n);
+                double l  = m.norm();
+                if(l==0) continue;
+                QEM_add_plane(q, m/l, pos.at(a), opt.feature_weight*e.norm_sqrd());
+            }
+        }
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// insertion sort, much faster than std::sort on the tiny lists of a one ring
+CINO_INLINE
+static void QEM_sort(std::vector<uint> & v)
+{
+    if(v.size()>32)
+    {
+        std::sort(v.begin(), v.end());
+        return;
+    }
+    for(uint i=1; i<v.size(); ++i)
+    {
+        uint x = v[i];
+        uint j = i;
+        for(; j>0 && v[j-1]>x; --j) v[j] = v[j-1];
+        v[j] = x;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void QEMDecimator::gather(const uint vid, Ring & r) const
+{
+    r.tris.clear();
+    r.nbrs.clear();
+    r.feat.clear();
+    r.on_boundary = false;
+
+    for(uint c=head.at(vid); c!=NONE; c=next.at(c))
+    {
+        uint tid = c/3;
+        if(!tri_alive.at(tid)) continue;
+        uint k  = c%3;
+        uint v1 = tris.at(3*tid+(k+1)%3);
+        uint v2 = tris.at(3*tid+(k+2)%3);
+        r.tris.push_back(tid);
+        r.nbrs.push_back(v1);
+        r.nbrs.push_back(v2);
+        if(tri_feat.at(tid) & (1u << k))       r.feat.push_back(v1); // edge (k,k+1)
+        if(tri_feat.at(tid) & (1u << (k+2)%3)) r.feat.push_back(v2); // edge (k+2,k)
+    }
+
+    // on a manifold, boundary edges are those seen by one triangle only
+    QEM_sort(r.nbrs);
+    for(uint i=0; i<r.nbrs.size(); ++i)
+    {
+        bool prev = (i>0               && r.nbrs.at(i-1)==r.nbrs.at(i));
+        bool succ = (i+1<r.nbrs.size() && r.nbrs.at(i+1)==r.nbrs.at(i));
+        if(!prev && !succ)
+        {
+            r.on_boundary = true;
+            if(opt.preserve_boundary) r.feat.push_back(r.nbrs.at(i));
+        }
+    }
+    r.nbrs.erase(std::unique(r.nbrs.begin(), r.nbrs.end()), r.nbrs.end());
+    QEM_sort(r.feat);
+    r.feat.erase(std::unique(r.feat.begin(), r.feat.end()), r.feat.end());
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool QEMDecimator::evaluate(const uint v0, const uint v1, Collapse & c) const
+{
+    static thread_local Ring r0, r1;
+    gather(v0, r0);
+    gather(v1, r1);
+    return evaluate(v0, r0, v1, r1, c);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// fills c with the collapse of v1 into v0, and returns false if the
+// collapse is not allowed (mirrors the checks in Trimesh::edge_collapse).
+// r0 and r1 are the one rings of v0 and v1, as returned by gather()
+CINO_INLINE
+bool QEMDecimator::evaluate(const uint v0, const Ring & r0, const uint v1, const Ring & r1, Collapse & c) const
+{
+    // computations are done in the same order regardless of the edge orientation,
+    // so that collapsing v0 into v1 or v1 into v0 has exactly the same cost
+    uint lo = std::min(v0,v1);
+    uint hi = std::max(v0,v1);
+    const Ring & r_lo = (lo==v0) ? r0 : r1;
+    const Ring & r_hi = (lo==v0) ? r1 : r0;
+
+    // topological check (link condition)
+    uint opp[2];
+    uint n_edge_tris = 0;
+    for(uint tid : r_lo.tris)
+    {
+        if(!tri_has_vert(tid,hi)) continue;
+        if(n_edge_tris==2) return false; // non manifold edge
+        opp[n_edge_tris++] = tri_third_vert(tid,lo,hi);
+    }
+    if(n_edge_tris==0) return false;
+
+    uint n_common = 0;
+    auto it_lo = r_lo.nbrs.begin();
+    auto it_hi = r_hi.nbrs.begin();
+    while(it_lo!=r_lo.nbrs.end() && it_hi!=r_hi.nbrs.end())
+    {
+        if     (*it_lo < *it_hi) ++it_lo;
+        else if(*it_hi < *it_lo) ++it_hi;
+        else { ++n_common; ++it_lo; ++it_hi; }
+    }
+    if(n_common != n_edge_tris) return false;
+
+    // an inner edge connecting two boundary vertices would pinch the mesh
+    if(n_edge_tris==2 && r_lo.on_boundary && r_hi.on_boundary) return false;
+
+    // do not make isolated triangles disappear
+    if(r_lo.tris.size()==1 && r_hi.tris.size()==1) return false;
+
+    // the collapse would create two coincident triangles
+    if(n_edge_tris==2 && opp[0]!=opp[1])
+    {
+        bool lo_has = false, hi_has = false;
+        for(uint tid : r_lo.tris) if(tri_has_vert(tid,opp[0]) && tri_has_vert(tid,opp[1])) lo_has = true;
+        for(uint tid : r_hi.tris) if(tri_has_vert(tid,opp[0]) && tri_has_vert(tid,opp[1])) hi_has = true;
+        if(lo_has && hi_has) return false;
+    }
+
+    // feature preservation
+    bool edge_is_feat = std::binary_search(r_lo.feat.begin(), r_lo.feat.end(), hi);
+    bool lo_is_feat   = !r_lo.feat.empty();
+    bool hi_is_feat   = !r_hi.feat.empty();
+    bool lo_is_corner = lo_is_feat && r_lo.feat.size()!=2;
+    bool hi_is_corner = hi_is_feat && r_hi.feat.size()!=2;
+
+    Quadric q;
+    for(uint i=0; i<10; ++i) q[i] = Q.at(lo)[i] + Q.at(hi)[i];
+
+    if(edge_is_feat)
+    {
+        if(lo_is_corner && hi_is_corner) return false;
+        if     (lo_is_corner) c.pos = pos.at(lo);
+        else if(hi_is_corner) c.pos = pos.at(hi);
+        else                  c.pos = QEM_optimal_pos(q, pos.at(lo), pos.at(hi));
+    }
+    else
+    {
+        if(lo_is_feat && hi_is_feat) return false; // would shortcut two features
+        if     (lo_is_feat) c.pos = pos.at(lo);
+        else if(hi_is_feat) c.pos = pos.at(hi);
+        else                c.pos = QEM_optimal_pos(q, pos.at(lo), pos.at(hi));
+    }
+
+    // geometric check (no triangle flips)
+    for(uint i=0; i<2; ++i)
+    {
+        uint         vid = (i==0) ? lo   : hi;
+        const Ring & r   = (i==0) ? r_lo : r_hi;
+        for(uint tid : r.tris)
+        {
+            if(tri_has_vert(tid,lo) && tri_has_vert(tid,hi)) continue;
+            uint k = (tris[3*tid]==vid) ? 0 : ((tris[3*tid+1]==vid) ? 1 : 2);
+            if(QEM_flips(pos[vid], c.pos, pos[tris[3*tid+(k+1)%3]], pos[tris[3*tid+(k+2)%3]])) return false;
+        }
+    }
+
+    c.cost = std::max(0.0, QEM_eval(q, c.pos));
+    c.v0   = v0;
+    c.v1   = v1;
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// performs the collapse and returns the number of triangles removed.
+// The whole update is confined to the triangles incident to v0 and v1,
+// therefore collapses with disjoint one rings can run concurrently
+CINO_INLINE
+uint QEMDecimator::collapse(const Collapse & c)
+{
+    uint v0 = c.v0;
+    uint v1 = c.v1;
+
+    // remove the triangles incident to the edge, moving their
+    // feature flags to the edges that will replace them
+    uint n_removed = 0;
+    for(uint cid=head.at(v1); cid!=NONE; cid=next.at(cid))
+    {
+        uint tid = cid/3;
+        if(!tri_alive.at(tid) || !tri_has_vert(tid,v0)) continue;
+        uint x    = tri_third_vert(tid,v0,v1);
+        bool feat = (tri_feat.at(tid) & (tri_edge_bit(tid,v0,x) | tri_edge_bit(tid,v1,x)));
+        tri_alive.at(tid) = 0;
+        ++n_removed;
+        if(!feat) continue;
+        for(uint vid : { v0, v1 })
+        {
+            for(uint cj=head.at(vid); cj!=NONE; cj=next.at(cj))
+            {
+                uint tj = cj/3;
+                if(tri_alive.at(tj) && tri_has_vert(tj,x) && !tri_has_vert(tj, vid==v0 ? v1 : v0))
+                {
+                    tri_feat.at(tj) |= tri_edge_bit(tj,vid,x);
+                }
+            }
+        }
+    }
+
+    // move the remaining corners of v1 to v0
+    for(uint cid=head.at(v1); cid!=NONE;)
+    {
+        uint cnext = next.at(cid);
+        if(tri_alive.at(cid/3))
+        {
+            tris.at(cid) = v0;
+            next.at(cid) = head.at(v0);
+            head.at(v0)  = cid;
+        }
+        cid = cnext;
+    }
+    head.at(v1)    = NONE;
+    v_alive.at(v1) = 0;
+
+    purge(v0);
+
+    pos.at(v0) = c.pos;
+    for(uint i=0; i<10; ++i) Q.at(v0)[i] += Q.at(v1)[i];
+    ++v_stamp.at(v0);
+    v_round.at(v0) = round;
+
+    // the best collapse of v0 must be recomputed, the ones of its neighbors
+    // only need to be checked against the edges incident to v0
+    v_dirty.at(v0).store(2, std::memory_order_relaxed);
+    for(uint cid=head.at(v0); cid!=NONE; cid=next.at(cid))
+    {
+        uint tid = cid/3;
+        for(uint k=0; k<3; ++k)
+        {
+            unsigned char clean = 0;
+            v_dirty.at(tris.at(3*tid+k)).compare_exchange_strong(clean, 1, std::memory_order_relaxed);
+        }
+    }
+    return n_removed;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// removes the corners of dead triangles from the list of a vertex
+CINO_INLINE
+void QEMDecimator::purge(const uint vid)
+{
+    uint * link = &head.at(vid);
+    while(*link!=NONE)
+    {
+        if(tri_alive.at(*link/3)) link = &next.at(*link);
+        else                      *link = next.at(*link);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void QEMDecimator::run()
+{
+    if(opt.parallel) run_parallel();
+    else             run_serial();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void QEMDecimator::run_serial()
+{
+    struct Entry
+    {
+        Collapse c;
+        uint     stamp0, stamp1;
+        bool operator> (const Entry & e) const { return e.c < c; }
+    };
+    std::priority_queue<Entry,std::vector<Entry>,std::greater<Entry>> q;
+
+    Ring r, r_nbr;
+    auto push_edges = [&](const uint vid, const bool all)
+    {
+        gather(vid, r);
+        for(uint nbr : r.nbrs)
+        {
+            if(!all && nbr<vid) continue; // initialization: visit each edge once
+            gather(nbr, r_nbr);
+            Entry e;
+            if(evaluate(vid, r, nbr, r_nbr, e.c) && e.c.cost<=opt.max_error)
+            {
+                e.stamp0 = v_stamp.at(vid);
+                e.stamp1 = v_stamp.at(nbr);
+                q.push(e);
+            }
+        }
+    };
+
+    for(uint vid=0; vid<pos.size(); ++vid) if(v_alive.at(vid)) push_edges(vid, false);
+
+    while(!q.empty() && n_alive_tris>opt.target_num_polys)
+    {
+        Entry e = q.top();
+        q.pop();
+
+        // lazy deletion of outdated entries
+        if(!v_alive.at(e.c.v0) || !v_alive.at(e.c.v1) ||
+           v_stamp.at(e.c.v0)!=e.stamp0 || v_stamp.at(e.c.v1)!=e.stamp1) continue;
+
+        // features may have changed in the neighborhood
+        Collapse c;
+        if(!evaluate(e.c.v0, e.c.v1, c) || c.cost>opt.max_error) continue;
+        if(e.c < c)
+        {
+            e.c = c;
+            q.push(e);
+            continue;
+        }
+
+        n_alive_tris -= collapse(c);
+        gather(c.v0, r);
+        for(uint nbr : r.nbrs) purge(nbr);
+        push_edges(c.v0, true);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void QEMDecimator::run_parallel()
+{
+    uint nv = pos.size();
+    std::vector<Collapse> best(nv); // cheapest valid collapse of each vertex
+    std::vector<uint>     candidates;
+    std::vector<unsigned char> is_min(nv, 0);
+    std::vector<std::atomic<uint64_t>> owner(nv); // lowest priority of the candidates incident to each vertex
+    for(auto & o : owner) o.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+    std::vector<double>   costs;
+    bool                  refreshed = false;
+    std::vector<Collapse> selected;
+    std::vector<uint>     active;
+    for(uint vid=0; vid<nv; ++vid) if(v_alive.at(vid)) active.push_back(vid);
+
+    while(n_alive_tris>opt.target_num_polys)
+    {
+        ++round;
+
+        // the lists of vertices adjacent to removed triangles contain dead corners.
+        // Only vertices whose one ring changed need to be visited, and lists are
+        // purged in a separate pass, because neighborhoods of concurrent collapses
+        // may overlap
+        PARALLEL_FOR(0, active.size(), 1000, [&](uint i)
+        {
+            uint vid = active.at(i);
+            if(v_dirty.at(vid).load(std::memory_order_relaxed)) purge(vid);
+        });
+
+        // update the best collapses. Vertices that moved (or whose best collapse
+        // is no longer valid) visit all their edges. Their neighbors only visit
+        // the edges towards the vertices that moved in the previous round, and
+        // fall back to a full visit only if their cached best collapse involved
+        // one of such vertices (or a vertex that was removed) and no cheaper
+        // option is found
+        PARALLEL_FOR(0, active.size(), 1000, [&](uint i)
+        {
+            uint vid   = active.at(i);
+            uint dirty = v_dirty.at(vid).load(std::memory_order_relaxed);
+            if(dirty==0) return;
+            v_dirty.at(vid).store(0, std::memory_order_relaxed);
+
+            static thread_local Ring r, r_nbr;
+            gather(vid, r);
+
+            Collapse & b = best.at(vid);
+            if(dirty==1 && b.cost<inf_double)
+            {
+                Collapse b_moved;
+                for(uint nbr : r.nbrs)
+                {
+                    if(v_round.at(nbr)+1!=round) continue;
+                    Collapse c;
+                    gather(nbr, r_nbr);
+                    if(evaluate(vid, r, nbr, r_nbr, c) && c.cost<=opt.max_error && c<b_moved) b_moved = c;
+                }
+                if(v_alive.at(b.v1) && v_round.at(b.v1)+1!=round) // b is still valid
+                {
+                    if(b_moved<b) b = b_moved;
+                    return;
+                }
+                if(!(b<b_moved)) // all other collapses cost at least b
+                {
+                    b = b_moved;
+                    return;
+                }
+            }
+
+            b = Collapse();
+            for(uint nbr : r.nbrs)
+            {
+                Collapse c;
+                gather(nbr, r_nbr);
+                if(evaluate(vid, r, nbr, r_nbr, c) && c.cost<=opt.max_error && c<b) b = c;
+            }
+        });
+
+        // candidates are the best collapses of each vertex whose cost is below a threshold
+        // (a quantile of the current costs). Each candidate claims its two endpoints, and
+        // conflicts are resolved in favour of the candidate with lowest priority. A candidate
+        // is selected if no other candidate with lower priority claimed a vertex in the one
+        // rings of its endpoints. Selected collapses can never share a triangle, and none of
+        // them moves a vertex that is read by another one, hence they are all independent.
+        // Priorities are randomized (rather than just being the costs) to avoid long chains
+        // of dependencies in regions where costs are all equal (e.g. flat areas), which
+        // would otherwise serialize the process
+        costs.clear();
+        for(uint vid : active) if(best.at(vid).cost<inf_double) costs.push_back(best.at(vid).cost);
+        if(costs.empty()) break;
+        std::nth_element(costs.begin(), costs.begin()+costs.size()/4, costs.end());
+        double max_cost = costs.at(costs.size()/4);
+
+        selected.clear();
+        for(uint attempt=0; attempt<2 && selected.empty(); ++attempt)
+        {
+            if(attempt==1) max_cost = inf_double; // no collapse found below threshold, use them all
+
+            candidates.clear();
+            for(uint vid : active)
+            {
+                const Collapse & c = best.at(vid);
+                if(c.cost>max_cost) continue;
+                // if the same edge is the best collapse of both its endpoints, only one of them takes it
+                if(c.v1<vid && best.at(c.v1).v1==vid && best.at(c.v1).cost<=max_cost) continue;
+                candidates.push_back(vid);
+            }
+
+            PARALLEL_FOR(0, candidates.size(), 1000, [&](uint i)
+            {
+                const Collapse & c = best.at(candidates.at(i));
+                uint64_t prio = QEM_priority(c);
+                for(uint vid : { c.v0, c.v1 })
+                {
+                    uint64_t curr = owner.at(vid).load(std::memory_order_relaxed);
+                    while(prio<curr && !owner.at(vid).compare_exchange_weak(curr, prio, std::memory_order_relaxed)) {}
+                }
+            });
+
+            PARALLEL_FOR(0, candidates.size(), 1000, [&](uint i)
+            {
+                const Collapse & c = best.at(candidates.at(i));
+                uint64_t prio = QEM_priority(c);
+                is_min.at(candidates.at(i)) = for_each_vert_in_footprint(c, [&](uint vid) -> bool
+                {
+                    return owner.at(vid).load(std::memory_order_relaxed)>=prio;
+                });
+            });
+
+            for(uint vid : candidates)
+            {
+                if(is_min.at(vid)) selected.push_back(best.at(vid));
+                owner.at(best.at(vid).v0).store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+                owner.at(best.at(vid).v1).store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+            }
+        }
+
+        // no independent collapse found: cached best collapses may be stale,
+        // recompute them all once before giving up
+        if(selected.empty())
+        {
+            if(refreshed) break;
+            for(uint vid : active) v_dirty.at(vid).store(2, std::memory_order_relaxed);
+            refreshed = true;
+            continue;
+        }
+        refreshed = false;
+
+        // do not go below the target number of triangles
+        uint n_needed = (n_alive_tris - opt.target_num_polys + 1)/2;
+        if(selected.size()>n_needed)
+        {
+            std::nth_element(selected.begin(), selected.begin()+n_needed, selected.end());
+            selected.resize(n_needed);
+        }
+
+        // the cached best collapse of a vertex is not updated when only the one ring
+        // of the other endpoint changes. Stale collapses are discarded, and their
+        // vertices fully evaluated again at the next round
+        std::vector<uint> n_removed(selected.size());
+        PARALLEL_FOR(0, selected.size(), 1000, [&](uint i)
+        {
+            const Collapse & c = selected.at(i);
+            Collapse c_now;
+            if(!evaluate(c.v0, c.v1, c_now) || c_now.cost!=c.cost || !(c_now.pos==c.pos))
+            {
+                v_dirty.at(c.v0).store(2, std::memory_order_relaxed);
+                v_dirty.at(c.v1).store(2, std::memory_order_relaxed);
+                n_removed.at(i) = 0;
+                return;
+            }
+            n_removed.at(i) = collapse(c);
+        });
+        for(uint n : n_removed) n_alive_tris -= n;
+
+        active.erase(std::remove_if(active.begin(), active.end(), [&](uint vid) { return !v_alive.at(vid); }), active.end());
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void QEMDecimator::output(std::vector<vec3d> & verts,
+                          std::vector<uint>  & tris,
+                          std::vector<ipair> & feature_edges) const
+{
+    std::vector<uint> vmap(pos.size(), NONE);
+    verts.clear();
+    tris.clear();
+    feature_edges.clear();
+
+    for(uint tid=0; tid<tri_alive.size(); ++tid)
+    {
+        if(!tri_alive.at(tid)) continue;
+        for(uint k=0; k<3; ++k)
+        {
+            uint vid = this->tris.at(3*tid+k);
+            if(vmap.at(vid)==NONE)
+            {
+                vmap.at(vid) = verts.size();
+                verts.push_back(pos.at(vid));
+            }
+            tris.push_back(vmap.at(vid));
+        }
+        for(uint k=0; k<3; ++k)
+        {
+            if(tri_feat.at(tid) & (1u << k))
+            {
+                feature_edges.push_back(unique_pair(tris.at(tris.size()-3+k),
+                                                    tris.at(tris.size()-3+(k+1)%3)));
+            }
+        }
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void QEM_decimation(Trimesh<M,V,E,P>           & m,
+                    const QEMDecimationOptions & opt)
+{
+    std::vector<uint>          tris(3*m.num_polys());
+    std::vector<unsigned char> tri_feat(m.num_polys(), 0);
+    for(uint pid=0; pid<m.num_polys(); ++pid)
+    {
+        for(uint k=0; k<3; ++k)
+        {
+            tris.at(3*pid+k) = m.poly_vert_id(pid,k);
+            if(opt.preserve_marked_edges && m.edge_data(m.poly_edge_id(pid,k)).flags[MARKED])
+            {
+                tri_feat.at(pid) |= (1u << k);
+            }
+        }
+    }
+
+    QEMDecimator d(opt);
+    d.init(m.vector_verts(), tris, tri_feat);
+    d.run();
+
+    std::vector<vec3d> verts;
+    std::vector<ipair> feat;
+    d.output(verts, tris, feat);
+
+    m = Trimesh<M,V,E,P>(verts, tris);
+    for(const ipair & e : feat)
+    {
+        int eid = m.edge_id(e.first, e.second);
+        if(eid>=0) m.edge_data(eid).flags[MARKED] = true;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void QEM_decimation(std::vector<vec3d>         & verts,
+                    std::vector<uint>          & tris,
+                    const QEMDecimationOptions & opt)
+{
+    QEMDecimator d(opt);
+    d.init(verts, tris, std::vector<unsigned char>(tris.size()/3, 0));
+    d.run();
+
+    std::vector<ipair> feat;
+    d.output(verts, tris, feat);
+}
+
+}
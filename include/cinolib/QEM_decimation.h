@@ -0,0 +1,113 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_QEM_DECIMATION_H
+#define CINO_QEM_DECIMATION_H
+
+#include <cinolib/meshes/trimesh.h>
+
+namespace cinolib
+{
+
+/* Simplifies a triangle mesh with a sequence of edge collapses ordered by
+ * the Quadric Error Metric described in:
+ *
+ *   Surface Simplification Using Quadric Error Metrics
+ *   Michael Garland and Paul S. Heckbert
+ *   SIGGRAPH 1997
+ *
+ * Each collapse is subject to the same checks of Trimesh::edge_collapse: the
+ * link condition (which keeps the mesh manifold, and its boundary untouched
+ * in topology) and the no-flip test on the triangles that survive the collapse.
+ * Collapses are not performed on the Trimesh itself (each vertex/poly removal
+ * renumbers the mesh elements, which does not scale to large meshes), but on a
+ * light corner-based representation from which the output mesh is rebuilt at
+ * the end. Vertex, edge and poly attributes are therefore reset, with the only
+ * exception of the MARKED edge flags, which are preserved when marked edges
+ * are treated as features.
+ *
+ * Feature edges (marked edges and/or boundary edges) are preserved by means
+ * of constraint quadrics, and by never collapsing an edge that would shortcut
+ * two feature lines. Feature corners (vertices incident to a number of feature
+ * edges other than 2) are held in place.
+ *
+ * The serial mode pops collapses from a priority queue (with lazy deletion of
+ * outdated entries). The parallel mode proceeds in rounds: at each round it
+ * selects an independent set of collapses (edges whose cost is the minimum in
+ * the one ring of both their endpoints, hence having disjoint neighborhoods)
+ * and performs them concurrently. The parallel mode is much faster on big meshes,
+ * at the price of a slightly less greedy ordering of the collapses.
+ *
+ * Decimation stops when the number of triangles drops to target_num_polys,
+ * or when the cheapest collapse available would introduce an error bigger
+ * than max_error (whichever comes first).
+*/
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+typedef struct
+{
+    uint   target_num_polys      = 0;          // stop when the mesh has (at most) this many triangles
+    double max_error             = inf_double; // stop when the cheapest collapse exceeds this error (area weighted squared distance)
+    bool   preserve_boundary     = true;       // treat boundary edges as features
+    bool   preserve_marked_edges = true;       // treat marked edges as features (Trimesh only)
+    double feature_weight        = 1000.0;     // weight of the constraint quadrics for feature edges
+    bool   parallel              = false;      // collapse independent sets of edges concurrently
+}
+QEMDecimationOptions;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void QEM_decimation(Trimesh<M,V,E,P>           & m,
+                    const QEMDecimationOptions & opt = QEMDecimationOptions());
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// works directly on a triangle soup (3 vids per triangle, with shared vertices),
+// skipping the construction of the mesh connectivity. Unreferenced vertices are
+// removed from the output
+CINO_INLINE
+void QEM_decimation(std::vector<vec3d>         & verts,
+                    std::vector<uint>          & tris,
+                    const QEMDecimationOptions & opt = QEMDecimationOptions());
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "QEM_decimation.cpp"
+#endif
+
+#endif // CINO_QEM_DECIMATION_H
@@ -34,6 +34,7 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/RBF_Hermite.h>
+#include <cinolib/parallel_for.h>
 
 namespace cinolib
 {
@@ -61,7 +62,8 @@ Hermite_RBF<RBF>::Hermite_RBF(const std::vector<vec3d> & points,
         center.col(i) = Eigen::Vector3d(points.at(i).x(), points.at(i).y(), points.at(i).z());
     }
 
-    for(uint i=0; i<np; ++i)
+    // rows of different points are independent
+    PARALLEL_FOR(0, np, 64, [&](const uint i)
     {
         Eigen::Vector3d p = Eigen::Vector3d(points.at(i).x(),  points.at(i).y(),  points.at(i).z());
         Eigen::Vector3d n = Eigen::Vector3d(normals.at(i).x(), normals.at(i).y(), normals.at(i).z());
@@ -77,7 +79,10 @@ Hermite_RBF<RBF>::Hermite_RBF(const std::vector<vec3d> & points,
             double len=diff.norm();
             if(len==0)
             {
+                // limits for len -> 0 (all zeros for the cubic kernel)
                 A.template block<4,4>(ii,jj).setZero();
+                A(ii,jj) = RBF::eval_f(0);
+                A.template block<3,3>(ii+1,jj+1).diagonal().array() += RBF::eval_ddf(0);
             }
             else
             {
@@ -92,7 +97,7 @@ Hermite_RBF<RBF>::Hermite_RBF(const std::vector<vec3d> & points,
                 A.template block<3,3>(ii+1,jj+1).diagonal().array() += dw_l;
             }
         }
-    }
+    });
 
     x = A.lu().solve(f);
     Eigen::Map<Eigen::Matrix4Xd> mx(x.data(), 4, np);
@@ -108,7 +113,10 @@ CINO_INLINE
 ScalarField Hermite_RBF<RBF>::eval(const std::vector<vec3d> & plist) const
 {
     ScalarField f(plist.size());
-    for(uint i=0; i<plist.size(); ++i) f[i] = eval(plist.at(i));
+    PARALLEL_FOR(0, plist.size(), 1000, [&](const uint i)
+    {
+        f[i] = eval(plist.at(i));
+    });
     return f;
 }
 
@@ -129,6 +137,7 @@ double Hermite_RBF<RBF>::eval(const vec3d & p) const
             val += alpha(i) * RBF::eval_f(l);
             val += beta.col(i).dot(diff)*RBF::eval_df(l)/l;
         }
+        else val += alpha(i) * RBF::eval_f(0);
     }
     return val;
 }
@@ -163,6 +172,7 @@ vec3d Hermite_RBF<RBF>::eval_grad(const vec3d &p) const
             grad += alpha_dphi * diffNormalized;
             grad += bDotd_l * (ddphi*diffNormalized - diff*dphi/squared_l) + beta*dphi/len ;
         }
+        else grad += beta * RBF::eval_ddf(0);
     }
 
     return vec3d(grad[0], grad[1], grad[2]);
@@ -0,0 +1,396 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/RBF_Hermite_PU.h>
+#include <cinolib/parallel_for.h>
+#include <algorithm>
+#include <numeric>
+
+namespace cinolib
+{
+
+template<class RBF>
+CINO_INLINE
+Hermite_RBF_PU<RBF>::Hermite_RBF_PU(const std::vector<vec3d>  & points,
+                                    const std::vector<vec3d>  & normals,
+                                    const HermiteRBFPUOptions & opt)
+{
+    assert(points.size()==normals.size());
+    if(points.empty()) return;
+
+    build_tree(points, opt);
+
+    std::vector<uint> leaves;
+    for(uint nid=0; nid<nodes.size(); ++nid)
+    {
+        if(nodes.at(nid).child>=0) continue;
+        nodes.at(nid).fit = leaves.size();
+        leaves.push_back(nid);
+    }
+
+    // local fits are independent from each other
+    fits.resize(leaves.size());
+    PARALLEL_FOR(0, leaves.size(), 16, [&](const uint i)
+    {
+        fit_leaf(leaves.at(i), normals, opt);
+    });
+
+    // children always follow their father, hence reach boxes can be computed bottom up
+    for(int nid=nodes.size()-1; nid>=0; --nid)
+    {
+        Node & n = nodes.at(nid);
+        if(n.child<0)
+        {
+            vec3d r(n.radius, n.radius, n.radius);
+            n.reach_min = n.center - r;
+            n.reach_max = n.center + r;
+        }
+        else
+        {
+            n.reach_min = nodes.at(n.child).reach_min;
+            n.reach_max = nodes.at(n.child).reach_max;
+            for(int i=1; i<8; ++i)
+            {
+                n.reach_min = n.reach_min.min(nodes.at(n.child+i).reach_min);
+                n.reach_max = n.reach_max.max(nodes.at(n.child+i).reach_max);
+            }
+        }
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class RBF>
+CINO_INLINE
+void Hermite_RBF_PU<RBF>::build_tree(const std::vector<vec3d>  & points,
+                                     const HermiteRBFPUOptions & opt)
+{
+    vec3d bmin = points.front();
+    vec3d bmax = points.front();
+    for(const vec3d & p : points)
+    {
+        bmin = bmin.min(p);
+        bmax = bmax.max(p);
+    }
+    double size = (bmax-bmin).max_entry();
+    if(size==0) size = 1;
+
+    Node root;
+    root.center    = (bmin+bmax)*0.5;
+    root.half_size = size;           // twice the size of the points bbox, to cover some space around them
+    root.radius    = 0;
+    root.reach_min = root.center;
+    root.reach_max = root.center;
+    root.beg       = 0;
+    root.end       = points.size();
+    root.child     = -1;
+    root.fit       = -1;
+    nodes.push_back(root);
+
+    sorted = points;
+    sort_ids.resize(points.size());
+    std::iota(sort_ids.begin(), sort_ids.end(), 0);
+
+    std::vector<vec3d> tmp_p;
+    std::vector<uint>  tmp_i;
+    std::vector<uint>  ball;
+    std::vector<std::pair<uint,uint>> stack; // (node, depth)
+    stack.push_back(std::make_pair(0,0));
+    while(!stack.empty())
+    {
+        uint nid   = stack.back().first;
+        uint depth = stack.back().second;
+        stack.pop_back();
+
+        Node n = nodes.at(nid);
+        if(depth>=opt.max_depth) continue;
+        if(n.end-n.beg <= opt.max_points_per_cell)
+        {
+            // cells whose circumscribed ball contains too many points are split too, so
+            // that their support can cover them without exceeding max_points_per_fit
+            points_in(n.center, n.ball_radius(), ball, opt.max_points_per_fit);
+            if(ball.size()<=opt.max_points_per_fit) continue;
+        }
+
+        // split the points in the 8 octants (counting sort)
+        auto octant = [&](const vec3d & p)
+        {
+            return ((p.x()>=n.center.x()) ? 1 : 0) |
+                   ((p.y()>=n.center.y()) ? 2 : 0) |
+                   ((p.z()>=n.center.z()) ? 4 : 0);
+        };
+        uint count[9] = {0,0,0,0,0,0,0,0,0};
+        for(uint i=n.beg; i<n.end; ++i) ++count[octant(sorted.at(i))+1];
+        for(int o=0; o<8; ++o) count[o+1] += count[o];
+
+        tmp_p.resize(n.end-n.beg);
+        tmp_i.resize(n.end-n.beg);
+        uint pos[8];
+        std::copy(count, count+8, pos);
+        for(uint i=n.beg; i<n.end; ++i)
+        {
+            uint j = pos[octant(sorted.at(i))]++;
+            tmp_p.at(j) = sorted.at(i);
+            tmp_i.at(j) = sort_ids.at(i);
+        }
+        std::copy(tmp_p.begin(), tmp_p.end(), sorted.begin()+n.beg);
+        std::copy(tmp_i.begin(), tmp_i.end(), sort_ids.begin()+n.beg);
+
+        nodes.at(nid).child = nodes.size();
+        for(int o=0; o<8; ++o)
+        {
+            double h = n.half_size*0.5;
+            Node c;
+            c.center    = n.center + vec3d((o&1) ? h : -h, (o&2) ? h : -h, (o&4) ? h : -h);
+            c.half_size = h;
+            c.radius    = 0;
+            c.reach_min = c.center;
+            c.reach_max = c.center;
+            c.beg       = n.beg + count[o];
+            c.end       = n.beg + count[o+1];
+            c.child     = -1;
+            c.fit       = -1;
+            stack.push_back(std::make_pair(nodes.size(), depth+1));
+            nodes.push_back(c);
+        }
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class RBF>
+CINO_INLINE
+void Hermite_RBF_PU<RBF>::fit_leaf(const uint                  nid,
+                                   const std::vector<vec3d>  & normals,
+                                   const HermiteRBFPUOptions & opt)
+{
+    Node & n = nodes.at(nid);
+
+    // gather the points in the support, enlarging it if they are too few
+    double r = opt.support_scale * 2*sqrt(3.0) * n.half_size;
+    std::vector<uint> ids;
+    points_in(n.center, r, ids);
+    while(ids.size()<opt.min_points_per_fit && ids.size()<sorted.size())
+    {
+        r *= 1.5;
+        points_in(n.center, r, ids);
+    }
+
+    // keep the closest ones if they are too many, and shrink the support accordingly
+    // (local functions are not reliable far from the points they interpolate). The
+    // support never gets smaller than the ball circumscribed to the cell, so that
+    // supports cover the whole domain. The tree is built so that this ball contains
+    // at most max_points_per_fit points (unless max_depth is reached)
+    if(ids.size()>opt.max_points_per_fit)
+    {
+        auto closer = [&](const uint i, const uint j)
+        {
+            return sorted.at(i).dist_sqrd(n.center) < sorted.at(j).dist_sqrd(n.center);
+        };
+        std::nth_element(ids.begin(), ids.begin()+opt.max_points_per_fit, ids.end(), closer);
+        r = std::max(sorted.at(ids.at(opt.max_points_per_fit)).dist(n.center), n.ball_radius());
+        ids.erase(std::remove_if(ids.begin(), ids.end(), [&](const uint i)
+        {
+            return sorted.at(i).dist(n.center) >= r;
+        }), ids.end());
+    }
+    n.radius = r;
+
+    // coincident points would make the system singular
+    std::vector<vec3d> p, nrm;
+    double eps = 1e-10 * r * r;
+    for(uint id : ids)
+    {
+        bool dup = false;
+        for(const vec3d & q : p) if(q.dist_sqrd(sorted.at(id))<=eps) { dup = true; break; }
+        if(dup) continue;
+        p.push_back(sorted.at(id));
+        nrm.push_back(normals.at(sort_ids.at(id)));
+    }
+    fits.at(n.fit) = Hermite_RBF<RBF>(p, nrm);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class RBF>
+CINO_INLINE
+void Hermite_RBF_PU<RBF>::points_in(const vec3d & c, const double r, std::vector<uint> & ids, const uint max_ids) const
+{
+    // stops as soon as more than max_ids points are found
+    ids.clear();
+    double r2 = r*r;
+    std::vector<uint> stack(1,0);
+    while(!stack.empty() && ids.size()<=max_ids)
+    {
+        const Node & n = nodes.at(stack.back());
+        stack.pop_back();
+
+        // squared distance between c and the cell
+        double d2 = 0;
+        for(int i=0; i<3; ++i)
+        {
+            double d = std::fabs(c[i]-n.center[i]) - n.half_size;
+            if(d>0) d2 += d*d;
+        }
+        if(d2>r2 || n.beg==n.end) continue;
+
+        if(n.child>=0)
+        {
+            for(int i=0; i<8; ++i) stack.push_back(n.child+i);
+        }
+        else
+        {
+            for(uint i=n.beg; i<n.end; ++i) if(sorted.at(i).dist_sqrd(c)<r2) ids.push_back(i);
+        }
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class RBF>
+CINO_INLINE
+int Hermite_RBF_PU<RBF>::closest_leaf(const vec3d & p) const
+{
+    if(nodes.empty()) return -1;
+    uint nid = 0;
+    while(nodes.at(nid).child>=0)
+    {
+        const Node & n = nodes.at(nid);
+        nid = n.child + (((p.x()>=n.center.x()) ? 1 : 0) |
+                         ((p.y()>=n.center.y()) ? 2 : 0) |
+                         ((p.z()>=n.center.z()) ? 4 : 0));
+    }
+    return nid;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class RBF>
+template<class Func>
+CINO_INLINE
+void Hermite_RBF_PU<RBF>::for_each_support(const vec3d & p, const Func & func) const
+{
+    if(nodes.empty()) return;
+    std::vector<uint> stack;
+    stack.reserve(64);
+    stack.push_back(0);
+    while(!stack.empty())
+    {
+        const Node & n = nodes.at(stack.back());
+        stack.pop_back();
+
+        if(p.x()<n.reach_min.x() || p.x()>n.reach_max.x() ||
+           p.y()<n.reach_min.y() || p.y()>n.reach_max.y() ||
+           p.z()<n.reach_min.z() || p.z()>n.reach_max.z()) continue;
+
+        if(n.child>=0)
+        {
+            for(int i=0; i<8; ++i) stack.push_back(n.child+i);
+        }
+        else
+        {
+            double d = p.dist(n.center);
+            if(d<n.radius) func(n, d);
+        }
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class RBF>
+CINO_INLINE
+ScalarField Hermite_RBF_PU<RBF>::eval(const std::vector<vec3d> & plist) const
+{
+    ScalarField f(plist.size());
+    PARALLEL_FOR(0, plist.size(), 1000, [&](const uint i)
+    {
+        f[i] = eval(plist.at(i));
+    });
+    return f;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class RBF>
+CINO_INLINE
+double Hermite_RBF_PU<RBF>::eval(const vec3d & p) const
+{
+    double sum_w  = 0;
+    double sum_wf = 0;
+    for_each_support(p, [&](const Node & n, const double d)
+    {
+        double w = WendlandRBF::eval_f(d/n.radius);
+        if(w==0) return;
+        sum_w  += w;
+        sum_wf += w * fits.at(n.fit).eval(p);
+    });
+    if(sum_w>0) return sum_wf/sum_w;
+
+    // outside of all supports
+    int nid = closest_leaf(p);
+    return (nid>=0) ? fits.at(nodes.at(nid).fit).eval(p) : 0;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class RBF>
+CINO_INLINE
+vec3d Hermite_RBF_PU<RBF>::eval_grad(const vec3d & p) const
+{
+    // gradient of sum(w_i*f_i)/sum(w_i)
+    double sum_w   = 0;
+    double sum_wf  = 0;
+    vec3d  sum_dw  (0,0,0);
+    vec3d  sum_dwf (0,0,0);
+    for_each_support(p, [&](const Node & n, const double d)
+    {
+        double w = WendlandRBF::eval_f(d/n.radius);
+        if(w==0) return;
+        vec3d  dw = (d>0) ? (p-n.center) * (WendlandRBF::eval_df(d/n.radius)/(d*n.radius)) : vec3d(0,0,0);
+        double f  = fits.at(n.fit).eval(p);
+        vec3d  df = fits.at(n.fit).eval_grad(p);
+        sum_w   += w;
+        sum_wf  += w*f;
+        sum_dw  += dw;
+        sum_dwf += df*w + dw*f;
+    });
+    if(sum_w>0) return (sum_dwf*sum_w - sum_dw*sum_wf)/(sum_w*sum_w);
+
+    // outside of all supports
+    int nid = closest_leaf(p);
+    return (nid>=0) ? fits.at(nodes.at(nid).fit).eval_grad(p) : vec3d(0,0,0);
+}
+
+}
@@ -0,0 +1,133 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_RBF_HERMITE_PU_H
+#define CINO_RBF_HERMITE_PU_H
+
+#include <cinolib/RBF_Hermite.h>
+#include <cinolib/RBF_kernels.h>
+#include <climits>
+
+namespace cinolib
+{
+
+typedef struct
+{
+    uint   max_points_per_cell = 32;   // octree cells containing more points are split
+    uint   max_depth           = 16;   // ...unless they are this deep already
+    double support_scale       = 0.75; // radius of the support of a cell, relative to the cell diagonal
+    uint   min_points_per_fit  = 16;   // supports containing less points are enlarged (e.g. around empty cells)
+    uint   max_points_per_fit  = 48;   // if more points fall in a support, the closest ones are used
+}
+HermiteRBFPUOptions;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* Hermite RBF interpolation (see RBF_Hermite.h) for large sets of oriented points. A single
+ * global Hermite RBF requires the solution of a dense 4n x 4n linear system, and each of its
+ * evaluations costs O(n). Here the domain is rather split with an octree, having at most
+ * max_points_per_cell points per leaf (and at most max_points_per_fit points in the ball
+ * circumscribed to each leaf), and a small Hermite RBF is fitted on the points that fall
+ * within a spherical support around each leaf. Local fits are independent from each
+ * other and are computed in parallel. Local functions are blended with the Wendland weights
+ * of their supports (partition of unity):
+ *
+ *     Multi-level Partition of Unity Implicits
+ *     Y. Ohtake, A. Belyaev, M. Alexa, G. Turk, H.P. Seidel
+ *     ACM Transactions on Graphics (SIGGRAPH 2003)
+ *
+ * Construction costs O(n log n), and each evaluation only visits the few supports containing
+ * the query point (the octree is used to cull the others). Leaves tile the bounding cube of
+ * the input points, hence every point in it is covered by some support. Outside of it, the
+ * function of the closest leaf is used.
+*/
+
+template<class RBF = CubicRBF>
+class Hermite_RBF_PU
+{
+    public:
+
+        Hermite_RBF_PU(){}
+        Hermite_RBF_PU(const std::vector<vec3d>  & points,
+                       const std::vector<vec3d>  & normals,
+                       const HermiteRBFPUOptions & opt = HermiteRBFPUOptions());
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        ScalarField eval     (const std::vector<vec3d> & plist) const; // evaluate at points plist (in parallel)
+        double      eval     (const vec3d & p) const;                  // evaluate at point p
+        vec3d       eval_grad(const vec3d & p) const;                  // evaluate the gradient at point p
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        uint num_cells() const { return fits.size(); }
+
+    protected:
+
+        struct Node
+        {
+            vec3d  center;      // center of the cell (and of its support)
+            double half_size;   // half edge of the (cubic) cell
+            double radius;      // radius of the support (leaves only)
+            vec3d  reach_min;   // bounding box of the supports of all the leaves below
+            vec3d  reach_max;
+            uint   beg, end;    // range of (sorted) points contained in the cell
+            int    child;       // index of the first of 8 consecutive children (-1 for leaves)
+            int    fit;         // index of the local function (-1 for inner nodes)
+
+            double ball_radius() const { return 1.001*sqrt(3.0)*half_size; } // (slightly enlarged) ball circumscribed to the cell
+        };
+
+        void build_tree  (const std::vector<vec3d> & points, const HermiteRBFPUOptions & opt);
+        void fit_leaf    (const uint nid, const std::vector<vec3d> & normals, const HermiteRBFPUOptions & opt);
+        void points_in   (const vec3d & c, const double r, std::vector<uint> & ids, const uint max_ids = UINT_MAX) const;
+        int  closest_leaf(const vec3d & p) const;
+
+        template<class Func>
+        void for_each_support(const vec3d & p, const Func & func) const;
+
+        std::vector<Node>             nodes;
+        std::vector<vec3d>            sorted;   // input points, sorted in leaf order
+        std::vector<uint>             sort_ids; // ...and their position in the input vector
+        std::vector<Hermite_RBF<RBF>> fits;
+};
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "RBF_Hermite_PU.cpp"
+#endif
+
+#endif // CINO_RBF_HERMITE_PU_H
@@ -47,6 +47,24 @@ class CubicRBF
     static inline double eval_ddf(const double x) { return 6*x;   } // second derivative
 };
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* Compactly supported (and positive definite) C2 kernel with support radius 1
+ *
+ *     Piecewise polynomial, positive definite radial functions of minimal degree
+ *     H. Wendland
+ *     Advances in Computational Mathematics (1995)
+ *
+ * Input data must be scaled accordingly (the kernel is zero for x >= 1)
+*/
+class WendlandRBF
+{
+    public:
+    static inline double eval_f  (const double x) { return (x<1) ? (1-x)*(1-x)*(1-x)*(1-x)*(4*x+1) : 0; }
+    static inline double eval_df (const double x) { return (x<1) ? -20*x*(1-x)*(1-x)*(1-x)        : 0; } // first  derivative
+    static inline double eval_ddf(const double x) { return (x<1) ? 20*(1-x)*(1-x)*(4*x-1)         : 0; } // second derivative
+};
+
 }
 
 #endif // CINO_RBF_KERNELS_H
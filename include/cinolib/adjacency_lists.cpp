@@ -0,0 +1,500 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/adjacency_lists.h>
+#include <algorithm>
+#include <stdexcept>
+#include <cstring>
+#include <assert.h>
+
+namespace cinolib
+{
+
+CINO_INLINE
+const uint & IndexSpan::at(const size_t i) const
+{
+    if(i>=size()) throw std::out_of_range("IndexSpan::at");
+    return b[i];
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+AdjacencyList & AdjacencyList::operator=(const IndexSpan & l)
+{
+    AdjacencyLists::Slot & s = lists->slots[id];
+    if(l.size()>s.cap)
+    {
+        s.size = 0; // nothing to copy
+        lists->grow(s, l.size());
+    }
+    // the source may be a list of the same storage (even this one), but
+    // slots are never moved by grow(), hence it is still valid here
+    std::copy(l.begin(), l.end(), s.ptr);
+    s.size = l.size();
+    return *this;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint * AdjacencyList::begin() const
+{
+    return lists->slots[id].ptr;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint * AdjacencyList::end() const
+{
+    const AdjacencyLists::Slot & s = lists->slots[id];
+    return s.ptr + s.size;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+size_t AdjacencyList::size() const
+{
+    return lists->slots[id].size;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint & AdjacencyList::at(const size_t i) const
+{
+    if(i>=size()) throw std::out_of_range("AdjacencyList::at");
+    return begin()[i];
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void AdjacencyList::push_back(const uint id)
+{
+    AdjacencyLists::Slot & s = lists->slots[this->id];
+    if(s.size==s.cap) lists->grow(s, std::max(4u, 2*s.cap));
+    s.ptr[s.size++] = id;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void AdjacencyList::pop_back()
+{
+    assert(!empty());
+    --lists->slots[id].size;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void AdjacencyList::clear()
+{
+    lists->slots[id].size = 0;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void AdjacencyList::reserve(const size_t n)
+{
+    AdjacencyLists::Slot & s = lists->slots[id];
+    if(n>s.cap) lists->grow(s, n);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void AdjacencyList::resize(const size_t n, const uint val)
+{
+    AdjacencyLists::Slot & s = lists->slots[id];
+    if(n>s.cap) lists->grow(s, n);
+    if(n>s.size) std::fill(s.ptr + s.size, s.ptr + n, val);
+    s.size = n;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint * AdjacencyList::insert(const uint * pos, const uint id)
+{
+    AdjacencyLists::Slot & s = lists->slots[this->id];
+    size_t i = pos - s.ptr;
+    assert(i<=s.size);
+    if(s.size==s.cap) lists->grow(s, std::max(4u, 2*s.cap));
+    std::copy_backward(s.ptr + i, s.ptr + s.size, s.ptr + s.size + 1);
+    s.ptr[i] = id;
+    ++s.size;
+    return s.ptr + i;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint * AdjacencyList::erase(const uint * pos)
+{
+    return erase(pos, pos+1);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint * AdjacencyList::erase(const uint * first, const uint * last)
+{
+    AdjacencyLists::Slot & s = lists->slots[id];
+    uint *b = s.ptr + (first - s.ptr);
+    uint *e = s.ptr + (last  - s.ptr);
+    assert(b>=s.ptr && b<=e && e<=s.ptr+s.size);
+    std::copy(e, s.ptr + s.size, b);
+    s.size -= e-b;
+    return b;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void AdjacencyList::swap(AdjacencyList l)
+{
+    if(lists==l.lists)
+    {
+        std::swap(lists->slots[id], lists->slots[l.id]);
+        return;
+    }
+    // slots belong to the storage that allocated them, hence contents are copied
+    std::vector<uint> tmp(begin(), end());
+    *this = IndexSpan(l.begin(), l.end());
+    l     = IndexSpan(tmp);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+AdjacencyLists::AdjacencyLists(const AdjacencyLists & l)
+{
+    // copies are compact
+    blocks.emplace_back(new uint[l.num_entries()]);
+    block_sizes.push_back(l.num_entries());
+    uint *ptr = blocks.back().get();
+    slots.resize(l.size());
+    for(size_t i=0; i<l.size(); ++i)
+    {
+        IndexSpan list = l[i];
+        std::copy(list.begin(), list.end(), ptr);
+        slots[i].ptr  = ptr;
+        slots[i].size = slots[i].cap = list.size();
+        ptr += list.size();
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+AdjacencyLists::AdjacencyLists(const std::vector<std::vector<uint>> & l)
+{
+    size_t n = 0;
+    for(const auto & list : l) n += list.size();
+    blocks.emplace_back(new uint[n]);
+    block_sizes.push_back(n);
+    uint *ptr = blocks.back().get();
+    slots.resize(l.size());
+    for(size_t i=0; i<l.size(); ++i)
+    {
+        std::copy(l[i].begin(), l[i].end(), ptr);
+        slots[i].ptr  = ptr;
+        slots[i].size = slots[i].cap = l[i].size();
+        ptr += l[i].size();
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+AdjacencyLists & AdjacencyLists::operator=(const AdjacencyLists & l)
+{
+    if(this == &l) return *this;
+    AdjacencyLists tmp(l);
+    swap(tmp);
+    return *this;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+IndexSpan AdjacencyLists::at(const size_t i) const
+{
+    if(i>=size()) throw std::out_of_range("AdjacencyLists::at");
+    return (*this)[i];
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+AdjacencyList AdjacencyLists::at(const size_t i)
+{
+    if(i>=size()) throw std::out_of_range("AdjacencyLists::at");
+    return (*this)[i];
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void AdjacencyLists::clear()
+{
+    slots.clear();
+    blocks.clear();
+    block_sizes.clear();
+    free_slots.clear();
+    tail      = nullptr;
+    tail_size = 0;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void AdjacencyLists::resize(const size_t n)
+{
+    for(size_t i=n; i<slots.size(); ++i) release(slots[i].ptr, slots[i].cap);
+    slots.resize(n);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void AdjacencyLists::push_back(const IndexSpan & l)
+{
+    // l may be a list of this storage: slots are never moved by alloc()
+    Slot s;
+    s.cap  = l.size();
+    s.ptr  = alloc(s.cap);
+    s.size = l.size();
+    std::copy(l.begin(), l.end(), s.ptr);
+    slots.push_back(s);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void AdjacencyLists::pop_back()
+{
+    assert(!empty());
+    release(slots.back().ptr, slots.back().cap);
+    slots.pop_back();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void AdjacencyLists::swap(AdjacencyLists & l)
+{
+    slots.swap(l.slots);
+    blocks.swap(l.blocks);
+    block_sizes.swap(l.block_sizes);
+    free_slots.swap(l.free_slots);
+    std::swap(tail,      l.tail);
+    std::swap(tail_size, l.tail_size);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void AdjacencyLists::assign(const size_t n, const uint64_t * offsets, const uint * items)
+{
+    clear();
+    size_t count = offsets[n] - offsets[0];
+    blocks.emplace_back(new uint[count]);
+    block_sizes.push_back(count);
+    uint *ptr = blocks.back().get();
+    if(count>0) memcpy(ptr, items + offsets[0], count*sizeof(uint));
+    slots.resize(n);
+    for(size_t i=0; i<n; ++i)
+    {
+        slots[i].ptr  = ptr + (offsets[i] - offsets[0]);
+        slots[i].size = slots[i].cap = offsets[i+1] - offsets[i];
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void AdjacencyLists::compact()
+{
+    size_t allocated = 0;
+    for(size_t n : block_sizes) allocated += n;
+    if(blocks.size()<=1 && allocated==num_entries()) return; // already compact
+    AdjacencyLists tmp(*this);
+    swap(tmp);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+size_t AdjacencyLists::num_entries() const
+{
+    size_t n = 0;
+    for(const Slot & s : slots) n += s.size;
+    return n;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+size_t AdjacencyLists::memory_usage_in_bytes() const
+{
+    size_t bytes = slots.capacity()*sizeof(Slot) + blocks.capacity()*sizeof(blocks[0]) + block_sizes.capacity()*sizeof(size_t);
+    for(size_t n : block_sizes) bytes += n*sizeof(uint);
+    for(const auto & l : free_slots) bytes += l.capacity()*sizeof(uint*);
+    return bytes;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint * AdjacencyLists::alloc(uint & cap)
+{
+    if(cap==0) return nullptr;
+
+    // recycle a released slot, if any
+    uint k = 0;
+    while((1u << k) < cap) ++k;
+    if(k<free_slots.size() && !free_slots[k].empty())
+    {
+        uint *ptr = free_slots[k].back();
+        free_slots[k].pop_back();
+        cap = 1u << k;
+        return ptr;
+    }
+
+    // big lists get their own block
+    if(cap>block_size)
+    {
+        blocks.emplace_back(new uint[cap]);
+        block_sizes.push_back(cap);
+        return blocks.back().get();
+    }
+
+    if(cap>tail_size)
+    {
+        release(tail, tail_size);
+        blocks.emplace_back(new uint[block_size]);
+        block_sizes.push_back(block_size);
+        tail      = blocks.back().get();
+        tail_size = block_size;
+    }
+    uint *ptr  = tail;
+    tail      += cap;
+    tail_size -= cap;
+    return ptr;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void AdjacencyLists::release(uint * ptr, const uint cap)
+{
+    if(cap==0) return;
+    uint k = 0;
+    while((2u << k) <= cap && k<31) ++k; // 2^k <= cap < 2^(k+1)
+    if(free_slots.size()<=k) free_slots.resize(k+1);
+    free_slots[k].push_back(ptr);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void AdjacencyLists::grow(Slot & s, const uint cap)
+{
+    assert(cap>s.cap);
+    uint  c   = cap;
+    uint *ptr = alloc(c);
+    std::copy(s.ptr, s.ptr + s.size, ptr);
+    release(s.ptr, s.cap);
+    s.ptr = ptr;
+    s.cap = c;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void REMOVE_FROM_VEC(AdjacencyList list, const uint elem)
+{
+    list.erase(std::remove(list.begin(), list.end(), elem), list.end());
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+size_t memory_usage_in_bytes(const AdjacencyLists & lists)
+{
+    return lists.memory_usage_in_bytes();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+size_t memory_usage_in_bytes(const std::vector<std::vector<uint>> & lists)
+{
+    // each list is a separate heap allocation. Bookkeeping is modeled after the
+    // glibc allocator: 8 bytes of header, 16 bytes alignment and 32 bytes minimum
+    size_t bytes = lists.capacity()*sizeof(std::vector<uint>);
+    for(const auto & l : lists)
+    {
+        if(l.capacity()==0) continue;
+        size_t n = l.capacity()*sizeof(uint) + 8;
+        bytes += std::max<size_t>(32, (n+15) & ~size_t(15));
+    }
+    return bytes;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void compact(AdjacencyLists & lists)
+{
+    lists.compact();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void compact(std::vector<std::vector<uint>> &)
+{}
+
+}
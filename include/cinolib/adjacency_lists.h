@@ -0,0 +1,283 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_ADJACENCY_LISTS_H
+#define CINO_ADJACENCY_LISTS_H
+
+#include <vector>
+#include <memory>
+#include <initializer_list>
+#include <stdint.h>
+#include <sys/types.h>
+#include <cinolib/cino_inline.h>
+
+namespace cinolib
+{
+
+/* Storage for the one-to-many relations of a mesh (e.g. vert to vert adjacency),
+ * alternative to std::vector<std::vector<uint>>. Lists are stored back to back in
+ * a few large blocks of memory (compressed row storage, CSR), hence there is no
+ * heap allocation per list, and visiting the lists of consecutive elements reads
+ * contiguous memory. Lists can still be edited: a list that outgrows its slot is
+ * moved to a bigger one, and released slots are recycled. compact() restores the
+ * tight CSR layout, and is called by the meshes at the end of init().
+ *
+ * The interface mimics std::vector<std::vector<uint>>, so that the same code works
+ * with both storages. Read access returns an IndexSpan (a read only view of a list),
+ * write access returns an AdjacencyList (a handle to the list, implementing a subset
+ * of the std::vector interface). As for std::vector, spans, pointers and iterators to
+ * a list are invalidated by operations that change the size of the list, and compact()
+ * invalidates them all. Different lists can be read and overwritten concurrently, but
+ * not resized concurrently.
+ *
+ * Meshes use this storage if CINOLIB_USES_CSR_ADJACENCY is defined (see MeshAdjacency)
+*/
+
+class IndexSpan
+{
+    public:
+
+        typedef uint         value_type;
+        typedef const uint * iterator;
+        typedef const uint * const_iterator;
+
+        IndexSpan() {}
+        IndexSpan(const uint * b, const uint * e) : b(b), e(e) {}
+        IndexSpan(const std::vector<uint> & l) : b(l.data()), e(l.data()+l.size()) {}
+
+        const uint * begin() const { return b;        }
+        const uint * end()   const { return e;        }
+        const uint * data()  const { return b;        }
+        size_t       size()  const { return e-b;      }
+        bool         empty() const { return e==b;     }
+        const uint & front() const { return *b;       }
+        const uint & back()  const { return *(e-1);   }
+
+        const uint & operator[](const size_t i) const { return b[i]; }
+        const uint & at        (const size_t i) const;
+
+        operator std::vector<uint>() const { return std::vector<uint>(b,e); }
+
+    protected:
+
+        const uint *b = nullptr, *e = nullptr;
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+class AdjacencyLists;
+
+class AdjacencyList
+{
+    public:
+
+        typedef uint         value_type;
+        typedef uint *       iterator;
+        typedef const uint * const_iterator;
+
+        AdjacencyList(AdjacencyLists & lists, const uint id) : lists(&lists), id(id) {}
+        AdjacencyList(const AdjacencyList & l) = default;
+
+        // assignments copy the content of the list, as for std::vector
+        AdjacencyList & operator=(const AdjacencyList & l)              { return *this = IndexSpan(l.begin(), l.end()); }
+        AdjacencyList & operator=(const std::vector<uint> & l)          { return *this = IndexSpan(l); }
+        AdjacencyList & operator=(const std::initializer_list<uint> & l) { return *this = IndexSpan(l.begin(), l.end()); }
+        AdjacencyList & operator=(const IndexSpan & l);
+
+        uint * begin() const;
+        uint * end()   const;
+        uint * data()  const { return begin();        }
+        size_t size()  const;
+        bool   empty() const { return size()==0;      }
+        uint & front() const { return *begin();       }
+        uint & back()  const { return *(end()-1);     }
+
+        uint & operator[](const size_t i) const { return begin()[i]; }
+        uint & at        (const size_t i) const;
+
+        void   push_back(const uint id);
+        void   pop_back();
+        void   clear();
+        void   reserve(const size_t n);
+        void   resize (const size_t n, const uint val = 0);
+        uint * insert (const uint * pos, const uint id);
+        uint * erase  (const uint * pos);
+        uint * erase  (const uint * first, const uint * last);
+        void   swap   (AdjacencyList l);
+
+        operator IndexSpan()         const { return IndexSpan(begin(), end()); }
+        operator std::vector<uint>() const { return std::vector<uint>(begin(), end()); }
+
+    protected:
+
+        AdjacencyLists *lists;
+        uint            id;
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+class AdjacencyLists
+{
+    public:
+
+        typedef IndexSpan     value_type;
+        typedef AdjacencyList reference;
+        typedef IndexSpan     const_reference;
+
+        class const_iterator
+        {
+            public:
+                const_iterator(const AdjacencyLists & l, const size_t i) : l(&l), i(i) {}
+                IndexSpan        operator* () const { return (*l)[i]; }
+                const_iterator & operator++()       { ++i; return *this; }
+                bool operator==(const const_iterator & it) const { return i==it.i; }
+                bool operator!=(const const_iterator & it) const { return i!=it.i; }
+            private:
+                const AdjacencyLists *l;
+                size_t                i;
+        };
+
+        AdjacencyLists() {}
+        AdjacencyLists(const AdjacencyLists & l);
+        AdjacencyLists(AdjacencyLists && l) { swap(l); }
+        AdjacencyLists(const std::vector<std::vector<uint>> & l);
+
+        AdjacencyLists & operator=(const AdjacencyLists & l);
+        AdjacencyLists & operator=(AdjacencyLists && l) { swap(l); return *this; }
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        size_t size()  const { return slots.size();  }
+        bool   empty() const { return slots.empty(); }
+
+        IndexSpan     operator[](const size_t i) const { return IndexSpan(slots[i].ptr, slots[i].ptr + slots[i].size); }
+        AdjacencyList operator[](const size_t i)       { return AdjacencyList(*this, i); }
+        IndexSpan     at        (const size_t i) const;
+        AdjacencyList at        (const size_t i);
+        IndexSpan     back()                     const { return (*this)[size()-1]; }
+        AdjacencyList back()                           { return (*this)[size()-1]; }
+
+        const_iterator begin() const { return const_iterator(*this, 0);      }
+        const_iterator end()   const { return const_iterator(*this, size()); }
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        void clear();
+        void reserve  (const size_t n) { slots.reserve(n); }
+        void resize   (const size_t n);
+        void push_back(const IndexSpan & l);
+        void push_back(const std::vector<uint> & l) { push_back(IndexSpan(l)); }
+        void pop_back();
+        void swap(AdjacencyLists & l);
+
+        // bulk initialization from CSR arrays: list i contains items[offsets[i]],...,items[offsets[i+1]-1]
+        void assign(const size_t n, const uint64_t * offsets, const uint * items);
+
+        // moves all lists in a single block, with no gaps between them
+        void compact();
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        size_t num_entries() const; // sum of the sizes of all lists
+        size_t memory_usage_in_bytes() const;
+
+    protected:
+
+        friend class AdjacencyList;
+
+        struct Slot
+        {
+            uint *ptr  = nullptr;
+            uint  size = 0;
+            uint  cap  = 0;
+        };
+
+        // returns a free slot with at least cap entries. The actual capacity is written in cap
+        uint * alloc(uint & cap);
+        void   release(uint * ptr, const uint cap);
+        void   grow(Slot & s, const uint cap); // moves s to a slot with at least cap entries
+
+        static const uint block_size = 1 << 16;
+
+        std::vector<Slot>                    slots;
+        std::vector<std::unique_ptr<uint[]>> blocks;
+        std::vector<size_t>                  block_sizes;
+        uint                                *tail      = nullptr; // free space at the end of the last block
+        size_t                               tail_size = 0;
+        std::vector<std::vector<uint*>>      free_slots;          // free_slots[k]: released slots with at least 2^k entries
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// overloads of the helpers in stl_container_utilities.h that modify a list
+CINO_INLINE
+void REMOVE_FROM_VEC(AdjacencyList list, const uint elem);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// memory (in bytes) allocated to store a relation, including the per allocation
+// bookkeeping of the heap for vectors of vectors. Useful to compare the two storages
+CINO_INLINE
+size_t memory_usage_in_bytes(const AdjacencyLists & lists);
+
+CINO_INLINE
+size_t memory_usage_in_bytes(const std::vector<std::vector<uint>> & lists);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void compact(AdjacencyLists & lists);
+
+CINO_INLINE
+void compact(std::vector<std::vector<uint>> & lists); // does nothing
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// storage used by the meshes for their adjacency relations. Accessors return
+// MeshAdjacency::reference (or const_reference), i.e. std::vector<uint> & in
+// the default configuration, AdjacencyList (or IndexSpan) with CSR storage
+#ifdef CINOLIB_USES_CSR_ADJACENCY
+typedef AdjacencyLists                 MeshAdjacency;
+#else
+typedef std::vector<std::vector<uint>> MeshAdjacency;
+#endif
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "adjacency_lists.cpp"
+#endif
+
+#endif // CINO_ADJACENCY_LISTS_H
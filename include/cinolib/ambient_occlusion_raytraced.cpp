@@ -0,0 +1,182 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/ambient_occlusion_raytraced.h>
+#include <cinolib/sphere_coverage.h>
+#include <cinolib/parallel_for.h>
+
+namespace cinolib
+{
+
+template<class SpatialIndex>
+CINO_INLINE
+void ambient_occlusion(const SpatialIndex             & occluders,
+                       const std::vector<vec3d>       & points,
+                       const std::vector<vec3d>       & normals,
+                       const double                     ray_offset,
+                       const double                     max_dist,
+                       const AOOptions                & opt,
+                             ScalarField              & ao)
+{
+    assert(points.size()==normals.size());
+    ao = ScalarField(points.size());
+
+    std::vector<vec3d> dirs;
+    sphere_coverage(opt.n_dirs, dirs);
+
+    // points are processed in blocks, each one generating at most batch_size rays
+    uint block = std::max(1u, opt.batch_size/std::max(1u,opt.n_dirs));
+
+    std::vector<uint>   offset;
+    std::vector<vec3d>  ray_p, ray_d;
+    std::vector<double> min_t;
+    std::vector<int>    ids;
+    for(uint beg=0; beg<points.size(); beg+=block)
+    {
+        uint end = std::min<uint>(beg+block, points.size());
+
+        // rays of point i are in [offset[i-beg], offset[i-beg+1])
+        offset.assign(1,0);
+        ray_p.clear();
+        ray_d.clear();
+        for(uint i=beg; i<end; ++i)
+        {
+            vec3d p = points.at(i) + normals.at(i)*ray_offset;
+            for(const vec3d & d : dirs)
+            {
+                if(d.dot(normals.at(i))<=0) continue;
+                ray_p.push_back(p);
+                ray_d.push_back(d);
+            }
+            offset.push_back(ray_p.size());
+        }
+
+        occluders.intersects_ray(ray_p, ray_d, min_t, ids);
+
+        PARALLEL_FOR(beg, end, 1000, [&](const uint i)
+        {
+            double sum = 0;
+            for(uint r=offset.at(i-beg); r<offset.at(i-beg+1); ++r)
+            {
+                if(ids.at(r)==-1 || min_t.at(r)>max_dist) sum += ray_d.at(r).dot(normals.at(i));
+            }
+            ao[i] = sum;
+        });
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// maps AO values in [0,1] (as ScalarField::normalize_in_01, but silently)
+CINO_INLINE
+void ambient_occlusion_normalize(ScalarField & ao)
+{
+    if(ao.size()==0) return;
+    double min = ao.minCoeff();
+    double max = ao.maxCoeff();
+    double delta = max - min;
+    for(uint i=0; i<ao.size(); ++i) ao[i] = (delta>0) ? (ao[i]-min)/delta : 1.0;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class SpatialIndex, class M, class V, class E, class P>
+CINO_INLINE
+void ambient_occlusion_srf(AbstractPolygonMesh<M,V,E,P> & m, const AOOptions & opt)
+{
+    std::vector<uint>  pids;
+    std::vector<vec3d> points, normals;
+    SpatialIndex occluders;
+    for(uint pid=0; pid<m.num_polys(); ++pid)
+    {
+        if(m.poly_data(pid).flags[HIDDEN]) continue;
+        pids.push_back(pid);
+        points.push_back(m.poly_centroid(pid));
+        normals.push_back(m.poly_data(pid).normal);
+        const std::vector<uint> & tris = m.poly_tessellation(pid);
+        for(uint i=0; i<tris.size(); i+=3)
+        {
+            occluders.push_triangle(pid, {m.vert(tris.at(i)), m.vert(tris.at(i+1)), m.vert(tris.at(i+2))});
+        }
+    }
+    if(pids.empty()) return;
+    occluders.build();
+
+    double diag = m.bbox().diag();
+    ScalarField ao;
+    ambient_occlusion(occluders, points, normals, 1e-4*diag, opt.max_dist*diag, opt, ao);
+    ambient_occlusion_normalize(ao);
+
+    for(uint pid=0; pid<m.num_polys(); ++pid) m.poly_data(pid).AO = 1.0;
+    for(uint i=0; i<pids.size(); ++i) m.poly_data(pids.at(i)).AO = ao[i];
+    m.mark_changed(CHANGES_POLY_DATA);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class SpatialIndex, class M, class V, class E, class F, class P>
+CINO_INLINE
+void ambient_occlusion_vol(AbstractPolyhedralMesh<M,V,E,F,P> & m, const AOOptions & opt)
+{
+    std::vector<uint>  fids;
+    std::vector<vec3d> points, normals;
+    SpatialIndex occluders;
+    for(uint fid=0; fid<m.num_faces(); ++fid)
+    {
+        uint pid_beneath;
+        if(!m.face_is_visible(fid, pid_beneath)) continue;
+        fids.push_back(fid);
+        points.push_back(m.face_centroid(fid));
+        normals.push_back(m.poly_face_normal(pid_beneath, fid));
+        std::vector<uint> tris = m.face_tessellation(fid);
+        for(uint i=0; i<tris.size(); i+=3)
+        {
+            occluders.push_triangle(fid, {m.vert(tris.at(i)), m.vert(tris.at(i+1)), m.vert(tris.at(i+2))});
+        }
+    }
+    if(fids.empty()) return;
+    occluders.build();
+
+    double diag = m.bbox().diag();
+    ScalarField ao;
+    ambient_occlusion(occluders, points, normals, 1e-4*diag, opt.max_dist*diag, opt, ao);
+    ambient_occlusion_normalize(ao);
+
+    for(uint fid=0; fid<m.num_faces(); ++fid) m.face_data(fid).AO = 1.0;
+    for(uint i=0; i<fids.size(); ++i) m.face_data(fids.at(i)).AO = ao[i];
+    m.mark_changed(CHANGES_FACE_DATA);
+}
+
+}
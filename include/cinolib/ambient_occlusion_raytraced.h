@@ -0,0 +1,101 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_AMBIENT_OCCLUSION_RAYTRACED_H
+#define CINO_AMBIENT_OCCLUSION_RAYTRACED_H
+
+#include <cinolib/meshes/abstract_polygonmesh.h>
+#include <cinolib/meshes/abstract_polyhedralmesh.h>
+#include <cinolib/scalar_field.h>
+#include <cinolib/bvh.h>
+#include <cinolib/octree.h>
+
+namespace cinolib
+{
+
+/* CPU counterpart of AO_srf and AO_vol (see ambient_occlusion.h), which does not need any
+ * OpenGL context and can therefore run headless. Rays are shot from the centroid of each
+ * visible surface element along a set of directions that evenly cover the unit sphere
+ * (see sphere_coverage.h). Each ray that escapes the mesh contributes to the AO value of
+ * the element with the dot between its direction and the element normal, exactly as each
+ * unoccluded view does in the OpenGL version. Values are then normalized in [0,1] and
+ * stored in the AO attribute of polygons (surfaces) or faces (volumes). Elements that
+ * are not visible (HIDDEN, or internal to a volume) get AO = 1.
+ *
+ * Occluders are stored in a spatial index (either a BVH or an Octree), and rays are
+ * traced in large parallel batches (see the batched intersects_ray of the two indices).
+*/
+
+typedef struct
+{
+    uint   n_dirs     = 256;     // rays per element (only the ones above the element plane are traced)
+    double max_dist   = 1.0;     // occluders farther than max_dist times the bbox diagonal are ignored
+    uint   batch_size = 1 << 18; // max number of rays traced at once (bounds memory usage)
+}
+AOOptions;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class SpatialIndex = BVH, class M, class V, class E, class P>
+CINO_INLINE
+void ambient_occlusion_srf(AbstractPolygonMesh<M,V,E,P> & m, const AOOptions & opt = AOOptions());
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class SpatialIndex = BVH, class M, class V, class E, class F, class P>
+CINO_INLINE
+void ambient_occlusion_vol(AbstractPolyhedralMesh<M,V,E,F,P> & m, const AOOptions & opt = AOOptions());
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// computes un-normalized AO values for a set of oriented points (e.g. element centroids
+// and normals), against the occluders stored in a spatial index. Points with null normal
+// get AO = 0
+template<class SpatialIndex>
+CINO_INLINE
+void ambient_occlusion(const SpatialIndex             & occluders,
+                       const std::vector<vec3d>       & points,
+                       const std::vector<vec3d>       & normals,
+                       const double                     ray_offset,
+                       const double                     max_dist,
+                       const AOOptions                & opt,
+                             ScalarField              & ao);
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "ambient_occlusion_raytraced.cpp"
+#endif
+
+#endif // CINO_AMBIENT_OCCLUSION_RAYTRACED_H
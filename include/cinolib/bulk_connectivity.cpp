@@ -0,0 +1,204 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/bulk_connectivity.h>
+#include <algorithm>
+#include <cassert>
+
+namespace cinolib
+{
+
+CINO_INLINE
+void radix_sort(std::vector<uint64_t> & keys,
+                std::vector<uint>     & vals)
+{
+    assert(keys.size()==vals.size());
+
+    uint64_t max_key = 0;
+    for(uint64_t k : keys) max_key = std::max(max_key, k);
+    uint n_bits = 0;
+    while(n_bits<64 && (max_key >> n_bits) > 0) ++n_bits;
+
+    const uint digit = 11;
+    const uint n_bkt = 1 << digit;
+    std::vector<uint64_t> tmp_keys(keys.size());
+    std::vector<uint>     tmp_vals(vals.size());
+    std::vector<size_t>   count(n_bkt);
+
+    for(uint shift=0; shift<n_bits; shift+=digit)
+    {
+        std::fill(count.begin(), count.end(), 0);
+        for(uint64_t k : keys) ++count[(k >> shift) & (n_bkt-1)];
+
+        size_t sum = 0;
+        for(size_t & c : count)
+        {
+            size_t tmp = c;
+            c   = sum;
+            sum += tmp;
+        }
+
+        for(size_t i=0; i<keys.size(); ++i)
+        {
+            size_t pos = count[(keys[i] >> shift) & (n_bkt-1)]++;
+            tmp_keys[pos] = keys[i];
+            tmp_vals[pos] = vals[i];
+        }
+        keys.swap(tmp_keys);
+        vals.swap(tmp_vals);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Lists>
+CINO_INLINE
+void unique_edges_from_polys(const std::vector<std::vector<uint>> & polys,
+                             const uint                             nv,
+                                   std::vector<uint>              & edges,
+                                   Lists                          & p2e)
+{
+    // serialize all edge occurrences, with a (min,max) vertex key
+    uint n_occ = 0;
+    for(const auto & p : polys) n_occ += p.size();
+
+    std::vector<uint64_t> keys;
+    std::vector<uint>     occ;
+    keys.reserve(n_occ);
+    occ.reserve(n_occ);
+    for(const auto & p : polys)
+    for(uint i=0; i<p.size(); ++i)
+    {
+        uint64_t v0 = p[i];
+        uint64_t v1 = p[(i+1)%p.size()];
+        if(v0>v1) std::swap(v0,v1);
+        keys.push_back(v0*nv + v1);
+        occ.push_back(occ.size());
+    }
+
+    // group identical keys. Sorting is stable, hence the first
+    // occurrence of each edge is the first element of its group
+    radix_sort(keys, occ);
+    std::vector<uint> occ_to_group(n_occ);
+    std::vector<uint> group_first;
+    for(uint i=0; i<n_occ; ++i)
+    {
+        if(i==0 || keys[i]!=keys[i-1]) group_first.push_back(occ[i]);
+        occ_to_group[occ[i]] = group_first.size()-1;
+    }
+    keys.clear();
+    keys.shrink_to_fit();
+    occ.clear();
+    occ.shrink_to_fit();
+
+    // assign edge ids in order of first appearance
+    std::vector<uint> group_to_eid(group_first.size());
+    edges.clear();
+    edges.reserve(2*group_first.size());
+    p2e.clear();
+    p2e.resize(polys.size());
+    uint o = 0;
+    for(uint pid=0; pid<polys.size(); ++pid)
+    {
+        const std::vector<uint> & p = polys[pid];
+        p2e[pid].resize(p.size());
+        for(uint i=0; i<p.size(); ++i, ++o)
+        {
+            uint g = occ_to_group[o];
+            if(group_first[g]==o)
+            {
+                group_to_eid[g] = edges.size()/2;
+                edges.push_back(p[i]);
+                edges.push_back(p[(i+1)%p.size()]);
+            }
+            p2e[pid][i] = group_to_eid[g];
+        }
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint duplicated_elements(const std::vector<std::vector<uint>> & elems,
+                               std::vector<uint>              & first_occurrence)
+{
+    // hash each element, then do exact comparisons only among elements with equal hash
+    std::vector<uint64_t> keys(elems.size());
+    std::vector<uint>     ids (elems.size());
+    std::vector<uint>     tmp;
+    for(uint i=0; i<elems.size(); ++i)
+    {
+        tmp = elems[i];
+        std::sort(tmp.begin(), tmp.end());
+        uint64_t h = tmp.size();
+        for(uint vid : tmp) h ^= vid + 0x9e3779b97f4a7c15ULL + (h<<6) + (h>>2);
+        keys[i] = h;
+        ids [i] = i;
+    }
+    radix_sort(keys, ids);
+
+    first_occurrence.resize(elems.size());
+    for(uint i=0; i<elems.size(); ++i) first_occurrence[i] = i;
+
+    uint count = 0;
+    std::vector<uint> a, b;
+    for(uint beg=0, end=0; beg<ids.size(); beg=end)
+    {
+        end = beg+1;
+        while(end<ids.size() && keys[end]==keys[beg]) ++end;
+        if(end-beg==1) continue;
+
+        for(uint i=beg+1; i<end; ++i)
+        {
+            a = elems[ids[i]];
+            std::sort(a.begin(), a.end());
+            for(uint j=beg; j<i; ++j)
+            {
+                if(first_occurrence[ids[j]]!=ids[j]) continue;
+                b = elems[ids[j]];
+                std::sort(b.begin(), b.end());
+                if(a==b)
+                {
+                    first_occurrence[ids[i]] = ids[j]; // ids are sorted within the group (stable sort)
+                    ++count;
+                    break;
+                }
+            }
+        }
+    }
+    return count;
+}
+
+}
@@ -0,0 +1,91 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_BULK_CONNECTIVITY_H
+#define CINO_BULK_CONNECTIVITY_H
+
+#include <vector>
+#include <stdint.h>
+#include <sys/types.h>
+#include <cinolib/cino_inline.h>
+
+namespace cinolib
+{
+
+/* Bulk routines to build mesh connectivity in a few linear passes, used by
+ * the init() methods of the mesh classes instead of the incremental poly_add,
+ * which would query (and scan) the adjacency of each element many times.
+ * All the routines are deterministic: element ids are assigned in order
+ * of first appearance, exactly as if elements were added one by one.
+*/
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// LSD radix sort of (key,val) pairs by key. The sort is stable, hence
+// values with the same key maintain their original relative order
+CINO_INLINE
+void radix_sort(std::vector<uint64_t> & keys,
+                std::vector<uint>     & vals);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// Extracts the unique edges of a collection of polygons (i.e. closed vertex loops).
+// edges are serialized (two vids per edge) and oriented as in the first polygon
+// containing them. p2e[pid][i] is the id of the edge (polys[pid][i],polys[pid][i+1]).
+// p2e is either a std::vector<std::vector<uint>> or an AdjacencyLists
+template<class Lists>
+CINO_INLINE
+void unique_edges_from_polys(const std::vector<std::vector<uint>> & polys,
+                             const uint                             nv,     // number of vertices
+                                   std::vector<uint>              & edges,
+                                   Lists                          & p2e);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// Detects duplicated elements (regardless of the order of their vertices).
+// For each element, first_occurrence[i] is the id of the first element in the
+// list having the same vertices (i.e. first_occurrence[i]==i for unique elements).
+// Returns the number of duplicates found
+CINO_INLINE
+uint duplicated_elements(const std::vector<std::vector<uint>> & elems,
+                               std::vector<uint>              & first_occurrence);
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "bulk_connectivity.cpp"
+#endif
+
+#endif // CINO_BULK_CONNECTIVITY_H
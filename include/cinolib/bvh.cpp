@@ -0,0 +1,1430 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/bvh.h>
+#include <cinolib/how_many_seconds.h>
+#include <cinolib/parallel_for.h>
+#include <numeric>
+#include <queue>
+#include <algorithm>
+#include <cstdint>
+
+namespace cinolib
+{
+
+// squared distance between a point and an axis aligned box
+static CINO_INLINE double box_dist_sqrd(const BVHNode & node, const vec3d & p)
+{
+    double d = 0.0;
+    for(int i=0; i<3; ++i)
+    {
+        if(p[i]<node.bmin[i]) d += (node.bmin[i]-p[i])*(node.bmin[i]-p[i]); else
+        if(p[i]>node.bmax[i]) d += (p[i]-node.bmax[i])*(p[i]-node.bmax[i]);
+    }
+    return d;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+static CINO_INLINE bool box_contains(const BVHNode & node, const vec3d & p)
+{
+    return p[0]>=node.bmin[0] && p[0]<=node.bmax[0] &&
+           p[1]>=node.bmin[1] && p[1]<=node.bmax[1] &&
+           p[2]>=node.bmin[2] && p[2]<=node.bmax[2];
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+static CINO_INLINE bool box_intersects_box(const double bmin[], const double bmax[], const AABB & b)
+{
+    return bmin[0]<=b.max[0] && bmax[0]>=b.min[0] &&
+           bmin[1]<=b.max[1] && bmax[1]>=b.min[1] &&
+           bmin[2]<=b.max[2] && bmax[2]>=b.min[2];
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// slab test between the ray R(t) := p + t * dir, with t in [0,t_max], and the node box.
+// If the ray hits, t_near is set to the entry point. Axes along which the ray is (almost)
+// parallel are handled as in AABB::intersects_ray
+static CINO_INLINE bool ray_hits_box(const BVHNode & node,
+                                     const vec3d   & p,
+                                     const vec3d   & dir,
+                                     const double    inv_dir[],
+                                     const double    t_max,
+                                           double  & t_near)
+{
+    double t0 = 0.0;
+    double t1 = t_max;
+    for(int i=0; i<3; ++i)
+    {
+        if(std::fabs(dir[i]) < 1e-15)
+        {
+            if(p[i]<node.bmin[i] || p[i]>node.bmax[i]) return false;
+        }
+        else
+        {
+            double ta = (node.bmin[i] - p[i]) * inv_dir[i];
+            double tb = (node.bmax[i] - p[i]) * inv_dir[i];
+            if(ta>tb) std::swap(ta,tb);
+            t0 = std::max(t0,ta);
+            t1 = std::min(t1,tb);
+            if(t0>t1) return false;
+        }
+    }
+    t_near = t0;
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// sorts a set of query points along a Morton curve spanning the box of the root. If
+// directions are given, rays are grouped by direction octant first, then by origin
+// and finally by direction
+static CINO_INLINE void morton_order(const BVHNode              & root,
+                                     const std::vector<vec3d>   & p,
+                                           std::vector<uint>    & order,
+                                     const std::vector<vec3d>   * dir = nullptr)
+{
+    // spreads the lowest 10 bits of x, leaving two zeros between each bit
+    auto spread = [](uint64_t x) -> uint64_t
+    {
+        x &= 0x3ff;
+        x = (x | (x << 16)) & 0x30000ff;
+        x = (x | (x <<  8)) & 0x300f00f;
+        x = (x | (x <<  4)) & 0x30c30c3;
+        x = (x | (x <<  2)) & 0x9249249;
+        return x;
+    };
+
+    // maps x from [min,max] to [0,1023]. Also catches NaNs
+    auto quantize = [](const double x, const double min, const double max) -> uint64_t
+    {
+        double y = (max>min) ? (x-min)/(max-min) : 0.0;
+        y = (y>0) ? std::min(y,1.0) : 0.0;
+        return uint64_t(y*1023.0);
+    };
+
+    std::vector<std::pair<uint64_t,uint>> codes(p.size());
+    PARALLEL_FOR(0, p.size(), 10000, [&](const uint i)
+    {
+        uint64_t c = 0;
+        for(int j=0; j<3; ++j)
+        {
+            c |= spread(quantize(p[i][j], root.bmin[j], root.bmax[j])) << j;
+        }
+        if(dir!=nullptr)
+        {
+            c <<= 30;
+            for(int j=0; j<3; ++j)
+            {
+                c |= spread(quantize(dir->at(i)[j], -1, 1)) << j;
+                if(dir->at(i)[j]<0) c |= uint64_t(1) << (60+j);
+            }
+        }
+        codes[i] = std::make_pair(c,i);
+    });
+
+    // ties are broken by index, so they keep the input order (which is often coherent already)
+    std::sort(codes.begin(), codes.end());
+    order.resize(p.size());
+    for(uint i=0; i<p.size(); ++i) order[i] = codes[i].second;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+static CINO_INLINE bool box_intersects_box(const double bmin0[], const double bmax0[],
+                                           const double bmin1[], const double bmax1[])
+{
+    return bmin0[0]<=bmax1[0] && bmax0[0]>=bmin1[0] &&
+           bmin0[1]<=bmax1[1] && bmax0[1]>=bmin1[1] &&
+           bmin0[2]<=bmax1[2] && bmax0[2]>=bmin1[2];
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// sum of the box sides (unlike the volume, it does not vanish for flat boxes)
+static CINO_INLINE double box_size(const BVHNode & node)
+{
+    return (node.bmax[0]-node.bmin[0]) + (node.bmax[1]-node.bmin[1]) + (node.bmax[2]-node.bmin[2]);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+BVH::BVH(const uint items_per_leaf)
+: items_per_leaf(std::max(items_per_leaf,uint(1)))
+{}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void BVH::push_item(const uint id, const ItemType type, const uint ref)
+{
+    item_ids.push_back(id);
+    item_types.push_back(type);
+    item_refs.push_back(ref);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void BVH::push_point(const uint id, const vec3d & v)
+{
+    push_item(id, POINT, points.size());
+    points.push_back(Point(id,v));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void BVH::push_sphere(const uint id, const vec3d & c, const double r)
+{
+    push_item(id, SPHERE, spheres.size());
+    spheres.push_back(Sphere(id,c,r));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void BVH::push_segment(const uint id, const std::vector<vec3d> & v)
+{
+    push_item(id, SEGMENT, segments.size());
+    segments.push_back(Segment(id,v.data()));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void BVH::push_triangle(const uint id, const std::vector<vec3d> & v)
+{
+    push_item(id, TRIANGLE, triangles.size());
+    triangles.push_back(Triangle(id,v.data()));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void BVH::push_tetrahedron(const uint id, const std::vector<vec3d> & v)
+{
+    push_item(id, TETRAHEDRON, tets.size());
+    tets.push_back(Tetrahedron(id,v.data()));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+const SpatialDataStructureItem & BVH::item(const uint i) const
+{
+    switch(item_types[i])
+    {
+        case POINT       : return points   [item_refs[i]];
+        case SPHERE      : return spheres  [item_refs[i]];
+        case SEGMENT     : return segments [item_refs[i]];
+        case TRIANGLE    : return triangles[item_refs[i]];
+        case TETRAHEDRON : return tets     [item_refs[i]];
+        default: assert(false && "Unknown item type");
+    }
+    return points.front(); // warning killer
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+vec3d BVH::item_closest_point(const uint i, const vec3d & p) const
+{
+    switch(item_types[i])
+    {
+        case POINT       : return points   [item_refs[i]].Point::point_closest_to(p);
+        case SPHERE      : return spheres  [item_refs[i]].Sphere::point_closest_to(p);
+        case SEGMENT     : return segments [item_refs[i]].Segment::point_closest_to(p);
+        case TRIANGLE    : return triangles[item_refs[i]].Triangle::point_closest_to(p);
+        case TETRAHEDRON : return tets     [item_refs[i]].Tetrahedron::point_closest_to(p);
+        default: assert(false && "Unknown item type");
+    }
+    return p; // warning killer
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool BVH::item_intersects_ray(const uint i, const vec3d & p, const vec3d & dir, double & t, vec3d & pos) const
+{
+    switch(item_types[i])
+    {
+        case POINT       : return points   [item_refs[i]].Point::intersects_ray(p,dir,t,pos);
+        case SPHERE      : return spheres  [item_refs[i]].Sphere::intersects_ray(p,dir,t,pos);
+        case SEGMENT     : return segments [item_refs[i]].Segment::intersects_ray(p,dir,t,pos);
+        case TRIANGLE    : return triangles[item_refs[i]].Triangle::intersects_ray(p,dir,t,pos);
+        case TETRAHEDRON : return tets     [item_refs[i]].Tetrahedron::intersects_ray(p,dir,t,pos);
+        default: assert(false && "Unknown item type");
+    }
+    return false; // warning killer
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void BVH::build()
+{
+    typedef std::chrono::high_resolution_clock Time;
+    Time::time_point t0 = Time::now();
+
+    nodes.clear();
+    tree_depth = 0;
+    if(item_ids.empty()) return;
+
+    uint n = num_items();
+
+    // item boxes and centroids
+    std::vector<double> centroids(3*n);
+    item_boxes.resize(6*n);
+    PARALLEL_FOR(0, n, 10000, [&](const uint i)
+    {
+        const AABB & b = item(i).aabb;
+        for(int j=0; j<3; ++j)
+        {
+            item_boxes[6*i+j  ] = b.min[j];
+            item_boxes[6*i+j+3] = b.max[j];
+            centroids [3*i+j  ] = 0.5*(b.min[j]+b.max[j]);
+        }
+    });
+
+    std::vector<uint> order(n);
+    std::iota(order.begin(), order.end(), 0);
+
+    // BUILD THE UPPER LEVELS OF THE TREE
+    // Nodes are split serially (breadth first) until there are enough
+    // subtrees to keep all threads busy. Each subtree is then built in
+    // parallel in its own node array, and appended to the global one
+    struct Task { uint nid, beg, end, depth; };
+    std::vector<Task> subtrees;
+    std::queue<Task>  q;
+    uint max_subtrees = (parallel_for_num_threads()>1) ? 4*parallel_for_num_threads() : 1;
+    nodes.reserve(2*n/items_per_leaf + 1);
+    nodes.push_back(BVHNode());
+    q.push({0, 0, n, 1});
+    while(!q.empty())
+    {
+        Task t = q.front();
+        q.pop();
+        if(t.end-t.beg < 4096 || q.size()+subtrees.size()+2 > max_subtrees)
+        {
+            subtrees.push_back(t);
+            continue;
+        }
+        uint mid = split(nodes[t.nid], t.beg, t.end, order, centroids);
+        tree_depth = std::max(tree_depth, t.depth);
+        if(mid==t.end) continue; // leaf
+        uint left = nodes.size();
+        nodes.push_back(BVHNode());
+        nodes.push_back(BVHNode());
+        nodes[t.nid].first = left;
+        nodes[t.nid].count = 0;
+        q.push({left,   t.beg, mid,   t.depth+1});
+        q.push({left+1, mid,   t.end, t.depth+1});
+    }
+
+    // BUILD THE SUBTREES IN PARALLEL
+    std::vector<std::vector<BVHNode>> local_nodes(subtrees.size());
+    std::vector<uint>                 local_depth(subtrees.size());
+    PARALLEL_FOR(0, subtrees.size(), 2, SCHEDULE_DYNAMIC, 1, [&](const uint i)
+    {
+        const Task & t = subtrees.at(i);
+        local_nodes.at(i).push_back(BVHNode());
+        local_depth.at(i) = t.depth - 1 + build_subtree(local_nodes.at(i), 0, t.beg, t.end, order, centroids);
+    });
+
+    // append subtrees to the global node array. The local root goes in place
+    // of the placeholder node, all other local nodes are shifted by base-1
+    for(uint i=0; i<subtrees.size(); ++i)
+    {
+        std::vector<BVHNode> & local = local_nodes.at(i);
+        uint base = nodes.size();
+        for(BVHNode & node : local)
+        {
+            if(!node.is_leaf()) node.first += base-1;
+        }
+        nodes.at(subtrees.at(i).nid) = local.front();
+        nodes.insert(nodes.end(), local.begin()+1, local.end());
+        tree_depth = std::max(tree_depth, local_depth.at(i));
+        std::vector<BVHNode>().swap(local);
+    }
+
+    // sort items in leaf order
+    std::vector<uint>     ids(n), refs(n);
+    std::vector<ItemType> types(n);
+    std::vector<double>   boxes(6*n);
+    for(uint i=0; i<n; ++i)
+    {
+        uint j   = order[i];
+        ids  [i] = item_ids  [j];
+        types[i] = item_types[j];
+        refs [i] = item_refs [j];
+        std::copy(item_boxes.begin()+6*j, item_boxes.begin()+6*j+6, boxes.begin()+6*i);
+    }
+    item_ids.swap(ids);
+    item_types.swap(types);
+    item_refs.swap(refs);
+    item_boxes.swap(boxes);
+
+    // cache triangle edges for the packet ray tests
+    item_tris.assign((triangles.empty()) ? 0 : 9*n, 0.0);
+    if(!triangles.empty())
+    {
+        PARALLEL_FOR(0, n, 10000, [&](const uint i)
+        {
+            if(item_types[i]!=TRIANGLE) return;
+            const Triangle & t = triangles[item_refs[i]];
+            vec3d e0 = t.v[1] - t.v[0];
+            vec3d e1 = t.v[2] - t.v[0];
+            for(int j=0; j<3; ++j)
+            {
+                item_tris[9*i+j  ] = t.v[0][j];
+                item_tris[9*i+j+3] = e0[j];
+                item_tris[9*i+j+6] = e1[j];
+            }
+        });
+    }
+
+    if(print_debug_info)
+    {
+        Time::time_point t1 = Time::now();
+        double t = how_many_seconds(t0,t1);
+        std::cout << ":::::::::::::::::::::::::::::::::::::::::::::::::::" << std::endl;
+        std::cout << "BVH created (" << t << "s)                         " << std::endl;
+        std::cout << "#Items                   : " << num_items()          << std::endl;
+        std::cout << "#Nodes                   : " << nodes.size()         << std::endl;
+        std::cout << "Depth                    : " << tree_depth           << std::endl;
+        std::cout << "Prescribed items per leaf: " << items_per_leaf       << std::endl;
+        std::cout << "Max items per leaf       : " << max_items_per_leaf() << std::endl;
+        std::cout << ":::::::::::::::::::::::::::::::::::::::::::::::::::" << std::endl;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint BVH::build_subtree(      std::vector<BVHNode> & nodes,
+                        const uint                   nid,
+                        const uint                   beg,
+                        const uint                   end,
+                              std::vector<uint>    & order,
+                        const std::vector<double>  & centroids) const
+{
+    // iterative rather than recursive, as unbalanced splits may produce deep trees
+    struct Task { uint nid, beg, end, depth; };
+    std::vector<Task> stack;
+    stack.push_back({nid, beg, end, 1});
+    uint depth = 0;
+    while(!stack.empty())
+    {
+        Task t = stack.back();
+        stack.pop_back();
+        depth = std::max(depth, t.depth);
+        uint mid = split(nodes[t.nid], t.beg, t.end, order, centroids);
+        if(mid==t.end) continue; // leaf
+        uint left = nodes.size();
+        nodes.push_back(BVHNode());
+        nodes.push_back(BVHNode());
+        nodes[t.nid].first = left;
+        nodes[t.nid].count = 0;
+        stack.push_back({left+1, mid,   t.end, t.depth+1});
+        stack.push_back({left,   t.beg, mid,   t.depth+1});
+    }
+    return depth;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint BVH::split(      BVHNode             & node,
+                const uint                  beg,
+                const uint                  end,
+                      std::vector<uint>   & order,
+                const std::vector<double> & centroids) const
+{
+    // node box and centroid bounds
+    double cmin[3] = { inf_double,  inf_double,  inf_double};
+    double cmax[3] = {-inf_double, -inf_double, -inf_double};
+    for(int j=0; j<3; ++j)
+    {
+        node.bmin[j] =  inf_double;
+        node.bmax[j] = -inf_double;
+    }
+    for(uint i=beg; i<end; ++i)
+    {
+        const double *b = &item_boxes[6*order[i]];
+        const double *c = &centroids [3*order[i]];
+        for(int j=0; j<3; ++j)
+        {
+            node.bmin[j] = std::min(node.bmin[j], b[j]);
+            node.bmax[j] = std::max(node.bmax[j], b[j+3]);
+            cmin[j]      = std::min(cmin[j], c[j]);
+            cmax[j]      = std::max(cmax[j], c[j]);
+        }
+    }
+
+    uint count = end-beg;
+    node.first = beg;
+    node.count = count;
+    if(count<=items_per_leaf) return end;
+
+    // nodes with (almost) flat boxes use the perimeter instead of the area
+    double d[3] = { node.bmax[0]-node.bmin[0], node.bmax[1]-node.bmin[1], node.bmax[2]-node.bmin[2] };
+    bool use_perimeter = (d[0]*d[1] + d[1]*d[2] + d[2]*d[0] <= 0);
+    auto cost_metric = [use_perimeter](const double bmin[], const double bmax[]) -> double
+    {
+        double dx = bmax[0]-bmin[0];
+        double dy = bmax[1]-bmin[1];
+        double dz = bmax[2]-bmin[2];
+        return (use_perimeter) ? dx+dy+dz : dx*dy + dy*dz + dz*dx;
+    };
+
+    // BINNED SAH
+    // the cost of a split is (A_left*N_left + A_right*N_right)/A + C_trav,
+    // the cost of a leaf is N (i.e. traversal and intersection are assumed to cost the same)
+    const uint   n_bins = 16;
+    const double C_trav = 1.0;
+    double best_cost = inf_double;
+    int    best_axis = -1;
+    uint   best_bin  = 0;
+    for(int axis=0; axis<3; ++axis)
+    {
+        double extent = cmax[axis]-cmin[axis];
+        if(extent<=0) continue;
+        double k = n_bins*(1.0-1e-6)/extent;
+
+        uint   bin_count[n_bins] = {};
+        double bin_min[n_bins][3], bin_max[n_bins][3];
+        for(uint b=0; b<n_bins; ++b)
+        for(int  j=0; j<3; ++j)
+        {
+            bin_min[b][j] =  inf_double;
+            bin_max[b][j] = -inf_double;
+        }
+        for(uint i=beg; i<end; ++i)
+        {
+            uint b = std::min(uint(k*(centroids[3*order[i]+axis]-cmin[axis])), n_bins-1);
+            const double *box = &item_boxes[6*order[i]];
+            ++bin_count[b];
+            for(int j=0; j<3; ++j)
+            {
+                bin_min[b][j] = std::min(bin_min[b][j], box[j]);
+                bin_max[b][j] = std::max(bin_max[b][j], box[j+3]);
+            }
+        }
+
+        // sweep from the right to accumulate the right side costs,
+        // then from the left to evaluate all the split positions
+        double right_cost[n_bins];
+        double acc_min[3] = { inf_double,  inf_double,  inf_double};
+        double acc_max[3] = {-inf_double, -inf_double, -inf_double};
+        uint   acc_count  = 0;
+        for(uint b=n_bins-1; b>0; --b)
+        {
+            acc_count += bin_count[b];
+            for(int j=0; j<3; ++j)
+            {
+                acc_min[j] = std::min(acc_min[j], bin_min[b][j]);
+                acc_max[j] = std::max(acc_max[j], bin_max[b][j]);
+            }
+            right_cost[b-1] = (acc_count>0) ? acc_count*cost_metric(acc_min,acc_max) : 0;
+        }
+        for(int j=0; j<3; ++j)
+        {
+            acc_min[j] =  inf_double;
+            acc_max[j] = -inf_double;
+        }
+        acc_count = 0;
+        for(uint b=0; b<n_bins-1; ++b)
+        {
+            acc_count += bin_count[b];
+            for(int j=0; j<3; ++j)
+            {
+                acc_min[j] = std::min(acc_min[j], bin_min[b][j]);
+                acc_max[j] = std::max(acc_max[j], bin_max[b][j]);
+            }
+            if(acc_count==0 || acc_count==count) continue;
+            double cost = acc_count*cost_metric(acc_min,acc_max) + right_cost[b];
+            if(cost<best_cost)
+            {
+                best_cost = cost;
+                best_axis = axis;
+                best_bin  = b;
+            }
+        }
+    }
+
+    // leaves cannot grow too big, even if the SAH says so
+    uint max_leaf_size = 4*items_per_leaf;
+    double node_metric = cost_metric(node.bmin, node.bmax);
+
+    if(best_axis>=0)
+    {
+        bool make_leaf = (node_metric>0) ? (C_trav + best_cost/node_metric >= count) : false;
+        if(make_leaf && count<=max_leaf_size) return end;
+
+        double k = n_bins*(1.0-1e-6)/(cmax[best_axis]-cmin[best_axis]);
+        auto it = std::partition(order.begin()+beg, order.begin()+end, [&](const uint i)
+        {
+            return std::min(uint(k*(centroids[3*i+best_axis]-cmin[best_axis])), n_bins-1) <= best_bin;
+        });
+        uint mid = it - order.begin();
+        if(mid>beg && mid<end)
+        {
+            node.count = 0;
+            return mid;
+        }
+    }
+
+    // all centroids coincide: split in the middle of the range
+    if(count<=max_leaf_size) return end;
+    node.count = 0;
+    return beg + count/2;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint BVH::max_items_per_leaf() const
+{
+    uint max=0;
+    for(const BVHNode & node : nodes) max = std::max(max,node.count);
+    return max;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void BVH::debug_mode(const bool b)
+{
+    print_debug_info = b;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+vec3d BVH::closest_point(const vec3d & p) const
+{
+    uint   id;
+    vec3d  pos;
+    double dist;
+    closest_point(p, id, pos, dist);
+    return pos;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void BVH::closest_point(const vec3d  & p,          // query point
+                              uint   & id,         // id of the item T closest to p
+                              vec3d  & pos,        // point in T closest to p
+                              double & dist) const // squared distance between pos and p
+{
+    assert(!nodes.empty());
+
+    typedef std::chrono::high_resolution_clock Time;
+    Time::time_point t0 = Time::now();
+
+    int item;
+    closest_item(p, -1, item, pos, dist);
+    id = item_ids[item];
+
+    if(print_debug_info)
+    {
+        Time::time_point t1 = Time::now();
+        std::cout << "Closest point\t" << how_many_seconds(t0,t1) << " seconds" << std::endl;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void BVH::closest_item(const vec3d  & p,
+                       const int      hint,
+                             int    & item,
+                             vec3d  & pos,
+                             double & dist) const
+{
+    // depth first, visiting the closest child first and pruning
+    // all nodes farther than the closest item found so far
+    dist = inf_double;
+    item = -1;
+    if(hint>=0)
+    {
+        pos  = item_closest_point(hint,p);
+        dist = pos.dist_sqrd(p);
+        item = hint;
+    }
+    std::vector<std::pair<double,uint>> stack;
+    stack.reserve(64);
+    stack.push_back(std::make_pair(box_dist_sqrd(nodes[0],p), 0));
+    while(!stack.empty())
+    {
+        double d   = stack.back().first;
+        uint   nid = stack.back().second;
+        stack.pop_back();
+        if(item>=0 && d>=dist) continue;
+
+        const BVHNode & node = nodes[nid];
+        if(node.is_leaf())
+        {
+            for(uint i=node.first; i<node.first+node.count; ++i)
+            {
+                vec3d  q  = item_closest_point(i,p);
+                double dq = q.dist_sqrd(p);
+                if(dq<dist || item<0)
+                {
+                    dist = dq;
+                    pos  = q;
+                    item = i;
+                }
+            }
+        }
+        else
+        {
+            double dl = box_dist_sqrd(nodes[node.first  ],p);
+            double dr = box_dist_sqrd(nodes[node.first+1],p);
+            if(dl<dr)
+            {
+                stack.push_back(std::make_pair(dr, node.first+1));
+                stack.push_back(std::make_pair(dl, node.first  ));
+            }
+            else
+            {
+                stack.push_back(std::make_pair(dl, node.first  ));
+                stack.push_back(std::make_pair(dr, node.first+1));
+            }
+        }
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void BVH::closest_point(const std::vector<vec3d>  & p,
+                              std::vector<uint>   & ids,
+                              std::vector<vec3d>  & pos,
+                              std::vector<double> & dist) const
+{
+    assert(!nodes.empty());
+
+    typedef std::chrono::high_resolution_clock Time;
+    Time::time_point t0 = Time::now();
+
+    ids.resize(p.size());
+    pos.resize(p.size());
+    dist.resize(p.size());
+
+    std::vector<uint> order;
+    morton_order(nodes[0], p, order);
+
+    // blocks of consecutive queries (in Morton order) are processed by the same thread,
+    // and each query uses the item found by the previous one as an upper bound
+    const uint block = 64;
+    uint n_blocks = (p.size()+block-1)/block;
+    PARALLEL_FOR(0, n_blocks, 2, SCHEDULE_DYNAMIC, 4, [&](const uint b)
+    {
+        int item = -1;
+        for(uint i=b*block; i<std::min(uint(p.size()),(b+1)*block); ++i)
+        {
+            uint q = order[i];
+            closest_item(p[q], item, item, pos[q], dist[q]);
+            ids[q] = item_ids[item];
+        }
+    });
+
+    if(print_debug_info)
+    {
+        Time::time_point t1 = Time::now();
+        std::cout << "Closest point (" << p.size() << " queries)\t" << how_many_seconds(t0,t1) << " seconds" << std::endl;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// this query becomes exact if CINOLIB_USES_EXACT_PREDICATES is defined
+CINO_INLINE
+bool BVH::contains(const vec3d & p, const bool strict, uint & id) const
+{
+    typedef std::chrono::high_resolution_clock Time;
+    Time::time_point t0 = Time::now();
+
+    std::vector<uint> stack;
+    if(!nodes.empty() && box_contains(nodes[0],p)) stack.push_back(0);
+    while(!stack.empty())
+    {
+        const BVHNode & node = nodes[stack.back()];
+        stack.pop_back();
+
+        if(node.is_leaf())
+        {
+            for(uint i=node.first; i<node.first+node.count; ++i)
+            {
+                if(item(i).contains(p,strict))
+                {
+                    id = item_ids[i];
+                    if(print_debug_info)
+                    {
+                        Time::time_point t1 = Time::now();
+                        std::cout << "Contains query (first item)\t" << how_many_seconds(t0,t1) << " seconds" << std::endl;
+                    }
+                    return true;
+                }
+            }
+        }
+        else
+        {
+            if(box_contains(nodes[node.first  ],p)) stack.push_back(node.first  );
+            if(box_contains(nodes[node.first+1],p)) stack.push_back(node.first+1);
+        }
+    }
+    return false;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// this query becomes exact if CINOLIB_USES_EXACT_PREDICATES is defined
+CINO_INLINE
+bool BVH::contains(const vec3d & p, const bool strict, std::unordered_set<uint> & ids) const
+{
+    typedef std::chrono::high_resolution_clock Time;
+    Time::time_point t0 = Time::now();
+
+    ids.clear();
+
+    std::vector<uint> stack;
+    if(!nodes.empty() && box_contains(nodes[0],p)) stack.push_back(0);
+    while(!stack.empty())
+    {
+        const BVHNode & node = nodes[stack.back()];
+        stack.pop_back();
+
+        if(node.is_leaf())
+        {
+            for(uint i=node.first; i<node.first+node.count; ++i)
+            {
+                if(item(i).contains(p,strict)) ids.insert(item_ids[i]);
+            }
+        }
+        else
+        {
+            if(box_contains(nodes[node.first  ],p)) stack.push_back(node.first  );
+            if(box_contains(nodes[node.first+1],p)) stack.push_back(node.first+1);
+        }
+    }
+
+    if(print_debug_info)
+    {
+        Time::time_point t1 = Time::now();
+        std::cout << "Contains query (all items)\t" << how_many_seconds(t0,t1) << " seconds" << std::endl;
+    }
+
+    return !ids.empty();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool BVH::intersects_ray(const vec3d & p, const vec3d & dir, double & min_t, uint & id) const
+{
+    typedef std::chrono::high_resolution_clock Time;
+    Time::time_point t0 = Time::now();
+
+    if(nodes.empty()) return false;
+
+    double t;
+    int    item;
+    first_hit(p, dir, t, item);
+
+    if(print_debug_info)
+    {
+        Time::time_point t1 = Time::now();
+        std::cout << "Intersects ray\t" << how_many_seconds(t0,t1) << " seconds" << std::endl;
+    }
+
+    if(item<0) return false;
+    min_t = t;
+    id    = item_ids[item];
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void BVH::first_hit(const vec3d  & p,
+                    const vec3d  & dir,
+                          double & min_t,
+                          int    & item) const
+{
+    double inv_dir[3] = { 1.0/dir[0], 1.0/dir[1], 1.0/dir[2] };
+    double t;
+    vec3d  pos;
+    min_t = inf_double;
+    item  = -1;
+
+    // depth first, visiting the closest child first and pruning
+    // all nodes that the ray enters after the closest hit found so far
+    std::vector<std::pair<double,uint>> stack;
+    stack.reserve(64);
+    if(ray_hits_box(nodes[0], p, dir, inv_dir, min_t, t)) stack.push_back(std::make_pair(t,0));
+    while(!stack.empty())
+    {
+        double t_node = stack.back().first;
+        uint   nid    = stack.back().second;
+        stack.pop_back();
+        if(t_node>min_t) continue;
+
+        const BVHNode & node = nodes[nid];
+        if(node.is_leaf())
+        {
+            for(uint i=node.first; i<node.first+node.count; ++i)
+            {
+                if(item_intersects_ray(i, p, dir, t, pos) && t>=0 && t<min_t)
+                {
+                    min_t = t;
+                    item  = i;
+                }
+            }
+        }
+        else
+        {
+            double tl, tr;
+            bool hl = ray_hits_box(nodes[node.first  ], p, dir, inv_dir, min_t, tl);
+            bool hr = ray_hits_box(nodes[node.first+1], p, dir, inv_dir, min_t, tr);
+            if(hl && hr)
+            {
+                if(tl<tr)
+                {
+                    stack.push_back(std::make_pair(tr, node.first+1));
+                    stack.push_back(std::make_pair(tl, node.first  ));
+                }
+                else
+                {
+                    stack.push_back(std::make_pair(tl, node.first  ));
+                    stack.push_back(std::make_pair(tr, node.first+1));
+                }
+            }
+            else if(hl) stack.push_back(std::make_pair(tl, node.first  ));
+            else if(hr) stack.push_back(std::make_pair(tr, node.first+1));
+        }
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool BVH::intersects_ray(const vec3d & p, const vec3d & dir, std::set<std::pair<double,uint>> & all_hits) const
+{
+    typedef std::chrono::high_resolution_clock Time;
+    Time::time_point t0 = Time::now();
+
+    if(nodes.empty()) return false;
+
+    double inv_dir[3] = { 1.0/dir[0], 1.0/dir[1], 1.0/dir[2] };
+    double t;
+    vec3d  pos;
+
+    std::vector<uint> stack;
+    if(ray_hits_box(nodes[0], p, dir, inv_dir, inf_double, t)) stack.push_back(0);
+    while(!stack.empty())
+    {
+        const BVHNode & node = nodes[stack.back()];
+        stack.pop_back();
+
+        if(node.is_leaf())
+        {
+            for(uint i=node.first; i<node.first+node.count; ++i)
+            {
+                if(item_intersects_ray(i, p, dir, t, pos) && t>=0)
+                {
+                    all_hits.insert(std::make_pair(t,item_ids[i]));
+                }
+            }
+        }
+        else
+        {
+            if(ray_hits_box(nodes[node.first  ], p, dir, inv_dir, inf_double, t)) stack.push_back(node.first  );
+            if(ray_hits_box(nodes[node.first+1], p, dir, inv_dir, inf_double, t)) stack.push_back(node.first+1);
+        }
+    }
+
+    if(print_debug_info)
+    {
+        Time::time_point t1 = Time::now();
+        std::cout << "Intersects ray\t" << how_many_seconds(t0,t1) << " seconds" << std::endl;
+    }
+
+    return !all_hits.empty();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void BVH::intersects_ray(const std::vector<vec3d>  & p,
+                         const std::vector<vec3d>  & dir,
+                               std::vector<double> & min_t,
+                               std::vector<int>    & ids) const
+{
+    assert(p.size()==dir.size());
+
+    typedef std::chrono::high_resolution_clock Time;
+    Time::time_point t0 = Time::now();
+
+    min_t.assign(p.size(), inf_double);
+    ids.assign(p.size(), -1);
+    if(nodes.empty()) return;
+
+    // sort rays by direction octant first, and then by origin
+    std::vector<uint> order;
+    morton_order(nodes[0], p, order, &dir);
+
+    uint n_packets = (p.size()+packet_size-1)/packet_size;
+    PARALLEL_FOR(0, n_packets, 2, SCHEDULE_DYNAMIC, 16, [&](const uint i)
+    {
+        vec3d  pp[packet_size], pd[packet_size];
+        double pt[packet_size];
+        int    pi[packet_size];
+        uint   n = 0;
+        for(uint j=i*packet_size; j<std::min(uint(p.size()),(i+1)*packet_size); ++j, ++n)
+        {
+            pp[n] = p  [order[j]];
+            pd[n] = dir[order[j]];
+        }
+        // packets pay off only if their rays travel through the same nodes.
+        // Incoherent packets are traced one ray at a time
+        bool coherent = true;
+        for(uint j=1; j<n; ++j)
+        {
+            double dot = pd[0].dot(pd[j]);
+            coherent = coherent && dot>0 && dot*dot >= 0.81*pd[0].norm_sqrd()*pd[j].norm_sqrd();
+        }
+        if(coherent) intersects_ray_packet(pp, pd, n, pt, pi);
+        else for(uint j=0; j<n; ++j) first_hit(pp[j], pd[j], pt[j], pi[j]);
+        for(uint j=0; j<n; ++j)
+        {
+            uint q = order[i*packet_size+j];
+            if(pi[j]>=0)
+            {
+                min_t[q] = pt[j];
+                ids  [q] = item_ids[pi[j]];
+            }
+        }
+    });
+
+    if(print_debug_info)
+    {
+        Time::time_point t1 = Time::now();
+        std::cout << "Intersects ray (" << p.size() << " queries)\t" << how_many_seconds(t0,t1) << " seconds" << std::endl;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// Packet traversal: each node is tested against all the rays in the packet, and it is
+// visited if at least one of them hits it. Lanes are stored as structs of arrays, and
+// the per-lane loops are written branch free, so that the compiler can vectorize them
+CINO_INLINE
+void BVH::intersects_ray_packet(const vec3d  p[],
+                                const vec3d  dir[],
+                                const uint   n,
+                                      double min_t[],
+                                      int    items[]) const
+{
+    assert(n<=packet_size);
+
+    // lanes past n replicate the first ray, and are always masked out
+    double o[3][packet_size], d[3][packet_size], inv[3][packet_size], t_max[packet_size];
+    int    hit_items[packet_size];
+    for(uint l=0; l<packet_size; ++l)
+    {
+        uint r = (l<n) ? l : 0;
+        for(int j=0; j<3; ++j)
+        {
+            o  [j][l] = p[r][j];
+            d  [j][l] = dir[r][j];
+            inv[j][l] = 1.0/dir[r][j];
+        }
+        t_max    [l] = inf_double;
+        hit_items[l] = -1;
+    }
+
+    // slab test for all lanes at once. Returns the mask of the active lanes hitting the box.
+    // Unlike ray_hits_box axis parallel rays are not special cased: 1/0 gives infinite slabs,
+    // and the NaNs arising for origins lying exactly on a slab are ignored by the comparisons,
+    // making the test conservative
+    auto packet_hits_box = [&](const BVHNode & node, const uint mask) -> uint
+    {
+        bool hit[packet_size];
+        for(uint l=0; l<packet_size; ++l)
+        {
+            double t0 = 0.0;
+            double t1 = t_max[l];
+            for(int j=0; j<3; ++j)
+            {
+                double ta = (node.bmin[j] - o[j][l]) * inv[j][l];
+                double tb = (node.bmax[j] - o[j][l]) * inv[j][l];
+                double lo = (ta<tb) ? ta : tb;
+                double hi = (ta<tb) ? tb : ta;
+                t0 = (lo>t0) ? lo : t0;
+                t1 = (hi<t1) ? hi : t1;
+            }
+            hit[l] = t0<=t1;
+        }
+        uint hits = 0;
+        for(uint l=0; l<packet_size; ++l) hits |= uint(hit[l]) << l;
+        return hits & mask;
+    };
+
+    // Moller-Trumbore (see Moller_Trumbore_intersection.cpp) for one triangle and all active lanes
+    auto packet_hits_triangle = [&](const uint i, const uint mask)
+    {
+        const double *v0 = &item_tris[9*i  ];
+        const double *e0 = &item_tris[9*i+3];
+        const double *e1 = &item_tris[9*i+6];
+        for(uint l=0; l<packet_size; ++l)
+        {
+            double pvec[3] = { d[1][l]*e1[2] - d[2][l]*e1[1],
+                               d[2][l]*e1[0] - d[0][l]*e1[2],
+                               d[0][l]*e1[1] - d[1][l]*e1[0] };
+            double det     = e0[0]*pvec[0] + e0[1]*pvec[1] + e0[2]*pvec[2];
+            double inv_det = 1.0/det;
+            double tvec[3] = { o[0][l]-v0[0], o[1][l]-v0[1], o[2][l]-v0[2] };
+            double b1      = (tvec[0]*pvec[0] + tvec[1]*pvec[1] + tvec[2]*pvec[2]) * inv_det;
+            double qvec[3] = { tvec[1]*e0[2] - tvec[2]*e0[1],
+                               tvec[2]*e0[0] - tvec[0]*e0[2],
+                               tvec[0]*e0[1] - tvec[1]*e0[0] };
+            double b2      = (d[0][l]*qvec[0] + d[1][l]*qvec[1] + d[2][l]*qvec[2]) * inv_det;
+            double b0      = b2 + b1;
+            double t       = (e1[0]*qvec[0] + e1[1]*qvec[1] + e1[2]*qvec[2]) * inv_det;
+            bool   hit     = ((mask >> l) & 1) && std::fabs(det)>=0.0000001 &&
+                             b1>=0.0 && b1<=1.0 && b2>=0.0 && b0<=1.0 && t>=0 && t<t_max[l];
+            t_max    [l] = (hit) ? t      : t_max[l];
+            hit_items[l] = (hit) ? int(i) : hit_items[l];
+        }
+    };
+
+    // each node is pushed together with the mask of the lanes that hit its parent
+    std::vector<std::pair<uint,uint>> stack;
+    stack.reserve(64);
+    stack.push_back(std::make_pair(0, (1u << n) - 1));
+    while(!stack.empty())
+    {
+        const BVHNode & node = nodes[stack.back().first];
+        uint            mask = packet_hits_box(node, stack.back().second);
+        stack.pop_back();
+        if(mask==0) continue;
+
+        if(node.is_leaf())
+        {
+            for(uint i=node.first; i<node.first+node.count; ++i)
+            {
+                if(item_types[i]==TRIANGLE) packet_hits_triangle(i, mask);
+                else
+                {
+                    for(uint l=0; l<n; ++l)
+                    {
+                        double t;
+                        vec3d  pos;
+                        if(((mask >> l) & 1) && item_intersects_ray(i, p[l], dir[l], t, pos) && t>=0 && t<t_max[l])
+                        {
+                            t_max    [l] = t;
+                            hit_items[l] = i;
+                        }
+                    }
+                }
+            }
+        }
+        else
+        {
+            // visit first the child that comes first along the direction of the first active ray
+            uint l = 0;
+            while(((mask >> l) & 1) == 0) ++l;
+            const BVHNode & c0 = nodes[node.first  ];
+            const BVHNode & c1 = nodes[node.first+1];
+            double dot = 0.0;
+            for(int j=0; j<3; ++j) dot += (c0.bmin[j]+c0.bmax[j]-c1.bmin[j]-c1.bmax[j]) * d[j][l];
+            if(dot>0)
+            {
+                stack.push_back(std::make_pair(node.first,   mask));
+                stack.push_back(std::make_pair(node.first+1, mask));
+            }
+            else
+            {
+                stack.push_back(std::make_pair(node.first+1, mask));
+                stack.push_back(std::make_pair(node.first,   mask));
+            }
+        }
+    }
+
+    for(uint l=0; l<n; ++l)
+    {
+        min_t[l] = t_max[l];
+        items[l] = hit_items[l];
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// this query becomes exact if CINOLIB_USES_EXACT_PREDICATES is defined
+CINO_INLINE
+bool BVH::intersects_triangle(const vec3d t[], const bool ignore_if_valid_complex, std::unordered_set<uint> & ids) const
+{
+    typedef std::chrono::high_resolution_clock Time;
+    Time::time_point t0 = Time::now();
+
+    std::vector<uint> candidates;
+    std::vector<vec3d> list = {t[0],t[1],t[2]};
+    items_in_box(AABB(list), candidates);
+
+    ids.clear();
+    for(uint i : candidates)
+    {
+        if(item(i).intersects_triangle(t, ignore_if_valid_complex))
+        {
+            ids.insert(item_ids[i]);
+        }
+    }
+
+    if(print_debug_info)
+    {
+        Time::time_point t1 = Time::now();
+        std::cout << "Intersects triangle\t" << how_many_seconds(t0,t1) << " seconds" << std::endl;
+    }
+
+    return !ids.empty();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// this query becomes exact if CINOLIB_USES_EXACT_PREDICATES is defined
+CINO_INLINE
+bool BVH::intersects_segment(const vec3d s[], const bool ignore_if_valid_complex, std::unordered_set<uint> & ids) const
+{
+    typedef std::chrono::high_resolution_clock Time;
+    Time::time_point t0 = Time::now();
+
+    std::vector<uint> candidates;
+    std::vector<vec3d> list = {s[0],s[1]};
+    items_in_box(AABB(list), candidates);
+
+    ids.clear();
+    for(uint i : candidates)
+    {
+        if(item(i).intersects_segment(s, ignore_if_valid_complex))
+        {
+            ids.insert(item_ids[i]);
+        }
+    }
+
+    if(print_debug_info)
+    {
+        Time::time_point t1 = Time::now();
+        std::cout << "Intersects segment\t" << how_many_seconds(t0,t1) << " seconds" << std::endl;
+    }
+
+    return !ids.empty();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// this query DOES NOT BECOME exact if CINOLIB_USES_EXACT_PREDICATES is defined
+CINO_INLINE
+bool BVH::intersects_box(const AABB & b, std::unordered_set<uint> & ids) const
+{
+    typedef std::chrono::high_resolution_clock Time;
+    Time::time_point t0 = Time::now();
+
+    std::vector<uint> candidates;
+    items_in_box(b, candidates);
+
+    ids.clear();
+    for(uint i : candidates) ids.insert(item_ids[i]);
+
+    if(print_debug_info)
+    {
+        Time::time_point t1 = Time::now();
+        std::cout << "Intersects box\t" << how_many_seconds(t0,t1) << " seconds" << std::endl;
+    }
+
+    return !ids.empty();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// the self overlap of a node is the union of the self overlaps of its children plus their
+// mutual overlap. Tasks are refined breadth first until there are enough of them to keep
+// all threads busy. Pairs of nodes whose boxes do not overlap are discarded right away
+CINO_INLINE
+void BVH::self_overlap_tasks(std::vector<ipair> & tasks) const
+{
+    tasks.clear();
+    if(nodes.empty()) return;
+
+    uint max_tasks = 32*parallel_for_num_threads();
+    std::queue<ipair> q;
+    q.push(ipair(0,0));
+    while(!q.empty() && q.size()+tasks.size()<max_tasks)
+    {
+        ipair t = q.front();
+        q.pop();
+        const BVHNode & a = nodes[t.first];
+        const BVHNode & b = nodes[t.second];
+        if(t.first==t.second)
+        {
+            if(a.is_leaf()) { tasks.push_back(t); continue; }
+            uint l = a.first;
+            uint r = a.first+1;
+            q.push(ipair(l,l));
+            q.push(ipair(r,r));
+            if(box_intersects_box(nodes[l].bmin, nodes[l].bmax, nodes[r].bmin, nodes[r].bmax)) q.push(ipair(l,r));
+        }
+        else if(a.is_leaf() && b.is_leaf())
+        {
+            tasks.push_back(t);
+        }
+        else
+        {
+            // descend the larger node
+            bool split_a = b.is_leaf() || (!a.is_leaf() && box_size(a)>=box_size(b));
+            uint n = split_a ? t.first : t.second;
+            uint o = split_a ? t.second : t.first;
+            for(uint c=nodes[n].first; c<nodes[n].first+2; ++c)
+            {
+                if(box_intersects_box(nodes[c].bmin, nodes[c].bmax, nodes[o].bmin, nodes[o].bmax)) q.push(ipair(c,o));
+            }
+        }
+    }
+    while(!q.empty())
+    {
+        tasks.push_back(q.front());
+        q.pop();
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Func>
+CINO_INLINE
+bool BVH::self_overlap(const ipair & task, const Func & func) const
+{
+    std::vector<ipair> stack;
+    stack.push_back(task);
+    while(!stack.empty())
+    {
+        ipair t = stack.back();
+        stack.pop_back();
+        const BVHNode & a = nodes[t.first];
+        const BVHNode & b = nodes[t.second];
+
+        if(t.first==t.second)
+        {
+            if(a.is_leaf())
+            {
+                for(uint i=a.first;   i<a.first+a.count; ++i)
+                for(uint j=i+1;       j<a.first+a.count; ++j)
+                {
+                    if(box_intersects_box(&item_boxes[6*i], &item_boxes[6*i+3], &item_boxes[6*j], &item_boxes[6*j+3]) &&
+                       !func(item_ids[i], item_ids[j])) return false;
+                }
+            }
+            else
+            {
+                uint l = a.first;
+                uint r = a.first+1;
+                stack.push_back(ipair(l,l));
+                stack.push_back(ipair(r,r));
+                if(box_intersects_box(nodes[l].bmin, nodes[l].bmax, nodes[r].bmin, nodes[r].bmax)) stack.push_back(ipair(l,r));
+            }
+        }
+        else if(a.is_leaf() && b.is_leaf())
+        {
+            for(uint i=a.first; i<a.first+a.count; ++i)
+            {
+                if(!box_intersects_box(&item_boxes[6*i], &item_boxes[6*i+3], b.bmin, b.bmax)) continue;
+                for(uint j=b.first; j<b.first+b.count; ++j)
+                {
+                    if(box_intersects_box(&item_boxes[6*i], &item_boxes[6*i+3], &item_boxes[6*j], &item_boxes[6*j+3]) &&
+                       !func(item_ids[i], item_ids[j])) return false;
+                }
+            }
+        }
+        else
+        {
+            bool split_a = b.is_leaf() || (!a.is_leaf() && box_size(a)>=box_size(b));
+            uint n = split_a ? t.first : t.second;
+            uint o = split_a ? t.second : t.first;
+            for(uint c=nodes[n].first; c<nodes[n].first+2; ++c)
+            {
+                if(box_intersects_box(nodes[c].bmin, nodes[c].bmax, nodes[o].bmin, nodes[o].bmax)) stack.push_back(ipair(c,o));
+            }
+        }
+    }
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// collects the (positions of the) items whose AABB intersects box b
+CINO_INLINE
+void BVH::items_in_box(const AABB & b, std::vector<uint> & items) const
+{
+    items.clear();
+    std::vector<uint> stack;
+    if(!nodes.empty() && box_intersects_box(nodes[0].bmin, nodes[0].bmax, b)) stack.push_back(0);
+    while(!stack.empty())
+    {
+        const BVHNode & node = nodes[stack.back()];
+        stack.pop_back();
+
+        if(node.is_leaf())
+        {
+            for(uint i=node.first; i<node.first+node.count; ++i)
+            {
+                if(box_intersects_box(&item_boxes[6*i], &item_boxes[6*i+3], b)) items.push_back(i);
+            }
+        }
+        else
+        {
+            for(uint c=node.first; c<node.first+2; ++c)
+            {
+                if(box_intersects_box(nodes[c].bmin, nodes[c].bmax, b)) stack.push_back(c);
+            }
+        }
+    }
+}
+
+}
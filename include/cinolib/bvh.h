@@ -0,0 +1,294 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_BVH_H
+#define CINO_BVH_H
+
+#include <cinolib/geometry/point.h>
+#include <cinolib/geometry/sphere.h>
+#include <cinolib/geometry/segment.h>
+#include <cinolib/geometry/triangle.h>
+#include <cinolib/geometry/tetrahedron.h>
+#include <cinolib/meshes/meshes.h>
+#include <cinolib/ipair.h>
+#include <unordered_set>
+#include <set>
+
+namespace cinolib
+{
+
+/* Node of a BVH. Nodes live in a flat array. The two children of an inner
+ * node are always stored next to each other, so that a node only needs to
+ * know where its first child is
+*/
+struct BVHNode
+{
+    double bmin[3];
+    double bmax[3];
+    uint   first; // index of the first item (leaves) or of the left child (inner nodes)
+    uint   count; // number of items (zero for inner nodes)
+
+    bool is_leaf() const { return count>0; }
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* Bounding Volume Hierarchy, built with the binned Surface Area Heuristic:
+ *
+ *   On fast Construction of SAH-based Bounding Volume Hierarchies
+ *   Ingo Wald
+ *   IEEE Symposium on Interactive Ray Tracing, 2007
+ *
+ * The BVH offers the same interface of the Octree (construction and queries),
+ * so that they can be used interchangeably, e.g. as a template parameter.
+ * Differently from the Octree, each item is referenced by exactly one leaf,
+ * nodes are stored in a flat array, and items are stored by value in per-type
+ * arrays rather than as individually allocated polymorphic objects. After
+ * build() items are sorted in leaf order, hence each leaf addresses a
+ * contiguous range of items. The upper levels of the tree are built serially,
+ * the subtrees below them are built in parallel.
+ *
+ * Usage:
+ *
+ *  i)   Create an empty BVH
+ *  ii)  Use the push_point/sphere/segment/triangle/tetrahedron facilities to populate it
+ *  iii) Call build to make the tree
+*/
+
+class BVH
+{
+    public:
+
+        explicit BVH(const uint items_per_leaf = 4);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        void push_point      (const uint id, const vec3d & v);
+        void push_sphere     (const uint id, const vec3d & c, const double r);
+        void push_segment    (const uint id, const std::vector<vec3d> & v);
+        void push_triangle   (const uint id, const std::vector<vec3d> & v);
+        void push_tetrahedron(const uint id, const std::vector<vec3d> & v);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        void build();
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        template<class M, class V, class E, class P>
+        void build_from_mesh_polys(const AbstractPolygonMesh<M,V,E,P> & m)
+        {
+            assert(num_items()==0);
+            triangles.reserve(m.num_polys());
+            for(uint pid=0; pid<m.num_polys(); ++pid)
+            {
+                for(uint i=0; i<m.poly_tessellation(pid).size()/3; ++i)
+                {
+                    vec3d v0 = m.vert(m.poly_tessellation(pid).at(3*i+0));
+                    vec3d v1 = m.vert(m.poly_tessellation(pid).at(3*i+1));
+                    vec3d v2 = m.vert(m.poly_tessellation(pid).at(3*i+2));
+                    push_triangle(pid, {v0,v1,v2});
+                }
+            }
+            build();
+        }
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        template<class M, class V, class E, class F, class P>
+        void build_from_mesh_polys(const AbstractPolyhedralMesh<M,V,E,F,P> & m)
+        {
+            assert(num_items()==0);
+            tets.reserve(m.num_polys());
+            for(uint pid=0; pid<m.num_polys(); ++pid)
+            {
+                switch(m.mesh_type())
+                {
+                    case TETMESH : push_tetrahedron(pid, m.poly_verts(pid)); break;
+                    default: assert(false && "Unsupported element");
+                }
+            }
+            build();
+        }
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        void build_from_vectors(const std::vector<vec3d> & verts,
+                                const std::vector<uint>  & tris)
+        {
+            assert(num_items()==0);
+            triangles.reserve(tris.size()/3);
+            for(uint i=0; i<tris.size(); i+=3)
+            {
+                push_triangle(i/3, { verts.at(tris.at(i  )),
+                                     verts.at(tris.at(i+1)),
+                                     verts.at(tris.at(i+2))});
+            }
+            build();
+        }
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        template<class M, class V, class E, class P>
+        void build_from_mesh_edges(const AbstractMesh<M,V,E,P> & m)
+        {
+            assert(num_items()==0);
+            segments.reserve(m.num_edges());
+            for(uint eid=0; eid<m.num_edges(); ++eid)
+            {
+                push_segment(eid, m.edge_verts(eid));
+            }
+            build();
+        }
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        uint num_items() const { return item_ids.size(); }
+        uint max_items_per_leaf() const;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        void debug_mode(const bool b);
+
+        // QUERIES :::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // returns pos, id and distance of the item that is closest to query point p
+        // note: as for the Octree, dist is the SQUARED distance
+        void  closest_point(const vec3d & p, uint & id, vec3d & pos, double & dist) const;
+        vec3d closest_point(const vec3d & p) const;
+
+        // returns respectively the first item and the full list of items containing query point p
+        // note: this query becomes exact if CINOLIB_USES_EXACT_PREDICATES is defined
+        bool contains(const vec3d & p, const bool strict, uint & id) const;
+        bool contains(const vec3d & p, const bool strict, std::unordered_set<uint> & ids) const;
+
+        // returns respectively the first and the full list of intersections
+        // between items in the BVH and a ray R(t) := p + t * dir (with t >= 0)
+        bool intersects_ray(const vec3d & p, const vec3d & dir, double & min_t, uint & id) const; // first hit
+        bool intersects_ray(const vec3d & p, const vec3d & dir, std::set<std::pair<double,uint>> & all_hits) const;
+
+        // note: the first two queries become exact if CINOLIB_USES_EXACT_PREDICATES is defined
+        // (intersect_box DOES NOT BECOME exact)
+        bool intersects_segment (const vec3d s[], const bool ignore_if_valid_complex, std::unordered_set<uint> & ids) const;
+        bool intersects_triangle(const vec3d t[], const bool ignore_if_valid_complex, std::unordered_set<uint> & ids) const;
+        bool intersects_box     (const AABB  & b, std::unordered_set<uint> & ids) const;
+
+        // BATCHED QUERIES :::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // answer many independent queries at once, in parallel. Queries are visited
+        // in Morton order, so that consecutive queries traverse the same nodes. Each
+        // closest point query is seeded with the item found by the previous one, and
+        // coherent rays are traced in packets, testing nodes and triangles against all
+        // the rays in a packet at once. ids[i] is -1 if the i-th ray does not hit anything
+        void closest_point (const std::vector<vec3d> & p, std::vector<uint> & ids, std::vector<vec3d> & pos, std::vector<double> & dist) const;
+        void intersects_ray(const std::vector<vec3d> & p, const std::vector<vec3d> & dir, std::vector<double> & min_t, std::vector<int> & ids) const;
+
+        enum { packet_size = 8 }; // max number of rays in a packet
+
+        // SELF OVERLAP ::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // finds all the pairs of items with overlapping AABBs by traversing the tree against
+        // itself. The traversal is split in independent tasks (pairs of nodes, possibly the same
+        // node twice) that can be processed in parallel. self_overlap calls func(id0,id1) once for
+        // each overlapping pair of distinct items found by a task, and stops as soon as func
+        // returns false (in which case it returns false as well)
+        void self_overlap_tasks(std::vector<ipair> & tasks) const;
+        template<class Func>
+        bool self_overlap(const ipair & task, const Func & func) const;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // the tree (nodes[0] is the root)
+        std::vector<BVHNode> nodes;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+    protected:
+
+        // items, sorted in leaf order after build(). For each item, its type
+        // and ref tell in which of the per-type arrays it lives, and where
+        std::vector<uint>        item_ids;
+        std::vector<ItemType>    item_types;
+        std::vector<uint>        item_refs;
+        std::vector<double>      item_boxes; // 6 doubles per item (min, max)
+        std::vector<double>      item_tris;  // 9 doubles per item (v0, v1-v0, v2-v0). Only for triangles
+        std::vector<Point>       points;
+        std::vector<Sphere>      spheres;
+        std::vector<Segment>     segments;
+        std::vector<Triangle>    triangles;
+        std::vector<Tetrahedron> tets;
+
+        uint items_per_leaf;  // leaves with at most this number of items are never split
+        uint tree_depth = 0;  // actual depth of the tree
+        bool print_debug_info = false;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        void push_item(const uint id, const ItemType type, const uint ref);
+
+        // access to the i-th item. closest point and ray queries are the hot
+        // ones, and dispatch on the item type to avoid virtual calls
+        const SpatialDataStructureItem & item(const uint i) const;
+        vec3d item_closest_point (const uint i, const vec3d & p) const;
+        bool  item_intersects_ray(const uint i, const vec3d & p, const vec3d & dir, double & t, vec3d & pos) const;
+
+        // builds the subtree rooted at nodes[nid], which spans items [beg,end) of order
+        uint build_subtree(std::vector<BVHNode> & nodes, const uint nid, const uint beg, const uint end,
+                           std::vector<uint> & order, const std::vector<double> & centroids) const;
+
+        // splits items [beg,end) of order in two, returning the split position (or end for a leaf)
+        uint split(BVHNode & node, const uint beg, const uint end,
+                   std::vector<uint> & order, const std::vector<double> & centroids) const;
+
+        void items_in_box(const AABB & b, std::vector<uint> & items) const;
+
+        // closest point query, optionally seeded with an item (hint) that
+        // gives an upper bound to the distance. Returns the item position
+        void closest_item(const vec3d & p, const int hint, int & item, vec3d & pos, double & dist) const;
+
+        // first hit along a single ray. Returns the item position, or -1 if the ray misses
+        void first_hit(const vec3d & p, const vec3d & dir, double & min_t, int & item) const;
+
+        // first hit for a packet of (at most packet_size) rays. items[i] is -1 if ray i misses
+        void intersects_ray_packet(const vec3d p[], const vec3d dir[], const uint n, double min_t[], int items[]) const;
+};
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "bvh.cpp"
+#endif
+
+#endif // CINO_BVH_H
@@ -132,6 +132,7 @@ void canonical_polygonal_schema(      Trimesh<M,V,E,P>  & m_in,
     // map the interior vertices
     m_out = m_in;
     m_out.vector_verts() = harmonic_map_3d(m_in, dirichlet_bcs, 1, laplacian_mode);
+    m_out.mark_changed(CHANGES_VERT_POS);
     m_out.update_bbox();
     m_out.update_normals();    
 }
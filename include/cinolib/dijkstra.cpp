@@ -35,33 +35,28 @@
 *********************************************************************************/
 #include <cinolib/dijkstra.h>
 #include <cinolib/min_max_inf.h>
-#include <cinolib/stl_container_utilities.h>
 
 namespace cinolib
 {
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-// LITTLE NOTE ON MY DIJKSTRA IMPLEMENTATIONS: why std::set and not
-// std::unordered_set or std::priority_queue?
+// LITTLE NOTE ON MY DIJKSTRA IMPLEMENTATIONS: all the routines below are
+// thin wrappers around the DijkstraEngine (see dijkstra_engine.h), which
+// handles priority updates with lazy deletion (i.e. a new copy of a node
+// is pushed each time its distance decreases, and dead copies are skipped
+// as they are popped). This is consistently faster than the former
+// std::set based implementation, which supported priority updates with a
+// find/remove/insert, but allocated a tree node at each insertion.
 //
-// The reason why I am using std::set is that Dijkstra requires priority
-// update, which is supported by none of the STL containers. Options are:
+// Each thread keeps its own engine, so that per vertex buffers are not
+// reallocated at each call. This matters for algorithms that run many
+// early terminated searches on the same mesh (e.g. homotopy bases).
 //
-//  1) remove an element and re-add it with updated priority. In this
-//     case std::set has the best remove performances
-//
-//  2) leave "dead" copies of an element in the container, and just add a
-//     new copy each time its priority needs an update. Regardless the waste
-//     of memory, which is an issue by itself, in this case at each iteration
-//     you need a mechanism that allows you to discard the current element
-//     if it is not the one with the most recent priority...
-//
-// I therefore decided to go for (1).
-// See also:
-// https://stackoverflow.com/questions/649640/how-to-do-an-efficient-priority-update-in-stl-priority-queue
-
-//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+// Point to point searches using Euclidean edge lengths as metric are
+// guided by A*, using the Euclidean distance to the destination as
+// heuristic. Searches with user defined weights, multiple destinations,
+// or no destination at all, are plain Dijkstras.
 
 template<class M, class V, class E, class P>
 CINO_INLINE
@@ -69,34 +64,7 @@ void dijkstra_exhaustive(const AbstractMesh<M,V,E,P> & m,
                          const uint                    source,
                                std::vector<double>   & dist)
 {
-    dist = std::vector<double>(m.num_verts(), inf_double);
-    dist.at(source) = 0.0;
-
-    std::set<std::pair<double,uint>> q;
-    q.insert(std::make_pair(0.0,source));
-
-    while(!q.empty())
-    {
-        uint vid = q.begin()->second;
-        q.erase(q.begin());
-
-        for(uint nbr : m.adj_v2v(vid))
-        {
-            double new_dist = dist.at(vid) + m.vert(vid).dist(m.vert(nbr));
-
-            if(dist.at(nbr) > new_dist)
-            {
-                if(dist.at(nbr) < inf_double) // otherwise it won't be found (one order of magnitude faster than initializing the queue with all the elements with inf dist)
-                {
-                    auto it = q.find(std::make_pair(dist.at(nbr),nbr));
-                    assert(it!=q.end());
-                    q.erase(it);
-                }
-                dist.at(nbr) = new_dist;
-                q.insert(std::make_pair(new_dist,nbr));
-            }
-        }
-    }
+    dijkstra_exhaustive(m, std::vector<uint>(1,source), dist);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -107,34 +75,12 @@ void dijkstra_exhaustive(const AbstractMesh<M,V,E,P> & m,
                          const std::vector<uint>     & sources,
                                std::vector<double>   & dist)
 {
-    dist = std::vector<double>(m.num_verts(), inf_double);
-    for(uint vid : sources) dist.at(vid) = 0.0;
-
-    std::set<std::pair<double,uint>> q;
-    for(uint vid : sources) q.insert(std::make_pair(0.0,vid));
-
-    while(!q.empty())
+    DijkstraEngine & engine = dijkstra_thread_engine();
+    engine.search(m.num_verts(), sources, [&m](const uint vid, std::vector<DijkstraArc> & arcs)
     {
-        uint vid = q.begin()->second;
-        q.erase(q.begin());
-
-        for(uint nbr : m.adj_v2v(vid))
-        {
-            double new_dist = dist.at(vid) + m.vert(vid).dist(m.vert(nbr));
-
-            if(dist.at(nbr) > new_dist)
-            {
-                if(dist.at(nbr) < inf_double) // otherwise it won't be found (one order of magnitude faster than initializing the queue with all the elements with inf dist)
-                {
-                    auto it = q.find(std::make_pair(dist.at(nbr),nbr));
-                    assert(it!=q.end());
-                    q.erase(it);
-                }
-                dist.at(nbr) = new_dist;
-                q.insert(std::make_pair(new_dist,nbr));
-            }
-        }
-    }
+        for(uint nbr : m.adj_v2v(vid)) arcs.emplace_back(nbr, m.vert(vid).dist(m.vert(nbr)));
+    });
+    engine.copy_dist(dist);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -145,38 +91,17 @@ void dijkstra_exhaustive_srf_only(const AbstractPolyhedralMesh<M,V,E,F,P> & m,
                                   const std::vector<uint>                 & sources,
                                         std::vector<double>               & dist)
 {
-    dist = std::vector<double>(m.num_verts(), inf_double);
-    for(uint vid : sources) dist.at(vid) = 0.0;
-
-    std::set<std::pair<double,uint>> q;
-    for(uint vid : sources) q.insert(std::make_pair(0.0,vid));
-
-    while(!q.empty())
+    DijkstraEngine & engine = dijkstra_thread_engine();
+    engine.search(m.num_verts(), sources, [&m](const uint vid, std::vector<DijkstraArc> & arcs)
     {
-        uint vid = q.begin()->second;
-        q.erase(q.begin());
-
         for(uint eid : m.adj_v2e(vid))
         {
-            if(m.edge_is_on_srf(eid))
-            {
-                uint   nbr      = m.vert_opposite_to(eid,vid);
-                double new_dist = dist.at(vid) + m.vert(vid).dist(m.vert(nbr));
-
-                if(dist.at(nbr) > new_dist)
-                {
-                    if(dist.at(nbr) < inf_double) // otherwise it won't be found (one order of magnitude faster than initializing the queue with all the elements with inf dist)
-                    {
-                        auto it = q.find(std::make_pair(dist.at(nbr),nbr));
-                        assert(it!=q.end());
-                        q.erase(it);
-                    }
-                    dist.at(nbr) = new_dist;
-                    q.insert(std::make_pair(new_dist,nbr));
-                }
-            }
+            if(!m.edge_is_on_srf(eid)) continue;
+            uint nbr = m.vert_opposite_to(eid,vid);
+            arcs.emplace_back(nbr, m.vert(vid).dist(m.vert(nbr)));
         }
-    }
+    });
+    engine.copy_dist(dist);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -189,37 +114,17 @@ void dijkstra_exhaustive_mask_on_edges(const AbstractMesh<M,V,E,P> & m,
                                        const std::vector<bool>     & mask,    // if mask[e] = true, path cannot pass through edge e
                                              std::vector<double>   & dist)
 {
-    dist = std::vector<double>(m.num_verts(), inf_double);
-    for(uint vid : sources) dist.at(vid) = 0.0;
-
-    std::set<std::pair<double,uint>> q;
-    for(uint vid : sources) q.insert(std::make_pair(0.0,vid));
-
-    while(!q.empty())
+    DijkstraEngine & engine = dijkstra_thread_engine();
+    engine.search(m.num_verts(), sources, [&](const uint vid, std::vector<DijkstraArc> & arcs)
     {
-        uint vid = q.begin()->second;
-        q.erase(q.begin());
-
         for(uint eid : m.adj_v2e(vid))
         {
             if(mask.at(eid)) continue;
-
-            uint   nbr      = m.vert_opposite_to(eid,vid);
-            double new_dist = dist.at(vid) + weights.at(nbr);
-
-            if(dist.at(nbr) > new_dist)
-            {
-                if(dist.at(nbr) < inf_double) // otherwise it won't be found (one order of magnitude faster than initializing the queue with all the elements with inf dist)
-                {
-                    auto it = q.find(std::make_pair(dist.at(nbr),nbr));
-                    assert(it!=q.end());
-                    q.erase(it);
-                }
-                dist.at(nbr) = new_dist;
-                q.insert(std::make_pair(new_dist,nbr));
-            }
+            uint nbr = m.vert_opposite_to(eid,vid);
+            arcs.emplace_back(nbr, weights.at(nbr));
         }
-    }
+    });
+    engine.copy_dist(dist);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -231,49 +136,19 @@ double dijkstra(const AbstractMesh<M,V,E,P> & m,
                 const uint                    dest,
                       std::vector<uint>     & path)
 {
-    path.clear();
-
-    std::vector<int> prev(m.num_verts(), -1);
-
-    std::vector<double> dist(m.num_verts(), inf_double);
-    dist.at(source) = 0.0;
-
-    std::set<std::pair<double,uint>> q;
-    q.insert(std::make_pair(0.0,source));
-
-    while(!q.empty())
+    DijkstraEngine & engine = dijkstra_thread_engine();
+    bool found = engine.search_astar(m.num_verts(), source, dest,
+    [&m](const uint vid, std::vector<DijkstraArc> & arcs)
     {
-        uint vid = q.begin()->second;
-        q.erase(q.begin());
-
-        if(vid==dest)
-        {
-            int tmp = vid;
-            do { path.push_back(tmp); tmp = prev.at(tmp); } while (tmp != -1);
-            std::reverse(path.begin(), path.end());
-            return dist.at(dest);
-        }
-
-        for(uint nbr : m.adj_v2v(vid))
-        {
-            double new_dist = dist.at(vid) + m.vert(vid).dist(m.vert(nbr));
-
-            if(dist.at(nbr) > new_dist)
-            {
-                if(dist.at(nbr) < inf_double) // otherwise it won't be found (one order of magnitude faster than initializing the queue with all the elements with inf dist)
-                {
-                    auto it = q.find(std::make_pair(dist.at(nbr),nbr));
-                    assert(it!=q.end());
-                    q.erase(it);
-                }
-                dist.at(nbr) = new_dist;
-                prev.at(nbr) = vid;
-                q.insert(std::make_pair(new_dist,nbr));
-            }
-        }
-    }
-    assert(false && "Dijkstra did not converge!");
-    return 0.0;
+        for(uint nbr : m.adj_v2v(vid)) arcs.emplace_back(nbr, m.vert(vid).dist(m.vert(nbr)));
+    },
+    [&m,dest](const uint vid)
+    {
+        return m.vert(vid).dist(m.vert(dest));
+    });
+    assert(found && "Dijkstra did not converge!");
+    engine.path_to(dest, path);
+    return found ? engine.dist(dest) : 0.0;
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -286,49 +161,15 @@ double dijkstra(const AbstractMesh<M,V,E,P> & m,
                 const std::vector<double>   & weights,
                       std::vector<uint>     & path)
 {
-    path.clear();
-
-    std::vector<int> prev(m.num_verts(), -1);
-
-    std::vector<double> dist(m.num_verts(), inf_double);
-    dist.at(source) = 0.0;
-
-    std::set<std::pair<double,uint>> q;
-    q.insert(std::make_pair(0.0,source));
-
-    while(!q.empty())
+    DijkstraEngine & engine = dijkstra_thread_engine();
+    int found = engine.search(m.num_verts(), std::vector<uint>(1,source), [&](const uint vid, std::vector<DijkstraArc> & arcs)
     {
-        uint vid = q.begin()->second;
-        q.erase(q.begin());
-
-        if(vid==dest)
-        {
-            int tmp = vid;
-            do { path.push_back(tmp); tmp = prev.at(tmp); } while (tmp != -1);
-            std::reverse(path.begin(), path.end());
-            return dist.at(dest);
-        }
-
-        for(uint nbr : m.adj_v2v(vid))
-        {
-            double new_dist = dist.at(vid) + weights.at(nbr);
-
-            if(dist.at(nbr) > new_dist)
-            {
-                if(dist.at(nbr) < inf_double) // otherwise it won't be found (one order of magnitude faster than initializing the queue with all the elements with inf dist)
-                {
-                    auto it = q.find(std::make_pair(dist.at(nbr),nbr));
-                    assert(it!=q.end());
-                    q.erase(it);
-                }
-                dist.at(nbr) = new_dist;
-                prev.at(nbr) = vid;
-                q.insert(std::make_pair(new_dist,nbr));
-            }
-        }
-    }
-    assert(false && "Dijkstra did not converge!");
-    return 0.0;
+        for(uint nbr : m.adj_v2v(vid)) arcs.emplace_back(nbr, weights.at(nbr));
+    },
+    std::vector<uint>(1,dest));
+    assert(found>=0 && "Dijkstra did not converge!");
+    engine.path_to(dest, path);
+    return (found>=0) ? engine.dist(dest) : 0.0;
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -342,53 +183,20 @@ double dijkstra(const AbstractMesh<M,V,E,P> & m,
                 const std::vector<bool>     & mask, // if mask[v] = true, path cannot pass through it
                       std::vector<uint>     & path)
 {
-    path.clear();
-
-    std::vector<int> prev(m.num_verts(), -1);
-
-    std::vector<double> dist(m.num_verts(), inf_double);
-    dist.at(source) = 0.0;
-
-    std::set<std::pair<double,uint>> q;
-    q.insert(std::make_pair(0.0,source));
-
-    while(!q.empty())
+    DijkstraEngine & engine = dijkstra_thread_engine();
+    int found = engine.search(m.num_verts(), std::vector<uint>(1,source), [&](const uint vid, std::vector<DijkstraArc> & arcs)
     {
-        uint vid = q.begin()->second;
-        q.erase(q.begin());
-
-        if(vid==dest)
-        {
-            int tmp = vid;
-            do { path.push_back(tmp); tmp = prev.at(tmp); } while (tmp != -1);
-            std::reverse(path.begin(), path.end());
-            return dist.at(dest);
-        }
-
         for(uint nbr : m.adj_v2v(vid))
         {
-            if(mask.at(nbr)) continue;
-
-            double new_dist = dist.at(vid) + weights.at(nbr);
-
-            if(dist.at(nbr) > new_dist)
-            {
-                if(dist.at(nbr) < inf_double) // otherwise it won't be found (one order of magnitude faster than initializing the queue with all the elements with inf dist)
-                {
-                    auto it = q.find(std::make_pair(dist.at(nbr),nbr));
-                    assert(it!=q.end());
-                    q.erase(it);
-                }
-                dist.at(nbr) = new_dist;
-                prev.at(nbr) = vid;
-                q.insert(std::make_pair(new_dist,nbr));
-            }
+            if(!mask.at(nbr)) arcs.emplace_back(nbr, weights.at(nbr));
         }
-    }
+    },
+    std::vector<uint>(1,dest));
 
-    // there exists no path with the given mask constraints
-    path.clear();
-    return 0.0;
+    // if found<0 there exists no path with the given mask constraints
+    engine.path_to(dest, path);
+    if(found<0) path.clear();
+    return (found>=0) ? engine.dist(dest) : 0.0;
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -402,56 +210,22 @@ double dijkstra_mask_on_edges(const AbstractMesh<M,V,E,P> & m,
                               const std::vector<bool>     & mask,    // if mask[e] = true, path cannot pass through edge e
                                     std::vector<uint>     & path)
 {
-    path.clear();
-
-    std::vector<int> prev(m.num_verts(), -1);
-
-    std::vector<double> dist(m.num_verts(), inf_double);
-    dist.at(source) = 0.0;
-
-    std::set<std::pair<double,uint>> q;
-    q.insert(std::make_pair(0.0,source));
-
-    while(!q.empty())
+    DijkstraEngine & engine = dijkstra_thread_engine();
+    int found = engine.search(m.num_verts(), std::vector<uint>(1,source), [&](const uint vid, std::vector<DijkstraArc> & arcs)
     {
-        uint vid = q.begin()->second;
-        q.erase(q.begin());
-
-        if(vid==dest)
-        {
-            int tmp = vid;
-            do { path.push_back(tmp); tmp = prev.at(tmp); } while (tmp != -1);
-            std::reverse(path.begin(), path.end());
-            return dist.at(dest);
-        }
-
-        for(uint nbr : m.adj_v2v(vid))
+        for(uint eid : m.adj_v2e(vid))
         {
-            int eid = m.edge_id(vid,nbr);
-            assert(eid>=0);
-
             if(mask.at(eid)) continue;
-
-            double new_dist = dist.at(vid) + weights.at(nbr);
-
-            if(dist.at(nbr) > new_dist)
-            {
-                if(dist.at(nbr) < inf_double) // otherwise it won't be found (one order of magnitude faster than initializing the queue with all the elements with inf dist)
-                {
-                    auto it = q.find(std::make_pair(dist.at(nbr),nbr));
-                    assert(it!=q.end());
-                    q.erase(it);
-                }
-                dist.at(nbr) = new_dist;
-                prev.at(nbr) = vid;
-                q.insert(std::make_pair(new_dist,nbr));
-            }
+            uint nbr = m.vert_opposite_to(eid,vid);
+            arcs.emplace_back(nbr, weights.at(nbr));
         }
-    }
+    },
+    std::vector<uint>(1,dest));
 
-    // there exists no path with the given mask constraints
-    path.clear();
-    return 0.0;
+    // if found<0 there exists no path with the given mask constraints
+    engine.path_to(dest, path);
+    if(found<0) path.clear();
+    return (found>=0) ? engine.dist(dest) : 0.0;
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -467,54 +241,26 @@ double dijkstra(const AbstractMesh<M,V,E,P> & m,
                 const std::vector<bool>     & mask,
                       std::vector<uint>     & path)
 {
-    path.clear();
     assert(mask.size() == m.num_verts());
 
-    std::vector<int> prev(m.num_verts(), -1);
-
-    std::vector<double> dist(m.num_verts(), inf_double);
-    dist.at(source) = 0.0;
-
-    std::set<std::pair<double,uint>> q;
-    q.insert(std::make_pair(0.0,source));
-
-    while(!q.empty())
+    DijkstraEngine & engine = dijkstra_thread_engine();
+    bool found = engine.search_astar(m.num_verts(), source, dest,
+    [&](const uint vid, std::vector<DijkstraArc> & arcs)
     {
-        uint vid = q.begin()->second;
-        q.erase(q.begin());
-
-        if(vid==dest)
-        {
-            int tmp = vid;
-            do { path.push_back(tmp); tmp = prev.at(tmp); } while (tmp != -1);
-            std::reverse(path.begin(), path.end());
-            return dist.at(dest);
-        }
-
         for(uint nbr : m.adj_v2v(vid))
         {
-            if(mask.at(nbr)) continue;
-
-            double new_dist = dist.at(vid) + m.vert(vid).dist(m.vert(nbr));
-
-            if(dist.at(nbr) > new_dist)
-            {
-                if(dist.at(nbr) < inf_double) // otherwise it won't be found (one order of magnitude faster than initializing the queue with all the elements with inf dist)
-                {
-                    auto it = q.find(std::make_pair(dist.at(nbr),nbr));
-                    assert(it!=q.end());
-                    q.erase(it);
-                }
-                dist.at(nbr) = new_dist;
-                prev.at(nbr) = vid;
-                q.insert(std::make_pair(new_dist,nbr));
-            }
+            if(!mask.at(nbr)) arcs.emplace_back(nbr, m.vert(vid).dist(m.vert(nbr)));
         }
-    }
+    },
+    [&m,dest](const uint vid)
+    {
+        return m.vert(vid).dist(m.vert(dest));
+    });
 
-    // there exists no path with the given mask constraints
-    path.clear();
-    return 0.0;
+    // if !found there exists no path with the given mask constraints
+    engine.path_to(dest, path);
+    if(!found) path.clear();
+    return found ? engine.dist(dest) : 0.0;
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -530,57 +276,28 @@ double dijkstra_mask_on_edges(const AbstractMesh<M,V,E,P> & m,
                               const std::vector<bool>     & mask, // if mask[e] = true, path cannot pass through edge e
                                     std::vector<uint>     & path)
 {
-    path.clear();
     assert(mask.size() == m.num_edges());
 
-    std::vector<int> prev(m.num_verts(), -1);
-
-    std::vector<double> dist(m.num_verts(), inf_double);
-    dist.at(source) = 0.0;
-
-    std::set<std::pair<double,uint>> q;
-    q.insert(std::make_pair(0.0,source));
-
-    while(!q.empty())
+    DijkstraEngine & engine = dijkstra_thread_engine();
+    bool found = engine.search_astar(m.num_verts(), source, dest,
+    [&](const uint vid, std::vector<DijkstraArc> & arcs)
     {
-        uint vid = q.begin()->second;
-        q.erase(q.begin());
-
-        if(vid==dest)
-        {
-            int tmp = vid;
-            do { path.push_back(tmp); tmp = prev.at(tmp); } while (tmp != -1);
-            std::reverse(path.begin(), path.end());
-            return dist.at(dest);
-        }
-
-        for(uint nbr : m.adj_v2v(vid))
+        for(uint eid : m.adj_v2e(vid))
         {
-            int eid = m.edge_id(vid,nbr);
-            assert(eid>=0);
-
             if(mask.at(eid)) continue;
-
-            double new_dist = dist.at(vid) + m.vert(vid).dist(m.vert(nbr));
-
-            if(dist.at(nbr) > new_dist)
-            {
-                if(dist.at(nbr) < inf_double) // otherwise it won't be found (one order of magnitude faster than initializing the queue with all the elements with inf dist)
-                {
-                    auto it = q.find(std::make_pair(dist.at(nbr),nbr));
-                    assert(it!=q.end());
-                    q.erase(it);
-                }
-                dist.at(nbr) = new_dist;
-                prev.at(nbr) = vid;
-                q.insert(std::make_pair(new_dist,nbr));
-            }
+            uint nbr = m.vert_opposite_to(eid,vid);
+            arcs.emplace_back(nbr, m.vert(vid).dist(m.vert(nbr)));
         }
-    }
+    },
+    [&m,dest](const uint vid)
+    {
+        return m.vert(vid).dist(m.vert(dest));
+    });
 
-    // there exists no path with the given mask constraints
-    path.clear();
-    return 0.0;
+    // if !found there exists no path with the given mask constraints
+    engine.path_to(dest, path);
+    if(!found) path.clear();
+    return found ? engine.dist(dest) : 0.0;
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -597,54 +314,26 @@ double dijkstra(const AbstractMesh<M,V,E,P> & m,
                 const std::vector<bool>     & mask,
                       std::vector<uint>     & path)
 {
-    path.clear();
     assert(mask.size() == m.num_verts());
 
-    std::vector<int> prev(m.num_verts(), -1);
-
-    std::vector<double> dist(m.num_verts(), inf_double);
-    dist.at(source) = 0.0;
-
-    std::set<std::pair<double,uint>> q;
-    q.insert(std::make_pair(0.0,source));
-
-    while(!q.empty())
+    DijkstraEngine & engine = dijkstra_thread_engine();
+    int vid = engine.search(m.num_verts(), std::vector<uint>(1,source), [&](const uint vid, std::vector<DijkstraArc> & arcs)
     {
-        uint vid = q.begin()->second;
-        q.erase(q.begin());
-
-        if(CONTAINS(dest,vid))
-        {
-            int tmp = vid;
-            do { path.push_back(tmp); tmp = prev.at(tmp); } while (tmp != -1);
-            std::reverse(path.begin(), path.end());
-            return dist.at(vid);
-        }
-
         for(uint nbr : m.adj_v2v(vid))
         {
-            if(mask.at(nbr)) continue;
-
-            double new_dist = dist.at(vid) + m.vert(vid).dist(m.vert(nbr));
-
-            if(dist.at(nbr) > new_dist)
-            {
-                if(dist.at(nbr) < inf_double) // otherwise it won't be found (one order of magnitude faster than initializing the queue with all the elements with inf dist)
-                {
-                    auto it = q.find(std::make_pair(dist.at(nbr),nbr));
-                    assert(it!=q.end());
-                    q.erase(it);
-                }
-                dist.at(nbr) = new_dist;
-                prev.at(nbr) = vid;
-                q.insert(std::make_pair(new_dist,nbr));
-            }
+            if(!mask.at(nbr)) arcs.emplace_back(nbr, m.vert(vid).dist(m.vert(nbr)));
         }
-    }
+    },
+    std::vector<uint>(dest.begin(), dest.end()));
 
-    // there exists no path with the given mask constraints
-    path.clear();
-    return 0.0;
+    // if vid<0 there exists no path with the given mask constraints
+    if(vid<0)
+    {
+        path.clear();
+        return 0.0;
+    }
+    engine.path_to(vid, path);
+    return engine.dist(vid);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -655,34 +344,7 @@ void dijkstra_exhaustive_on_dual(const AbstractMesh<M,V,E,P> & m,
                                  const uint                    source,
                                        std::vector<double>   & dist)
 {
-    dist = std::vector<double>(m.num_polys(), inf_double);
-    dist.at(source) = 0.0;
-
-    std::set<std::pair<double,uint>> q;
-    q.insert(std::make_pair(0.0,source));
-
-    while(!q.empty())
-    {
-        uint vid = q.begin()->second;
-        q.erase(q.begin());
-
-        for(uint nbr : m.adj_p2p(vid))
-        {
-            double new_dist = dist.at(vid) + m.poly_centroid(vid).dist(m.poly_centroid(nbr));
-
-            if(dist.at(nbr) > new_dist)
-            {
-                if(dist.at(nbr) < inf_double) // otherwise it won't be found (one order of magnitude faster than initializing the queue with all the elements with inf dist)
-                {
-                    auto it = q.find(std::make_pair(dist.at(nbr),nbr));
-                    assert(it!=q.end());
-                    q.erase(it);
-                }
-                dist.at(nbr) = new_dist;
-                q.insert(std::make_pair(new_dist,nbr));
-            }
-        }
-    }
+    dijkstra_exhaustive_on_dual(m, std::vector<uint>(1,source), dist);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -693,38 +355,12 @@ void dijkstra_exhaustive_on_dual(const AbstractMesh<M,V,E,P> & m,
                                  const std::vector<uint>     & sources,
                                        std::vector<double>   & dist)
 {
-    dist = std::vector<double>(m.num_polys(), inf_double);
-
-    std::set<std::pair<double,uint>> q;
-
-    for(uint s : sources)
-    {
-        dist.at(s) = 0.0;
-        q.insert(std::make_pair(0.0,s));
-    }
-
-    while(!q.empty())
+    DijkstraEngine & engine = dijkstra_thread_engine();
+    engine.search(m.num_polys(), sources, [&m](const uint pid, std::vector<DijkstraArc> & arcs)
     {
-        uint vid = q.begin()->second;
-        q.erase(q.begin());
-
-        for(uint nbr : m.adj_p2p(vid))
-        {
-            double new_dist = dist.at(vid) + m.poly_centroid(vid).dist(m.poly_centroid(nbr));
-
-            if(dist.at(nbr) > new_dist)
-            {
-                if(dist.at(nbr) < inf_double) // otherwise it won't be found (one order of magnitude faster than initializing the queue with all the elements with inf dist)
-                {
-                    auto it = q.find(std::make_pair(dist.at(nbr),nbr));
-                    assert(it!=q.end());
-                    q.erase(it);
-                }
-                dist.at(nbr) = new_dist;
-                q.insert(std::make_pair(new_dist,nbr));
-            }
-        }
-    }
+        for(uint nbr : m.adj_p2p(pid)) arcs.emplace_back(nbr, m.poly_centroid(pid).dist(m.poly_centroid(nbr)));
+    });
+    engine.copy_dist(dist);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -736,49 +372,21 @@ double dijkstra_on_dual(const AbstractMesh<M,V,E,P> & m,
                         const uint                    dest,
                               std::vector<uint>     & path)
 {
-    path.clear();
+    vec3d target = m.poly_centroid(dest);
 
-    std::vector<int> prev(m.num_polys(), -1);
-
-    std::vector<double> dist(m.num_polys(), inf_double);
-    dist.at(source) = 0.0;
-
-    std::set<std::pair<double,uint>> q;
-    q.insert(std::make_pair(0.0,source));
-
-    while(!q.empty())
+    DijkstraEngine & engine = dijkstra_thread_engine();
+    bool found = engine.search_astar(m.num_polys(), source, dest,
+    [&m](const uint pid, std::vector<DijkstraArc> & arcs)
     {
-        uint vid = q.begin()->second;
-        q.erase(q.begin());
-
-        if(vid==dest)
-        {
-            int tmp = vid;
-            do { path.push_back(tmp); tmp = prev.at(tmp); } while (tmp != -1);
-            std::reverse(path.begin(), path.end());
-            return dist.at(dest);
-        }
-
-        for(uint nbr : m.adj_p2p(vid))
-        {
-            double new_dist = dist.at(vid) + m.poly_centroid(vid).dist(m.poly_centroid(nbr));
-
-            if(dist.at(nbr) > new_dist)
-            {
-                if(dist.at(nbr) < inf_double) // otherwise it won't be found (one order of magnitude faster than initializing the queue with all the elements with inf dist)
-                {
-                    auto it = q.find(std::make_pair(dist.at(nbr),nbr));
-                    assert(it!=q.end());
-                    q.erase(it);
-                }
-                dist.at(nbr) = new_dist;
-                prev.at(nbr) = vid;
-                q.insert(std::make_pair(new_dist,nbr));
-            }
-        }
-    }
-    assert(false && "Dijkstra did not converge!");
-    return 0.0;
+        for(uint nbr : m.adj_p2p(pid)) arcs.emplace_back(nbr, m.poly_centroid(pid).dist(m.poly_centroid(nbr)));
+    },
+    [&m,&target](const uint pid)
+    {
+        return m.poly_centroid(pid).dist(target);
+    });
+    assert(found && "Dijkstra did not converge!");
+    engine.path_to(dest, path);
+    return found ? engine.dist(dest) : 0.0;
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -791,53 +399,26 @@ double dijkstra_on_dual(const AbstractMesh<M,V,E,P> & m,
                         const std::vector<bool>     & mask,
                               std::vector<uint>     & path)
 {
-    path.clear();
-
-    std::vector<int> prev(m.num_polys(), -1);
-
-    std::vector<double> dist(m.num_polys(), inf_double);
-    dist.at(source) = 0.0;
+    vec3d target = m.poly_centroid(dest);
 
-    std::set<std::pair<double,uint>> q;
-    q.insert(std::make_pair(0.0,source));
-
-    while(!q.empty())
+    DijkstraEngine & engine = dijkstra_thread_engine();
+    bool found = engine.search_astar(m.num_polys(), source, dest,
+    [&](const uint pid, std::vector<DijkstraArc> & arcs)
     {
-        uint vid = q.begin()->second;
-        q.erase(q.begin());
-
-        if(vid==dest)
+        for(uint nbr : m.adj_p2p(pid))
         {
-            int tmp = vid;
-            do { path.push_back(tmp); tmp = prev.at(tmp); } while (tmp != -1);
-            std::reverse(path.begin(), path.end());
-            return dist.at(dest);
+            if(!mask.at(nbr)) arcs.emplace_back(nbr, m.poly_centroid(pid).dist(m.poly_centroid(nbr)));
         }
+    },
+    [&m,&target](const uint pid)
+    {
+        return m.poly_centroid(pid).dist(target);
+    });
 
-        for(uint nbr : m.adj_p2p(vid))
-        {
-            if(mask.at(nbr)) continue;
-
-            double new_dist = dist.at(vid) + m.poly_centroid(vid).dist(m.poly_centroid(nbr));
-
-            if(dist.at(nbr) > new_dist)
-            {
-                if(dist.at(nbr) < inf_double) // otherwise it won't be found (one order of magnitude faster than initializing the queue with all the elements with inf dist)
-                {
-                    auto it = q.find(std::make_pair(dist.at(nbr),nbr));
-                    assert(it!=q.end());
-                    q.erase(it);
-                }
-                dist.at(nbr) = new_dist;
-                prev.at(nbr) = vid;
-                q.insert(std::make_pair(new_dist,nbr));
-            }
-        }
-    }
-
-    // there exists no path with the given mask constraints
-    path.clear();
-    return 0.0;
+    // if !found there exists no path with the given mask constraints
+    engine.path_to(dest, path);
+    if(!found) path.clear();
+    return found ? engine.dist(dest) : 0.0;
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -850,53 +431,24 @@ double dijkstra_on_dual(const AbstractMesh<M,V,E,P> & m,
                         const std::vector<bool>     & mask,
                               std::vector<uint>     & path)
 {
-    path.clear();
-
-    std::vector<int> prev(m.num_polys(), -1);
-
-    std::vector<double> dist(m.num_polys(), inf_double);
-    dist.at(source) = 0.0;
-
-    std::set<std::pair<double,uint>> q;
-    q.insert(std::make_pair(0.0,source));
-
-    while(!q.empty())
+    DijkstraEngine & engine = dijkstra_thread_engine();
+    int pid = engine.search(m.num_polys(), std::vector<uint>(1,source), [&](const uint pid, std::vector<DijkstraArc> & arcs)
     {
-        uint vid = q.begin()->second;
-        q.erase(q.begin());
-
-        if(CONTAINS(dest,vid))
+        for(uint nbr : m.adj_p2p(pid))
         {
-            int tmp = vid;
-            do { path.push_back(tmp); tmp = prev.at(tmp); } while (tmp != -1);
-            std::reverse(path.begin(), path.end());
-            return dist.at(vid);
+            if(!mask.at(nbr)) arcs.emplace_back(nbr, m.poly_centroid(pid).dist(m.poly_centroid(nbr)));
         }
+    },
+    std::vector<uint>(dest.begin(), dest.end()));
 
-        for(uint nbr : m.adj_p2p(vid))
-        {
-            if(mask.at(nbr)) continue;
-
-            double new_dist = dist.at(vid) + m.poly_centroid(vid).dist(m.poly_centroid(nbr));
-
-            if(dist.at(nbr) > new_dist)
-            {
-                if(dist.at(nbr) < inf_double) // otherwise it won't be found (one order of magnitude faster than initializing the queue with all the elements with inf dist)
-                {
-                    auto it = q.find(std::make_pair(dist.at(nbr),nbr));
-                    assert(it!=q.end());
-                    q.erase(it);
-                }
-                dist.at(nbr) = new_dist;
-                prev.at(nbr) = vid;
-                q.insert(std::make_pair(new_dist,nbr));
-            }
-        }
+    // if pid<0 there exists no path with the given mask constraints
+    if(pid<0)
+    {
+        path.clear();
+        return 0.0;
     }
-
-    // there exists no path with the given mask constraints
-    path.clear();
-    return 0.0;
+    engine.path_to(pid, path);
+    return engine.dist(pid);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -908,49 +460,20 @@ double dijkstra_on_dual(const AbstractMesh<M,V,E,P> & m,
                         const std::set<uint>        & dest,
                               std::vector<uint>     & path)
 {
-    path.clear();
-
-    std::vector<int> prev(m.num_polys(), -1);
-
-    std::vector<double> dist(m.num_polys(), inf_double);
-    dist.at(source) = 0.0;
-
-    std::set<std::pair<double,uint>> q;
-    q.insert(std::make_pair(0.0,source));
-
-    while(!q.empty())
+    DijkstraEngine & engine = dijkstra_thread_engine();
+    int pid = engine.search(m.num_polys(), std::vector<uint>(1,source), [&m](const uint pid, std::vector<DijkstraArc> & arcs)
     {
-        uint vid = q.begin()->second;
-        q.erase(q.begin());
-
-        if(CONTAINS(dest,vid))
-        {
-            int tmp = vid;
-            do { path.push_back(tmp); tmp = prev.at(tmp); } while (tmp != -1);
-            std::reverse(path.begin(), path.end());
-            return dist.at(vid);
-        }
-
-        for(uint nbr : m.adj_p2p(vid))
-        {
-            double new_dist = dist.at(vid) + m.poly_centroid(vid).dist(m.poly_centroid(nbr));
-
-            if(dist.at(nbr) > new_dist)
-            {
-                if(dist.at(nbr) < inf_double) // otherwise it won't be found (one order of magnitude faster than initializing the queue with all the elements with inf dist)
-                {
-                    auto it = q.find(std::make_pair(dist.at(nbr),nbr));
-                    assert(it!=q.end());
-                    q.erase(it);
-                }
-                dist.at(nbr) = new_dist;
-                prev.at(nbr) = vid;
-                q.insert(std::make_pair(new_dist,nbr));
-            }
-        }
+        for(uint nbr : m.adj_p2p(pid)) arcs.emplace_back(nbr, m.poly_centroid(pid).dist(m.poly_centroid(nbr)));
+    },
+    std::vector<uint>(dest.begin(), dest.end()));
+    assert(pid>=0 && "Dijkstra did not converge!");
+    if(pid<0)
+    {
+        path.clear();
+        return 0.0;
     }
-    assert(false && "Dijkstra did not converge!");
-    return 0.0;
+    engine.path_to(pid, path);
+    return engine.dist(pid);
 }
 
 }
@@ -40,6 +40,7 @@
 #include <sys/types.h>
 #include <vector>
 #include <cinolib/cino_inline.h>
+#include <cinolib/dijkstra_engine.h>
 #include <cinolib/meshes/abstract_mesh.h>
 #include <cinolib/meshes/abstract_polyhedralmesh.h>
 
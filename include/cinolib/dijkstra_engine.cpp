@@ -0,0 +1,492 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/dijkstra_engine.h>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace cinolib
+{
+
+template<uint D>
+CINO_INLINE
+void DijkstraDaryHeap<D>::push(const double key, const uint node)
+{
+    // sift up
+    uint i = items.size();
+    items.emplace_back();
+    while(i>0)
+    {
+        uint parent = (i-1)/D;
+        if(items[parent].first <= key) break;
+        items[i] = items[parent];
+        i = parent;
+    }
+    items[i] = std::make_pair(key,node);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<uint D>
+CINO_INLINE
+void DijkstraDaryHeap<D>::pop()
+{
+    assert(!items.empty());
+    DijkstraHeapItem last = items.back();
+    items.pop_back();
+    if(items.empty()) return;
+
+    // sift down the last item, starting from the root
+    uint n = items.size();
+    uint i = 0;
+    while(true)
+    {
+        uint first = D*i+1;
+        if(first>=n) break;
+        uint last_child = std::min(first+D, n);
+        uint best = first;
+        for(uint c=first+1; c<last_child; ++c)
+        {
+            if(items[c].first < items[best].first) best = c;
+        }
+        if(items[best].first >= last.first) break;
+        items[i] = items[best];
+        i = best;
+    }
+    items[i] = last;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint64_t DijkstraRadixHeap::to_bits(const double key)
+{
+    if(key<=0) return 0; // also maps -0.0 to zero
+    uint64_t bits;
+    std::memcpy(&bits, &key, sizeof(double));
+    return bits;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// position of the most significant bit + 1 (zero for x=0)
+CINO_INLINE
+uint DijkstraRadixHeap::bucket(uint64_t x)
+{
+    uint b = 0;
+    if(x >> 32) { b += 32; x >>= 32; }
+    if(x >> 16) { b += 16; x >>= 16; }
+    if(x >>  8) { b +=  8; x >>=  8; }
+    if(x >>  4) { b +=  4; x >>=  4; }
+    if(x >>  2) { b +=  2; x >>=  2; }
+    if(x >>  1) { b +=  1; x >>=  1; }
+    return b + uint(x);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void DijkstraRadixHeap::clear()
+{
+    for(auto & b : buckets) b.clear();
+    last = 0;
+    size = 0;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void DijkstraRadixHeap::push(const double key, const uint node)
+{
+    // keys smaller than the last popped one may only come from round off
+    // errors (e.g. A* with an heuristic that is consistent up to epsilon)
+    uint64_t k = std::max(to_bits(key), last);
+    buckets[bucket(k ^ last)].push_back(std::make_pair(key,node));
+    ++size;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+const DijkstraHeapItem & DijkstraRadixHeap::top()
+{
+    assert(size>0);
+    if(buckets[0].empty())
+    {
+        // find the first non empty bucket, make its minimum the new
+        // reference key, and redistribute its items in lower buckets
+        uint i = 1;
+        while(buckets[i].empty()) ++i;
+        last = to_bits(buckets[i].front().first);
+        for(const auto & item : buckets[i]) last = std::min(last, to_bits(item.first));
+        for(const auto & item : buckets[i])
+        {
+            uint64_t k = std::max(to_bits(item.first), last);
+            buckets[bucket(k ^ last)].push_back(item);
+        }
+        buckets[i].clear();
+    }
+    return buckets[0].back();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void DijkstraRadixHeap::pop()
+{
+    top();
+    buckets[0].pop_back();
+    --size;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void DijkstraEngine::resize(Side & s, const uint n_nodes)
+{
+    if(s.dist.size()>=n_nodes) return;
+    s.dist.resize(n_nodes);
+    s.prev.resize(n_nodes);
+    s.stamp.resize(n_nodes, 0);
+    s.settled.resize(n_nodes, 0);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void DijkstraEngine::new_epoch(const uint n_nodes)
+{
+    resize(fwd, n_nodes);
+    if(is_target.size()<n_nodes) is_target.resize(n_nodes, 0);
+    this->n_nodes = n_nodes;
+    n_settled     = 0;
+
+    // on overflow all stamps must be actually cleared (once every 2^32 searches)
+    if(++epoch==0)
+    {
+        for(Side *s : {&fwd, &bwd})
+        {
+            std::fill(s->stamp.begin(),   s->stamp.end(),   0);
+            std::fill(s->settled.begin(), s->settled.end(), 0);
+        }
+        std::fill(is_target.begin(), is_target.end(), 0);
+        epoch = 1;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Nbrs>
+CINO_INLINE
+int DijkstraEngine::search(const uint                n_nodes,
+                           const std::vector<uint> & sources,
+                           const Nbrs              & nbrs,
+                           const std::vector<uint> & targets,
+                           const double              max_dist)
+{
+    new_epoch(n_nodes);
+    for(uint vid : targets) is_target.at(vid) = epoch;
+    bool has_targets = !targets.empty();
+
+    auto visit = [](const uint) { return true; };
+    switch(heap_type)
+    {
+        case DIJKSTRA_4ARY_HEAP:  return run(quad_heap[0],  sources, nbrs, has_targets, max_dist, visit);
+        case DIJKSTRA_RADIX_HEAP: return run(radix_heap[0], sources, nbrs, has_targets, max_dist, visit);
+        default:                  return run(bin_heap[0],   sources, nbrs, has_targets, max_dist, visit);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Nbrs, class Visit>
+CINO_INLINE
+bool DijkstraEngine::search_visit(const uint                n_nodes,
+                                  const std::vector<uint> & sources,
+                                  const Nbrs              & nbrs,
+                                  const Visit             & visit)
+{
+    new_epoch(n_nodes);
+
+    // run() returns the first target settled, or -1. Here the only "target"
+    // is the node for which visit returned false
+    switch(heap_type)
+    {
+        case DIJKSTRA_4ARY_HEAP:  return run(quad_heap[0],  sources, nbrs, false, inf_double, visit) < 0;
+        case DIJKSTRA_RADIX_HEAP: return run(radix_heap[0], sources, nbrs, false, inf_double, visit) < 0;
+        default:                  return run(bin_heap[0],   sources, nbrs, false, inf_double, visit) < 0;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Heap, class Nbrs, class Visit>
+CINO_INLINE
+int DijkstraEngine::run(Heap & q, const std::vector<uint> & sources, const Nbrs & nbrs, const bool has_targets, const double max_dist, const Visit & visit)
+{
+    q.clear();
+    for(uint vid : sources)
+    {
+        assert(vid<n_nodes);
+        fwd.dist[vid]  = 0.0;
+        fwd.prev[vid]  = -1;
+        fwd.stamp[vid] = epoch;
+        q.push(0.0, vid);
+    }
+
+    while(!q.empty())
+    {
+        DijkstraHeapItem item = q.top();
+        q.pop();
+
+        uint vid = item.second;
+        if(fwd.settled[vid]==epoch) continue; // dead copy
+        if(item.first>max_dist) break;
+        fwd.settled[vid] = epoch;
+        ++n_settled;
+
+        if(has_targets && is_target[vid]==epoch) return vid;
+        if(!visit(vid)) return vid;
+
+        double d = fwd.dist[vid];
+        arcs.clear();
+        nbrs(vid, arcs);
+        for(const DijkstraArc & a : arcs)
+        {
+            uint   nbr      = a.first;
+            double new_dist = d + a.second;
+            assert(nbr<n_nodes && a.second>=0);
+            if(fwd.stamp[nbr]!=epoch || fwd.dist[nbr]>new_dist)
+            {
+                fwd.dist[nbr]  = new_dist;
+                fwd.prev[nbr]  = vid;
+                fwd.stamp[nbr] = epoch;
+                q.push(new_dist, nbr);
+            }
+        }
+    }
+    return -1;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Nbrs, class Heuristic>
+CINO_INLINE
+bool DijkstraEngine::search_astar(const uint        n_nodes,
+                                  const uint        source,
+                                  const uint        target,
+                                  const Nbrs      & nbrs,
+                                  const Heuristic & h)
+{
+    new_epoch(n_nodes);
+
+    switch(heap_type)
+    {
+        case DIJKSTRA_4ARY_HEAP:  return run_astar(quad_heap[0],  source, target, nbrs, h);
+        case DIJKSTRA_RADIX_HEAP: return run_astar(radix_heap[0], source, target, nbrs, h);
+        default:                  return run_astar(bin_heap[0],   source, target, nbrs, h);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Heap, class Nbrs, class Heuristic>
+CINO_INLINE
+bool DijkstraEngine::run_astar(Heap & q, const uint source, const uint target, const Nbrs & nbrs, const Heuristic & h)
+{
+    assert(source<n_nodes && target<n_nodes);
+
+    q.clear();
+    fwd.dist[source]  = 0.0;
+    fwd.prev[source]  = -1;
+    fwd.stamp[source] = epoch;
+    q.push(h(source), source);
+
+    while(!q.empty())
+    {
+        uint vid = q.top().second;
+        q.pop();
+
+        if(fwd.settled[vid]==epoch) continue; // dead copy
+        fwd.settled[vid] = epoch;
+        ++n_settled;
+
+        if(vid==target) return true;
+
+        double d = fwd.dist[vid];
+        arcs.clear();
+        nbrs(vid, arcs);
+        for(const DijkstraArc & a : arcs)
+        {
+            uint   nbr      = a.first;
+            double new_dist = d + a.second;
+            assert(nbr<n_nodes && a.second>=0);
+            if(fwd.stamp[nbr]!=epoch || fwd.dist[nbr]>new_dist)
+            {
+                fwd.dist[nbr]  = new_dist;
+                fwd.prev[nbr]  = vid;
+                fwd.stamp[nbr] = epoch;
+                q.push(new_dist + h(nbr), nbr);
+            }
+        }
+    }
+    return false;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Nbrs>
+CINO_INLINE
+double DijkstraEngine::search_bidirectional(const uint          n_nodes,
+                                            const uint          source,
+                                            const uint          target,
+                                            const Nbrs        & nbrs,
+                                            std::vector<uint> & path)
+{
+    new_epoch(n_nodes);
+    resize(bwd, n_nodes);
+
+    switch(heap_type)
+    {
+        case DIJKSTRA_4ARY_HEAP:  return run_bidirectional(quad_heap[0],  quad_heap[1],  source, target, nbrs, path);
+        case DIJKSTRA_RADIX_HEAP: return run_bidirectional(radix_heap[0], radix_heap[1], source, target, nbrs, path);
+        default:                  return run_bidirectional(bin_heap[0],   bin_heap[1],   source, target, nbrs, path);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Heap, class Nbrs>
+CINO_INLINE
+double DijkstraEngine::run_bidirectional(Heap & qf, Heap & qb, const uint source, const uint target, const Nbrs & nbrs, std::vector<uint> & path)
+{
+    assert(source<n_nodes && target<n_nodes);
+    path.clear();
+
+    qf.clear();
+    qb.clear();
+    fwd.dist[source]  = 0.0;
+    fwd.prev[source]  = -1;
+    fwd.stamp[source] = epoch;
+    bwd.dist[target]  = 0.0;
+    bwd.prev[target]  = -1;
+    bwd.stamp[target] = epoch;
+    qf.push(0.0, source);
+    qb.push(0.0, target);
+
+    double mu   = (source==target) ? 0.0 : inf_double; // length of the best path found so far
+    int    meet = (source==target) ? int(source) : -1; // node where the two searches met along it
+
+    // expand the side with the smallest tentative distance, and stop as soon as no
+    // path shorter than the best one found so far can exist
+    while(!qf.empty() && !qb.empty() && qf.top().first + qb.top().first < mu)
+    {
+        bool   forward = qf.top().first <= qb.top().first;
+        Heap & q       = forward ? qf  : qb;
+        Side & s       = forward ? fwd : bwd;
+        Side & o       = forward ? bwd : fwd;
+
+        uint vid = q.top().second;
+        q.pop();
+
+        if(s.settled[vid]==epoch) continue; // dead copy
+        s.settled[vid] = epoch;
+        ++n_settled;
+
+        double d = s.dist[vid];
+        arcs.clear();
+        nbrs(vid, arcs);
+        for(const DijkstraArc & a : arcs)
+        {
+            uint   nbr      = a.first;
+            double new_dist = d + a.second;
+            assert(nbr<n_nodes && a.second>=0);
+            if(s.stamp[nbr]!=epoch || s.dist[nbr]>new_dist)
+            {
+                s.dist[nbr]  = new_dist;
+                s.prev[nbr]  = vid;
+                s.stamp[nbr] = epoch;
+                q.push(new_dist, nbr);
+            }
+            if(o.stamp[nbr]==epoch && s.dist[nbr] + o.dist[nbr] < mu)
+            {
+                mu   = s.dist[nbr] + o.dist[nbr];
+                meet = nbr;
+            }
+        }
+    }
+
+    if(meet<0) return inf_double;
+
+    for(int tmp=meet; tmp!=-1; tmp=fwd.prev[tmp]) path.push_back(tmp);
+    std::reverse(path.begin(), path.end());
+    for(int tmp=bwd.prev[meet]; tmp!=-1; tmp=bwd.prev[tmp]) path.push_back(tmp);
+    return mu;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void DijkstraEngine::path_to(const uint node, std::vector<uint> & path) const
+{
+    path.clear();
+    if(!reached(node)) return;
+    for(int tmp=node; tmp!=-1; tmp=fwd.prev[tmp]) path.push_back(tmp);
+    std::reverse(path.begin(), path.end());
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void DijkstraEngine::copy_dist(std::vector<double> & dist) const
+{
+    dist.resize(n_nodes);
+    for(uint vid=0; vid<n_nodes; ++vid)
+    {
+        dist[vid] = (fwd.stamp[vid]==epoch) ? fwd.dist[vid] : inf_double;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+DijkstraEngine & dijkstra_thread_engine()
+{
+    static thread_local DijkstraEngine engine;
+    return engine;
+}
+
+}
@@ -0,0 +1,245 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_DIJKSTRA_ENGINE_H
+#define CINO_DIJKSTRA_ENGINE_H
+
+#include <vector>
+#include <stdint.h>
+#include <sys/types.h>
+#include <cinolib/cino_inline.h>
+#include <cinolib/min_max_inf.h>
+
+namespace cinolib
+{
+
+enum
+{
+    DIJKSTRA_BINARY_HEAP, // default
+    DIJKSTRA_4ARY_HEAP,
+    DIJKSTRA_RADIX_HEAP,
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* Priority queues used by the DijkstraEngine. None of them supports priority
+ * update: each time the distance of a node decreases a new copy of it is pushed,
+ * and "dead" copies are discarded by the engine as they are popped (lazy deletion).
+ * Keys must be non negative.
+ *
+ * The radix heap is a monotone priority queue (keys pushed must not be smaller than
+ * the last key popped), which is always true for Dijkstra and for A* with consistent
+ * heuristics. Keys are bucketed according to the most significant bit in which they
+ * differ from the last popped key, comparing the IEEE 754 representation of doubles
+ * (which preserves order for non negative values). See:
+ *
+ *   Faster Algorithms for the Shortest Path Problem
+ *   R.K. Ahuja, K. Mehlhorn, J.B. Orlin, R.E. Tarjan
+ *   Journal of the ACM, 1990
+*/
+
+typedef std::pair<double,uint> DijkstraHeapItem; // (key, node)
+typedef std::pair<uint,double> DijkstraArc;      // (nbr, weight)
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<uint D>
+class DijkstraDaryHeap
+{
+    public:
+
+        bool empty() const { return items.empty(); }
+        void clear()       { items.clear(); }
+
+        void push(const double key, const uint node);
+        void pop();
+        const DijkstraHeapItem & top() const { return items.front(); }
+
+    protected:
+
+        std::vector<DijkstraHeapItem> items;
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+class DijkstraRadixHeap
+{
+    public:
+
+        bool empty() const { return size==0; }
+        void clear();
+
+        void push(const double key, const uint node);
+        void pop();
+        const DijkstraHeapItem & top();
+
+    protected:
+
+        static uint64_t to_bits(const double key);
+        static uint     bucket (const uint64_t x);
+
+        std::vector<DijkstraHeapItem> buckets[65];
+        uint64_t                      last = 0;
+        uint                          size = 0;
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* Reusable Dijkstra solver for generic graphs with non negative arc weights.
+ * All per node buffers (distances, predecessors, visit flags) are allocated once,
+ * and are reset in constant time at each new search by bumping an epoch counter:
+ * an entry is valid only if its stamp matches the current epoch. Repeated queries
+ * on the same graph (even early terminated ones) therefore cost only the portion
+ * of the graph they actually visit.
+ *
+ * The graph is given as a functor nbrs(node,arcs) that must append to arcs a pair
+ * (nbr,w) for each arc (node->nbr) of weight w. The arcs buffer is owned (and cleared)
+ * by the engine, and the engine is templated on the functor, so that the inner loop
+ * is inlined. Arcs that cannot be traversed (e.g. masked edges) are just not listed.
+ *
+ * An engine must not be shared between concurrent searches. The dijkstra_* free
+ * functions in dijkstra.h use one engine per thread.
+*/
+class DijkstraEngine
+{
+    public:
+
+        explicit DijkstraEngine(const int heap_type = DIJKSTRA_BINARY_HEAP) : heap_type(heap_type) {}
+
+        void set_heap(const int h) { heap_type = h; }
+        int  heap()          const { return heap_type; }
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // multi source search. It stops as soon as a node flagged as target is settled
+        // (returning it), or when all nodes within max_dist from the sources have been
+        // settled. Returns -1 if no target was reached
+        template<class Nbrs>
+        int search(const uint                n_nodes,
+                   const std::vector<uint> & sources,
+                   const Nbrs              & nbrs,
+                   const std::vector<uint> & targets  = {},
+                   const double              max_dist = inf_double);
+
+        // multi source search that calls visit(node) each time a node is settled (its
+        // distance being final). The search stops as soon as visit returns false, in
+        // which case false is returned. Useful to compute bounds on the fly
+        template<class Nbrs, class Visit>
+        bool search_visit(const uint                n_nodes,
+                          const std::vector<uint> & sources,
+                          const Nbrs              & nbrs,
+                          const Visit             & visit);
+
+        // point to point A*. The heuristic h(node) must be consistent (i.e. never
+        // overestimate the cost of an arc), e.g. the Euclidean distance to the target
+        // when arc weights are Euclidean lengths. Returns false if target is unreachable
+        template<class Nbrs, class Heuristic>
+        bool search_astar(const uint        n_nodes,
+                          const uint        source,
+                          const uint        target,
+                          const Nbrs      & nbrs,
+                          const Heuristic & h);
+
+        // point to point bidirectional search. Arc weights must be symmetric, as the
+        // same functor is used to expand the backward search from the target. Returns
+        // the distance between source and target (inf_double if they are disconnected).
+        // The path is stored in path, dist/prev queries refer only to the forward search
+        template<class Nbrs>
+        double search_bidirectional(const uint          n_nodes,
+                                    const uint          source,
+                                    const uint          target,
+                                    const Nbrs        & nbrs,
+                                    std::vector<uint> & path);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // results of the last search
+        bool   reached(const uint node) const { return fwd.stamp.at(node)==epoch; }
+        bool   settled(const uint node) const { return fwd.settled.at(node)==epoch; }
+        double dist   (const uint node) const { return reached(node) ? fwd.dist.at(node) : inf_double; }
+        int    prev   (const uint node) const { return reached(node) ? fwd.prev.at(node) : -1; }
+        void   path_to(const uint node, std::vector<uint> & path) const; // from the closest source to node
+        void   copy_dist(std::vector<double> & dist) const;              // inf_double for unreached nodes
+        uint   num_settled() const { return n_settled; }
+
+    protected:
+
+        struct Side
+        {
+            std::vector<double> dist;
+            std::vector<int>    prev;
+            std::vector<uint>   stamp;   // dist/prev are valid only if stamp==epoch
+            std::vector<uint>   settled; // node is settled if settled==epoch
+        };
+
+        void new_epoch(const uint n_nodes);
+        void resize(Side & s, const uint n_nodes);
+
+        template<class Heap, class Nbrs, class Visit>
+        int run(Heap & q, const std::vector<uint> & sources, const Nbrs & nbrs, const bool has_targets, const double max_dist, const Visit & visit);
+
+        template<class Heap, class Nbrs, class Heuristic>
+        bool run_astar(Heap & q, const uint source, const uint target, const Nbrs & nbrs, const Heuristic & h);
+
+        template<class Heap, class Nbrs>
+        double run_bidirectional(Heap & qf, Heap & qb, const uint source, const uint target, const Nbrs & nbrs, std::vector<uint> & path);
+
+        int                      heap_type;
+        uint                     epoch     = 0;
+        uint                     n_nodes   = 0;
+        uint                     n_settled = 0;
+        Side                     fwd, bwd;
+        std::vector<uint>        is_target; // node is a target if is_target==epoch
+        std::vector<DijkstraArc> arcs;      // neighbors of the node being expanded
+
+        // one per direction (only the first is used by one directional searches)
+        DijkstraDaryHeap<2>      bin_heap[2];
+        DijkstraDaryHeap<4>      quad_heap[2];
+        DijkstraRadixHeap        radix_heap[2];
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// engine owned by the calling thread (each thread has its own)
+CINO_INLINE
+DijkstraEngine & dijkstra_thread_engine();
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "dijkstra_engine.cpp"
+#endif
+
+#endif // CINO_DIJKSTRA_ENGINE_H
@@ -52,10 +52,8 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 ScalarField divergence(const AbstractPolygonMesh<M,V,E,P> & m, ScalarField & f)
 {
-    Eigen::SparseMatrix<double> G    = gradient_matrix(m);
-    VectorField                 grad = G * f;
-    ScalarField                 div  = G.transpose() * grad;
-    return div;
+    SparseAssembler G;
+    return divergence(m, f, G);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -64,9 +62,31 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 ScalarField divergence(const AbstractPolyhedralMesh<M,V,E,F,P> & m, ScalarField & f)
 {
-    Eigen::SparseMatrix<double> G    = gradient_matrix(m);
-    VectorField                 grad = G * f;
-    ScalarField                 div  = G.transpose() * grad;
+    SparseAssembler G;
+    return divergence(m, f, G);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+ScalarField divergence(const AbstractPolygonMesh<M,V,E,P> & m, ScalarField & f, SparseAssembler & G)
+{
+    gradient_matrix(m, G);
+    VectorField grad = G.matrix() * f;
+    ScalarField div  = G.matrix().transpose() * grad;
+    return div;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+ScalarField divergence(const AbstractPolyhedralMesh<M,V,E,F,P> & m, ScalarField & f, SparseAssembler & G)
+{
+    gradient_matrix(m, G);
+    VectorField grad = G.matrix() * f;
+    ScalarField div  = G.matrix().transpose() * grad;
     return div;
 }
 
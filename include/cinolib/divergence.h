@@ -46,6 +46,7 @@
 
 #include <Eigen/Sparse>
 #include <cinolib/scalar_field.h>
+#include <cinolib/sparse_assembler.h>
 #include <cinolib/meshes/abstract_polyhedralmesh.h>
 #include <cinolib/meshes/abstract_polygonmesh.h>
 
@@ -78,6 +79,20 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 ScalarField divergence(const AbstractPolyhedralMesh<M,V,E,F,P> & m, ScalarField & f);
 
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// same as above, but the gradient matrix is assembled with (and stored in) G,
+// so that repeated calls on the same (possibly deforming) mesh only update its values
+template<class M, class V, class E, class P>
+CINO_INLINE
+ScalarField divergence(const AbstractPolygonMesh<M,V,E,P> & m, ScalarField & f, SparseAssembler & G);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+ScalarField divergence(const AbstractPolyhedralMesh<M,V,E,F,P> & m, ScalarField & f, SparseAssembler & G);
 }
 
 #ifndef  CINO_STATIC_LIB
@@ -44,6 +44,8 @@ CINO_INLINE
 DrawableIsosurface<M,V,E,F,P>::DrawableIsosurface() : Isosurface<M,V,E,F,P>()
 {
     color = Color::RED();
+    drawlist.draw_mode = DRAW_TRIS | DRAW_TRI_FLAT | DRAW_TRI_FACECOLOR;
+    updateGL();
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -54,6 +56,20 @@ DrawableIsosurface<M,V,E,F,P>::DrawableIsosurface(const Tetmesh<M,V,E,F,P> & m,
     : Isosurface<M,V,E,F,P>(m, iso_value)
 {
     color = Color::RED();
+    drawlist.draw_mode = DRAW_TRIS | DRAW_TRI_FLAT | DRAW_TRI_FACECOLOR;
+    updateGL();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+DrawableIsosurface<M,V,E,F,P>::DrawableIsosurface(const Isosurface<M,V,E,F,P> & iso)
+    : Isosurface<M,V,E,F,P>(iso)
+{
+    color = Color::RED();
+    drawlist.draw_mode = DRAW_TRIS | DRAW_TRI_FLAT | DRAW_TRI_FACECOLOR;
+    updateGL();
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -62,28 +78,34 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void DrawableIsosurface<M,V,E,F,P>::draw(const float) const
 {
-    glLightModeli(GL_LIGHT_MODEL_TWO_SIDE, GL_TRUE);
-    glDisable(GL_CULL_FACE);
-    glEnable(GL_LIGHTING);
-    glEnable(GL_COLOR_MATERIAL);
-    glShadeModel(GL_SMOOTH);
+    if(drawlist_color!=color) updateGL();
+    render(drawlist);
+}
 
-    for(uint i=0; i<this->tris.size(); i+=3)
-    {
-        uint vid0 = this->tris[i+0];
-        uint vid1 = this->tris[i+1];
-        uint vid2 = this->tris[i+2];
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-        glBegin(GL_TRIANGLES);
-        glColor3fv(color.rgba);
-        glNormal3dv(this->norms.at(i/3).ptr());
-        glVertex3dv(this->verts.at(vid0).ptr());
-        glVertex3dv(this->verts.at(vid1).ptr());
-        glVertex3dv(this->verts.at(vid2).ptr());
-        glEnd();
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void DrawableIsosurface<M,V,E,F,P>::updateGL() const
+{
+    uint n_tris = this->tris.size()/3;
+    render_data_resize(drawlist, n_tris, 0);
+    for(uint i=0; i<3*n_tris; ++i)
+    {
+        const vec3d & p = this->verts.at(this->tris.at(i));
+        const vec3d & n = this->norms.at(i/3);
+        drawlist.tri_coords  [3*i  ] = p.x();
+        drawlist.tri_coords  [3*i+1] = p.y();
+        drawlist.tri_coords  [3*i+2] = p.z();
+        drawlist.tri_v_norms [3*i  ] = n.x();
+        drawlist.tri_v_norms [3*i+1] = n.y();
+        drawlist.tri_v_norms [3*i+2] = n.z();
+        drawlist.tri_v_colors[4*i  ] = color.r;
+        drawlist.tri_v_colors[4*i+1] = color.g;
+        drawlist.tri_v_colors[4*i+2] = color.b;
+        drawlist.tri_v_colors[4*i+3] = color.a;
     }
-
-    glColor3f(1.0,1.0,1.0);
+    drawlist_color = color;
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -40,6 +40,7 @@
 #include <cinolib/geometry/vec_mat.h>
 #include <cinolib/isosurface.h>
 #include <cinolib/meshes/tetmesh.h>
+#include <cinolib/gl/draw_lines_tris.h>
 #include <cinolib/color.h>
 
 namespace cinolib
@@ -56,6 +57,7 @@ class DrawableIsosurface : public Isosurface<M,V,E,F,P>, public DrawableObject
 
         explicit DrawableIsosurface();
         explicit DrawableIsosurface(const Tetmesh<M,V,E,F,P> & m, const double iso_value);
+        explicit DrawableIsosurface(const Isosurface<M,V,E,F,P> & iso); // e.g. from Isosurface::extract
 
         ~DrawableIsosurface(){}
 
@@ -66,6 +68,17 @@ class DrawableIsosurface : public Isosurface<M,V,E,F,P>, public DrawableObject
         float      scene_radius() const;
         ObjectType object_type()  const { return DRAWABLE_ISOSURFACE; }
         Color      color;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // regenerates rendering data. Color changes are detected at
+        // rendering time, call this only after editing the surface
+        void updateGL() const;
+
+    private:
+
+        mutable RenderData drawlist;
+        mutable Color      drawlist_color; // color currently stored in the drawlist
 };
 
 }
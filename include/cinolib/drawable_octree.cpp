@@ -35,14 +35,6 @@
 *********************************************************************************/
 #include "drawable_octree.h"
 
-#ifdef __APPLE__
-#include <gl.h>
-#include <glu.h>
-#else
-#include <GL/gl.h>
-#include <GL/glu.h>
-#endif
-
 namespace cinolib
 {
 
@@ -51,6 +43,7 @@ DrawableOctree::DrawableOctree(const uint max_depth,
                                   const uint items_per_leaf)
 : Octree(max_depth, items_per_leaf)
 {
+    drawlist.draw_mode = DRAW_SEGS;
     updateGL();
 }
 
@@ -59,7 +52,7 @@ DrawableOctree::DrawableOctree(const uint max_depth,
 CINO_INLINE
 void DrawableOctree::draw(const float ) const
 {
-    for(auto obj : render_list) obj.draw();
+    render_segs(drawlist);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -85,9 +78,11 @@ float DrawableOctree::scene_radius() const
 CINO_INLINE
 void DrawableOctree::updateGL()
 {
-    render_list.clear();
-    if(this->root==nullptr) return;
-    updateGL(this->root);
+    drawlist.segs.clear();
+    drawlist.seg_coords.clear();
+    drawlist.seg_colors.clear();
+    if(this->root!=nullptr) updateGL(this->root);
+    render_data_changed(drawlist);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -95,7 +90,7 @@ void DrawableOctree::updateGL()
 CINO_INLINE
 void DrawableOctree::updateGL(const OctreeNode *node)
 {
-    render_list.push_back(DrawableAABB(node->bbox.min, node->bbox.max));
+    push_aabb_segs(drawlist, node->bbox, color);
     if(node->is_inner)
     {
         assert(node->item_indices.empty());
@@ -108,7 +103,15 @@ void DrawableOctree::updateGL(const OctreeNode *node)
 CINO_INLINE
 void DrawableOctree::set_color(const Color & c)
 {
-    for(auto & obj : render_list) obj.set_color(c);
+    color = c;
+    for(uint i=0; i<drawlist.seg_colors.size(); i+=4)
+    {
+        drawlist.seg_colors[i  ] = c.r;
+        drawlist.seg_colors[i+1] = c.g;
+        drawlist.seg_colors[i+2] = c.b;
+        drawlist.seg_colors[i+3] = c.a;
+    }
+    render_data_changed(drawlist);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -116,7 +119,7 @@ void DrawableOctree::set_color(const Color & c)
 CINO_INLINE
 void DrawableOctree::set_thickness(float t)
 {
-    for(auto & obj : render_list) obj.set_thickness(t);
+    drawlist.seg_width = t;
 }
 
 }
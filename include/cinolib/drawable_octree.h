@@ -74,7 +74,8 @@ class DrawableOctree : public Octree, public DrawableObject
 
     private:
 
-        std::vector<DrawableAABB> render_list;
+        RenderData drawlist;
+        Color      color = Color::BLACK();
 };
 
 }
@@ -50,6 +50,7 @@ DrawableSegmentSoup::DrawableSegmentSoup()
     thickness     = 1.0;
     use_gl_lines  = false;
     no_depth_test = false;
+    drawlist.draw_mode = DRAW_SEGS;
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -75,23 +76,8 @@ void DrawableSegmentSoup::draw(const float scene_size) const
     }
     else
     {
-        glLineWidth(thickness);
-        glEnable(GL_LINE_SMOOTH);
-        glHint(GL_LINE_SMOOTH_HINT,  GL_NICEST);
-        glDisable(GL_LIGHTING);
-        glColor3fv(color.rgba);
-        for(uint i=0; i<size()/2; ++i)
-        {
-            vec3d a = at(2*i+0);
-            vec3d b = at(2*i+1);
-            glBegin(GL_LINES);
-                glVertex3d(a.x(), a.y(), a.z());
-                glVertex3d(b.x(), b.y(), b.z());
-            glEnd();
-        }
-        glColor3f(0,0,0);
-        glEnable(GL_LIGHTING);
-        glDisable(GL_LINE_SMOOTH);
+        if(drawlist.segs.size() != size()/2*2) updateGL();
+        render_segs(drawlist);
     }
 
     if(no_depth_test) glEnable(GL_DEPTH_TEST);
@@ -99,6 +85,25 @@ void DrawableSegmentSoup::draw(const float scene_size) const
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+CINO_INLINE
+void DrawableSegmentSoup::updateGL() const
+{
+    uint n = size()/2*2;
+    render_data_resize(drawlist, 0, n/2);
+    for(uint i=0; i<n; ++i)
+    {
+        drawlist.seg_coords[3*i  ] = at(i).x();
+        drawlist.seg_coords[3*i+1] = at(i).y();
+        drawlist.seg_coords[3*i+2] = at(i).z();
+        drawlist.seg_colors[4*i  ] = color.r;
+        drawlist.seg_colors[4*i+1] = color.g;
+        drawlist.seg_colors[4*i+2] = color.b;
+        drawlist.seg_colors[4*i+3] = color.a;
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 CINO_INLINE
 void DrawableSegmentSoup::push_seg(const vec3d v0, const vec3d v1)
 {
@@ -138,6 +143,7 @@ CINO_INLINE
 void DrawableSegmentSoup::set_color(const Color & c)
 {
     color = c;
+    updateGL();
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -146,6 +152,7 @@ CINO_INLINE
 void DrawableSegmentSoup::set_thickness(float t)
 {
     thickness = t;
+    drawlist.seg_width = t;
 }
 
 }
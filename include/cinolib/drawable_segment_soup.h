@@ -39,6 +39,7 @@
 #include <vector>
 #include <cinolib/geometry/vec_mat.h>
 #include <cinolib/drawable_object.h>
+#include <cinolib/gl/draw_lines_tris.h>
 #include <cinolib/color.h>
 
 
@@ -81,6 +82,10 @@ class DrawableSegmentSoup: public std::vector<vec3d>, public DrawableObject
         void push_seg(const vec3d v0, const vec3d v1);
         void pop_seg();
 
+        // regenerates rendering data. Segments added or removed are detected
+        // at rendering time, call this only after moving existing endpoints
+        void updateGL() const;
+
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
         void set_color          (const Color & c);
@@ -96,6 +101,8 @@ class DrawableSegmentSoup: public std::vector<vec3d>, public DrawableObject
         bool  use_gl_lines;  // to speedup rendering (when lots of segments are to be rendered)
         Color color;
         float thickness;
+
+        mutable RenderData drawlist; // used for cheap rendering (GL lines)
 };
 
 }
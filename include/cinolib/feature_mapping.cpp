@@ -35,7 +35,6 @@
 *********************************************************************************/
 #include <cinolib/feature_mapping.h>
 #include <cinolib/feature_network.h>
-#include <cinolib/octree.h>
 #include <cinolib/clamp.h>
 #include <cinolib/dijkstra.h>
 #include <cinolib/export_surface.h>
@@ -45,7 +44,8 @@ namespace cinolib
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-template<class M1, class V1, class E1, class P1,
+template<class SpatialIndex,
+         class M1, class V1, class E1, class P1,
          class M2, class V2, class E2, class P2>
 CINO_INLINE
 bool feature_mapping(const AbstractPolygonMesh<M1,V1,E1,P1> & m_source,
@@ -56,7 +56,7 @@ bool feature_mapping(const AbstractPolygonMesh<M1,V1,E1,P1> & m_source,
     std::vector<std::vector<uint>> f_source, f_target;
     feature_network(m_source, f_source);
 
-    feature_mapping(m_source, f_source, m_target, f_target);
+    feature_mapping<SpatialIndex>(m_source, f_source, m_target, f_target);
 
     for(auto f : f_target)
     {
@@ -73,7 +73,8 @@ bool feature_mapping(const AbstractPolygonMesh<M1,V1,E1,P1> & m_source,
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-template<class M1, class V1, class E1, class P1,
+template<class SpatialIndex,
+         class M1, class V1, class E1, class P1,
          class M2, class V2, class E2, class P2>
 CINO_INLINE
 bool feature_mapping(const AbstractPolygonMesh<M1,V1,E1,P1> & m_source,
@@ -87,7 +88,7 @@ bool feature_mapping(const AbstractPolygonMesh<M1,V1,E1,P1> & m_source,
 
     // STEP 1: map corners from source to target
 
-    Octree o_corners;
+    SpatialIndex o_corners;
     for(uint vid=0; vid<m_target.num_verts(); ++vid)
     {
         o_corners.push_point(vid, m_target.vert(vid));
@@ -107,7 +108,7 @@ bool feature_mapping(const AbstractPolygonMesh<M1,V1,E1,P1> & m_source,
     }
 
     // STEP 2: map curves
-    Octree o_curves;
+    SpatialIndex o_curves;
     o_curves.build_from_mesh_polys(m_target);
     double L = m_target.edge_avg_length();
     std::vector<bool> mask(m_target.num_verts(),false);
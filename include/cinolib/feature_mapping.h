@@ -37,6 +37,7 @@
 #define CINO_FEATURE_MAPPING_H
 
 #include <cinolib/meshes/meshes.h>
+#include <cinolib/octree.h>
 
 namespace cinolib
 {
@@ -56,9 +57,12 @@ namespace cinolib
  * WARNING: the algorithm does not guarantee that ALL the input curves will be mapped. Edge conflicts
  * during the shortest path tracing may arise. The method returns true if all input features have been
  * sucecssfully mapped, false otherwise.
+ *
+ * SpatialIndex is the data structure used for closest point queries (e.g. Octree or BVH)
 */
 
-template<class M1, class V1, class E1, class P1,
+template<class SpatialIndex = Octree,
+         class M1, class V1, class E1, class P1,
          class M2, class V2, class E2, class P2>
 CINO_INLINE
 bool feature_mapping(const AbstractPolygonMesh<M1,V1,E1,P1> & m_source,
@@ -68,7 +72,8 @@ bool feature_mapping(const AbstractPolygonMesh<M1,V1,E1,P1> & m_source,
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-template<class M1, class V1, class E1, class P1,
+template<class SpatialIndex = Octree,
+         class M1, class V1, class E1, class P1,
          class M2, class V2, class E2, class P2>
 CINO_INLINE
 bool feature_mapping(const AbstractPolygonMesh<M1,V1,E1,P1> & m_source,
@@ -35,19 +35,122 @@
 *********************************************************************************/
 #include <cinolib/find_intersections.h>
 #include <cinolib/parallel_for.h>
-#include <cinolib/octree.h>
-#include <mutex>
+#include <cinolib/predicates.h>
+#include <cinolib/bvh.h>
+#include <algorithm>
+#include <atomic>
 
 namespace cinolib
 {
 
+// returns true if triangles tid0 and tid1 intersect in a non conforming way. Triangles
+// sharing an edge can only do so if they are coplanar, and are rejected with a single
+// orient3d. All other cases are handled by triangle_triangle_intersect_3d
+static CINO_INLINE bool tris_intersect(const std::vector<vec3d> & verts,
+                                       const std::vector<uint>  & tris,
+                                       const uint                 tid0,
+                                       const uint                 tid1)
+{
+    const uint *t0 = &tris[3*tid0];
+    const uint *t1 = &tris[3*tid1];
+
+    uint n_shared = 0;
+    uint opp1     = 0;
+    for(int i=0; i<3; ++i)
+    {
+        if(t1[i]==t0[0] || t1[i]==t0[1] || t1[i]==t0[2]) ++n_shared; else opp1 = t1[i];
+    }
+    if(n_shared==3) return false;
+    if(n_shared==2 && orient3d(verts[t0[0]], verts[t0[1]], verts[t0[2]], verts[opp1])!=0) return false;
+
+    return triangle_triangle_intersect_3d(verts[t0[0]], verts[t0[1]], verts[t0[2]],
+                                          verts[t1[0]], verts[t1[1]], verts[t1[2]]) > SIMPLICIAL_COMPLEX;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// shared by all the find_intersections variants. If first_only is true, all
+// tasks stop as soon as one of them finds an intersection. If tri2poly is
+// given, pairs of triangles coming from the same polygon are not tested
+static CINO_INLINE void find_intersections(const std::vector<vec3d> & verts,
+                                           const std::vector<uint>  & tris,
+                                                 std::vector<ipair> & intersections,
+                                           const bool                 first_only,
+                                           const std::vector<uint>  * tri2poly = nullptr)
+{
+    intersections.clear();
+    if(tris.empty()) return;
+
+    BVH bvh;
+    bvh.build_from_vectors(verts, tris);
+
+    std::vector<ipair> tasks;
+    bvh.self_overlap_tasks(tasks);
+
+    std::vector<std::vector<ipair>> found(tasks.size());
+    std::atomic<bool> stop(false);
+    PARALLEL_FOR(0, tasks.size(), 2, SCHEDULE_DYNAMIC, 1, [&](const uint i)
+    {
+        if(stop.load(std::memory_order_relaxed)) return;
+        bvh.self_overlap(tasks.at(i), [&](const uint tid0, const uint tid1)
+        {
+            if(tri2poly!=nullptr && tri2poly->at(tid0)==tri2poly->at(tid1)) return true;
+            if(tris_intersect(verts, tris, tid0, tid1))
+            {
+                found.at(i).push_back(unique_pair(tid0,tid1));
+                if(first_only) stop = true;
+            }
+            return !(first_only && stop.load(std::memory_order_relaxed));
+        });
+    });
+
+    size_t n = 0;
+    for(const auto & f : found) n += f.size();
+    intersections.reserve(n);
+    for(const auto & f : found) intersections.insert(intersections.end(), f.begin(), f.end());
+    std::sort(intersections.begin(), intersections.end());
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// triangulates the polygons of m, keeping track of which polygon each triangle comes from
+template<class M, class V, class E, class P>
+CINO_INLINE
+void find_intersections(const AbstractPolygonMesh<M,V,E,P> & m,
+                              std::vector<ipair>           & intersections,
+                        const bool                           first_only)
+{
+    std::vector<uint> tris, tri2poly;
+    for(uint pid=0; pid<m.num_polys(); ++pid)
+    {
+        const std::vector<uint> & tess = m.poly_tessellation(pid);
+        tris.insert(tris.end(), tess.begin(), tess.end());
+        tri2poly.insert(tri2poly.end(), tess.size()/3, pid);
+    }
+
+    std::vector<ipair> tri_pairs;
+    find_intersections(m.vector_verts(), tris, tri_pairs, first_only, &tri2poly);
+
+    intersections.clear();
+    for(const ipair & p : tri_pairs)
+    {
+        intersections.push_back(unique_pair(tri2poly.at(p.first), tri2poly.at(p.second)));
+    }
+    std::sort(intersections.begin(), intersections.end());
+    intersections.erase(std::unique(intersections.begin(), intersections.end()), intersections.end());
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class P>
 CINO_INLINE
-void find_intersections(const Trimesh<M,V,E,P> & m,
-                              std::set<ipair>  & intersections)
+void find_intersections(const AbstractPolygonMesh<M,V,E,P> & m,
+                        std::set<ipair>                    & intersections)
 {
-    auto tris = serialized_vids_from_polys(m.vector_polys());
-    find_intersections(m.vector_verts(), tris, intersections);
+    std::vector<ipair> tmp;
+    find_intersections(m, tmp, false);
+    intersections.clear();
+    intersections.insert(tmp.begin(), tmp.end());
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -57,33 +160,48 @@ void find_intersections(const std::vector<vec3d> & verts,
                         const std::vector<uint>  & tris,
                               std::set<ipair>    & intersections)
 {
-    Octree o(8,1000); // max 1000 elements per leaf, depth permitting
-    o.build_from_vectors(verts, tris);
-
-    std::mutex mutex;
-    PARALLEL_FOR(0, o.leaves.size(), 1, [&](uint i)
-    {        
-        auto & leaf = o.leaves.at(i);
-        if(leaf->item_indices.empty()) return;
-        for(uint j=0;   j<leaf->item_indices.size()-1; ++j)
-        for(uint k=j+1; k<leaf->item_indices.size();   ++k)
-        {
-            uint tid0 = leaf->item_indices.at(j);
-            uint tid1 = leaf->item_indices.at(k);
-            auto T0 = o.items.at(tid0);
-            auto T1 = o.items.at(tid1);
-            if(T0->aabb.intersects_box(T1->aabb)) // early reject based on AABB intersection
-            {
-                const Triangle *t0 = dynamic_cast<Triangle*>(T0);
-                const Triangle *t1 = dynamic_cast<Triangle*>(T1);
-                if(t0->intersects_triangle(t1->v,true)) // precise check (exact if CINOLIB_USES_EXACT_PREDICATES is defined)
-                {
-                    std::lock_guard<std::mutex> guard(mutex);
-                    intersections.insert(unique_pair(tid0,tid1));
-                }
-            }
-        }
-    });
+    std::vector<ipair> tmp;
+    find_intersections(verts, tris, tmp, false);
+    intersections.clear();
+    intersections.insert(tmp.begin(), tmp.end());
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void find_intersections(const std::vector<vec3d> & verts,
+                        const std::vector<uint>  & tris,
+                              std::vector<ipair> & intersections)
+{
+    find_intersections(verts, tris, intersections, false);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+bool find_first_intersection(const AbstractPolygonMesh<M,V,E,P> & m,
+                                   ipair                        & hit)
+{
+    std::vector<ipair> tmp;
+    find_intersections(m, tmp, true);
+    if(tmp.empty()) return false;
+    hit = tmp.front();
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool find_first_intersection(const std::vector<vec3d> & verts,
+                             const std::vector<uint>  & tris,
+                                   ipair              & hit)
+{
+    std::vector<ipair> tmp;
+    find_intersections(verts, tris, tmp, true);
+    if(tmp.empty()) return false;
+    hit = tmp.front();
+    return true;
 }
 
 }
@@ -38,18 +38,23 @@
 
 #include <cinolib/geometry/vec_mat.h>
 #include <cinolib/ipair.h>
+#include <cinolib/meshes/abstract_polygonmesh.h>
 #include <set>
 
 namespace cinolib
 {
 
-/* This method puts all the input polygons into an octree, then
- * performs pairwise intersection tests within each leaf, retunrning
- * a set of pairs of intersecting triangles.
+/* These methods find all pairs of polygons that intersect in a non conforming way,
+ * that is, without forming a valid simplicial complex.
  *
- * The output must be a set and not a vector because triangles will
- * appear in all the leaves that have non empty overlap with it. Therefore,
- * the same intersection can be detected multiple times.
+ * The broad phase traverses a BVH of the triangles against itself, visiting pairs
+ * of subtrees in parallel and gathering the results in per task buffers, which are
+ * merged at the end. Each candidate pair is found exactly once. Triangles that are
+ * topologically adjacent (i.e. share an edge) can only intersect if they are coplanar,
+ * and are skipped without running the full test otherwise.
+ *
+ * Polygonal meshes are handled through their triangulation. Intersections between
+ * triangles of the same polygon are not reported.
  *
  * IMPORTANT: intersections tests are based on the orient predicates contained
  * in cinolib/predicates.h. These predicates are exact if the symbol
@@ -68,6 +73,32 @@ void find_intersections(const std::vector<vec3d> & verts,
                         const std::vector<uint>  & tris,
                               std::set<ipair>    & intersections);
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// same as above, but returns a sorted vector of pairs (i,j) with i<j
+CINO_INLINE
+void find_intersections(const std::vector<vec3d> & verts,
+                        const std::vector<uint>  & tris,
+                              std::vector<ipair> & intersections);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// stops at the first intersection found, which is returned in hit (since
+// the search is parallel, it is not necessarily the same at each run).
+// Returns false if the mesh has no intersections
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+bool find_first_intersection(const AbstractPolygonMesh<M,V,E,P> & m,
+                                   ipair                        & hit);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool find_first_intersection(const std::vector<vec3d> & verts,
+                             const std::vector<uint>  & tris,
+                                   ipair              & hit);
+
 }
 
 #ifndef  CINO_STATIC_LIB
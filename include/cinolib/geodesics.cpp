@@ -39,6 +39,10 @@
 #include <cinolib/laplacian.h>
 #include <cinolib/vertex_mass.h>
 #include <cinolib/linear_solvers.h>
+#include <cinolib/parallel_for.h>
+#include <cinolib/io/read_CINO.h>
+#include <cinolib/io/write_CINO.h>
+#include <mutex>
 
 namespace cinolib
 {
@@ -51,7 +55,10 @@ ScalarField compute_geodesics(      Mesh              & m,
                               const float               time_scalar,
                               const bool                hard_constrain_charges)
 {
-    // optimize position and scale to get better numerical precision
+    // optimize position and scale to get better numerical precision. Original positions
+    // are restored exactly at the end. Positions change twice per call, hence an operator
+    // cache (see operator_cache.h) only saves the assembly of the sparsity patterns
+    std::vector<vec3d> verts = m.vector_verts();
     double d = m.bbox().diag();
     vec3d  c = m.bbox().center();
     m.translate(-c);
@@ -91,8 +98,9 @@ ScalarField compute_geodesics(      Mesh              & m,
     }
 
     // restore original scale and position
-    m.scale(d);
-    m.translate(c);
+    m.vector_verts() = verts;
+    m.mark_changed(CHANGES_VERT_POS);
+    if(m.mesh_data().update_bbox) m.update_bbox();
 
     geodesics.normalize_in_01();
     return geodesics;
@@ -100,6 +108,331 @@ ScalarField compute_geodesics(      Mesh              & m,
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+// FNV-1a hash of connectivity and vertex positions. Positions are hashed in single
+// precision, so that tiny perturbations (e.g. scaling the mesh back and forth) are ignored
+template<class Mesh>
+static CINO_INLINE
+uint64_t geodesics_mesh_hash(const Mesh & m)
+{
+    uint64_t h = 14695981039346656037ull;
+    auto add = [&h](const void * data, const size_t bytes)
+    {
+        const unsigned char *b = static_cast<const unsigned char*>(data);
+        for(size_t i=0; i<bytes; ++i)
+        {
+            h ^= b[i];
+            h *= 1099511628211ull;
+        }
+    };
+    for(uint vid=0; vid<m.num_verts(); ++vid)
+    {
+        float xyz[3] = { float(m.vert(vid).x()), float(m.vert(vid).y()), float(m.vert(vid).z()) };
+        add(xyz, sizeof(xyz));
+    }
+    for(uint pid=0; pid<m.num_polys(); ++pid)
+    {
+        for(uint vid : m.adj_p2v(pid)) add(&vid, sizeof(uint));
+        uint sep = 0xffffffff;
+        add(&sep, sizeof(uint));
+    }
+    return h;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void GeodesicsCache::init(Mesh & m, const int laplacian_mode, const float time_scalar)
+{
+    clear();
+
+    nv                   = m.num_verts();
+    np                   = m.num_polys();
+    hash                 = geodesics_mesh_hash(m);
+    this->laplacian_mode = laplacian_mode;
+    this->time_scalar    = time_scalar;
+
+    // optimize position and scale to get better numerical precision. Original positions
+    // are restored exactly at the end. Positions change twice per call, hence an operator
+    // cache (see operator_cache.h) only saves the assembly of the sparsity patterns
+    std::vector<vec3d> verts = m.vector_verts();
+    double d = m.bbox().diag();
+    vec3d  c = m.bbox().center();
+    m.translate(-c);
+    m.scale(1.0/d);
+
+    // use the squared avg edge length as time step, as suggested in the original paper
+    double time = m.edge_avg_length();
+    time *= time;
+    time *= time_scalar;
+
+    Eigen::SparseMatrix<double> L  = laplacian(m, laplacian_mode);
+    Eigen::SparseMatrix<double> MM = mass_matrix(m);
+    gradient = gradient_matrix(m);
+
+    Eigen::SimplicialLLT<Eigen::SparseMatrix<double>> llt(MM - time * L);
+    assert(llt.info() == Eigen::Success);
+    heat_flow.P = llt.permutationP().indices();
+    heat_flow.L = llt.matrixL();
+
+    Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> ldlt(-L);
+    assert(ldlt.info() == Eigen::Success);
+    integration.P = ldlt.permutationP().indices();
+    integration.L = ldlt.matrixL();
+    integration.D = ldlt.vectorD();
+
+    // restore original scale and position
+    m.vector_verts() = verts;
+    m.mark_changed(CHANGES_VERT_POS);
+    if(m.mesh_data().update_bbox) m.update_bbox();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void GeodesicsCache::clear()
+{
+    heat_flow   = Factor();
+    integration = Factor();
+    gradient    = Eigen::SparseMatrix<double>();
+    nv          = 0;
+    np          = 0;
+    hash        = 0;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// same steps of the solve() method of Eigen's simplicial Cholesky solvers
+CINO_INLINE
+void GeodesicsCache::Factor::solve_in_place(Eigen::VectorXd & x) const
+{
+    Eigen::PermutationMatrix<Eigen::Dynamic,Eigen::Dynamic,int> perm(P);
+    x = perm * x;
+    if(D.size()>0)
+    {
+        L.triangularView<Eigen::UnitLower>().solveInPlace(x);
+        x = D.asDiagonal().inverse() * x;
+        L.transpose().triangularView<Eigen::UnitUpper>().solveInPlace(x);
+    }
+    else
+    {
+        L.triangularView<Eigen::Lower>().solveInPlace(x);
+        L.transpose().triangularView<Eigen::Upper>().solveInPlace(x);
+    }
+    x = perm.transpose() * x;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// Same as above, for a chunk of right hand sides stored row major. Each entry of L is read
+// once for the whole chunk, and each update is a fixed size (vectorized) operation on a row
+CINO_INLINE
+void GeodesicsCache::Factor::solve_in_place(Chunk & X) const
+{
+    assert(L.isCompressed());
+    const bool    unit  = D.size()>0;
+    const int     n     = L.cols();
+    const int    *outer = L.outerIndexPtr();
+    const int    *inner = L.innerIndexPtr();
+    const double *value = L.valuePtr();
+
+    Eigen::PermutationMatrix<Eigen::Dynamic,Eigen::Dynamic,int> perm(P);
+    X = perm * X;
+
+    // L X = B (entries of each column are sorted, hence the diagonal comes first)
+    for(int j=0; j<n; ++j)
+    {
+        int it = outer[j];
+        if(it<outer[j+1] && inner[it]==j)
+        {
+            if(!unit) X.row(j) /= value[it];
+            ++it;
+        }
+        for(; it<outer[j+1]; ++it) X.row(inner[it]) -= value[it] * X.row(j);
+    }
+
+    if(unit) X = D.asDiagonal().inverse() * X;
+
+    // L^T X = B
+    for(int j=n-1; j>=0; --j)
+    {
+        double diag = 1.0;
+        for(int it=outer[j]; it<outer[j+1]; ++it)
+        {
+            if(inner[it]==j) diag = value[it];
+            else X.row(j) -= value[it] * X.row(inner[it]);
+        }
+        if(!unit) X.row(j) /= diag;
+    }
+
+    X = perm.transpose() * X;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void GeodesicsCache::solve(const Eigen::MatrixXd & heat_charges, Eigen::MatrixXd & geodesics) const
+{
+    assert(is_initialized());
+    assert(heat_charges.rows() == nv);
+
+    geodesics.resize(nv, heat_charges.cols());
+
+    if(heat_charges.cols()==1)
+    {
+        Eigen::VectorXd heat = heat_charges.col(0);
+        heat_flow.solve_in_place(heat);
+
+        VectorField grad = gradient * heat;
+        grad.normalize();
+
+        Eigen::VectorXd phi = gradient.transpose() * grad;
+        integration.solve_in_place(phi);
+        geodesics.col(0) = phi;
+        return;
+    }
+
+    // multiple right hand sides are processed in chunks, stored row major. In this layout
+    // also the sparse/dense products become fixed size operations between rows
+    const int k = Chunk::ColsAtCompileTime;
+    Chunk X(nv,k);
+    Eigen::Matrix<double,Eigen::Dynamic,k,Eigen::RowMajor> grad;
+    for(int c=0; c<heat_charges.cols(); c+=k)
+    {
+        // unused columns replicate the first one
+        int w = std::min(k, int(heat_charges.cols())-c);
+        X.leftCols(w) = heat_charges.middleCols(c,w);
+        for(int i=w; i<k; ++i) X.col(i) = X.col(0);
+
+        heat_flow.solve_in_place(X);
+
+        // normalized gradient (see VectorField::normalize)
+        grad = gradient * X;
+        for(int i=0; i<grad.rows(); i+=3)
+        {
+            Eigen::Array<double,1,k> norm = (grad.row(i  ).array().square() +
+                                             grad.row(i+1).array().square() +
+                                             grad.row(i+2).array().square()).sqrt();
+            grad.row(i  ).array() /= norm;
+            grad.row(i+1).array() /= norm;
+            grad.row(i+2).array() /= norm;
+        }
+
+        X = gradient.transpose() * grad;
+        integration.solve_in_place(X);
+        geodesics.middleCols(c,w) = X.leftCols(w);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// writes/reads a sparse matrix to/from three consecutive sections of a .cino file
+static CINO_INLINE
+void geodesics_write_sparse(CINO_writer & w, const uint32_t tag, const Eigen::SparseMatrix<double> & M)
+{
+    assert(M.isCompressed());
+    w.add_array(tag,   std::vector<int>   (M.outerIndexPtr(), M.outerIndexPtr()+M.outerSize()+1));
+    w.add_array(tag+1, std::vector<int>   (M.innerIndexPtr(), M.innerIndexPtr()+M.nonZeros()));
+    w.add_array(tag+2, std::vector<double>(M.valuePtr(),      M.valuePtr()+M.nonZeros()));
+}
+
+static CINO_INLINE
+bool geodesics_read_sparse(const CINO_reader & r, const uint32_t tag, const uint rows, Eigen::SparseMatrix<double> & M)
+{
+    std::vector<int>    outer, inner;
+    std::vector<double> values;
+    if(!r.get_array(tag,   outer ) || outer.empty()) return false;
+    if(!r.get_array(tag+1, inner )) return false;
+    if(!r.get_array(tag+2, values)) return false;
+    uint cols = outer.size()-1;
+    if(inner.size()!=values.size() || uint(outer.back())!=inner.size()) return false;
+    for(int i : inner) if(i<0 || uint(i)>=rows) return false;
+    for(uint i=0; i<cols; ++i) if(outer.at(i)>outer.at(i+1)) return false;
+    M = Eigen::Map<const Eigen::SparseMatrix<double>>(rows, cols, values.size(), outer.data(), inner.data(), values.data());
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool GeodesicsCache::save(const char * filename) const
+{
+    assert(is_initialized());
+
+    CINO_writer w(filename, 0);
+    if(!w.is_open()) return false;
+    w.add_array(CINO_GEO_INFO,      std::vector<uint64_t>{nv, np, hash, uint64_t(laplacian_mode)});
+    w.add_array(CINO_GEO_TIME,      std::vector<double>{time_scalar});
+    w.add_array(CINO_GEO_HEAT_P,    std::vector<int>(heat_flow.P.data(), heat_flow.P.data()+heat_flow.P.size()));
+    w.add_array(CINO_GEO_POISSON_P, std::vector<int>(integration.P.data(), integration.P.data()+integration.P.size()));
+    w.add_array(CINO_GEO_POISSON_D, std::vector<double>(integration.D.data(), integration.D.data()+integration.D.size()));
+    geodesics_write_sparse(w, CINO_GEO_HEAT_L,    heat_flow.L);
+    geodesics_write_sparse(w, CINO_GEO_POISSON_L, integration.L);
+    geodesics_write_sparse(w, CINO_GEO_GRADIENT,  gradient);
+    return w.close();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+bool GeodesicsCache::load(const char * filename, const Mesh & m)
+{
+    clear();
+
+    CINO_reader r(filename);
+    if(!r.is_open()) return false;
+
+    std::vector<uint64_t> info;
+    std::vector<double>   time;
+    std::vector<int>      heat_P, int_P;
+    std::vector<double>   int_D;
+    if(!r.get_array(CINO_GEO_INFO, info) || info.size()!=4) return false;
+    if(!r.get_array(CINO_GEO_TIME, time) || time.size()!=1) return false;
+    if(info[0]!=m.num_verts() || info[1]!=m.num_polys() || info[2]!=geodesics_mesh_hash(m))
+    {
+        std::cerr << "WARNING: " << filename << " : geodesics cache was computed for a different mesh" << std::endl;
+        return false;
+    }
+
+    // permutations must be permutations of [0,nv) (they are used to index memory)
+    auto is_perm = [&](const std::vector<int> & p)
+    {
+        if(p.size()!=m.num_verts()) return false;
+        std::vector<bool> seen(p.size(), false);
+        for(int i : p)
+        {
+            if(i<0 || uint(i)>=p.size() || seen.at(i)) return false;
+            seen.at(i) = true;
+        }
+        return true;
+    };
+    if(!r.get_array(CINO_GEO_HEAT_P,    heat_P) || !is_perm(heat_P)) return false;
+    if(!r.get_array(CINO_GEO_POISSON_P, int_P ) || !is_perm(int_P )) return false;
+    if(!r.get_array(CINO_GEO_POISSON_D, int_D ) || int_D.size()!=m.num_verts()) return false;
+
+    Factor heat, poisson;
+    Eigen::SparseMatrix<double> G;
+    if(!geodesics_read_sparse(r, CINO_GEO_HEAT_L,    m.num_verts(), heat.L)    || heat.L.cols()    != int(m.num_verts())) return false;
+    if(!geodesics_read_sparse(r, CINO_GEO_POISSON_L, m.num_verts(), poisson.L) || poisson.L.cols() != int(m.num_verts())) return false;
+    if(!geodesics_read_sparse(r, CINO_GEO_GRADIENT,  3*m.num_polys(), G)       || G.cols()         != int(m.num_verts())) return false;
+    heat.P    = Eigen::Map<Eigen::VectorXi>(heat_P.data(), heat_P.size());
+    poisson.P = Eigen::Map<Eigen::VectorXi>(int_P.data(),  int_P.size());
+    poisson.D = Eigen::Map<Eigen::VectorXd>(int_D.data(),  int_D.size());
+
+    heat_flow      = heat;
+    integration    = poisson;
+    gradient       = G;
+    nv             = info[0];
+    np             = info[1];
+    hash           = info[2];
+    laplacian_mode = int(info[3]);
+    time_scalar    = time[0];
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class Mesh>
 CINO_INLINE
 ScalarField compute_geodesics_amortized(      Mesh              & m,
@@ -108,62 +441,84 @@ ScalarField compute_geodesics_amortized(      Mesh              & m,
                                         const int                 laplacian_mode,
                                         const float               time_scalar)
 {
-    // first call, heavy solve (matrix factorization + gradient matrix)
-    if (cache.heat_flow_cache == NULL)
+    // first call, heavy solve (matrix factorization + gradient matrix).
+    // Next calls solve by back-substitution using pre-factored matrices
+    if(!cache.is_initialized()) cache.init(m, laplacian_mode, time_scalar);
+
+    Eigen::MatrixXd rhs = Eigen::MatrixXd::Zero(m.num_verts(),1);
+    for(uint vid : heat_charges) rhs(vid,0) = 1.0;
+
+    Eigen::MatrixXd res;
+    cache.solve(rhs, res);
+
+    ScalarField geodesics(res.col(0));
+    geodesics.normalize_in_01();
+    return geodesics;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void compute_geodesics_batched(      Mesh                           & m,
+                                     GeodesicsCache                 & cache,
+                               const std::vector<std::vector<uint>> & sources,
+                                     Eigen::MatrixXd                & geodesics,
+                               const int                              laplacian_mode,
+                               const float                            time_scalar,
+                               const uint                             block_size)
+{
+    geodesics.resize(m.num_verts(), sources.size());
+    compute_geodesics_batched(m, cache, sources, [&](const uint i, const ScalarField & f)
     {
-        // optimize position and scale to get better numerical precision
-        double d = m.bbox().diag();
-        vec3d  c = m.bbox().center();
-        m.translate(-c);
-        m.scale(1.0/d);
-
-        // use the squared avg edge length as time step, as suggested in the original paper
-        double time = m.edge_avg_length();
-        time *= time;
-        time *= time_scalar;
-
-        Eigen::SparseMatrix<double> L   = laplacian(m, laplacian_mode);
-        Eigen::SparseMatrix<double> MM  = mass_matrix(m);
-        Eigen::VectorXd             rhs = Eigen::VectorXd::Zero(m.num_verts());
-
-        for(uint vid : heat_charges) rhs[vid] = 1.0;
-
-        ScalarField heat(m.num_verts());
-        cache.heat_flow_cache = new Eigen::SimplicialLLT<Eigen::SparseMatrix<double>>(MM - time * L);
-        assert(cache.heat_flow_cache->info() == Eigen::Success);
-        heat = cache.heat_flow_cache->solve(rhs).eval();
-
-        cache.gradient_matrix = gradient_matrix(m);
-        VectorField grad = cache.gradient_matrix * heat;
-        grad.normalize();
+        geodesics.col(i) = f;
+    },
+    laplacian_mode, time_scalar, block_size);
+}
 
-        ScalarField geodesics(m.num_verts());
-        cache.integration_cache = new Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>>(-L);
-        assert(cache.integration_cache->info() == Eigen::Success);
-        geodesics = cache.integration_cache->solve(cache.gradient_matrix.transpose() * grad).eval();
-        geodesics.normalize_in_01();
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-        // restore original scale and position
-        m.scale(d);
-        m.translate(c);
-        return geodesics;
-    }
-    else // solve by back-substitution using pre-factored matrices
+template<class Mesh>
+CINO_INLINE
+void compute_geodesics_batched(      Mesh                                                    & m,
+                                     GeodesicsCache                                          & cache,
+                               const std::vector<std::vector<uint>>                          & sources,
+                               const std::function<void(const uint i, const ScalarField & f)> & callback,
+                               const int                                                       laplacian_mode,
+                               const float                                                     time_scalar,
+                               const uint                                                      block_size)
+{
+    assert(block_size>0);
+    if(!cache.is_initialized()) cache.init(m, laplacian_mode, time_scalar);
+
+    std::mutex mutex;
+    uint n_blocks = (sources.size()+block_size-1)/block_size;
+    PARALLEL_FOR(0, n_blocks, 2, SCHEDULE_DYNAMIC, 1, [&](const uint b)
     {
-        Eigen::VectorXd rhs = Eigen::VectorXd::Zero(m.num_verts());
-        for(uint vid : heat_charges) rhs[vid] = 1.0;
-        ScalarField heat = cache.heat_flow_cache->solve(rhs).eval();
+        uint beg = b*block_size;
+        uint end = std::min(uint(sources.size()), beg+block_size);
 
-        VectorField grad = cache.gradient_matrix * heat;
-        grad.normalize();
+        Eigen::MatrixXd rhs = Eigen::MatrixXd::Zero(m.num_verts(), end-beg);
+        for(uint i=beg; i<end; ++i)
+        {
+            for(uint vid : sources.at(i)) rhs(vid,i-beg) = 1.0;
+        }
 
-        ScalarField geodesics(m.num_verts());
-        geodesics = cache.integration_cache->solve(cache.gradient_matrix.transpose() * grad).eval();
-        geodesics.normalize_in_01();
+        Eigen::MatrixXd res;
+        cache.solve(rhs, res);
 
-        return geodesics;
-    }
+        for(uint i=beg; i<end; ++i)
+        {
+            // same as ScalarField::normalize_in_01 (without logging)
+            ScalarField f(res.col(i-beg));
+            double min = f.minCoeff();
+            double max = f.maxCoeff();
+            f.array() = (f.array() - min) / (max - min);
 
+            std::lock_guard<std::mutex> lock(mutex);
+            callback(i, f);
+        }
+    });
 }
 
 }
@@ -37,6 +37,8 @@
 #define CINO_GEODESICS_H
 
 #include <vector>
+#include <functional>
+#include <stdint.h>
 #include <sys/types.h>
 #include <cinolib/cino_inline.h>
 #include <cinolib/scalar_field.h>
@@ -79,13 +81,56 @@ ScalarField compute_geodesics(      Mesh              & m,
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-typedef struct
+/* Pre-factored operators for the heat method: the Cholesky factorization of the heat
+ * flow matrix, the LDLT factorization of the Laplacian and the gradient matrix. Once
+ * initialized, geodesic distances from any set of sources are computed with just two
+ * back substitutions. Factors are stored explicitly, so that the cache can be saved
+ * to disk and reloaded, skipping both the assembly and the factorization of the
+ * operators. Loading fails if the file was generated for a different mesh (same
+ * number of elements, connectivity and vertex positions, up to single precision).
+*/
+class GeodesicsCache
 {
-    Eigen::SimplicialLLT<Eigen::SparseMatrix<double>>  *heat_flow_cache   = NULL;
-    Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> *integration_cache = NULL;
-    Eigen::SparseMatrix<double>                         gradient_matrix;
-}
-GeodesicsCache;
+    public:
+
+        template<class Mesh>
+        void init(Mesh & m, const int laplacian_mode = COTANGENT, const float time_scalar = 1.0);
+        void clear();
+        bool is_initialized() const { return nv>0; }
+
+        bool save(const char * filename) const;
+        template<class Mesh>
+        bool load(const char * filename, const Mesh & m);
+
+        // solves for many sets of sources at once. Each column of heat_charges contains
+        // the initial heat (i.e. 1 at sources, 0 elsewhere) of a separate problem. Output
+        // distances are NOT normalized. Can be called concurrently from multiple threads
+        void solve(const Eigen::MatrixXd & heat_charges, Eigen::MatrixXd & geodesics) const;
+
+    protected:
+
+        // a chunk of right hand sides, stored row major
+        typedef Eigen::Matrix<double,Eigen::Dynamic,8,Eigen::RowMajor> Chunk;
+
+        // factorization P^T L D L^T P (D is empty for LLT, and L has unit diagonal for LDLT)
+        struct Factor
+        {
+            Eigen::VectorXi             P;
+            Eigen::SparseMatrix<double> L;
+            Eigen::VectorXd             D;
+            void solve_in_place(Eigen::VectorXd & x) const;
+            void solve_in_place(Chunk           & X) const;
+        };
+
+        Factor                      heat_flow;
+        Factor                      integration;
+        Eigen::SparseMatrix<double> gradient;
+        uint                        nv = 0;
+        uint                        np = 0;
+        uint64_t                    hash = 0;
+        int                         laplacian_mode = COTANGENT;
+        double                      time_scalar = 1.0;
+};
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
@@ -96,6 +141,41 @@ ScalarField compute_geodesics_amortized(      Mesh              & m,
                                         const std::vector<uint> & heat_charges,
                                         const int                 laplacian_mode = COTANGENT,
                                         const float               time_scalar = 1.0);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+/* Batched geodesics, for when distances from many independent sets of sources are
+ * needed (e.g. descriptors, Voronoi partitions, farthest point sampling). Source sets
+ * are grouped in blocks of block_size, and each block is solved with a single multi
+ * RHS back substitution. Blocks are processed in parallel. Each distance field is
+ * normalized in [0,1], as in compute_geodesics_amortized. The cache is initialized
+ * with the given parameters if it is empty.
+ *
+ * The first version returns a dense #V x #sources matrix, with a distance field per
+ * column. The second one streams each distance field to a callback instead, and is
+ * meant for when the dense matrix would not fit in memory. The callback is never
+ * invoked concurrently, but source sets are not visited in any particular order.
+*/
+template<class Mesh>
+CINO_INLINE
+void compute_geodesics_batched(      Mesh                           & m,
+                                     GeodesicsCache                 & cache,
+                               const std::vector<std::vector<uint>> & sources,
+                                     Eigen::MatrixXd                & geodesics,
+                               const int                              laplacian_mode = COTANGENT,
+                               const float                            time_scalar = 1.0,
+                               const uint                             block_size = 32);
+
+template<class Mesh>
+CINO_INLINE
+void compute_geodesics_batched(      Mesh                                                    & m,
+                                     GeodesicsCache                                          & cache,
+                               const std::vector<std::vector<uint>>                          & sources,
+                               const std::function<void(const uint i, const ScalarField & f)> & callback,
+                               const int                                                       laplacian_mode = COTANGENT,
+                               const float                                                     time_scalar = 1.0,
+                               const uint                                                      block_size = 32);
+
 }
 
 #ifndef  CINO_STATIC_LIB
@@ -35,14 +35,6 @@
 *********************************************************************************/
 #include "drawable_aabb.h"
 
-#ifdef __APPLE__
-#include <gl.h>
-#include <glu.h>
-#else
-#include <GL/gl.h>
-#include <GL/glu.h>
-#endif
-
 namespace cinolib
 {
 
@@ -50,7 +42,8 @@ CINO_INLINE
 DrawableAABB::DrawableAABB(const vec3d min, const vec3d max)
     : AABB(min, max)
 {
-    verts = this->corners();
+    drawlist.draw_mode = DRAW_SEGS;
+    updateGL();
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -59,7 +52,8 @@ CINO_INLINE
 DrawableAABB::DrawableAABB(const std::vector<vec3d> &p_list, const double scaling_factor)
     : AABB(p_list, scaling_factor)
 {
-    verts = this->corners();
+    drawlist.draw_mode = DRAW_SEGS;
+    updateGL();
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -68,7 +62,8 @@ CINO_INLINE
 DrawableAABB::DrawableAABB(const std::vector<AABB> &b_list, const double scaling_factor)
     : AABB(b_list, scaling_factor)
 {
-    verts = this->corners();
+    drawlist.draw_mode = DRAW_SEGS;
+    updateGL();
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -76,24 +71,19 @@ DrawableAABB::DrawableAABB(const std::vector<AABB> &b_list, const double scaling
 CINO_INLINE
 void DrawableAABB::draw(const float ) const
 {
-    glLineWidth(thickness);
-    glDisable(GL_LIGHTING);
-    glColor3fv(color.rgba);
-    glBegin(GL_LINES);
-        glVertex3dv(verts.at(0).ptr()); glVertex3dv(verts.at(1).ptr());
-        glVertex3dv(verts.at(0).ptr()); glVertex3dv(verts.at(3).ptr());
-        glVertex3dv(verts.at(0).ptr()); glVertex3dv(verts.at(4).ptr());
-        glVertex3dv(verts.at(1).ptr()); glVertex3dv(verts.at(2).ptr());
-        glVertex3dv(verts.at(1).ptr()); glVertex3dv(verts.at(5).ptr());
-        glVertex3dv(verts.at(2).ptr()); glVertex3dv(verts.at(3).ptr());
-        glVertex3dv(verts.at(2).ptr()); glVertex3dv(verts.at(6).ptr());
-        glVertex3dv(verts.at(3).ptr()); glVertex3dv(verts.at(7).ptr());
-        glVertex3dv(verts.at(4).ptr()); glVertex3dv(verts.at(5).ptr());
-        glVertex3dv(verts.at(4).ptr()); glVertex3dv(verts.at(7).ptr());
-        glVertex3dv(verts.at(5).ptr()); glVertex3dv(verts.at(6).ptr());
-        glVertex3dv(verts.at(6).ptr()); glVertex3dv(verts.at(7).ptr());
-    glEnd();
-    glEnable(GL_LIGHTING);
+    render_segs(drawlist);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void DrawableAABB::updateGL()
+{
+    drawlist.segs.clear();
+    drawlist.seg_coords.clear();
+    drawlist.seg_colors.clear();
+    push_aabb_segs(drawlist, *this, color);
+    render_data_changed(drawlist);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -118,6 +108,7 @@ CINO_INLINE
 void DrawableAABB::set_color(const Color & c)
 {
     color = c;
+    updateGL();
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -125,7 +116,29 @@ void DrawableAABB::set_color(const Color & c)
 CINO_INLINE
 void DrawableAABB::set_thickness(float t)
 {
-    thickness = t;
+    drawlist.seg_width = t;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void push_aabb_segs(RenderData & data, const AABB & b, const Color & c)
+{
+    static const uint edges[24] = { 0,1, 0,3, 0,4, 1,2, 1,5, 2,3, 2,6, 3,7, 4,5, 4,7, 5,6, 6,7 };
+
+    std::vector<vec3d> verts = b.corners();
+    for(uint i=0; i<24; ++i)
+    {
+        const vec3d & p = verts.at(edges[i]);
+        data.segs.push_back(data.seg_coords.size()/3);
+        data.seg_coords.push_back(p.x());
+        data.seg_coords.push_back(p.y());
+        data.seg_coords.push_back(p.z());
+        data.seg_colors.push_back(c.r);
+        data.seg_colors.push_back(c.g);
+        data.seg_colors.push_back(c.b);
+        data.seg_colors.push_back(c.a);
+    }
 }
 
 }
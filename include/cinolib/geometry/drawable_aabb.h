@@ -38,6 +38,7 @@
 
 #include <cinolib/drawable_object.h>
 #include <cinolib/geometry/aabb.h>
+#include <cinolib/gl/draw_lines_tris.h>
 #include <cinolib/color.h>
 
 namespace cinolib
@@ -66,16 +67,25 @@ class DrawableAABB : public AABB, public DrawableObject
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+        void updateGL(); // regenerates rendering data (e.g. after changing min/max)
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
         void set_color(const Color & c);
         void set_thickness(float t);
 
     private:
 
-        std::vector<vec3d> verts;
-        Color color = Color::BLACK();
-        float thickness = 1.0;
+        RenderData drawlist;
+        Color      color = Color::BLACK();
 };
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// appends the 12 edges of b to the segments of data
+CINO_INLINE
+void push_aabb_segs(RenderData & data, const AABB & b, const Color & c);
+
 }
 
 #ifndef  CINO_STATIC_LIB
@@ -34,21 +34,267 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/gl/draw_lines_tris.h>
+#include <numeric>
+#include <algorithm>
 
 namespace cinolib
 {
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+CINO_INLINE
+RenderDataBuffers & RenderDataBuffers::operator=(const RenderDataBuffers &)
+{
+    // keep the own GPU buffers, but upload the new data
+    all_changed = true;
+    tri_changes.clear();
+    seg_changes.clear();
+    return *this;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+RenderDataBuffers::~RenderDataBuffers()
+{
+    if(id[0]!=0) glDeleteBuffers(NUM_BUFFERS, id);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void render_data_changed(RenderData & data)
+{
+    data.gpu.all_changed = true;
+    data.gpu.tri_changes.clear();
+    data.gpu.seg_changes.clear();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void render_data_changed_tris(RenderData & data, const uint first, const uint count)
+{
+    if(!data.gpu.all_changed && count>0) data.gpu.tri_changes.push_back(std::make_pair(first, first+count));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void render_data_changed_segs(RenderData & data, const uint first, const uint count)
+{
+    if(!data.gpu.all_changed && count>0) data.gpu.seg_changes.push_back(std::make_pair(first, first+count));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// sorts and merges ranges. Too many sparse ranges are uploaded as a single
+// one, as each glBufferSubData call has its own (driver) overhead
+CINO_INLINE
+void render_data_merge_ranges(std::vector<std::pair<uint,uint>> & ranges)
+{
+    if(ranges.empty()) return;
+    std::sort(ranges.begin(), ranges.end());
+    uint last = 0;
+    for(uint i=1; i<ranges.size(); ++i)
+    {
+        if(ranges[i].first <= ranges[last].second) ranges[last].second = std::max(ranges[last].second, ranges[i].second);
+        else ranges[++last] = ranges[i];
+    }
+    ranges.resize(last+1);
+    if(ranges.size() > 64) ranges = { std::make_pair(ranges.front().first, ranges.back().second) };
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void render_data_upload(const RenderData & data)
+{
+    RenderDataBuffers & gpu = data.gpu;
+
+    struct { GLenum target; const void *ptr; size_t bytes; bool is_tri; } buffers[RenderDataBuffers::NUM_BUFFERS] =
+    {
+        { GL_ELEMENT_ARRAY_BUFFER, data.tris.data(),         data.tris.size()        *sizeof(uint),  true  },
+        { GL_ARRAY_BUFFER,         data.tri_coords.data(),   data.tri_coords.size()  *sizeof(float), true  },
+        { GL_ARRAY_BUFFER,         data.tri_v_norms.data(),  data.tri_v_norms.size() *sizeof(float), true  },
+        { GL_ARRAY_BUFFER,         data.tri_v_colors.data(), data.tri_v_colors.size()*sizeof(float), true  },
+        { GL_ARRAY_BUFFER,         data.tri_text.data(),     data.tri_text.size()    *sizeof(float), true  },
+        { GL_ELEMENT_ARRAY_BUFFER, data.segs.data(),         data.segs.size()        *sizeof(uint),  false },
+        { GL_ARRAY_BUFFER,         data.seg_coords.data(),   data.seg_coords.size()  *sizeof(float), false },
+        { GL_ARRAY_BUFFER,         data.seg_colors.data(),   data.seg_colors.size()  *sizeof(float), false },
+    };
+
+    bool pending = gpu.all_changed || !gpu.tri_changes.empty() || !gpu.seg_changes.empty();
+    for(int i=0; i<RenderDataBuffers::NUM_BUFFERS; ++i) pending |= (buffers[i].bytes != gpu.bytes[i]);
+    if(!pending) return;
+
+    if(gpu.id[0]==0) glGenBuffers(RenderDataBuffers::NUM_BUFFERS, gpu.id);
+    render_data_merge_ranges(gpu.tri_changes);
+    render_data_merge_ranges(gpu.seg_changes);
+
+    uint n_tris = data.tris.size()/3;
+    uint n_segs = data.segs.size()/2;
+
+    for(int i=0; i<RenderDataBuffers::NUM_BUFFERS; ++i)
+    {
+        const auto & b = buffers[i];
+        const auto & changes = (b.is_tri) ? gpu.tri_changes : gpu.seg_changes;
+        uint   n_elems = (b.is_tri) ? n_tris : n_segs;
+
+        if(gpu.all_changed || b.bytes!=gpu.bytes[i])
+        {
+            glBindBuffer(b.target, gpu.id[i]);
+            glBufferData(b.target, b.bytes, b.ptr, GL_DYNAMIC_DRAW);
+            gpu.bytes[i] = b.bytes;
+        }
+        else if(!changes.empty() && n_elems>0)
+        {
+            size_t stride = b.bytes/n_elems; // bytes per triangle (segment)
+            glBindBuffer(b.target, gpu.id[i]);
+            for(const auto & r : changes)
+            {
+                glBufferSubData(b.target, r.first*stride, (r.second-r.first)*stride, static_cast<const char*>(b.ptr) + r.first*stride);
+            }
+        }
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    gpu.all_changed = false;
+    gpu.tri_changes.clear();
+    gpu.seg_changes.clear();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// resizes all buffers but the element lists, preserving their content
+CINO_INLINE
+void render_data_resize_attributes(RenderData & data, const uint n_tris, const uint n_segs)
+{
+    uint n_tri_verts = 3*n_tris;
+    uint n_seg_verts = 2*n_segs;
+
+    data.tri_coords.resize(3*n_tri_verts);
+
+    bool norms  = data.draw_mode & (DRAW_TRI_SMOOTH | DRAW_TRI_FLAT);
+    bool colors = data.draw_mode & (DRAW_TRI_FACECOLOR | DRAW_TRI_VERTCOLOR | DRAW_TRI_QUALITY);
+    uint text   = (data.draw_mode & DRAW_TRI_TEXTURE1D) ? 1 : ((data.draw_mode & DRAW_TRI_TEXTURE2D) ? 2 : 0);
+
+    data.tri_v_norms.resize (norms  ? 3*n_tri_verts : 0);
+    data.tri_v_colors.resize(colors ? 4*n_tri_verts : 0);
+    data.tri_text.resize(text*n_tri_verts);
+
+    data.seg_coords.resize(3*n_seg_verts);
+    data.seg_colors.resize(4*n_seg_verts);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void render_data_resize(RenderData & data, const uint n_tris, const uint n_segs)
+{
+    render_data_resize_attributes(data, n_tris, n_segs);
+
+    data.tris.resize(3*n_tris);
+    std::iota(data.tris.begin(), data.tris.end(), 0);
+    data.segs.resize(2*n_segs);
+    std::iota(data.segs.begin(), data.segs.end(), 0);
+
+    render_data_changed(data);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+int render_data_alloc_tris(RenderData & data, RenderDataLayout & layout, const uint n_tris)
+{
+    std::vector<int> & slots = layout.free_tris[n_tris];
+    if(slots.empty())
+    {
+        // append a batch of free slots, proportional to the current size of the buffers
+        uint n_old   = data.tris.size()/3;
+        uint n_slots = std::max(1u, n_old/(16*n_tris));
+        render_data_resize_attributes(data, n_old + n_slots*n_tris, data.segs.size()/2);
+        data.tris.resize(3*(n_old + n_slots*n_tris));
+        for(uint i=n_slots; i>0; --i)
+        {
+            uint first = n_old + (i-1)*n_tris;
+            std::fill(data.tris.begin() + 3*first, data.tris.begin() + 3*(first+n_tris), 3*first);
+            slots.push_back(first);
+        }
+        layout.n_free_tris += n_slots*n_tris;
+    }
+    int first = slots.back();
+    slots.pop_back();
+    layout.n_free_tris -= n_tris;
+
+    std::iota(data.tris.begin() + 3*first, data.tris.begin() + 3*(first+n_tris), 3*first);
+    render_data_changed_tris(data, first, n_tris);
+    return first;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void render_data_free_tris(RenderData & data, RenderDataLayout & layout, const int first, const uint n_tris)
+{
+    std::fill(data.tris.begin() + 3*first, data.tris.begin() + 3*(first+n_tris), 3*first);
+    render_data_changed_tris(data, first, n_tris);
+    layout.free_tris[n_tris].push_back(first);
+    layout.n_free_tris += n_tris;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+int render_data_alloc_seg(RenderData & data, RenderDataLayout & layout)
+{
+    if(layout.free_segs.empty())
+    {
+        uint n_old   = data.segs.size()/2;
+        uint n_slots = std::max(1u, n_old/16);
+        render_data_resize_attributes(data, data.tris.size()/3, n_old + n_slots);
+        data.segs.resize(2*(n_old + n_slots));
+        for(uint i=n_old+n_slots; i>n_old; --i)
+        {
+            data.segs[2*(i-1)] = data.segs[2*(i-1)+1] = 2*(i-1);
+            layout.free_segs.push_back(i-1);
+        }
+    }
+    int seg = layout.free_segs.back();
+    layout.free_segs.pop_back();
+
+    data.segs[2*seg  ] = 2*seg;
+    data.segs[2*seg+1] = 2*seg+1;
+    render_data_changed_segs(data, seg, 1);
+    return seg;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void render_data_free_seg(RenderData & data, RenderDataLayout & layout, const int seg)
+{
+    data.segs[2*seg+1] = data.segs[2*seg];
+    render_data_changed_segs(data, seg, 1);
+    layout.free_segs.push_back(seg);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 CINO_INLINE
 void render_tris(const RenderData & data)
 {
+    render_data_upload(data);
+
     if (data.draw_mode & DRAW_TRI_POINTS)
     {
         glEnableClientState(GL_COLOR_ARRAY);
-        glColorPointer(4, GL_FLOAT, 0, data.tri_v_colors.data());
+        glBindBuffer(GL_ARRAY_BUFFER, data.gpu.id[RenderDataBuffers::TRI_COLORS]);
+        glColorPointer(4, GL_FLOAT, 0, 0);
         glEnableClientState(GL_VERTEX_ARRAY);
-        glVertexPointer(3, GL_FLOAT, 0, data.tri_coords.data());
+        glBindBuffer(GL_ARRAY_BUFFER, data.gpu.id[RenderDataBuffers::TRI_COORDS]);
+        glVertexPointer(3, GL_FLOAT, 0, 0);
         glPointSize(data.seg_width);
         glDrawArrays(GL_POINTS, 0, data.tri_coords.size()/3);
         glDisableClientState(GL_VERTEX_ARRAY);
@@ -65,7 +311,8 @@ void render_tris(const RenderData & data)
             glTexParameteri(GL_TEXTURE_1D, GL_TEXTURE_WRAP_S,     GL_CLAMP_TO_EDGE);
 
             glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-            glTexCoordPointer(1, GL_FLOAT, 0, data.tri_text.data());
+            glBindBuffer(GL_ARRAY_BUFFER, data.gpu.id[RenderDataBuffers::TRI_TEXT]);
+            glTexCoordPointer(1, GL_FLOAT, 0, 0);
             glColor3f(1,1,1);
             glEnable(GL_COLOR_MATERIAL);
             glEnable(GL_TEXTURE_1D);
@@ -81,7 +328,8 @@ void render_tris(const RenderData & data)
             glGenerateMipmap(GL_TEXTURE_2D);
 
             glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-            glTexCoordPointer(2, GL_FLOAT, 0, data.tri_text.data());
+            glBindBuffer(GL_ARRAY_BUFFER, data.gpu.id[RenderDataBuffers::TRI_TEXT]);
+            glTexCoordPointer(2, GL_FLOAT, 0, 0);
             glColor3f(1,1,1);
             glEnable(GL_COLOR_MATERIAL);
             glEnable(GL_TEXTURE_2D);
@@ -90,13 +338,17 @@ void render_tris(const RenderData & data)
         {
             glEnable(GL_COLOR_MATERIAL);
             glEnableClientState(GL_COLOR_ARRAY);
-            glColorPointer(4, GL_FLOAT, 0, data.tri_v_colors.data());
+            glBindBuffer(GL_ARRAY_BUFFER, data.gpu.id[RenderDataBuffers::TRI_COLORS]);
+            glColorPointer(4, GL_FLOAT, 0, 0);
         }
         glEnableClientState(GL_VERTEX_ARRAY);
-        glVertexPointer(3, GL_FLOAT, 0, data.tri_coords.data());
+        glBindBuffer(GL_ARRAY_BUFFER, data.gpu.id[RenderDataBuffers::TRI_COORDS]);
+        glVertexPointer(3, GL_FLOAT, 0, 0);
         glEnableClientState(GL_NORMAL_ARRAY);
-        glNormalPointer(GL_FLOAT, 0, data.tri_v_norms.data());
-        glDrawElements(GL_TRIANGLES, data.tris.size(), GL_UNSIGNED_INT, data.tris.data());
+        glBindBuffer(GL_ARRAY_BUFFER, data.gpu.id[RenderDataBuffers::TRI_NORMS]);
+        glNormalPointer(GL_FLOAT, 0, 0);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, data.gpu.id[RenderDataBuffers::TRIS]);
+        glDrawElements(GL_TRIANGLES, data.tris.size(), GL_UNSIGNED_INT, 0);
         glDisableClientState(GL_VERTEX_ARRAY);
         glDisableClientState(GL_NORMAL_ARRAY);
         if (data.draw_mode & DRAW_TRI_TEXTURE1D)
@@ -117,6 +369,8 @@ void render_tris(const RenderData & data)
             glDisable(GL_COLOR_MATERIAL);
         }
     }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -126,15 +380,22 @@ void render_segs(const RenderData & data)
 {
     if (data.draw_mode & DRAW_SEGS)
     {
+        render_data_upload(data);
+
         glEnable(GL_LINE_SMOOTH);
         glHint(GL_LINE_SMOOTH_HINT, GL_NICEST);        
         glDisable(GL_LIGHTING);
         glEnableClientState(GL_VERTEX_ARRAY);
-        glVertexPointer(3, GL_FLOAT, 0, data.seg_coords.data());
+        glBindBuffer(GL_ARRAY_BUFFER, data.gpu.id[RenderDataBuffers::SEG_COORDS]);
+        glVertexPointer(3, GL_FLOAT, 0, 0);
         glLineWidth(data.seg_width);
         glEnableClientState(GL_COLOR_ARRAY);
-        glColorPointer(4, GL_FLOAT, 0, data.seg_colors.data());
-        glDrawElements(GL_LINES, data.segs.size(), GL_UNSIGNED_INT, data.segs.data());
+        glBindBuffer(GL_ARRAY_BUFFER, data.gpu.id[RenderDataBuffers::SEG_COLORS]);
+        glColorPointer(4, GL_FLOAT, 0, 0);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, data.gpu.id[RenderDataBuffers::SEGS]);
+        glDrawElements(GL_LINES, data.segs.size(), GL_UNSIGNED_INT, 0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
         glDisableClientState(GL_COLOR_ARRAY);
         glDisableClientState(GL_VERTEX_ARRAY);
         glEnable(GL_LIGHTING);
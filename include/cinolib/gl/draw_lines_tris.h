@@ -46,7 +46,9 @@
 #include <GL/glu.h>
 #endif
 
+#include <map>
 #include <vector>
+#include <cstdint>
 #include <cmath>
 #include <sys/types.h>
 #include <cinolib/cino_inline.h>
@@ -94,6 +96,27 @@ struct Material
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+// GPU copy of the buffers of a RenderData (vertex buffer objects). Buffers are created
+// and uploaded by render(), hence RenderData can be filled also without a GL context.
+// Copies do not share GPU resources: they upload their own data at their first rendering
+struct RenderDataBuffers
+{
+    enum { TRIS, TRI_COORDS, TRI_NORMS, TRI_COLORS, TRI_TEXT, SEGS, SEG_COORDS, SEG_COLORS, NUM_BUFFERS };
+
+    RenderDataBuffers() {}
+    RenderDataBuffers(const RenderDataBuffers &) {}
+    RenderDataBuffers & operator=(const RenderDataBuffers &);
+   ~RenderDataBuffers();
+
+    GLuint                            id   [NUM_BUFFERS] = {};
+    size_t                            bytes[NUM_BUFFERS] = {}; // size of each buffer on the GPU
+    bool                              all_changed = true;      // upload all the buffers
+    std::vector<std::pair<uint,uint>> tri_changes;             // ranges [beg,end) of triangles to upload
+    std::vector<std::pair<uint,uint>> seg_changes;             // ranges [beg,end) of segments to upload
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 struct RenderData
 {
     Material           material;
@@ -112,13 +135,90 @@ struct RenderData
     std::vector<float> seg_colors; // rgba
     GLfloat            seg_width = 1;
     //
+    mutable RenderDataBuffers gpu;
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// Bookkeeping used by drawable meshes to update their RenderData incrementally:
+// where each mesh element is stored in the buffers, and the state of the mesh
+// (revisions of its change logs) and of the render settings the buffers reflect
+struct RenderDataLayout
+{
+    std::vector<int>      tri_offset; // first triangle of each poly/face (-1 if not rendered)
+    std::vector<int>      seg_offset; // segment of each edge (-1 if not rendered)
+    std::vector<int>      owner;      // element whose attributes are rendered (e.g. the visible poly beneath a face)
+    std::vector<uint64_t> revisions;  // revisions of the mesh change logs
+    int                   draw_mode = 0;
+    float                 AO_alpha  = 1.0;
+    double                tex_scale = 1.0;
+
+    // unused slots of the buffers (see render_data_alloc_tris)
+    std::map<uint,std::vector<int>> free_tris;       // first triangle of free slots, by number of triangles
+    std::vector<int>                free_segs;       // free segments
+    uint                            n_free_tris = 0; // triangles in free slots
+
+    void clear_free_slots() { free_tris.clear(); free_segs.clear(); n_free_tris = 0; }
 };
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+// allocates (exactly) the buffers of data for n_tris triangles and n_segs segments,
+// each with its own vertices, with the per vertex attributes required by data.draw_mode.
+// Element lists are filled with sequential indices, so that attributes can be written
+// independently (e.g. in parallel) for each triangle/segment. Implies render_data_changed()
+CINO_INLINE
+void render_data_resize(RenderData & data, const uint n_tris, const uint n_segs);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// Slots for elements that start/stop being rendered (e.g. when slicing a mesh), without
+// re-allocating the buffers. Freed slots are left in the buffers as degenerate primitives
+// (all indices equal), and reused by elements with the same number of triangles. When no
+// free slot is available new slots are appended, with some spare room (i.e. free slots) to
+// amortize the re-allocation of the buffers. Allocated slots must be filled by the caller.
+// Not available for DRAW_TRI_POINTS, which renders all vertices in the buffers
+CINO_INLINE
+int render_data_alloc_tris(RenderData & data, RenderDataLayout & layout, const uint n_tris);
+
+CINO_INLINE
+void render_data_free_tris(RenderData & data, RenderDataLayout & layout, const int first, const uint n_tris);
+
+CINO_INLINE
+int render_data_alloc_seg(RenderData & data, RenderDataLayout & layout);
+
+CINO_INLINE
+void render_data_free_seg(RenderData & data, RenderDataLayout & layout, const int seg);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// Buffers are uploaded to the GPU only when they change. Whoever fills a RenderData must
+// notify its changes, either as a whole (render_data_changed), or as ranges of triangles
+// and segments (render_data_changed_tris/segs), which are uploaded with glBufferSubData.
+// Buffers that changed size are always uploaded as a whole
+CINO_INLINE
+void render_data_changed(RenderData & data);
+
+CINO_INLINE
+void render_data_changed_tris(RenderData & data, const uint first, const uint count);
+
+CINO_INLINE
+void render_data_changed_segs(RenderData & data, const uint first, const uint count);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// uploads pending changes to the GPU (requires a GL context). Called by render()
+CINO_INLINE
+void render_data_upload(const RenderData & data);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 CINO_INLINE
 void render(const RenderData & data);
 
+CINO_INLINE
+void render_segs(const RenderData & data); // segments only (e.g. for boxes, curves and segment soups)
+
 }
 
 #ifndef  CINO_STATIC_LIB
@@ -42,185 +42,235 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/gradient.h>
+#include <cinolib/operator_cache.h>
+#include <cinolib/parallel_for.h>
+#include <atomic>
 
 namespace cinolib
 {
 
-typedef Eigen::Triplet<double> Entry;
+template<class M, class V, class E, class P>
+CINO_INLINE
+Eigen::SparseMatrix<double> gradient_matrix(const AbstractPolygonMesh<M,V,E,P> & m, const bool per_poly)
+{
+    if(m.operator_cache()) return *m.operator_cache()->gradient_matrix(m, per_poly);
+
+    SparseAssembler A;
+    gradient_matrix(m, A, per_poly);
+    return std::move(A.matrix());
+}
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-template<class M, class V, class E, class P>
+template<class M, class V, class E, class F, class P>
 CINO_INLINE
-Eigen::SparseMatrix<double> gradient_matrix(const AbstractPolygonMesh<M,V,E,P> & m, const bool per_poly)
+Eigen::SparseMatrix<double> gradient_matrix(const AbstractPolyhedralMesh<M,V,E,F,P> & m, const bool per_poly)
 {
-    if(per_poly)
-    {
-        Eigen::SparseMatrix<double> G(m.num_polys()*3, m.num_verts());
-        std::vector<Entry> entries;
+    if(m.operator_cache()) return *m.operator_cache()->gradient_matrix(m, per_poly);
+
+    SparseAssembler A;
+    gradient_matrix(m, A, per_poly);
+    return std::move(A.matrix());
+}
 
-        for(uint pid=0; pid<m.num_polys(); ++pid)
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// assembles a per poly gradient matrix (column vid has 3 rows for each poly incident to it)
+template<class Mesh, class Fill>
+CINO_INLINE
+void gradient_matrix_per_poly_assemble(const Mesh & m, SparseAssembler & A, const Fill & fill)
+{
+    A.assemble(m.num_polys()*3, m.num_verts(), m.topology_revision(), [&](const uint vid, std::vector<uint> & rows)
+    {
+        for(uint pid : m.adj_v2p(vid))
         {
-            double area = std::max(m.poly_area(pid), 1e-5) * 2.0; // (2 is the average term : two verts for each edge)
-            vec3d n     = m.poly_data(pid).normal;
+            rows.push_back(3*pid  );
+            rows.push_back(3*pid+1);
+            rows.push_back(3*pid+2);
+        }
+    }, fill);
+}
 
-            for(uint off=0; off<m.verts_per_poly(pid); ++off)
-            {
-                uint  prev = m.poly_vert_id(pid,off);
-                uint  curr = m.poly_vert_id(pid,(off+1)%m.verts_per_poly(pid));
-                uint  next = m.poly_vert_id(pid,(off+2)%m.verts_per_poly(pid));
-                vec3d u    = m.vert(next) - m.vert(curr);
-                vec3d v    = m.vert(curr) - m.vert(prev);
-                vec3d u_90 = u.cross(n); u_90.normalize();
-                vec3d v_90 = v.cross(n); v_90.normalize();
-
-                vec3d per_vert_sum_over_edge_normals = u_90 * u.norm() + v_90 * v.norm();
-                per_vert_sum_over_edge_normals /= area;
-
-                uint row = 3 * pid;
-                entries.push_back(Entry(row, curr, per_vert_sum_over_edge_normals.x())); ++row;
-                entries.push_back(Entry(row, curr, per_vert_sum_over_edge_normals.y())); ++row;
-                entries.push_back(Entry(row, curr, per_vert_sum_over_edge_normals.z()));
-            }
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// assembles a per vertex gradient matrix (column vid has 3 rows for
+// each vertex that shares at least one element with it)
+template<class Mesh, class Fill>
+CINO_INLINE
+void gradient_matrix_per_vert_assemble(const Mesh & m, SparseAssembler & A, const Fill & fill)
+{
+    A.assemble(m.num_verts()*3, m.num_verts(), m.topology_revision(), [&](const uint vid, std::vector<uint> & rows)
+    {
+        for(uint pid : m.adj_v2p(vid))
+        for(uint nbr : m.adj_p2v(pid))
+        {
+            rows.push_back(3*nbr  );
+            rows.push_back(3*nbr+1);
+            rows.push_back(3*nbr+2);
         }
+    }, fill);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-        G.setFromTriplets(entries.begin(), entries.end());
-        return G;
+// writes g in rows row,row+1,row+2 of column col. The three entries are consecutive
+// in the column, hence only the first one needs to be searched for. If they are not
+// in the pattern nothing is written, and in_pattern is set to false
+CINO_INLINE
+void gradient_matrix_add(SparseAssembler & A, const uint row, const uint col, const vec3d & g, std::atomic<bool> & in_pattern)
+{
+    int s = A.slot(row, col);
+    if(s<0)
+    {
+        in_pattern = false;
+        return;
     }
-    else // per vertex
+    double * val = A.values() + s;
+    val[0] += g.x();
+    val[1] += g.y();
+    val[2] += g.z();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+const Eigen::SparseMatrix<double> & gradient_matrix(const AbstractPolygonMesh<M,V,E,P> & m, SparseAssembler & A, const bool per_poly)
+{
+    // contribution of vertex curr to the gradient of poly pid
+    auto vert_contr = [&](const uint pid, const uint off, uint & curr) -> vec3d
     {
-        Eigen::SparseMatrix<double> G(m.num_verts()*3, m.num_verts());
-        std::vector<Entry> entries;
+        vec3d n    = m.poly_data(pid).normal;
+        uint  prev = m.poly_vert_id(pid,off);
+              curr = m.poly_vert_id(pid,(off+1)%m.verts_per_poly(pid));
+        uint  next = m.poly_vert_id(pid,(off+2)%m.verts_per_poly(pid));
+        vec3d u    = m.vert(next) - m.vert(curr);
+        vec3d v    = m.vert(curr) - m.vert(prev);
+        vec3d u_90 = u.cross(n); u_90.normalize();
+        vec3d v_90 = v.cross(n); v_90.normalize();
+        return u_90 * u.norm() + v_90 * v.norm();
+    };
 
-        for(uint vid=0; vid<m.num_verts(); ++vid)
+    if(per_poly)
+    {
+        gradient_matrix_per_poly_assemble(m, A, [&]() -> bool
         {
-            std::vector<std::pair<uint,vec3d>> vert_contr;
-            double area=0.f;
-            for(uint pid : m.adj_v2p(vid))
+            std::atomic<bool> in_pattern(true);
+            PARALLEL_FOR(0, m.num_polys(), 1000, [&](const uint pid)
             {
-                area   += std::max(m.poly_area(pid), 1e-5) * 2.0;
-                vec3d n = m.poly_data(pid).normal;
-
+                double area = std::max(m.poly_area(pid), 1e-5) * 2.0; // (2 is the average term : two verts for each edge)
                 for(uint off=0; off<m.verts_per_poly(pid); ++off)
                 {
-                    uint  prev = m.poly_vert_id(pid,off);
-                    uint  curr = m.poly_vert_id(pid,(off+1)%m.verts_per_poly(pid));
-                    uint  next = m.poly_vert_id(pid,(off+2)%m.verts_per_poly(pid));
-                    vec3d u    = m.vert(next) - m.vert(curr);
-                    vec3d v    = m.vert(curr) - m.vert(prev);
-                    vec3d u_90 = u.cross(n); u_90.normalize();
-                    vec3d v_90 = v.cross(n); v_90.normalize();
-
-                    // note: Eigen::setFromTriplets will take care of summing contributs w.r.t. multiple polys
-                    vert_contr.push_back(std::make_pair(curr, u_90*u.norm()+v_90*v.norm()));
+                    uint  curr;
+                    vec3d per_vert_sum_over_edge_normals = vert_contr(pid, off, curr);
+                    per_vert_sum_over_edge_normals /= area;
+                    gradient_matrix_add(A, 3*pid, curr, per_vert_sum_over_edge_normals, in_pattern);
                 }
-            }
-            uint row = vid * 3;
-            for(auto c : vert_contr)
+            });
+            return in_pattern.load();
+        });
+    }
+    else // per vertex
+    {
+        gradient_matrix_per_vert_assemble(m, A, [&]() -> bool
+        {
+            std::atomic<bool> in_pattern(true);
+            PARALLEL_FOR(0, m.num_verts(), 1000, [&](const uint vid)
             {
-                entries.push_back(Entry(row  , c.first, c.second.x()/area));
-                entries.push_back(Entry(row+1, c.first, c.second.y()/area));
-                entries.push_back(Entry(row+2, c.first, c.second.z()/area));
-            }
-        }
-
-        G.setFromTriplets(entries.begin(), entries.end());
-        return G;
+                double area = 0.0;
+                for(uint pid : m.adj_v2p(vid)) area += std::max(m.poly_area(pid), 1e-5) * 2.0;
+                for(uint pid : m.adj_v2p(vid))
+                {
+                    for(uint off=0; off<m.verts_per_poly(pid); ++off)
+                    {
+                        uint  curr;
+                        vec3d contr = vert_contr(pid, off, curr);
+                        gradient_matrix_add(A, 3*vid, curr, contr/area, in_pattern);
+                    }
+                }
+            });
+            return in_pattern.load();
+        });
     }
+    return A.matrix();
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
 template<class M, class V, class E, class F, class P>
 CINO_INLINE
-Eigen::SparseMatrix<double> gradient_matrix(const AbstractPolyhedralMesh<M,V,E,F,P> & m, const bool per_poly)
+const Eigen::SparseMatrix<double> & gradient_matrix(const AbstractPolyhedralMesh<M,V,E,F,P> & m, SparseAssembler & A, const bool per_poly)
 {
-    if(per_poly)
+    // gradient of poly pid w.r.t. its vertex vid
+    auto poly_contr = [&](const uint pid, const uint vid) -> vec3d
     {
-        Eigen::SparseMatrix<double> G(m.num_polys()*3, m.num_verts());
-        std::vector<Entry> entries;
-
-        for(uint pid=0; pid<m.num_polys(); ++pid)
+        double vol = std::max(m.poly_volume(pid), 1e-5);
+        vec3d per_vert_sum_over_f_normals(0,0,0);
+        for(uint fid : m.adj_p2f(pid))
         {
-            double vol = std::max(m.poly_volume(pid), 1e-5);
-
-            for(uint vid : m.adj_p2v(pid))
+            if (m.face_contains_vert(fid,vid))
             {
-                vec3d per_vert_sum_over_f_normals(0,0,0);
-                for(uint fid : m.adj_p2f(pid))
-                {
-                    if (m.face_contains_vert(fid,vid))
-                    {
-                        vec3d  n   = m.poly_face_normal(pid,fid);
-                        double a   = m.face_area(fid);
-                        double avg = static_cast<double>(m.verts_per_face(fid));
-                        per_vert_sum_over_f_normals += (n*a)/avg;
-                    }
-                }
-                per_vert_sum_over_f_normals /= vol;
-                uint row = 3 * pid;
-                entries.push_back(Entry(row, vid, per_vert_sum_over_f_normals.x())); ++row;
-                entries.push_back(Entry(row, vid, per_vert_sum_over_f_normals.y())); ++row;
-                entries.push_back(Entry(row, vid, per_vert_sum_over_f_normals.z()));
+                vec3d  n   = m.poly_face_normal(pid,fid);
+                double a   = m.face_area(fid);
+                double avg = static_cast<double>(m.verts_per_face(fid));
+                per_vert_sum_over_f_normals += (n*a)/avg;
             }
         }
+        return per_vert_sum_over_f_normals / vol;
+    };
 
-        G.setFromTriplets(entries.begin(), entries.end());
-        return G;
-    }
-    else // per vert
+    if(per_poly)
     {
-        Eigen::SparseMatrix<double> G(m.num_polys()*3, m.num_verts());
-        std::vector<Entry> entries;
-
-        for(uint pid=0; pid<m.num_polys(); ++pid)
+        gradient_matrix_per_poly_assemble(m, A, [&]() -> bool
         {
-            double vol = std::max(m.poly_volume(pid), 1e-5);
-
-            for(uint vid : m.adj_p2v(pid))
+            std::atomic<bool> in_pattern(true);
+            PARALLEL_FOR(0, m.num_polys(), 1000, [&](const uint pid)
             {
-                vec3d per_vert_sum_over_f_normals(0,0,0);
-                for(uint fid : m.adj_p2f(pid))
+                for(uint vid : m.adj_p2v(pid))
                 {
-                    if (m.face_contains_vert(fid,vid))
-                    {
-                        vec3d  n   = m.poly_face_normal(pid,fid);
-                        double a   = m.face_area(fid);
-                        double avg = static_cast<double>(m.verts_per_face(fid));
-                        per_vert_sum_over_f_normals += (n*a)/avg;
-                    }
+                    gradient_matrix_add(A, 3*pid, vid, poly_contr(pid,vid), in_pattern);
                 }
-                per_vert_sum_over_f_normals /= vol;
-                uint row = 3 * pid;
-                entries.push_back(Entry(row, vid, per_vert_sum_over_f_normals.x())); ++row;
-                entries.push_back(Entry(row, vid, per_vert_sum_over_f_normals.y())); ++row;
-                entries.push_back(Entry(row, vid, per_vert_sum_over_f_normals.z()));
-            }
-        }
-        G.setFromTriplets(entries.begin(), entries.end());
-
-        Eigen::SparseMatrix<double> A(m.num_verts()*3, m.num_polys()*3);
-        entries.clear();
-
-        for(uint vid=0;vid<m.num_verts();++vid)
+            });
+            return in_pattern.load();
+        });
+    }
+    else // per vert (volume weighted average of the per poly gradients)
+    {
+        // per poly gradients are computed once, and stored in a flat
+        // array, with a section of size verts_per_poly for each poly
+        std::vector<uint> offset(m.num_polys()+1, 0);
+        for(uint pid=0; pid<m.num_polys(); ++pid) offset.at(pid+1) = offset.at(pid) + m.verts_per_poly(pid);
+        std::vector<vec3d>  g(offset.back());
+        std::vector<double> vol(m.num_polys());
+        PARALLEL_FOR(0, m.num_polys(), 1000, [&](const uint pid)
         {
-            double total_volume=0;
-            for(uint pid : m.adj_v2p(vid))
+            vol.at(pid) = m.poly_volume(pid);
+            for(uint off=0; off<m.verts_per_poly(pid); ++off)
             {
-                total_volume += m.poly_volume(pid);
+                g.at(offset.at(pid)+off) = poly_contr(pid, m.poly_vert_id(pid,off));
             }
-            uint row = 3*vid;
-            for(uint pid : m.adj_v2p(vid))
+        });
+
+        gradient_matrix_per_vert_assemble(m, A, [&]() -> bool
+        {
+            std::atomic<bool> in_pattern(true);
+            PARALLEL_FOR(0, m.num_verts(), 1000, [&](const uint vid)
             {
-                uint col=3*pid;
-                entries.push_back(Entry(row,  col,   m.poly_volume(pid)/total_volume));
-                entries.push_back(Entry(row+1,col+1, m.poly_volume(pid)/total_volume));
-                entries.push_back(Entry(row+2,col+2, m.poly_volume(pid)/total_volume));
-            }
-        }
-        A.setFromTriplets(entries.begin(), entries.end());
-        return A*G;
+                double total_volume = 0;
+                for(uint pid : m.adj_v2p(vid)) total_volume += vol.at(pid);
+                for(uint pid : m.adj_v2p(vid))
+                {
+                    double w = vol.at(pid)/total_volume;
+                    for(uint off=0; off<m.verts_per_poly(pid); ++off)
+                    {
+                        gradient_matrix_add(A, 3*vid, m.poly_vert_id(pid,off), g.at(offset.at(pid)+off)*w, in_pattern);
+                    }
+                }
+            });
+            return in_pattern.load();
+        });
     }
+    return A.matrix();
 }
 
 }
@@ -46,6 +46,7 @@
 
 #include <Eigen/Sparse>
 #include <cinolib/cino_inline.h>
+#include <cinolib/sparse_assembler.h>
 #include <cinolib/meshes/abstract_polyhedralmesh.h>
 #include <cinolib/meshes/abstract_polygonmesh.h>
 
@@ -75,6 +76,11 @@ namespace cinolib
  *   A Comparison of Gradient Estimation Methods for Volume Rendering on Unstructured Meshes
  *   Carlos D. Correa, Robert Hero and Kwan-Liu Ma
  *   IEEE Transactions on Visualization and Computer Graphics (2011)
+ *
+ * The versions that take a SparseAssembler assemble the matrix with (and store
+ * it in) A, computing the sparsity pattern only if A does not have one for the
+ * current connectivity of m. Reuse A across calls to cheaply re-assemble the gradient of
+ * a deforming mesh.
 */
 
 template<class M, class V, class E, class P>
@@ -87,6 +93,18 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 Eigen::SparseMatrix<double> gradient_matrix(const AbstractPolyhedralMesh<M,V,E,F,P> & m, const bool per_poly = true);
 
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+const Eigen::SparseMatrix<double> & gradient_matrix(const AbstractPolygonMesh<M,V,E,P> & m, SparseAssembler & A, const bool per_poly = true);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+const Eigen::SparseMatrix<double> & gradient_matrix(const AbstractPolyhedralMesh<M,V,E,F,P> & m, SparseAssembler & A, const bool per_poly = true);
 }
 
 #ifndef  CINO_STATIC_LIB
@@ -34,12 +34,12 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/grid_projector.h>
-#include <cinolib/octree.h>
 
 namespace cinolib
 {
 
-template<class M1, class V1, class E1, class F1, class P1,
+template<class SpatialIndex,
+         class M1, class V1, class E1, class F1, class P1,
          class M2, class V2, class E2, class P2>
 CINO_INLINE
 double grid_projector(      Hexmesh<M1,V1,E1,F1,P1> & m,
@@ -54,10 +54,10 @@ double grid_projector(      Hexmesh<M1,V1,E1,F1,P1> & m,
     };
     std::vector<Proj> targets;
 
-    // prepare octrees for projection
-    Octree o_srf;
-    Octree o_corners;
-    Octree o_lines;
+    // prepare spatial indices for projection
+    SpatialIndex o_srf;
+    SpatialIndex o_corners;
+    SpatialIndex o_lines;
     for(uint vid=0; vid<srf.num_verts(); ++vid)
     {
         uint count = 0;
@@ -116,7 +116,7 @@ double grid_projector(      Hexmesh<M1,V1,E1,F1,P1> & m,
         {
             PARALLEL_FOR(0, m.num_verts(), 1000,[&](const uint vid)
             {
-                vec3d p;
+                vec3d p(0,0,0);
                 if(m.vert_is_on_srf(vid))
                 {
                     for(uint nbr : m.vert_adj_srf_verts(vid)) p += verts.at(nbr);
@@ -221,7 +221,7 @@ double grid_projector(      Hexmesh<M1,V1,E1,F1,P1> & m,
         for(auto & t : targets)
         {
             vec3d p = binary_search(t.vid, t.target);
-            m.vert(t.vid) = p;
+            m.vert_move(t.vid, p);
             t.dist = p.dist(t.target);
         }
 
@@ -37,6 +37,7 @@
 #define CINO_GRID_PROJECTOR_H
 
 #include <cinolib/meshes/meshes.h>
+#include <cinolib/octree.h>
 
 namespace cinolib
 {
@@ -54,7 +55,9 @@ GridProjectorOptions;
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-template<class M1, class V1, class E1, class F1, class P1,
+// SpatialIndex is the data structure used for closest point queries (e.g. Octree or BVH)
+template<class SpatialIndex = Octree,
+         class M1, class V1, class E1, class F1, class P1,
          class M2, class V2, class E2, class P2>
 CINO_INLINE
 double grid_projector(      Hexmesh<M1,V1,E1,F1,P1> & m,
@@ -1063,6 +1063,7 @@ void SurfaceMeshControlPanel<Mesh>::connect()
                     face_normals.push_seg(c, c+(n*l));
                 }
             }
+            face_normals.updateGL();
             canvas->push_obj(&face_normals,false);
         }
         else canvas->pop(&face_normals);
@@ -1088,6 +1089,7 @@ void SurfaceMeshControlPanel<Mesh>::connect()
                     vert_normals.push_seg(p, p+(n*l));
                 }
             }
+            vert_normals.updateGL();
             canvas->push_obj(&vert_normals,false);
         }
         else canvas->pop(&vert_normals);
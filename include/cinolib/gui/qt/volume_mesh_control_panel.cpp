@@ -1468,6 +1468,7 @@ void VolumeMeshControlPanel<Mesh>::connect()
                     face_normals.push_seg(c, c+(n*l));
                 }
             }
+            face_normals.updateGL();
             canvas->push_obj(&face_normals,false);
         }
         else canvas->pop(&face_normals);
@@ -1493,6 +1494,7 @@ void VolumeMeshControlPanel<Mesh>::connect()
                     vert_normals.push_seg(p, p+(n*l));
                 }
             }
+            vert_normals.updateGL();
             canvas->push_obj(&vert_normals,false);
         }
         else canvas->pop(&vert_normals);
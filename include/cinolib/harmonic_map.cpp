@@ -46,7 +46,8 @@ ScalarField harmonic_map(const AbstractMesh<M,V,E,P> & m,
                          const std::map<uint,double> & bc,
                          const uint                    n,
                          const int                     laplacian_mode,
-                         const int                     solver)
+                         const int                     solver,
+                               LinearSolverCache     * cache)
 {
     assert(n > 0);
     assert(bc.size() > 0);
@@ -61,7 +62,7 @@ ScalarField harmonic_map(const AbstractMesh<M,V,E,P> & m,
 
     for(uint i=1; i<n; ++i) Ln  = Ln * (-L); // keep it PSD
 
-    solve_square_system_with_bc(Ln, rhs, f, bc, solver);
+    solve_square_system_with_bc(Ln, rhs, f, bc, solver, cache);
 
     return f;
 }
@@ -75,39 +76,35 @@ std::vector<vec3d> harmonic_map_3d(const AbstractMesh<M,V,E,P> & m,
                                    const std::map<uint,vec3d>  & bc,
                                    const uint                    n,
                                    const int                     laplacian_mode,
-                                   const int                     solver)
+                                   const int                     solver,
+                                         LinearSolverCache     * cache)
 {
     assert(n > 0);
     assert(bc.size() > 0);
     assert(laplacian_mode == COTANGENT || laplacian_mode == UNIFORM);
     assert(solver == SIMPLICIAL_LLT || solver == SIMPLICIAL_LDLT || solver == SparseLU || solver == BiCGSTAB);
 
-    ScalarField f(3*m.num_verts());
-
-    Eigen::SparseMatrix<double> L   = laplacian(m, laplacian_mode, 3);
+    // x, y and z are three independent problems sharing the same matrix and boundary
+    // vertices: factorize it once and solve for three right hand sides at once
+    Eigen::SparseMatrix<double> L   = laplacian(m, laplacian_mode);
     Eigen::SparseMatrix<double> Ln = -L;
-    Eigen::VectorXd             rhs = Eigen::VectorXd::Zero(3*m.num_verts());
+    Eigen::MatrixXd             rhs = Eigen::MatrixXd::Zero(m.num_verts(),3);
 
     for(uint i=1; i<n; ++i) Ln  = Ln * (-L); // keep it PSD
 
-    uint y_off = m.num_verts();
-    uint z_off = m.num_verts() + y_off;
-    std::map<uint,double> bc_1d;
+    std::map<uint,Eigen::VectorXd> bc_3d;
     for(auto obj : bc)
     {
-        uint  vid = obj.first;
-        vec3d pos = obj.second;
-        bc_1d[      vid] = pos.x();
-        bc_1d[y_off+vid] = pos.y();
-        bc_1d[z_off+vid] = pos.z();
+        bc_3d[obj.first] = Eigen::Vector3d(obj.second.x(), obj.second.y(), obj.second.z());
     }
 
-    solve_square_system_with_bc(Ln, rhs, f, bc_1d, solver);
+    Eigen::MatrixXd X;
+    solve_square_system_with_bc(Ln, rhs, X, bc_3d, solver, cache);
 
     std::vector<vec3d> res(m.num_verts());
     for(uint vid=0; vid<m.num_verts(); ++vid)
     {
-        res.at(vid) = vec3d(f[vid], f[y_off+vid], f[z_off+vid]);
+        res.at(vid) = vec3d(X(vid,0), X(vid,1), X(vid,2));
     }
 
     return res;
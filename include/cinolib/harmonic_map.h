@@ -57,6 +57,9 @@ namespace cinolib
  * n = 2  | biharmonic  | C^1 at boundary conditions, C^2 everywhere else
  * n = 3  | triharmonic | C^2 at boundary conditions, C^3 everywhere else
  * ...
+ *
+ * If a cache is provided, repeated calls with the same mesh and boundary vertices
+ * (e.g. with different boundary values) reuse the factorization of the system matrix
 */
 
 template<class M, class V, class E, class P>
@@ -65,7 +68,8 @@ ScalarField harmonic_map(const AbstractMesh<M,V,E,P> & m,
                          const std::map<uint,double> & bc,
                          const uint                    n = 1,
                          const int                     laplacian_mode = COTANGENT,
-                         const int                     solver = SIMPLICIAL_LLT);
+                         const int                     solver = SIMPLICIAL_LLT,
+                               LinearSolverCache     * cache = nullptr);
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
@@ -75,7 +79,8 @@ std::vector<vec3d> harmonic_map_3d(const AbstractMesh<M,V,E,P> & m,
                                    const std::map<uint,vec3d>  & bc,
                                    const uint                    n = 1,
                                    const int                     laplacian_mode = COTANGENT,
-                                   const int                     solver = SIMPLICIAL_LLT);
+                                   const int                     solver = SIMPLICIAL_LLT,
+                                         LinearSolverCache     * cache = nullptr);
 }
 
 #ifndef  CINO_STATIC_LIB
@@ -42,12 +42,16 @@
 #include <cinolib/scalar_field.h>
 #include <cinolib/meshes/abstract_mesh.h>
 #include <cinolib/symbols.h>
+#include <cinolib/linear_solvers.h>
 
 namespace cinolib
 {
 
 /* Solve the heat flow problem  (M - t * L) u = u0,
  * subject to certain Dirichlet boundary conditions
+ *
+ * If a cache is provided, repeated calls on the same mesh (e.g. with different
+ * heat charges) reuse the factorization of the system matrix
 */
 
 template<class M, class V, class E, class P>
@@ -56,7 +60,8 @@ ScalarField heat_flow(const AbstractMesh<M,V,E,P> & m,
                       const std::vector<uint>     & heat_charges,
                       const double                  time = 1.0,
                       const int                     laplacian_mode = COTANGENT,
-                      const bool                    hard_contraint_bcs = false);
+                      const bool                    hard_contraint_bcs = false,
+                            LinearSolverCache     * cache = nullptr);
 }
 
 #ifndef  CINO_STATIC_LIB
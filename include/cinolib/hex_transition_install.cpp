@@ -427,8 +427,8 @@ void mark_concave_edge(const Polyhedralmesh<M,V,E,F,P>     & m,
                        const std::vector<uint>             & t_verts_direction,
                        std::unordered_map<uint,SchemeInfo> & poly2scheme)
 {
-    auto adjs_v1 = m.adj_v2v(t_verts[0]);
-    auto adjs_v2 = m.adj_v2v(t_verts[1]);
+    std::vector<uint> adjs_v1 = m.adj_v2v(t_verts[0]);
+    std::vector<uint> adjs_v2 = m.adj_v2v(t_verts[1]);
     std::vector<uint> intersection;
     std::sort(adjs_v1.begin(), adjs_v1.end());
     std::sort(adjs_v2.begin(), adjs_v2.end());
@@ -594,8 +594,8 @@ void mark_convex(const Polyhedralmesh<M,V,E,F,P>     & m,
     uint conv_edge_vert = t_verts.back();
     int min_ref = find_min_ref(m, conv_edge_vert);
 
-    auto adj1 = m.adj_v2p(t_verts[0]);
-    auto adj2 = m.adj_v2p(t_verts[1]);
+    std::vector<uint> adj1 = m.adj_v2p(t_verts[0]);
+    std::vector<uint> adj2 = m.adj_v2p(t_verts[1]);
     std::vector<uint> intersection;
     std::sort(adj1.begin(), adj1.end());
     std::sort(adj2.begin(), adj2.end());
@@ -34,9 +34,12 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/homotopy_basis.h>
-#include <cinolib/shortest_path_tree.h>
+#include <cinolib/dijkstra_engine.h>
 #include <cinolib/mst.h>
+#include <cinolib/parallel_for.h>
 #include <cinolib/stl_container_utilities.h>
+#include <atomic>
+#include <mutex>
 
 namespace cinolib
 {
@@ -87,25 +90,107 @@ double homotopy_basis(AbstractPolygonMesh<M,V,E,P>   & m,
                       std::vector<std::vector<uint>> & basis,
                       std::vector<bool>              & tree,
                       std::vector<bool>              & cotree)
+{
+    const AbstractPolygonMesh<M,V,E,P> & cm = m;
+    return homotopy_basis(cm, root, inf_double, basis, tree, cotree);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+double homotopy_basis(const AbstractPolygonMesh<M,V,E,P> & m,
+                      const uint                           root,
+                      const double                         max_length,
+                      std::vector<std::vector<uint>>     & basis,
+                      std::vector<bool>                  & tree,
+                      std::vector<bool>                  & cotree)
 {
     assert(root<m.num_verts());
 
-    shortest_path_tree(m, root, tree);
+    // per thread buffers, reused across calls
+    static thread_local std::vector<double> dist;         // distance from root
+    static thread_local std::vector<int>    parent;       // parent vertex in the shortest path tree
+    static thread_local std::vector<float>  edge_weights; // weights for the cotree computation
+
+    // Lower bound for the basis length. Let K be the sub complex made of the vertices settled
+    // by Dijkstra (i.e. the geodesic ball of radius R around root), plus all edges and polys
+    // whose vertices are all in it. The loops of the basis are independent in homology, and a
+    // loop of length l through root only visits vertices at distance at most l/2. Therefore,
+    // if K first has k independent cycles (b1 = 1 - Euler characteristic, K being connected)
+    // at radius R_k, the k-th shortest loop is at least 2R_k long. Loops not appeared yet are
+    // at least 2R long. A tiny tolerance accounts for round off errors
+    int    n_gen = std::max(0, 2*m.genus());
+    bool   prune = max_length < inf_double && n_gen>0;
+    double limit = max_length + 1e-9*max_length;
+    bool   closed = true;
+    if(prune) for(uint eid=0; eid<m.num_edges() && closed; ++eid) closed = !m.edge_is_boundary(eid);
+
+    // grow the shortest path tree, aborting as soon as the bound exceeds the limit
+    DijkstraEngine & engine = dijkstra_thread_engine();
+    int    nv = 0, ne = 0, np = 0; // elements in K
+    int    n_found = 0;            // number of loops appeared so far...
+    double bound   = 0.0;          // ...and their minimum length
+    bool complete  = engine.search_visit(m.num_verts(), std::vector<uint>(1,root),
+    [&m](const uint vid, std::vector<DijkstraArc> & arcs)
+    {
+        for(uint eid : m.adj_v2e(vid)) arcs.emplace_back(m.vert_opposite_to(eid,vid), m.edge_length(eid));
+    },
+    [&](const uint vid)
+    {
+        if(!prune) return true;
+
+        ++nv;
+        for(uint nbr : m.adj_v2v(vid)) if(engine.settled(nbr)) ++ne;
+        for(uint pid : m.adj_v2p(vid))
+        {
+            bool in_K = true;
+            for(uint v : m.adj_p2v(pid)) in_K = in_K && engine.settled(v);
+            if(in_K) ++np;
+        }
+        int b2 = (closed && np==int(m.num_polys())) ? 1 : 0;
+        int b1 = 1 - (nv - ne + np) + b2;
+
+        double R = engine.dist(vid);
+        for(; n_found<std::min(b1,n_gen); ++n_found) bound += 2*R;
+        return bound + (n_gen-n_found)*2*R <= limit;
+    });
+    if(!complete) return inf_double;
+
+    // shortest path tree: there may be multiple shortest paths from root to vid.
+    // Consistently choose the one with lowest ID, as in shortest_path_tree()
+    dist.resize(m.num_verts());
+    parent.assign(m.num_verts(), -1);
+    for(uint vid=0; vid<m.num_verts(); ++vid) dist.at(vid) = engine.dist(vid);
+    tree.assign(m.num_edges(), false);
+    for(uint vid=0; vid<m.num_verts(); ++vid)
+    {
+        if(vid==root) continue;
+        int p_eid = -1;
+        for(uint eid : m.adj_v2e(vid))
+        {
+            uint nbr = m.vert_opposite_to(eid,vid);
+            if(dist.at(vid) == m.edge_length(eid) + dist.at(nbr) && (p_eid<0 || int(nbr)<parent.at(vid)))
+            {
+                parent.at(vid) = nbr;
+                p_eid = eid;
+            }
+        }
+        assert(p_eid>=0);
+        tree.at(p_eid) = true;
+    }
 
     // Compute the cotree as the Maximum Spanning Tree of the dual of M,
     // without considering dual edges that cross edges of primal tree.
     //
     // I'm using a classical Minimum Spanning Tree algorithm (Prim's) with negative weights
-    std::vector<float> edge_weights(m.num_edges(),0);
-    std::vector<bool>  edge_mask(m.num_edges()); // restrict Dijkstra to the edges in tree only
-    for(uint eid=0; eid<m.num_edges(); ++eid) edge_mask.at(eid) = !tree.at(eid);
+    edge_weights.assign(m.num_edges(), 0);
     for(uint eid=0; eid<m.num_edges(); ++eid)
     {
         if(tree.at(eid)) continue;
-        std::vector<uint> tmp;
         edge_weights.at(eid) -= m.edge_length(eid);
-        edge_weights.at(eid) -= dijkstra_mask_on_edges(m, m.edge_vert_id(eid,0), root, edge_mask, tmp);
-        edge_weights.at(eid) -= dijkstra_mask_on_edges(m, m.edge_vert_id(eid,1), root, edge_mask, tmp);
+        edge_weights.at(eid) -= dist.at(m.edge_vert_id(eid,0));
+        edge_weights.at(eid) -= dist.at(m.edge_vert_id(eid,1));
     }
     MST_on_dual_mask_on_edges(m, edge_weights, tree, cotree); // use tree as edge mask
 
@@ -115,7 +200,7 @@ double homotopy_basis(AbstractPolygonMesh<M,V,E,P>   & m,
     {
         if(!tree.at(eid) && !cotree.at(eid)) generators.push_back(eid);
     }
-    assert(m.genus()*2 == (int)generators.size());
+    assert(n_gen == int(generators.size()));
 
     // Start from each such edge, and close a loop with its two endpoints
     basis.clear();
@@ -123,9 +208,11 @@ double homotopy_basis(AbstractPolygonMesh<M,V,E,P>   & m,
     for(uint eid : generators)
     {
         std::vector<uint> e0_to_root, e1_to_root;
+        for(int vid=m.edge_vert_id(eid,0); vid!=-1; vid=parent.at(vid)) e0_to_root.push_back(vid);
+        for(int vid=m.edge_vert_id(eid,1); vid!=-1; vid=parent.at(vid)) e1_to_root.push_back(vid);
         length += m.edge_length(eid);
-        length += dijkstra_mask_on_edges(m, m.edge_vert_id(eid,0), root, edge_mask, e0_to_root);
-        length += dijkstra_mask_on_edges(m, m.edge_vert_id(eid,1), root, edge_mask, e1_to_root);
+        length += dist.at(m.edge_vert_id(eid,0));
+        length += dist.at(m.edge_vert_id(eid,1));
         e1_to_root.pop_back();
         std::reverse(e1_to_root.begin(), e1_to_root.end());
         std::copy(e1_to_root.begin(), e1_to_root.end(), std::back_inserter(e0_to_root));
@@ -142,34 +229,44 @@ void homotopy_basis(AbstractPolygonMesh<M,V,E,P> & m,
                     HomotopyBasisData            & data)
 {
     // BASIS COMPUTATION: either run tree-cotree once on a given root in O(n log n), or try
-    // computing a homotopy basis for each mesh vertex, findng the shortest in O(n^2 log n)
+    // computing a homotopy basis for each mesh vertex, findng the shortest in O(n^2 log n).
+    // Roots are evaluated in parallel, and each evaluation is aborted as soon as it is proven
+    // that it cannot beat the best basis found so far. Among bases of equal length, the one
+    // with lowest root is chosen, hence the output does not depend on the evaluation order
     //
     if(data.globally_shortest)
     {
-        double best_length = inf_double;
-        uint   best_root;
-        std::vector<std::vector<uint>> best_basis;
-        std::vector<bool>              best_tree;
-        std::vector<bool>              best_cotree;
-
-        for(uint vid=0; vid<m.num_verts(); ++vid)
+        std::vector<uint> roots;
+        uint nv = m.num_verts();
+        uint n  = (data.n_root_samples>0) ? std::min(data.n_root_samples, nv) : nv;
+        for(uint i=0; i<n; ++i) roots.push_back(uint(uint64_t(i)*nv/n));
+
+        const AbstractPolygonMesh<M,V,E,P> & cm = m;
+        std::mutex          mutex;
+        std::atomic<double> best_length(inf_double);
+        uint                best_root = max_uint;
+        PARALLEL_FOR(0, roots.size(), 2, SCHEDULE_DYNAMIC, 1, [&](const uint i)
         {
-            double length = homotopy_basis(m, vid, data.loops, data.tree, data.cotree);
-
-            if(length < best_length)
+            std::vector<std::vector<uint>> basis;
+            std::vector<bool>              tree;
+            std::vector<bool>              cotree;
+            double max_length = data.prune_roots ? best_length.load() : inf_double;
+            double length     = homotopy_basis(cm, roots.at(i), max_length, basis, tree, cotree);
+            if(length==inf_double) return;
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if(length < best_length || (length == best_length && roots.at(i) < best_root))
             {
-                best_root   = vid;
+                best_root   = roots.at(i);
                 best_length = length;
-                best_basis  = data.loops;
-                best_tree   = data.tree;
-                best_cotree = data.cotree;
+                data.loops  = basis;
+                data.tree   = tree;
+                data.cotree = cotree;
             }
-        }
-        data.loops  = best_basis;
+        });
+        assert(best_root<nv);
         data.root   = best_root;
         data.length = best_length;
-        data.tree   = best_tree;
-        data.cotree = best_cotree;
     }
     else
     {
@@ -356,8 +453,8 @@ uint detach_loops_by_vert_split(Trimesh<M,V,E,P>  & m,
 
     vec3d og_pos = m.vert(v_mid);
     uint  v_new  = m.vert_split(e_in, e_out);
-    m.vert(v_mid) = og_pos;
-    m.vert(v_new) = new_pos;
+    m.vert_move(v_mid, og_pos);
+    m.vert_move(v_new, new_pos);
 
     // reset loop topology inside the refined umbrella
     for(uint eid : m.adj_v2e(v_mid)) m.edge_data(eid).label = 0;
@@ -113,6 +113,8 @@ typedef struct
     // INPUT: SETTINGS
     bool  globally_shortest  = false; // cost for globally shortest is O(n^2 log n). When this is set to true, root will contain the root of the globally shortest basis
     uint  root               = 0;     // cost for a base centered at root is O(n log n)
+    uint  n_root_samples     = 0;     // if globally shortest, evaluate only this many (evenly spaced) candidate roots. Zero means all vertices
+    bool  prune_roots        = true;  // if globally shortest, skip roots that provably cannot improve on the best basis found so far (exact, does not change the output)
 
     // INPUT: REFINEMENT OPTIONS AND STATISTICS
     bool  detach_loops       = false;                 // refine mesh topology to detach loops traversing the same edges
@@ -153,6 +155,21 @@ double homotopy_basis(AbstractPolygonMesh<M,V,E,P>   & m,
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+// Same as above, but the computation is aborted as soon as the basis is proven to be
+// longer than max_length, in which case inf_double is returned (and the content of
+// basis, tree and cotree is undefined). Used to prune candidate roots in the search
+// for the globally shortest basis. Can be called concurrently on the same mesh
+template<class M, class V, class E, class P>
+CINO_INLINE
+double homotopy_basis(const AbstractPolygonMesh<M,V,E,P> & m,
+                      const uint                           root,
+                      const double                         max_length,
+                      std::vector<std::vector<uint>>     & basis,
+                      std::vector<bool>                  & tree,
+                      std::vector<bool>                  & cotree);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 // globally detaches loops in the homotopy basis
 template<class M, class V, class E, class P>
 CINO_INLINE
@@ -0,0 +1,138 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_CINO_FORMAT_H
+#define CINO_CINO_FORMAT_H
+
+#include <stdint.h>
+
+namespace cinolib
+{
+
+/* .cino is the native binary format of CinoLib. A file is made of:
+ *
+ *   header   : magic string, version, endianness tag, mesh type (see MeshType),
+ *              number of sections and position of the section table
+ *   payload  : the data of all sections, each aligned at 8 bytes
+ *   table    : one entry per section (tag, kind, element size, count, offset, size)
+ *
+ * ARRAY sections are flat arrays of count elements (e.g. vertex coordinates).
+ * LISTS sections store a vector of lists (e.g. polygons or adjacency relations)
+ * in CSR form: count+1 uint64 offsets followed by all the list items in a row.
+ * Readers skip the sections they do not know, hence new sections can be added
+ * without breaking older files. Adjacency sections are optional: if present,
+ * meshes are initialized by copying them rather than recomputing connectivity.
+*/
+
+static const char     CINO_MAGIC[8]   = {'C','I','N','O','M','E','S','H'};
+static const uint32_t CINO_VERSION    = 1;
+static const uint32_t CINO_ENDIANNESS = 0x01020304;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+enum
+{
+    CINO_ARRAY = 0,
+    CINO_LISTS = 1,
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+enum
+{
+    // geometry and topology
+    CINO_VERT_XYZ     = 0,  // ARRAY of double triplets
+    CINO_EDGES        = 1,  // ARRAY of uint (two per edge)
+    CINO_FACES        = 2,  // LISTS of vids   (volume meshes only)
+    CINO_POLYS        = 3,  // LISTS of vids (surface meshes) or fids (volume meshes)
+    CINO_POLY_WINDING = 4,  // LISTS of bool (volume meshes only)
+    // attributes
+    CINO_VERT_UVW     = 10, // ARRAY of double triplets
+    CINO_VERT_LABEL   = 11, // ARRAY of int
+    CINO_POLY_LABEL   = 12, // ARRAY of int
+    CINO_POLY_COLOR   = 13, // ARRAY of float quadruplets (RGBA)
+    // adjacency
+    CINO_V2V          = 20,
+    CINO_V2E          = 21,
+    CINO_V2F          = 22,
+    CINO_V2P          = 23,
+    CINO_E2F          = 24,
+    CINO_E2P          = 25,
+    CINO_F2E          = 26,
+    CINO_F2F          = 27,
+    CINO_F2P          = 28,
+    CINO_P2V          = 29,
+    CINO_P2E          = 30,
+    CINO_P2P          = 31,
+    // heat geodesics cache (see GeodesicsCache in geodesics.h). Sparse matrices
+    // take three consecutive tags, storing their CSC arrays (outer, inner, values)
+    CINO_GEO_INFO      = 40, // ARRAY of uint64 (#verts, #polys, mesh hash, laplacian mode)
+    CINO_GEO_TIME      = 41, // ARRAY of double (time scalar)
+    CINO_GEO_HEAT_P    = 42, // ARRAY of int (fill reducing permutation)
+    CINO_GEO_HEAT_L    = 43, // sparse (43,44,45): Cholesky factor of the heat flow matrix
+    CINO_GEO_POISSON_P = 46, // ARRAY of int (fill reducing permutation)
+    CINO_GEO_POISSON_D = 47, // ARRAY of double (diagonal of the LDLT factorization)
+    CINO_GEO_POISSON_L = 48, // sparse (48,49,50): LDLT factor of the Laplacian
+    CINO_GEO_GRADIENT  = 51, // sparse (51,52,53): gradient matrix
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+struct CINO_header
+{
+    char     magic[8];
+    uint32_t version;
+    uint32_t endianness;
+    uint32_t mesh_type;
+    uint32_t n_sections;
+    uint64_t table_offset;
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+struct CINO_section
+{
+    uint32_t tag;
+    uint32_t kind;
+    uint32_t elem_size; // in bytes
+    uint32_t padding;
+    uint64_t count;     // number of elements (ARRAY) or lists (LISTS)
+    uint64_t offset;    // from the beginning of the file
+    uint64_t bytes;
+};
+
+}
+
+#endif // CINO_CINO_FORMAT_H
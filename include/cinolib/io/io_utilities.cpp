@@ -35,6 +35,10 @@
 *********************************************************************************/
 #include <cinolib/io/io_utilities.h>
 #include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <locale.h>
+#include <ctype.h>
 
 namespace cinolib
 {
@@ -108,4 +112,146 @@ bool eat_uint(FILE * f, uint & i)
     return true;
 }
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void skip_blanks(const char *& s, const char * end)
+{
+    while(s<end && (*s==' ' || *s=='\t' || *s=='\r' || *s=='\v' || *s=='\f')) ++s;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void skip_line(const char *& s, const char * end)
+{
+    const char *nl = (s<end) ? (const char*)memchr(s, '\n', end-s) : NULL;
+    s = (nl) ? nl+1 : end;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+std::string parse_word(const char *& s, const char * end)
+{
+    skip_blanks(s, end);
+    const char *beg = s;
+    while(s<end && !isspace((unsigned char)*s)) ++s;
+    return std::string(beg, s);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool parse_double(const char *& s, const char * end, double & d)
+{
+    // Numbers having at most 15 significant digits and a small exponent are
+    // converted exactly with a single floating point operation (Clinger's fast
+    // path). Everything else (e.g. numbers written with %.17g, inf, nan) falls
+    // back to strtod, which is slower but correctly rounded
+    static const double pow10[] =
+    {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    const char *p = s;
+    skip_blanks(p, end);
+    const char *beg = p;
+
+    bool neg = false;
+    if(p<end && (*p=='-' || *p=='+')) neg = (*p++=='-');
+
+    uint64_t m        = 0;
+    int      n_digits = 0; // significant digits
+    int      exp10    = 0;
+    bool     any      = false;
+    bool     exact    = true;
+    while(p<end && *p>='0' && *p<='9')
+    {
+        any = true;
+        if(n_digits<19) { m = m*10 + (*p-'0'); if(m>0) ++n_digits; }
+        else            { ++exp10; if(*p!='0') exact = false; }
+        ++p;
+    }
+    if(p<end && *p=='.')
+    {
+        ++p;
+        while(p<end && *p>='0' && *p<='9')
+        {
+            any = true;
+            if(n_digits<19) { m = m*10 + (*p-'0'); if(m>0) ++n_digits; --exp10; }
+            else if(*p!='0') exact = false;
+            ++p;
+        }
+    }
+    if(any && p<end && (*p=='e' || *p=='E'))
+    {
+        const char *q = p+1;
+        bool neg_exp = false;
+        if(q<end && (*q=='-' || *q=='+')) neg_exp = (*q++=='-');
+        if(q<end && *q>='0' && *q<='9')
+        {
+            int e = 0;
+            while(q<end && *q>='0' && *q<='9') { if(e<100000) e = e*10 + (*q-'0'); ++q; }
+            exp10 += (neg_exp) ? -e : e;
+            p = q;
+        }
+    }
+
+    if(any && exact && m<(uint64_t(1)<<53) && exp10>=-22 && exp10<=22)
+    {
+        d = (double)m;
+        if(exp10<0) d /= pow10[-exp10];
+        else        d *= pow10[ exp10];
+        if(neg) d = -d;
+        s = p;
+        return true;
+    }
+
+    // slow path: copy the token and make it readable by strtod in the current locale
+    if(!any) while(p<end && !isspace((unsigned char)*p)) ++p; // inf, nan, ...
+    std::string token(beg, p);
+    char point = localeconv()->decimal_point[0];
+    if(point!='.') for(char & c : token) if(c=='.') c = point;
+    char *token_end;
+    d = strtod(token.c_str(), &token_end);
+    if(token_end==token.c_str()) return false;
+    s = beg + (token_end - token.c_str());
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool parse_int(const char *& s, const char * end, int & i)
+{
+    const char *p = s;
+    skip_blanks(p, end);
+    bool neg = false;
+    if(p<end && (*p=='-' || *p=='+')) neg = (*p++=='-');
+    if(p>=end || *p<'0' || *p>'9') return false;
+    long long v = 0;
+    while(p<end && *p>='0' && *p<='9') v = v*10 + (*p++ - '0');
+    i = int((neg) ? -v : v);
+    s = p;
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool parse_uint(const char *& s, const char * end, uint & i)
+{
+    const char *p = s;
+    skip_blanks(p, end);
+    if(p<end && *p=='+') ++p;
+    if(p>=end || *p<'0' || *p>'9') return false;
+    unsigned long long v = 0;
+    while(p<end && *p>='0' && *p<='9') v = v*10 + (*p++ - '0');
+    i = uint(v);
+    s = p;
+    return true;
+}
+
 }
@@ -37,6 +37,8 @@
 #define CINO_IO_UTILITIES_H
 
 #include <iostream>
+#include <string>
+#include <sys/types.h>
 #include <cinolib/cino_inline.h>
 
 namespace cinolib
@@ -72,6 +74,45 @@ bool eat_uint(FILE * f, uint & i);
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+/* Tokenizers for in-memory buffers (e.g. memory mapped files). They all
+ * advance the cursor s, never read past end, and do not cross line breaks.
+ * Numbers are parsed independently of the current C locale ("." is always
+ * the decimal separator). The parse_* functions return false, leaving s
+ * untouched, if the next token is not a valid number.
+*/
+
+CINO_INLINE
+void skip_blanks(const char *& s, const char * end);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// moves s to the first character of the next line (or to end)
+CINO_INLINE
+void skip_line(const char *& s, const char * end);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// returns the first non blank token of the current line
+CINO_INLINE
+std::string parse_word(const char *& s, const char * end);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool parse_double(const char *& s, const char * end, double & d);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool parse_int(const char *& s, const char * end, int & i);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool parse_uint(const char *& s, const char * end, uint & i);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 }
 
 #ifndef  CINO_STATIC_LIB
@@ -0,0 +1,155 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/io/mapped_file.h>
+#include <cinolib/parallel_for.h>
+#include <string.h>
+#include <stdio.h>
+#include <algorithm>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace cinolib
+{
+
+CINO_INLINE
+MappedFile::MappedFile(const char * filename)
+{
+    if(filename!=NULL) open(filename);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool MappedFile::open(const char * filename)
+{
+    close();
+
+#ifndef _WIN32
+    int fd = ::open(filename, O_RDONLY);
+    if(fd<0) return false;
+    struct stat st;
+    if(fstat(fd, &st)==0)
+    {
+        sz = st.st_size;
+        if(sz==0)
+        {
+            ::close(fd);
+            is_valid = true;
+            return true;
+        }
+        void *addr = mmap(NULL, sz, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(addr!=MAP_FAILED)
+        {
+            madvise(addr, sz, MADV_SEQUENTIAL);
+            ::close(fd);
+            ptr      = (const char*)addr;
+            is_mmap  = true;
+            is_valid = true;
+            return true;
+        }
+    }
+    ::close(fd);
+#endif
+
+    // fallback: read the whole file in memory
+    FILE *f = fopen(filename, "rb");
+    if(!f) return false;
+    fseek(f, 0, SEEK_END);
+    long n = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if(n<0) { fclose(f); return false; }
+    buffer.resize(n);
+    sz = fread(buffer.data(), 1, n, f);
+    fclose(f);
+    ptr      = buffer.data();
+    is_valid = true;
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void MappedFile::close()
+{
+#ifndef _WIN32
+    if(is_mmap) munmap((void*)ptr, sz);
+#endif
+    buffer.clear();
+    buffer.shrink_to_fit();
+    ptr      = NULL;
+    sz       = 0;
+    is_valid = false;
+    is_mmap  = false;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+std::vector<const char*> line_aligned_chunks(const char   * beg,
+                                             const char   * end,
+                                             const size_t   min_chunk_size)
+{
+    size_t size     = end - beg;
+    size_t n_chunks = std::min(size_t(4*parallel_for_num_threads()), size/std::max(min_chunk_size,size_t(1)));
+    n_chunks        = std::max(n_chunks, size_t(1));
+
+    std::vector<const char*> chunks;
+    chunks.push_back(beg);
+    for(size_t i=1; i<n_chunks; ++i)
+    {
+        const char *p  = std::max(beg + i*(size/n_chunks), chunks.back());
+        const char *nl = (p<end) ? (const char*)memchr(p, '\n', end-p) : NULL;
+        p = (nl) ? nl+1 : end;
+        if(p>chunks.back() && p<end) chunks.push_back(p);
+    }
+    chunks.push_back(end);
+    return chunks;
+}
+
+}
@@ -0,0 +1,98 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_MAPPED_FILE_H
+#define CINO_MAPPED_FILE_H
+
+#include <vector>
+#include <cstddef>
+#include <sys/types.h>
+#include <cinolib/cino_inline.h>
+
+namespace cinolib
+{
+
+/* Read-only view of a whole file in memory. On POSIX systems the file is
+ * memory mapped, so that pages are loaded lazily by the OS and no copy is
+ * made. Elsewhere (or if mmap fails) the file is read into a heap buffer.
+ * Used by the fast OBJ/OFF/STL readers, which parse chunks of the file in
+ * parallel.
+*/
+
+class MappedFile
+{
+    public:
+
+        explicit MappedFile(const char * filename = NULL);
+        ~MappedFile();
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile & operator=(const MappedFile &) = delete;
+
+        bool open(const char * filename);
+        void close();
+
+        bool         is_open() const { return is_valid; }
+        const char * begin()   const { return ptr;       }
+        const char * end()     const { return ptr + sz;  }
+        size_t       size()    const { return sz;        }
+
+    private:
+
+        const char        *ptr      = NULL;
+        size_t             sz       = 0;
+        bool               is_valid = false;
+        bool               is_mmap  = false;
+        std::vector<char>  buffer;  // used if mmap is not available
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// Splits [beg,end) into chunks that begin at the start of a line, to be
+// parsed independently. The number of chunks depends on the number of
+// threads used by PARALLEL_FOR and on min_chunk_size (in bytes).
+// Returns the chunk boundaries (i.e. #chunks+1 pointers)
+CINO_INLINE
+std::vector<const char*> line_aligned_chunks(const char   * beg,
+                                             const char   * end,
+                                             const size_t   min_chunk_size = 1<<20);
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "mapped_file.cpp"
+#endif
+
+#endif // CINO_MAPPED_FILE_H
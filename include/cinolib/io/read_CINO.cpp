@@ -0,0 +1,236 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/io/read_CINO.h>
+#include <cinolib/parallel_for.h>
+#include <string.h>
+#include <type_traits>
+#include <iostream>
+
+namespace cinolib
+{
+
+CINO_INLINE
+CINO_reader::CINO_reader(const char * filename)
+{
+    if(!f.open(filename))
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : read_CINO() : couldn't open input file " << filename << std::endl;
+        return;
+    }
+    if(f.size()<sizeof(CINO_header))
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : read_CINO() : " << filename << " is not a CINO file" << std::endl;
+        return;
+    }
+    memcpy(&header, f.begin(), sizeof(CINO_header));
+    if(memcmp(header.magic, CINO_MAGIC, 8)!=0)
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : read_CINO() : " << filename << " is not a CINO file" << std::endl;
+        return;
+    }
+    if(header.endianness!=CINO_ENDIANNESS || header.version>CINO_VERSION)
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : read_CINO() : unsupported version (or endianness) of file " << filename << std::endl;
+        return;
+    }
+    if(header.table_offset > f.size() || header.n_sections > (f.size() - header.table_offset)/sizeof(CINO_section))
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : read_CINO() : file " << filename << " is truncated" << std::endl;
+        return;
+    }
+    table.resize(header.n_sections);
+    if(!table.empty()) memcpy(table.data(), f.begin() + header.table_offset, header.n_sections*sizeof(CINO_section));
+    for(const CINO_section & s : table)
+    {
+        if(s.offset > f.size() || s.bytes > f.size() - s.offset)
+        {
+            std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : read_CINO() : file " << filename << " is truncated" << std::endl;
+            return;
+        }
+    }
+    valid = true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint64_t CINO_reader::count(const uint32_t tag) const
+{
+    const CINO_section *s = find(tag);
+    return (s) ? s->count : 0;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<typename T>
+CINO_INLINE
+bool CINO_reader::get_array(const uint32_t tag, std::vector<T> & array) const
+{
+    static_assert(std::is_trivially_copyable<T>::value, "CINO_reader: array type must be trivially copyable");
+    const CINO_section *s = find(tag);
+    if(s==NULL || s->kind!=CINO_ARRAY || s->elem_size!=sizeof(T) || s->count>s->bytes/sizeof(T)) return false;
+    array.resize(s->count);
+    if(s->count>0) memcpy(array.data(), f.begin() + s->offset, s->count*sizeof(T));
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool CINO_reader::get_array(const uint32_t tag, std::vector<vec3d> & array) const
+{
+    const CINO_section *s = find(tag);
+    if(s==NULL || s->kind!=CINO_ARRAY || s->elem_size!=3*sizeof(double) || s->count>s->bytes/(3*sizeof(double))) return false;
+    const double *xyz = (const double*)(f.begin() + s->offset);
+    array.resize(s->count);
+    PARALLEL_FOR(0, s->count, 100000, [&](const uint i)
+    {
+        array[i] = vec3d(xyz[3*i], xyz[3*i+1], xyz[3*i+2]);
+    });
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool CINO_reader::get_lists(const uint32_t tag, std::vector<std::vector<uint>> & lists) const
+{
+    uint64_t count;
+    const uint64_t *offsets = find_lists(tag, sizeof(uint), count);
+    if(offsets==NULL) return false;
+    const uint *items = (const uint*)(offsets + count + 1);
+
+    lists.resize(count);
+    PARALLEL_FOR(0, count, 10000, [&](const uint i)
+    {
+        lists[i].assign(items + offsets[i], items + offsets[i+1]);
+    });
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool CINO_reader::get_lists(const uint32_t tag, AdjacencyLists & lists) const
+{
+    uint64_t count;
+    const uint64_t *offsets = find_lists(tag, sizeof(uint), count);
+    if(offsets==NULL) return false;
+
+    // the section is already in CSR format, hence it is copied in one go
+    lists.assign(count, offsets, (const uint*)(offsets + count + 1));
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool CINO_reader::get_lists(const uint32_t tag, std::vector<std::vector<bool>> & lists) const
+{
+    uint64_t count;
+    const uint64_t *offsets = find_lists(tag, sizeof(uint8_t), count);
+    if(offsets==NULL) return false;
+    const uint8_t *items = (const uint8_t*)(offsets + count + 1);
+
+    lists.resize(count);
+    PARALLEL_FOR(0, count, 10000, [&](const uint i)
+    {
+        lists[i].assign(items + offsets[i], items + offsets[i+1]);
+    });
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+const CINO_section * CINO_reader::find(const uint32_t tag) const
+{
+    for(const CINO_section & s : table) if(s.tag==tag) return &s;
+    return NULL;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+const uint64_t * CINO_reader::find_lists(const uint32_t tag, const uint32_t elem_size, uint64_t & count) const
+{
+    const CINO_section *s = find(tag);
+    if(s==NULL || s->kind!=CINO_LISTS || s->elem_size!=elem_size || s->count>=s->bytes/sizeof(uint64_t)) return NULL;
+
+    const uint64_t *offsets = (const uint64_t*)(f.begin() + s->offset);
+    for(uint64_t i=0; i<s->count; ++i) if(offsets[i]>offsets[i+1]) return NULL;
+    if(offsets[s->count] > (s->bytes - (s->count+1)*sizeof(uint64_t))/elem_size) return NULL;
+    count = s->count;
+    return offsets;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool CINO_ids_in_range(const std::vector<uint> & ids, const uint n)
+{
+    for(uint id : ids) if(id>=n) return false;
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool CINO_ids_in_range(const std::vector<std::vector<uint>> & lists, const uint n)
+{
+    for(const auto & l : lists) if(!CINO_ids_in_range(l,n)) return false;
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool CINO_ids_in_range(const AdjacencyLists & lists, const uint n)
+{
+    for(IndexSpan l : lists) for(uint id : l) if(id>=n) return false;
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool CINO_sizes_in_range(const std::vector<std::vector<uint>> & lists, const uint min_size, const uint max_size)
+{
+    for(const auto & l : lists) if(l.size()<min_size || l.size()>max_size) return false;
+    return true;
+}
+
+}
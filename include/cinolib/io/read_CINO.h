@@ -0,0 +1,112 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_READ_CINO_H
+#define CINO_READ_CINO_H
+
+#include <vector>
+#include <sys/types.h>
+#include <cinolib/cino_inline.h>
+#include <cinolib/io/CINO_format.h>
+#include <cinolib/io/mapped_file.h>
+#include <cinolib/adjacency_lists.h>
+#include <cinolib/geometry/vec_mat.h>
+
+namespace cinolib
+{
+
+/* Reads a .cino file (see CINO_format.h). The file is memory mapped, and
+ * sections are copied straight from the mapped memory to the output vectors.
+ * All the get_* methods return false if the section does not exist or if
+ * it does not contain data of the requested type.
+*/
+
+class CINO_reader
+{
+    public:
+
+        explicit CINO_reader(const char * filename);
+
+        bool     is_open()   const { return valid; }
+        uint32_t mesh_type() const { return header.mesh_type; }
+        bool     has(const uint32_t tag) const { return find(tag)!=NULL; }
+        uint64_t count(const uint32_t tag) const;
+
+        template<typename T>
+        bool get_array(const uint32_t tag, std::vector<T> & array) const;
+        bool get_array(const uint32_t tag, std::vector<vec3d> & array) const;
+        bool get_lists(const uint32_t tag, std::vector<std::vector<uint>> & lists) const;
+        bool get_lists(const uint32_t tag, std::vector<std::vector<bool>> & lists) const;
+        bool get_lists(const uint32_t tag, AdjacencyLists                 & lists) const;
+
+    private:
+
+        const CINO_section * find(const uint32_t tag) const;
+
+        // returns the offsets of a section of lists (followed by its items), or NULL if
+        // the section does not exist, has a different type or its offsets are not valid
+        const uint64_t * find_lists(const uint32_t tag, const uint32_t elem_size, uint64_t & count) const;
+
+        MappedFile                 f;
+        CINO_header                header;
+        std::vector<CINO_section>  table;
+        bool                       valid = false;
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// sections are only checked for size when read. These helpers check that all the ids
+// they contain refer to existing elements (i.e. are smaller than n) before using them
+CINO_INLINE
+bool CINO_ids_in_range(const std::vector<uint> & ids, const uint n);
+
+CINO_INLINE
+bool CINO_ids_in_range(const std::vector<std::vector<uint>> & lists, const uint n);
+
+CINO_INLINE
+bool CINO_ids_in_range(const AdjacencyLists & lists, const uint n);
+
+// checks that each list contains at least min_size and at most max_size ids (e.g.
+// 3 vertices per triangle), so that malformed elements are rejected before use
+CINO_INLINE
+bool CINO_sizes_in_range(const std::vector<std::vector<uint>> & lists, const uint min_size, const uint max_size);
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "read_CINO.cpp"
+#endif
+
+#endif // CINO_READ_CINO_H
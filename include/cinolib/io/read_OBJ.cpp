@@ -44,6 +44,9 @@
 #include <cinolib/io/read_OBJ.h>
 #include <cinolib/to_openGL_unified_verts.h>
 #include <cinolib/string_utilities.h>
+#include <cinolib/io/io_utilities.h>
+#include <cinolib/io/mapped_file.h>
+#include <cinolib/parallel_for.h>
 #include <sstream>
 #include <iostream>
 #include <fstream>
@@ -56,16 +59,122 @@ namespace cinolib
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-// https://stackoverflow.com/questions/9310327/sscanf-optional-column
+// Parses a face corner in one of the formats v, v/vt, v//vn, v/vt/vn.
+// Missing (or invalid) ids are set to -1
 //
 CINO_INLINE
-void read_point_id(char * s, int & v, int & vt, int & vn)
+void read_point_id(const char *& s, const char * end, int & v, int & vt, int & vn)
 {
     v = vt = vn = -1;
-         if(sscanf(s, "%d/%d/%d", &v, &vt, &vn) == 3) { --v; --vt; --vn; }
-    else if(sscanf(s, "%d/%d",    &v, &vt     ) == 2) { --v; --vt;       }
-    else if(sscanf(s, "%d//%d",   &v, &vn     ) == 2) { --v; --vn;       }
-    else if(sscanf(s, "%d",       &v          ) == 1) { --v;             }
+    if(!parse_int(s, end, v)) { while(s<end && !isspace((unsigned char)*s)) ++s; return; }
+    if(s<end && *s=='/')
+    {
+        ++s;
+        if(s<end && *s=='/') { ++s; parse_int(s, end, vn); }
+        else if(parse_int(s, end, vt) && s<end && *s=='/') { ++s; parse_int(s, end, vn); }
+    }
+    while(s<end && !isspace((unsigned char)*s)) ++s; // discard anything else
+    --v; --vt; --vn;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// Output of the parser for a chunk of the OBJ file. Polygons are stored in
+// flat arrays, and materials (which depend on the lines preceding the chunk)
+// are stored as a list of events to be replayed in order when stitching chunks
+//
+struct OBJ_chunk
+{
+    std::vector<vec3d> pos, tex, nor;
+    std::vector<uint>  n_pos, n_tex, n_nor; // number of corners of each 'f' line
+    std::vector<uint>  f_pos, f_tex, f_nor; // corner ids, all polys in a row
+    uint               np = 0, nt = 0, nn = 0;
+    struct Event { uint n_polys_before; bool is_mtllib; std::string arg; };
+    std::vector<Event> events;
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void read_OBJ_chunk(const char * s, const char * end, OBJ_chunk & chunk)
+{
+    while(s<end)
+    {
+        const char *line = s;
+        const char *eol  = (const char*)memchr(s, '\n', end-s);
+        if(eol==NULL) eol = end;
+
+        switch(*line)
+        {
+            case 'v':
+            {
+                double a, b, c;
+                const char *p = line+1;
+                if(p<eol && (*p==' ' || *p=='\t'))
+                {
+                    if(parse_double(p,eol,a) && parse_double(p,eol,b) && parse_double(p,eol,c)) chunk.pos.push_back(vec3d(a,b,c));
+                }
+                else if(p<eol && *p=='t')
+                {
+                    ++p;
+                    if(parse_double(p,eol,a) && parse_double(p,eol,b))
+                    {
+                        if(!parse_double(p,eol,c)) c = 0;
+                        chunk.tex.push_back(vec3d(a,b,c));
+                    }
+                }
+                else if(p<eol && *p=='n')
+                {
+                    ++p;
+                    if(parse_double(p,eol,a) && parse_double(p,eol,b) && parse_double(p,eol,c)) chunk.nor.push_back(vec3d(a,b,c));
+                }
+                break;
+            }
+
+            case 'f':
+            {
+                uint np=0, nt=0, nn=0;
+                const char *p = line+1;
+                for(skip_blanks(p,eol); p<eol; skip_blanks(p,eol))
+                {
+                    int v_pos, v_tex, v_nor;
+                    read_point_id(p, eol, v_pos, v_tex, v_nor);
+                    if(v_pos>=0) { chunk.f_pos.push_back(v_pos); ++np; }
+                    if(v_tex>=0) { chunk.f_tex.push_back(v_tex); ++nt; }
+                    if(v_nor>=0) { chunk.f_nor.push_back(v_nor); ++nn; }
+                }
+                if(np>0) { chunk.n_pos.push_back(np); ++chunk.np; }
+                if(nt>0) { chunk.n_tex.push_back(nt); ++chunk.nt; }
+                if(nn>0) { chunk.n_nor.push_back(nn); ++chunk.nn; }
+                break;
+            }
+
+            case 'u':
+            {
+                const char *p = line;
+                if(parse_word(p,eol)=="usemtl")
+                {
+                    std::string mat = parse_word(p,eol);
+                    if(!mat.empty()) chunk.events.push_back({chunk.np, false, mat});
+                }
+                break;
+            }
+
+            case 'm':
+            {
+                const char *p = line;
+                if(parse_word(p,eol)=="mtllib")
+                {
+                    skip_blanks(p,eol);
+                    const char *q = eol;
+                    while(q>p && isspace((unsigned char)q[-1])) --q;
+                    if(q>p) chunk.events.push_back({chunk.np, true, std::string(p,q)});
+                }
+                break;
+            }
+        }
+        s = eol+1;
+    }
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -115,8 +224,6 @@ void read_OBJ(const char                     * filename,
               std::string                    & specular_path, // path of the image encoding the specular texture component
               std::string                    & normal_path)   // path of the image encoding the normal   texture component
 {
-    setlocale(LC_NUMERIC, "en_US.UTF-8"); // makes sure "." is the decimal separator
-
     pos.clear();
     tex.clear();
     nor.clear();
@@ -128,90 +235,104 @@ void read_OBJ(const char                     * filename,
     specular_path.clear();
     normal_path.clear();
 
-    std::ifstream f(filename);
+    MappedFile f(filename);
     if(!f.is_open())
     {
         std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : read_OBJ() : couldn't open input file " << filename << std::endl;
         exit(-1);
     }
 
+    // parse line aligned chunks of the file in parallel...
+    std::vector<const char*> bounds = line_aligned_chunks(f.begin(), f.end());
+    std::vector<OBJ_chunk>   chunks(bounds.size()-1);
+    PARALLEL_FOR(0, chunks.size(), 2, SCHEDULE_DYNAMIC, 1, [&](const uint i)
+    {
+        read_OBJ_chunk(bounds.at(i), bounds.at(i+1), chunks.at(i));
+    });
+
+    // ...and stitch the results together
+    struct Offsets { size_t pos=0, tex=0, nor=0, np=0, nt=0, nn=0, f_pos=0, f_tex=0, f_nor=0; };
+    std::vector<Offsets> off(chunks.size()+1);
+    for(uint i=0; i<chunks.size(); ++i)
+    {
+        const OBJ_chunk & c = chunks.at(i);
+        off.at(i+1).pos   = off.at(i).pos   + c.pos.size();
+        off.at(i+1).tex   = off.at(i).tex   + c.tex.size();
+        off.at(i+1).nor   = off.at(i).nor   + c.nor.size();
+        off.at(i+1).np    = off.at(i).np    + c.np;
+        off.at(i+1).nt    = off.at(i).nt    + c.nt;
+        off.at(i+1).nn    = off.at(i).nn    + c.nn;
+        off.at(i+1).f_pos = off.at(i).f_pos + c.f_pos.size();
+        off.at(i+1).f_tex = off.at(i).f_tex + c.f_tex.size();
+        off.at(i+1).f_nor = off.at(i).f_nor + c.f_nor.size();
+    }
+    pos.resize(off.back().pos);
+    tex.resize(off.back().tex);
+    nor.resize(off.back().nor);
+    poly_pos.resize(off.back().np);
+    poly_tex.resize(off.back().nt);
+    poly_nor.resize(off.back().nn);
+
+    auto unflatten = [](const std::vector<uint> & n, const std::vector<uint> & ids, std::vector<std::vector<uint>>::iterator out)
+    {
+        auto it = ids.begin();
+        for(uint size : n)
+        {
+            out->assign(it, it+size);
+            it += size;
+            ++out;
+        }
+    };
+    PARALLEL_FOR(0, chunks.size(), 2, SCHEDULE_DYNAMIC, 1, [&](const uint i)
+    {
+        OBJ_chunk & c = chunks.at(i);
+        std::copy(c.pos.begin(), c.pos.end(), pos.begin() + off.at(i).pos);
+        std::copy(c.tex.begin(), c.tex.end(), tex.begin() + off.at(i).tex);
+        std::copy(c.nor.begin(), c.nor.end(), nor.begin() + off.at(i).nor);
+        unflatten(c.n_pos, c.f_pos, poly_pos.begin() + off.at(i).np);
+        unflatten(c.n_tex, c.f_tex, poly_tex.begin() + off.at(i).nt);
+        unflatten(c.n_nor, c.f_nor, poly_nor.begin() + off.at(i).nn);
+        // release memory asap (but keep the material events)
+        std::vector<vec3d>().swap(c.pos);
+        std::vector<vec3d>().swap(c.tex);
+        std::vector<vec3d>().swap(c.nor);
+        std::vector<uint>().swap(c.f_pos);
+        std::vector<uint>().swap(c.f_tex);
+        std::vector<uint>().swap(c.f_nor);
+    });
+
+    // materials are processed serially, in the same order they appear in the file
     std::map<std::string,Color> color_map;
     Color curr_color = Color::WHITE();     // set WHITE as default color
     bool has_per_face_color = false;       // true if a mtllib is found. If "has_per_face_color" stays
                                            // false the "poly_color" vector will be emptied before returning.
-    std::string line;
-    while(std::getline(f,line))
+    poly_col.reserve(poly_pos.size());
+    for(uint i=0; i<chunks.size(); ++i)
     {
-        switch(line[0])
+        for(const auto & e : chunks.at(i).events)
         {
-            case 'v':
+            poly_col.resize(off.at(i).np + e.n_polys_before, curr_color);
+            if(e.is_mtllib)
             {
-                // http://stackoverflow.com/questions/16839658/printf-width-specifier-to-maintain-precision-of-floating-point-value
-                //
-                double a, b, c;
-                     if(sscanf(line.data(), "v  %lf %lf %lf", &a, &b, &c) == 3) pos.push_back(vec3d(a,b,c));
-                else if(sscanf(line.data(), "vt %lf %lf %lf", &a, &b, &c) == 3) tex.push_back(vec3d(a,b,c));
-                else if(sscanf(line.data(), "vt %lf %lf %lf", &a, &b, &c) == 2) tex.push_back(vec3d(a,b,0));
-                else if(sscanf(line.data(), "vn %lf %lf %lf", &a, &b, &c) == 3) nor.push_back(vec3d(a,b,c));
-                break;
-            }
-
-            case 'f':
-            {
-                line = line.substr(1,line.size()-1); // discard the 'f' letter
-                std::istringstream ss(line);
-                std::vector<uint> p_pos, p_tex, p_nor;
-                for(std::string sub_str; ss >> sub_str;)
-                {
-                    int v_pos, v_tex, v_nor;
-                    read_point_id(strdup(sub_str.c_str()), v_pos, v_tex, v_nor);
-                    if (v_pos >= 0) p_pos.push_back(v_pos);
-                    if (v_tex >= 0) p_tex.push_back(v_tex);
-                    if (v_nor >= 0) p_nor.push_back(v_nor);
-                }
-                if (!p_tex.empty()) poly_tex.push_back(p_tex);
-                if (!p_nor.empty()) poly_nor.push_back(p_nor);
-                if (!p_pos.empty())
-                {
-                    poly_pos.push_back(p_pos);
-                    poly_col.push_back(curr_color);
-                }
-                break;
-            }
-
-            case 'u':
-            {
-                char mat_c[1024];
-                if (sscanf(line.data(), "usemtl %s", mat_c) == 1)
+                std::string s0(filename);
+                std::string s2 = get_file_path(s0) + get_file_name(e.arg);
+                if(read_MTU(s2.c_str(), color_map, diffuse_path, specular_path, normal_path))
                 {
-                    auto query = color_map.find(std::string(mat_c));
-                    if (query != color_map.end())
-                    {
-                        curr_color = query->second;
-                    }
-                    else std::cerr << "WARNING: could not find material: " << mat_c << std::endl;
+                    has_per_face_color = true;
                 }
-                break;
             }
-
-            case 'm':
+            else
             {
-                char mtu_c[1024];
-                if(sscanf(line.data(), "mtllib %[^\n]s", mtu_c) == 1)
+                auto query = color_map.find(e.arg);
+                if (query != color_map.end())
                 {
-                    std::string s0(filename);
-                    std::string s1(mtu_c);
-                    std::string s2 = get_file_path(s0) + get_file_name(s1);
-                    if(read_MTU(s2.c_str(), color_map, diffuse_path, specular_path, normal_path))
-                    {
-                        has_per_face_color = true;
-                    }
+                    curr_color = query->second;
                 }
-                break;
+                else std::cerr << "WARNING: could not find material: " << e.arg << std::endl;
             }
         }
     }
-    f.close();
+    poly_col.resize(poly_pos.size(), curr_color);
     if (!has_per_face_color) poly_col.clear();
 }
 
@@ -265,8 +386,9 @@ bool read_MTU(const char                  * filename,
 
             case 'K':
             {
-                float r,g,b;
-                if (sscanf(line, "Kd %f %f %f", &r, &g, &b) == 3)
+                double r,g,b;
+                const char *s = line, *end = line + strlen(line);
+                if (parse_word(s,end)=="Kd" && parse_double(s,end,r) && parse_double(s,end,g) && parse_double(s,end,b))
                 {
                     color_map[std::string(curr_material)] = Color(r,g,b);
                 }
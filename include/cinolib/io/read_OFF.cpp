@@ -34,10 +34,11 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/io/read_OFF.h>
-#include <string>
-#include <sstream>
-#include <fstream>
-#include <stdio.h>
+#include <cinolib/io/io_utilities.h>
+#include <cinolib/io/mapped_file.h>
+#include <cinolib/parallel_for.h>
+#include <algorithm>
+#include <iostream>
 
 namespace cinolib
 {
@@ -63,67 +64,117 @@ void read_OFF(const char                     * filename,
     polys.clear();
     poly_colors.clear();
 
-    setlocale(LC_NUMERIC, "en_US.UTF-8"); // makes sure "." is the decimal separator
-
-    std::ifstream f(filename);
+    MappedFile f(filename);
     if(!f.is_open())
     {
         std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : read_OFF() : couldn't open input file " << filename << std::endl;
         exit(-1);
     }
 
-    std::string line;
-    uint        nv, np, ne;
-
     // read header and number of elements
-    do getline(f, line, '\n'); while(line.find("OFF")==std::string::npos);
-    do getline(f, line, '\n'); while(sscanf(line.c_str(), "%d %d %d\n", &nv, &np, &ne)!=3);
+    const char *s   = f.begin();
+    const char *end = f.end();
+    uint nv = 0, np = 0, ne = 0;
+    bool has_counts = false;
+    while(s<end)
+    {
+        const char *eol = s;
+        skip_line(eol, end);
+        bool found = (std::search(s, eol, "OFF", "OFF"+3)!=eol);
+        s = eol;
+        if(found) break;
+    }
+    while(s<end)
+    {
+        const char *p = s;
+        skip_line(s, end);
+        if(parse_uint(p,s,nv) && parse_uint(p,s,np) && parse_uint(p,s,ne)) { has_counts = true; break; }
+    }
+    if(!has_counts)
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : read_OFF() : couldn't parse header of " << filename << std::endl;
+        return;
+    }
 
-    // read verts
-    for(uint i=0; i<nv; ++i)
+    // Elements are listed one per line (verts first, then polys). Each line is
+    // parsed independently. Lines that do not begin with a number (e.g. blank
+    // lines and comments) are skipped
+    auto is_element = [](const char * p, const char * end) -> bool
     {
-        getline(f, line, '\n');
-        std::stringstream ss(line);
+        skip_blanks(p, end);
+        return p<end && ((*p>='0' && *p<='9') || *p=='-' || *p=='+' || *p=='.');
+    };
 
-        double x, y, z;
-        if(ss >> x >> y >> z)
+    // count the elements in each chunk, so that each chunk knows the global
+    // index of the elements it contains
+    std::vector<const char*> bounds = line_aligned_chunks(s, end);
+    std::vector<uint> first(bounds.size(), 0);
+    PARALLEL_FOR(0, bounds.size()-1, 2, SCHEDULE_DYNAMIC, 1, [&](const uint i)
+    {
+        for(const char *p=bounds.at(i); p<bounds.at(i+1); skip_line(p, bounds.at(i+1)))
         {
-            verts.push_back(vec3d(x,y,z));
+            if(is_element(p, bounds.at(i+1))) ++first.at(i+1);
         }
-        else --i;
-    }
+    });
+    for(uint i=1; i<first.size(); ++i) first.at(i) += first.at(i-1);
 
-    // read polys
-    for(uint i=0; i<np; ++i)
+    verts.resize(nv);
+    polys.resize(np);
+    std::vector<Color> colors(np);
+    std::vector<bool>  has_color(np, false);
+    std::vector<bool>  failed(bounds.size()-1, false);
+    PARALLEL_FOR(0, bounds.size()-1, 2, SCHEDULE_DYNAMIC, 1, [&](const uint i)
     {
-        getline(f, line, '\n');
-        std::stringstream ss(line);
-
-        uint n_corners;
-        if(ss >> n_corners)
+        uint id = first.at(i);
+        std::vector<float> attr;
+        for(const char *p=bounds.at(i); p<bounds.at(i+1) && id<nv+np; )
         {
-            uint vid;
-            std::vector<uint> p;
-            for(uint j=0; j<n_corners; ++j)
+            const char *eol = p;
+            skip_line(eol, bounds.at(i+1));
+            if(!is_element(p, eol)) { p = eol; continue; }
+
+            if(id<nv)
             {
-                ss >> vid;
-                p.push_back(vid);
+                vec3d & v = verts.at(id);
+                if(!parse_double(p,eol,v.x()) || !parse_double(p,eol,v.y()) || !parse_double(p,eol,v.z())) failed.at(i) = true;
             }
-            polys.push_back(p);
+            else
+            {
+                uint pid = id-nv;
+                uint n_corners = 0, vid = 0;
+                parse_uint(p,eol,n_corners);
+                polys.at(pid).resize(n_corners);
+                for(uint j=0; j<n_corners; ++j)
+                {
+                    if(!parse_uint(p,eol,vid)) failed.at(i) = true;
+                    polys.at(pid).at(j) = vid;
+                }
 
-            float val;
-            std::vector<float> attr;
-            while(ss >> val) attr.push_back(val);
+                double val;
+                attr.clear();
+                while(parse_double(p,eol,val)) attr.push_back(val);
 
-            switch(attr.size())
-            {
-                case 1 : break; // TODO: READ LABEL (cast to int)!!!
-                case 3 : poly_colors.push_back(Color(attr.at(0), attr.at(1), attr.at(2))); break;
-                case 4 : poly_colors.push_back(Color(attr.at(0), attr.at(1), attr.at(2), attr.at(3))); break;
-                default: break;
+                switch(attr.size())
+                {
+                    case 1 : break; // TODO: READ LABEL (cast to int)!!!
+                    case 3 : colors.at(pid) = Color(attr.at(0), attr.at(1), attr.at(2));              has_color.at(pid) = true; break;
+                    case 4 : colors.at(pid) = Color(attr.at(0), attr.at(1), attr.at(2), attr.at(3)); has_color.at(pid) = true; break;
+                    default: break;
+                }
             }
+            ++id;
+            p = eol;
         }
-        else --i;
+    });
+
+    if(first.back()<nv+np || std::find(failed.begin(), failed.end(), true)!=failed.end())
+    {
+        std::cerr << "WARNING : " << __FILE__ << ", line " << __LINE__ << " : read_OFF() : file " << filename << " seems corrupted" << std::endl;
+    }
+
+    for(uint pid=0; pid<np; ++pid)
+    {
+        if(has_color.at(pid)) poly_colors.push_back(colors.at(pid));
     }
 }
 
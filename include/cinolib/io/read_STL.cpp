@@ -43,7 +43,12 @@
 *********************************************************************************/
 #include <cinolib/io/read_STL.h>
 #include <cinolib/io/io_utilities.h>
-#include <map>
+#include <cinolib/io/mapped_file.h>
+#include <cinolib/parallel_for.h>
+#include <cinolib/vertex_clustering.h>
+#include <string.h>
+#include <stdint.h>
+#include <climits>
 
 namespace cinolib
 {
@@ -60,6 +65,84 @@ void read_STL(const char         * filename,
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+// Finds the next occurrence of keyword in [s,end) and returns a pointer to the
+// first character after it (or NULL if the keyword is not found)
+//
+CINO_INLINE
+const char * STL_seek_keyword(const char * s, const char * end, const char * keyword)
+{
+    size_t n = strlen(keyword);
+    while(s+n<=end)
+    {
+        s = (const char*)memchr(s, keyword[0], end-s-n+1);
+        if(s==NULL) return NULL;
+        if(memcmp(s, keyword, n)==0) return s+n;
+        ++s;
+    }
+    return NULL;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// Finds the beginning of the first "facet" keyword in [s,end), skipping "endfacet"
+//
+CINO_INLINE
+const char * STL_seek_facet(const char * beg, const char * s, const char * end)
+{
+    while((s = STL_seek_keyword(s, end, "facet"))!=NULL)
+    {
+        if(s-5==beg || isspace((unsigned char)s[-6])) return s-5;
+    }
+    return end;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// Parses all the ASCII facets that begin in [s,end)
+//
+CINO_INLINE
+bool STL_read_ASCII_facets(const char * s, const char * end, const char * eof, std::vector<vec3d> & normals, std::vector<vec3d> & soup)
+{
+    while((s = STL_seek_keyword(s, end, "facet"))!=NULL)
+    {
+        vec3d n, v[3];
+        if(!(s = STL_seek_keyword(s, eof, "normal"))) return false;
+        for(int j=0; j<3; ++j)
+        {
+            while(s<eof && isspace((unsigned char)*s)) ++s;
+            if(!parse_double(s, eof, n[j])) return false;
+        }
+        for(int i=0; i<3; ++i)
+        {
+            if(!(s = STL_seek_keyword(s, eof, "vertex"))) return false;
+            for(int j=0; j<3; ++j)
+            {
+                while(s<eof && isspace((unsigned char)*s)) ++s;
+                if(!parse_double(s, eof, v[i][j])) return false;
+            }
+        }
+        normals.push_back(n);
+        soup.insert(soup.end(), v, v+3);
+        if(!(s = STL_seek_keyword(s, eof, "endfacet"))) return false;
+    }
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// Merges coincident vertices of a triangle soup. Vertex ids are assigned in
+// order of first appearance
+//
+CINO_INLINE
+void STL_merge_duplicated_verts(const std::vector<vec3d> & soup,
+                                      std::vector<vec3d> & verts,
+                                      std::vector<uint>  & tris)
+{
+    weld_vertices(soup, 0.0, verts, tris);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 CINO_INLINE
 void read_STL(const char         * filename,
               std::vector<vec3d> & verts,
@@ -73,128 +156,80 @@ void read_STL(const char         * filename,
     normals.clear();
     tris.clear();
 
-    setlocale(LC_NUMERIC, "en_US.UTF-8"); // makes sure "." is the decimal separator
-
-    FILE *fp = fopen(filename, "r");
-    if(!fp)
+    MappedFile f(filename);
+    if(!f.is_open())
     {
         std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : load_STL() : couldn't open input file " << filename << std::endl;
         exit(-1);
     }
 
-    std::map<vec3d,uint> vmap;
-
-    /* This is a horrible trick to cope with the fact that in Thingi10K
-     * binary files start with the header of ASCII files even if they shouldn't.
-     * As a result it becomes messy to figure out whether a file is binary or not.
-     * I assume it is, then I try to parse it as if it was ASCII first, and if I fail
-     * then I know that is indeed binary.
+    /* In Thingi10K binary files start with the header of ASCII files even if they
+     * shouldn't. I therefore consider binary any file whose size matches the number
+     * of triangles declared in its header. Otherwise I try to parse it as ASCII
+     * first, and if I fail then I know that is indeed binary.
     */
-    bool is_binary = true;
+    std::vector<vec3d> soup;
+    bool     is_binary = false;
+    uint32_t nt        = 0;
+    if(f.size()>=84)
+    {
+        memcpy(&nt, f.begin()+80, sizeof(uint32_t));
+        is_binary = (84 + 50*uint64_t(nt) == f.size());
+    }
 
-    if(seek_keyword(fp, "solid")) // ASCII file
+    if(!is_binary)
     {
-        while(seek_keyword(fp, "facet"))
+        // split the file at facet boundaries and parse chunks in parallel
+        std::vector<const char*> bounds = line_aligned_chunks(f.begin(), f.end());
+        for(const char* & p : bounds) p = STL_seek_facet(f.begin(), p, f.end());
+        std::vector<std::vector<vec3d>> chunk_normals(bounds.size()-1);
+        std::vector<std::vector<vec3d>> chunk_soup   (bounds.size()-1);
+        std::vector<char>               chunk_ok     (bounds.size()-1, true);
+        PARALLEL_FOR(0, bounds.size()-1, 2, SCHEDULE_DYNAMIC, 1, [&](const uint i)
         {
-            is_binary = false;
-
-            vec3d n;
-            if(!seek_keyword(fp, "normal")) assert(false && "could not find keyword NORMAL");
-            if(!eat_double(fp, n.x()))      assert(false && "could not parse x coord");
-            if(!eat_double(fp, n.y()))      assert(false && "could not parse y coord");
-            if(!eat_double(fp, n.z()))      assert(false && "could not parse z coord");
-            normals.push_back(n);
-
-            if(!seek_keyword(fp, "outer")) assert(false && "could not find keyword OUTER");
-            if(!seek_keyword(fp, "loop"))  assert(false && "could not find keyword LOOP");
-            for(int i=0; i<3; ++i)
-            {
-                vec3d v;
-                if(!seek_keyword(fp, "vertex")) assert(false && "could not find keyword VERTEX");
-                if(!eat_double(fp, v.x()))      assert(false && "could not parse x coord");
-                if(!eat_double(fp, v.y()))      assert(false && "could not parse y coord");
-                if(!eat_double(fp, v.z()))      assert(false && "could not parse z coord");
-
-                if(merge_duplicated_verts)
-                {
-                    auto it = vmap.find(v);
-                    if(it == vmap.end())
-                    {
-                        uint fresh_id = vmap.size();
-                        vmap[v] = fresh_id;
-                        verts.push_back(v);
-                        tris.push_back(fresh_id);
-                    }
-                    else tris.push_back(it->second);
-                }
-                else
-                {
-                    tris.push_back(verts.size());
-                    verts.push_back(v);
-                }
-            }
-            if(!seek_keyword(fp, "endloop"))  assert(false && "could not find keyword ENDLOOP");
-            if(!seek_keyword(fp, "endfacet")) assert(false && "could not find keyword ENDFACET");
+            chunk_ok.at(i) = STL_read_ASCII_facets(bounds.at(i), bounds.at(i+1), f.end(), chunk_normals.at(i), chunk_soup.at(i));
+        });
+        for(uint i=0; i<chunk_soup.size(); ++i)
+        {
+            if(!chunk_ok.at(i)) std::cerr << "WARNING : " << __FILE__ << ", line " << __LINE__ << " : load_STL() : could not parse all facets in " << filename << std::endl;
+            normals.insert(normals.end(), chunk_normals.at(i).begin(), chunk_normals.at(i).end());
+            soup.insert   (soup.end(),    chunk_soup.at(i).begin(),    chunk_soup.at(i).end());
         }
+        if(soup.empty() && f.size()>=84) is_binary = true;
     }
-    fclose(fp);
 
     if(is_binary)
     {
-        // open the file in binary mode
-        FILE *fp = fopen(filename, "rb");
-        if(!fp)
+        if(84 + 50*uint64_t(nt) > f.size())
         {
-            std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : load_STL() : couldn't open input file " << filename << std::endl;
-            exit(-1);
+            std::cerr << "WARNING : " << __FILE__ << ", line " << __LINE__ << " : load_STL() : file " << filename << " is truncated" << std::endl;
+            nt = (f.size()-84)/50;
         }
 
-        // read header
-        char header[80];
-        if(fread(header, 1, 80, fp)!=80) assert(false && "error reading STL binary header");
-
-        // read triangles
-        unsigned int nt;
-        if(fread(&nt, sizeof(unsigned int), 1, fp)!=1) assert(false && "error reading number of triangles");
-        for(unsigned int i=0; i<nt; ++i)
+        // each triangle is: normal (3 floats), verts (9 floats), attribute (uint16)
+        normals.resize(nt);
+        soup.resize(3*nt);
+        PARALLEL_FOR(0, nt, 10000, [&](const uint tid)
         {
-            // read normal
-            float nf[3];
-            if(fread(&nf, sizeof(float), 3, fp)!=3) assert(false && "error reading normal");
-            vec3d n(nf[0], nf[1], nf[2]);
-            normals.push_back(n);
-
-            // read verts
+            float data[12];
+            memcpy(data, f.begin() + 84 + 50*size_t(tid), 12*sizeof(float));
+            normals.at(tid) = vec3d(data[0], data[1], data[2]);
             for(int j=0; j<3; ++j)
             {
-                float vf[3];
-                if(fread(&vf, sizeof(float), 3, fp)!=3) assert(false && "error reading vertex");
-
-                vec3d v(vf[0], vf[1], vf[2]);                
-                if(merge_duplicated_verts)
-                {
-                    auto it = vmap.find(v);
-                    if(it == vmap.end())
-                    {
-                        uint fresh_id = vmap.size();
-                        vmap[v] = fresh_id;
-                        verts.push_back(v);
-                        tris.push_back(fresh_id);
-                    }
-                    else tris.push_back(it->second);
-                }
-                else
-                {
-                    tris.push_back(verts.size());
-                    verts.push_back(v);
-                }
+                soup.at(3*tid+j) = vec3d(data[3+3*j], data[4+3*j], data[5+3*j]);
             }
+        });
+    }
 
-            // read (and discard) attribute
-            unsigned short attribute;
-            if(fread(&attribute, sizeof(unsigned short), 1, fp)!=1) assert(false && "error reading attribute");
-        }
-        fclose(fp);
+    if(merge_duplicated_verts)
+    {
+        STL_merge_duplicated_verts(soup, verts, tris);
+    }
+    else
+    {
+        verts.swap(soup);
+        tris.resize(verts.size());
+        for(uint i=0; i<tris.size(); ++i) tris.at(i) = i;
     }
 }
 
@@ -64,6 +64,11 @@
 #include <cinolib/io/write_VTK.h>
 
 
+// NATIVE BINARY FORMAT (SURFACE AND VOLUME MESHES)
+#include <cinolib/io/read_CINO.h>
+#include <cinolib/io/write_CINO.h>
+
+
 // SKELETON READERS
 #include <cinolib/io/read_LIVESU2012.h>
 #include <cinolib/io/read_TAGLIASACCHI2012.h>
@@ -0,0 +1,212 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/io/write_CINO.h>
+#include <string.h>
+#include <type_traits>
+#include <iostream>
+
+namespace cinolib
+{
+
+CINO_INLINE
+CINO_writer::CINO_writer(const char * filename, const uint32_t mesh_type)
+{
+    memcpy(header.magic, CINO_MAGIC, 8);
+    header.version      = CINO_VERSION;
+    header.endianness   = CINO_ENDIANNESS;
+    header.mesh_type    = mesh_type;
+    header.n_sections   = 0;
+    header.table_offset = 0;
+
+    fp = fopen(filename, "wb");
+    if(!fp)
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : write_CINO() : couldn't open output file " << filename << std::endl;
+        return;
+    }
+    // placeholder, the actual header is written when the file is closed
+    ok  = (fwrite(&header, sizeof(CINO_header), 1, fp)==1);
+    pos = sizeof(CINO_header);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+CINO_writer::~CINO_writer()
+{
+    close();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<typename T>
+CINO_INLINE
+void CINO_writer::add_array(const uint32_t tag, const std::vector<T> & array)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "CINO_writer: array type must be trivially copyable");
+    if(!is_open()) return;
+    begin_section(tag, CINO_ARRAY, sizeof(T), array.size());
+    if(!array.empty()) ok &= (fwrite(array.data(), sizeof(T), array.size(), fp)==array.size());
+    pos += sizeof(T)*array.size();
+    end_section();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void CINO_writer::add_array(const uint32_t tag, const std::vector<vec3d> & array)
+{
+    std::vector<double> xyz(3*array.size());
+    for(size_t i=0; i<array.size(); ++i)
+    {
+        xyz[3*i  ] = array[i].x();
+        xyz[3*i+1] = array[i].y();
+        xyz[3*i+2] = array[i].z();
+    }
+    if(!is_open()) return;
+    begin_section(tag, CINO_ARRAY, 3*sizeof(double), array.size());
+    if(!xyz.empty()) ok &= (fwrite(xyz.data(), sizeof(double), xyz.size(), fp)==xyz.size());
+    pos += sizeof(double)*xyz.size();
+    end_section();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void CINO_writer::add_lists(const uint32_t tag, const std::vector<std::vector<uint>> & lists)
+{
+    add_uint_lists(tag, lists);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void CINO_writer::add_lists(const uint32_t tag, const AdjacencyLists & lists)
+{
+    add_uint_lists(tag, lists);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Lists>
+CINO_INLINE
+void CINO_writer::add_uint_lists(const uint32_t tag, const Lists & lists)
+{
+    if(!is_open()) return;
+    std::vector<uint64_t> offsets(lists.size()+1, 0);
+    for(size_t i=0; i<lists.size(); ++i) offsets.at(i+1) = offsets.at(i) + lists.at(i).size();
+
+    begin_section(tag, CINO_LISTS, sizeof(uint), lists.size());
+    ok &= (fwrite(offsets.data(), sizeof(uint64_t), offsets.size(), fp)==offsets.size());
+    pos += sizeof(uint64_t)*offsets.size();
+    for(const auto & l : lists)
+    {
+        if(!l.empty()) ok &= (fwrite(l.data(), sizeof(uint), l.size(), fp)==l.size());
+    }
+    pos += sizeof(uint)*offsets.back();
+    end_section();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void CINO_writer::add_lists(const uint32_t tag, const std::vector<std::vector<bool>> & lists)
+{
+    if(!is_open()) return;
+    std::vector<uint64_t> offsets(lists.size()+1, 0);
+    for(size_t i=0; i<lists.size(); ++i) offsets.at(i+1) = offsets.at(i) + lists.at(i).size();
+
+    std::vector<uint8_t> items;
+    items.reserve(offsets.back());
+    for(const auto & l : lists) for(bool b : l) items.push_back(b);
+
+    begin_section(tag, CINO_LISTS, sizeof(uint8_t), lists.size());
+    ok &= (fwrite(offsets.data(), sizeof(uint64_t), offsets.size(), fp)==offsets.size());
+    if(!items.empty()) ok &= (fwrite(items.data(), sizeof(uint8_t), items.size(), fp)==items.size());
+    pos += sizeof(uint64_t)*offsets.size() + items.size();
+    end_section();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool CINO_writer::close()
+{
+    if(!is_open()) return false;
+
+    header.n_sections   = table.size();
+    header.table_offset = pos;
+    if(!table.empty()) ok &= (fwrite(table.data(), sizeof(CINO_section), table.size(), fp)==table.size());
+    ok &= (fseek(fp, 0, SEEK_SET)==0);
+    ok &= (fwrite(&header, sizeof(CINO_header), 1, fp)==1);
+    ok &= (fclose(fp)==0);
+    fp = NULL;
+
+    if(!ok) std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : write_CINO() : error while writing file" << std::endl;
+    return ok;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void CINO_writer::begin_section(const uint32_t tag, const uint32_t kind, const uint32_t elem_size, const uint64_t count)
+{
+    // align each section at 8 bytes
+    static const char zeros[8] = {0,0,0,0,0,0,0,0};
+    uint64_t pad = (8 - pos%8)%8;
+    if(pad>0) ok &= (fwrite(zeros, 1, pad, fp)==pad);
+    pos += pad;
+
+    CINO_section s;
+    s.tag       = tag;
+    s.kind      = kind;
+    s.elem_size = elem_size;
+    s.padding   = 0;
+    s.count     = count;
+    s.offset    = pos;
+    s.bytes     = 0;
+    table.push_back(s);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void CINO_writer::end_section()
+{
+    table.back().bytes = pos - table.back().offset;
+}
+
+}
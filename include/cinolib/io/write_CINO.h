@@ -0,0 +1,106 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_WRITE_CINO_H
+#define CINO_WRITE_CINO_H
+
+#include <stdio.h>
+#include <vector>
+#include <sys/types.h>
+#include <cinolib/cino_inline.h>
+#include <cinolib/io/CINO_format.h>
+#include <cinolib/adjacency_lists.h>
+#include <cinolib/geometry/vec_mat.h>
+
+namespace cinolib
+{
+
+/* Writes a .cino file (see CINO_format.h) one section at a time.
+ * Sections are streamed to disk as soon as they are added, and the
+ * section table is written when the writer is closed (or destroyed).
+ *
+ * Usage:
+ *
+ *      CINO_writer w(filename, mesh_type);
+ *      w.add_array(CINO_VERT_XYZ, verts);
+ *      w.add_lists(CINO_POLYS, polys);
+ *      w.close();
+*/
+
+class CINO_writer
+{
+    public:
+
+        explicit CINO_writer(const char * filename, const uint32_t mesh_type);
+        ~CINO_writer();
+
+        CINO_writer(const CINO_writer &) = delete;
+        CINO_writer & operator=(const CINO_writer &) = delete;
+
+        bool is_open() const { return fp!=NULL; }
+
+        // T must be trivially copyable. Points are stored as plain double
+        // triplets, because vec3d has a vtable and cannot be copied bitwise
+        template<typename T>
+        void add_array(const uint32_t tag, const std::vector<T> & array);
+        void add_array(const uint32_t tag, const std::vector<vec3d> & array);
+        void add_lists(const uint32_t tag, const std::vector<std::vector<uint>> & lists);
+        void add_lists(const uint32_t tag, const std::vector<std::vector<bool>> & lists);
+        void add_lists(const uint32_t tag, const AdjacencyLists                 & lists);
+
+        bool close();
+
+    private:
+
+        void begin_section(const uint32_t tag, const uint32_t kind, const uint32_t elem_size, const uint64_t count);
+        void end_section();
+
+        template<class Lists>
+        void add_uint_lists(const uint32_t tag, const Lists & lists);
+
+        FILE                      *fp = NULL;
+        CINO_header                header;
+        std::vector<CINO_section>  table;
+        uint64_t                   pos = 0;
+        bool                       ok  = true;
+};
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "write_CINO.cpp"
+#endif
+
+#endif // CINO_WRITE_CINO_H
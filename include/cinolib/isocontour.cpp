@@ -36,6 +36,10 @@
 #include <cinolib/isocontour.h>
 #include <cinolib/cino_inline.h>
 #include <cinolib/interval.h>
+#include <cinolib/parallel_for.h>
+#include <algorithm>
+#include <functional>
+#include <numeric>
 #include <queue>
 
 namespace cinolib
@@ -56,70 +60,183 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 Isocontour<M,V,E,P>::Isocontour(AbstractPolygonMesh<M,V,E,P> & m, double iso_value) : iso_value(iso_value)
 {
-    for(uint pid=0; pid<m.num_polys(); ++pid)
-    for(uint i=0; i< m.poly_tessellation(pid).size()/3; ++i)
+    std::vector<std::vector<vec3d>> all_segs;
+    march(m, std::vector<double>(1,iso_value), all_segs);
+    segs.swap(all_segs.front());
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+std::vector<Isocontour<M,V,E,P>> Isocontour<M,V,E,P>::extract(const AbstractPolygonMesh<M,V,E,P> & m,
+                                                              const std::vector<double>          & iso_values)
+{
+    std::vector<std::vector<vec3d>> all_segs;
+    march(m, iso_values, all_segs);
+
+    std::vector<Isocontour<M,V,E,P>> res(iso_values.size());
+    for(uint i=0; i<iso_values.size(); ++i)
     {
-        uint   vid0 = m.poly_tessellation(pid).at(3*i+0);
-        uint   vid1 = m.poly_tessellation(pid).at(3*i+1);
-        uint   vid2 = m.poly_tessellation(pid).at(3*i+2);
-
-        double f0   = m.vert_data(vid0).uvw[0];
-        double f1   = m.vert_data(vid1).uvw[0];
-        double f2   = m.vert_data(vid2).uvw[0];
-
-        // There are seven possible cases:
-        // 1) the curve coincides with (v0,v1)
-        // 2) the curve coincides with (v1,v2)
-        // 3) the curve coincides with (v2,v0)
-        // 4) the curve enters from (v0,v1) and exits from (v0,v2)
-        // 5) the curve enters from (v0,v1) and exits from (v1,v2)
-        // 6) the curve enters from (v1,v2) and exits from (v2,v0)
-        // 7) the does not pass fromm here
-
-        bool through_v0    = (iso_value == f0);
-        bool through_v1    = (iso_value == f1);
-        bool through_v2    = (iso_value == f2);
-        bool crosses_v0_v1 = is_into_interval<double>(iso_value, f0, f1, true);
-        bool crosses_v1_v2 = is_into_interval<double>(iso_value, f1, f2, true);
-        bool crosses_v2_v0 = is_into_interval<double>(iso_value, f2, f0, true);
-
-        if (through_v0 && through_v1) // case 1) the curve coincides with (v0,v1)
-        {
-            segs.push_back(m.vert(vid0));
-            segs.push_back(m.vert(vid1));
-        }
-        else if (through_v1 && through_v2) // case 2) the curve coincides with (v1,v2)
-        {
-            segs.push_back(m.vert(vid1));
-            segs.push_back(m.vert(vid2));
-        }
-        else if (through_v2 && through_v0) // 3) the curve coincides with (v2,v0)
+        res.at(i).iso_value = iso_values.at(i);
+        res.at(i).segs.swap(all_segs.at(i));
+    }
+    return res;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// computes the segment of the iso-contour within triangle (v0,v1,v2), with
+// scalar values (f0,f1,f2). Returns false if the curve does not pass from here
+CINO_INLINE
+bool isocontour_segment(const double iso_value,
+                        const vec3d  v[],
+                        const double f[],
+                              vec3d  seg[])
+{
+    // There are seven possible cases:
+    // 1) the curve coincides with (v0,v1)
+    // 2) the curve coincides with (v1,v2)
+    // 3) the curve coincides with (v2,v0)
+    // 4) the curve enters from (v0,v1) and exits from (v0,v2)
+    // 5) the curve enters from (v0,v1) and exits from (v1,v2)
+    // 6) the curve enters from (v1,v2) and exits from (v2,v0)
+    // 7) the does not pass fromm here
+
+    bool through_v0    = (iso_value == f[0]);
+    bool through_v1    = (iso_value == f[1]);
+    bool through_v2    = (iso_value == f[2]);
+    bool crosses_v0_v1 = is_into_interval<double>(iso_value, f[0], f[1], true);
+    bool crosses_v1_v2 = is_into_interval<double>(iso_value, f[1], f[2], true);
+    bool crosses_v2_v0 = is_into_interval<double>(iso_value, f[2], f[0], true);
+
+    if (through_v0 && through_v1) // case 1) the curve coincides with (v0,v1)
+    {
+        seg[0] = v[0];
+        seg[1] = v[1];
+    }
+    else if (through_v1 && through_v2) // case 2) the curve coincides with (v1,v2)
+    {
+        seg[0] = v[1];
+        seg[1] = v[2];
+    }
+    else if (through_v2 && through_v0) // 3) the curve coincides with (v2,v0)
+    {
+        seg[0] = v[2];
+        seg[1] = v[0];
+    }
+    else if (crosses_v0_v1 && crosses_v1_v2) // case 4) the curve enters from (v0,v1) and exits from (v0,v2)
+    {
+        double alpha0 = std::fabs(iso_value - f[0])/fabs(f[1] - f[0]);
+        double alpha1 = std::fabs(iso_value - f[1])/fabs(f[2] - f[1]);
+        seg[0] = (1.0-alpha0)*v[0] + alpha0*v[1];
+        seg[1] = (1.0-alpha1)*v[1] + alpha1*v[2];
+    }
+    else if (crosses_v0_v1 && crosses_v2_v0) // case 5) the curve enters from (v0,v1) and exits from (v1,v2)
+    {
+        double alpha0 = std::fabs(iso_value - f[0])/fabs(f[1] - f[0]);
+        double alpha1 = std::fabs(iso_value - f[2])/fabs(f[0] - f[2]);
+        seg[0] = (1.0-alpha0)*v[0] + alpha0*v[1];
+        seg[1] = (1.0-alpha1)*v[2] + alpha1*v[0];
+    }
+    else if (crosses_v1_v2 && crosses_v2_v0) // 6) the curve enters from (v1,v2) and exits from (v2,v0)
+    {
+        double alpha0 = std::fabs(iso_value - f[1])/fabs(f[2] - f[1]);
+        double alpha1 = std::fabs(iso_value - f[2])/fabs(f[0] - f[2]);
+        seg[0] = (1.0-alpha0)*v[1] + alpha0*v[2];
+        seg[1] = (1.0-alpha1)*v[2] + alpha1*v[0];
+    }
+    else return false;
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void Isocontour<M,V,E,P>::march(const AbstractPolygonMesh<M,V,E,P>    & m,
+                                const std::vector<double>             & iso_values,
+                                      std::vector<std::vector<vec3d>> & segs)
+{
+    uint n_iso = iso_values.size();
+    segs.assign(n_iso, std::vector<vec3d>());
+    if(n_iso==0) return;
+
+    // iso-values are processed in increasing order, so that
+    // the ones spanned by a triangle form a contiguous range
+    std::vector<uint> iso_order(n_iso);
+    std::iota(iso_order.begin(), iso_order.end(), 0);
+    std::stable_sort(iso_order.begin(), iso_order.end(), [&](const uint i, const uint j)
+    {
+        return iso_values.at(i) < iso_values.at(j);
+    });
+    std::vector<double> iso(n_iso);
+    for(uint i=0; i<n_iso; ++i) iso.at(i) = iso_values.at(iso_order.at(i));
+
+    // calls func(s,seg) for each segment generated by polygon pid for the s-th sorted iso-value
+    auto visit = [&](const uint pid, const std::function<void(const uint, const vec3d[])> & func)
+    {
+        const std::vector<uint> & tess = m.poly_tessellation(pid);
+        for(uint i=0; i<tess.size()/3; ++i)
         {
-            segs.push_back(m.vert(vid2));
-            segs.push_back(m.vert(vid0));
+            vec3d  v[3];
+            double f[3];
+            for(uint j=0; j<3; ++j)
+            {
+                v[j] = m.vert(tess.at(3*i+j));
+                f[j] = m.vert_data(tess.at(3*i+j)).uvw[0];
+            }
+            auto beg = std::lower_bound(iso.begin(), iso.end(), *std::min_element(f,f+3));
+            auto end = std::upper_bound(beg,         iso.end(), *std::max_element(f,f+3));
+            for(auto it=beg; it!=end; ++it)
+            {
+                vec3d seg[2];
+                if(isocontour_segment(*it, v, f, seg)) func(it-iso.begin(), seg);
+            }
         }
-        else if (crosses_v0_v1 && crosses_v1_v2) // case 4) the curve enters from (v0,v1) and exits from (v0,v2)
+    };
+
+    // FIRST PASS: count the segments of each block of polygons (for each iso-value)
+    const uint block_size = 1024;
+    uint n_blocks = (m.num_polys()+block_size-1)/block_size;
+    std::vector<uint> block_count(n_blocks*n_iso, 0);
+    PARALLEL_FOR(0, n_blocks, 1, SCHEDULE_DYNAMIC, 4, [&](const uint b)
+    {
+        uint *count = &block_count.at(b*n_iso);
+        for(uint pid=b*block_size; pid<std::min((b+1)*block_size, m.num_polys()); ++pid)
         {
-            double alpha0 = std::fabs(iso_value - f0)/fabs(f1 - f0);
-            double alpha1 = std::fabs(iso_value - f1)/fabs(f2 - f1);
-            segs.push_back((1.0-alpha0)*m.vert(vid0) + alpha0*m.vert(vid1));
-            segs.push_back((1.0-alpha1)*m.vert(vid1) + alpha1*m.vert(vid2));
+            visit(pid, [&](const uint s, const vec3d[]) { ++count[s]; });
         }
-        else if (crosses_v0_v1 && crosses_v2_v0) // case 5) the curve enters from (v0,v1) and exits from (v1,v2)
+    });
+
+    // exclusive prefix sum of the block counts (for each iso-value)
+    for(uint s=0; s<n_iso; ++s)
+    {
+        uint n_segs = 0;
+        for(uint b=0; b<n_blocks; ++b)
         {
-            double alpha0 = std::fabs(iso_value - f0)/fabs(f1 - f0);
-            double alpha1 = std::fabs(iso_value - f2)/fabs(f0 - f2);
-            segs.push_back((1.0-alpha0)*m.vert(vid0) + alpha0*m.vert(vid1));
-            segs.push_back((1.0-alpha1)*m.vert(vid2) + alpha1*m.vert(vid0));
+            uint count = block_count.at(b*n_iso+s);
+            block_count.at(b*n_iso+s) = n_segs;
+            n_segs += count;
         }
-        else if (crosses_v1_v2 && crosses_v2_v0) // 6) the curve enters from (v1,v2) and exits from (v2,v0)
+        segs.at(iso_order.at(s)).resize(2*n_segs);
+    }
+
+    // SECOND PASS: write the segments of each block at its own offset
+    PARALLEL_FOR(0, n_blocks, 1, SCHEDULE_DYNAMIC, 4, [&](const uint b)
+    {
+        uint *offset = &block_count.at(b*n_iso);
+        for(uint pid=b*block_size; pid<std::min((b+1)*block_size, m.num_polys()); ++pid)
         {
-            double alpha0 = std::fabs(iso_value - f1)/fabs(f2 - f1);
-            double alpha1 = std::fabs(iso_value - f2)/fabs(f0 - f2);
-            segs.push_back((1.0-alpha0)*m.vert(vid1) + alpha0*m.vert(vid2));
-            segs.push_back((1.0-alpha1)*m.vert(vid2) + alpha1*m.vert(vid0));
+            visit(pid, [&](const uint s, const vec3d seg[])
+            {
+                std::vector<vec3d> & out = segs.at(iso_order.at(s));
+                uint i = offset[s]++;
+                out.at(2*i  ) = seg[0];
+                out.at(2*i+1) = seg[1];
+            });
         }
-    }
+    });
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
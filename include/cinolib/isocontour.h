@@ -54,6 +54,10 @@ class Isocontour
         explicit Isocontour();
         explicit Isocontour(AbstractPolygonMesh<M,V,E,P> & m, double iso_value);
 
+        // extracts the iso-contours of many iso-values in a single sweep over the polygons
+        static std::vector<Isocontour<M,V,E,P>> extract(const AbstractPolygonMesh<M,V,E,P> & m,
+                                                        const std::vector<double>          & iso_values);
+
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
         std::vector<uint> tessellate(Trimesh<M,V,E,P> & m) const;
@@ -62,6 +66,13 @@ class Isocontour
 
     protected:
 
+        // polygons are visited in parallel, in two passes: the first counts the segments
+        // generated by each block of polygons, the second writes them at the offsets given
+        // by a prefix sum of the counts. segs[i] are the segments of iso_values[i]
+        static void march(const AbstractPolygonMesh<M,V,E,P>   & m,
+                          const std::vector<double>            & iso_values,
+                                std::vector<std::vector<vec3d>> & segs);
+
         double             iso_value;
         std::vector<vec3d> segs;
 };
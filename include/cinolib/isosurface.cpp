@@ -55,6 +55,28 @@ Isosurface<M,V,E,F,P>::Isosurface(const Tetmesh<M,V,E,F,P> & m,
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+std::vector<Isosurface<M,V,E,F,P>> Isosurface<M,V,E,F,P>::extract(const Tetmesh<M,V,E,F,P> & m,
+                                                                  const std::vector<double> & iso_values)
+{
+    std::vector<std::vector<vec3d>> verts, norms;
+    std::vector<std::vector<uint>>  tris;
+    marching_tets(m, iso_values, verts, tris, norms);
+
+    std::vector<Isosurface<M,V,E,F,P>> res(iso_values.size());
+    for(uint i=0; i<iso_values.size(); ++i)
+    {
+        res.at(i).iso_value = iso_values.at(i);
+        res.at(i).verts.swap(verts.at(i));
+        res.at(i).tris.swap (tris.at(i));
+        res.at(i).norms.swap(norms.at(i));
+    }
+    return res;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class F, class P>
 CINO_INLINE
 Trimesh<M,V,E,F> Isosurface<M,V,E,F,P>::export_as_trimesh() const
@@ -59,6 +59,10 @@ class Isosurface
                             const double               iso_value,
                             const bool                 run_marching_tets = true);
 
+        // extracts the iso-surfaces of many iso-values in a single sweep over the tets
+        static std::vector<Isosurface<M,V,E,F,P>> extract(const Tetmesh<M,V,E,F,P> & m,
+                                                          const std::vector<double> & iso_values);
+
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
         Trimesh<M,V,E,F> export_as_trimesh() const;
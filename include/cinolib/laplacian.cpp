@@ -34,8 +34,11 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/laplacian.h>
+#include <cinolib/operator_cache.h>
 #include <cinolib/symbols.h>
+#include <cinolib/parallel_for.h>
 #include <Eigen/Sparse>
+#include <atomic>
 
 namespace cinolib
 {
@@ -87,13 +90,75 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 Eigen::SparseMatrix<double> laplacian(const AbstractMesh<M,V,E,P> & m, const int mode, const int n)
 {
-    std::vector<Entry> entries = laplacian_matrix_entries(m, mode, n);
+    if(m.operator_cache()) return *m.operator_cache()->laplacian(m, mode, n);
 
-    uint nv = n*m.num_verts();
-    Eigen::SparseMatrix<double> L(nv,nv);
-    L.setFromTriplets(entries.begin(), entries.end());
+    SparseAssembler A;
+    laplacian(m, mode, A, n);
+    return std::move(A.matrix());
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+const Eigen::SparseMatrix<double> & laplacian(const AbstractMesh<M,V,E,P> & m,
+                                              const int                     mode,
+                                              SparseAssembler             & A,
+                                              const int                     n)
+{
+    uint nv = m.num_verts();
+    std::atomic<uint> null_rows(0);
+
+    // the non zeros of column vid are vid itself and its neighbors (for each diagonal block)
+    auto col_rows = [&](const uint col, std::vector<uint> & rows)
+    {
+        uint base = nv*(col/nv);
+        uint vid  = col%nv;
+        rows.push_back(col);
+        for(uint nbr : m.adj_v2v(vid)) rows.push_back(base + nbr);
+    };
+
+    auto fill = [&]() -> bool
+    {
+        // diagonal blocks have the same pattern, hence the slot of an
+        // entry in the i-th block is its slot in the first block + i*nnz
+        uint nnz = A.num_nonzeros()/n;
+        double * val = A.values();
+        std::atomic<bool> in_pattern(true);
+        null_rows = 0;
+        PARALLEL_FOR(0, nv, 1000, [&](const uint vid)
+        {
+            // each thread only writes the entries of the rows it owns
+            thread_local std::vector<std::pair<uint,double>> wgts;
+            m.vert_weights(vid, mode, wgts);
+            double sum = 0.0;
+            for(auto item : wgts)
+            {
+                int s = A.slot(vid, item.first);
+                if(s<0) { in_pattern = false; continue; }
+                for(int i=0; i<n; ++i) val[s + i*nnz] += item.second;
+                sum -= item.second;
+            }
+            if(sum == 0.0)
+            {
+                ++null_rows;
+                sum = 1.0;
+            }
+            int s = A.slot(vid, vid);
+            if(s<0) { in_pattern = false; return; }
+            for(int i=0; i<n; ++i) val[s + i*nnz] += sum;
+        });
+        return in_pattern.load();
+    };
+
+    A.assemble(n*nv, n*nv, m.topology_revision(), col_rows, fill);
+
+    if(null_rows>0)
+    {
+        std::cerr << "WARNING: " << null_rows << " null rows in the matrix! (disconnected vertices? I put 1 in the diagonal)" << std::endl;
+    }
 
-    return L;
+    return A.matrix();
 }
 
 }
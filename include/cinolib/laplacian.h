@@ -37,6 +37,7 @@
 #define CINO_LAPLACIAN_H
 
 #include <cinolib/meshes/abstract_mesh.h>
+#include <cinolib/sparse_assembler.h>
 #include <Eigen/Sparse>
 #include <vector>
 
@@ -60,6 +61,18 @@ Eigen::SparseMatrix<double> laplacian(const AbstractMesh<M,V,E,P> & m,
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+// same as above, but assembled with (and stored in) A. The sparsity pattern is computed
+// only if A does not have one for the current connectivity of m, otherwise only values are updated.
+// Reuse A across calls to cheaply re-assemble the laplacian of a deforming mesh
+template<class M, class V, class E, class P>
+CINO_INLINE
+const Eigen::SparseMatrix<double> & laplacian(const AbstractMesh<M,V,E,P> & m,
+                                              const int                     mode,
+                                              SparseAssembler             & A,
+                                              const int                     n = 1);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class P>
 CINO_INLINE
 std::vector<Eigen::Triplet<double>> laplacian_matrix_entries(const AbstractMesh<M,V,E,P> & m,
@@ -35,6 +35,7 @@
 *********************************************************************************/
 #include <cinolib/linear_solvers.h>
 #include <cinolib/stl_container_utilities.h>
+#include <algorithm>
 
 namespace cinolib
 {
@@ -44,20 +45,159 @@ typedef Eigen::Triplet<double> Entry;
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
 CINO_INLINE
-void solve_square_system(const Eigen::SparseMatrix<double> & A,
-                         const Eigen::VectorXd             & b,
-                               Eigen::VectorXd             & x,
-                         int   solver)
+LinearSolverCache::LinearSolverCache(const int solver) : solver_type(solver)
 {
-    assert(A.rows() == A.cols());
+    assert(solver == SIMPLICIAL_LLT || solver == SIMPLICIAL_LDLT || solver == SparseLU || solver == BiCGSTAB);
+    bicgstab.setTolerance(1e-5);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void LinearSolverCache::clear()
+{
+    A          = Eigen::SparseMatrix<double>();
+    factorized = false;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void LinearSolverCache::set_solver(const int s)
+{
+    assert(s == SIMPLICIAL_LLT || s == SIMPLICIAL_LDLT || s == SparseLU || s == BiCGSTAB);
+    if(s == solver_type) return;
+    solver_type = s;
+    clear();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool LinearSolverCache::factorize(const Eigen::SparseMatrix<double> & M)
+{
+    assert(M.rows() == M.cols());
+
+    // patterns and values are compared on the compressed storage
+    Eigen::SparseMatrix<double> tmp;
+    const Eigen::SparseMatrix<double> *Mc = &M;
+    if(!M.isCompressed())
+    {
+        tmp = M;
+        tmp.makeCompressed();
+        Mc = &tmp;
+    }
+
+    uint nnz        = Mc->nonZeros();
+    bool same_shape = A.size()>0 && A.rows()==Mc->rows() && A.cols()==Mc->cols() && A.nonZeros()==Mc->nonZeros();
+    bool same_pattern = same_shape &&
+                        std::equal(Mc->outerIndexPtr(), Mc->outerIndexPtr()+Mc->outerSize()+1, A.outerIndexPtr()) &&
+                        std::equal(Mc->innerIndexPtr(), Mc->innerIndexPtr()+nnz, A.innerIndexPtr());
+
+    if(same_pattern && factorized && std::equal(Mc->valuePtr(), Mc->valuePtr()+nnz, A.valuePtr()))
+    {
+        return true; // nothing to do
+    }
+
+    if(same_pattern) std::copy(Mc->valuePtr(), Mc->valuePtr()+nnz, A.valuePtr());
+    else A = *Mc;
+
+    if(!same_pattern) ++n_analyses;
+    ++n_factorizations;
+
+    switch(solver_type)
+    {
+        case SIMPLICIAL_LLT:
+        {
+            if(!same_pattern) llt.analyzePattern(A);
+            llt.factorize(A);
+            factorized = (llt.info() == Eigen::Success);
+            break;
+        }
+
+        case SIMPLICIAL_LDLT:
+        {
+            if(!same_pattern) ldlt.analyzePattern(A);
+            ldlt.factorize(A);
+            factorized = (ldlt.info() == Eigen::Success);
+            break;
+        }
+
+        case SparseLU:
+        {
+            if(!same_pattern) lu.analyzePattern(A);
+            lu.factorize(A);
+            factorized = (lu.info() == Eigen::Success);
+            break;
+        }
 
+        case BiCGSTAB:
+        {
+            // the incomplete LU preconditioner has no separate symbolic phase
+            bicgstab.compute(A);
+            factorized = (bicgstab.info() == Eigen::Success);
+            break;
+        }
+
+        default: assert(false && "Unknown Solver");
+    }
+
+    return factorized;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void LinearSolverCache::solve(const Eigen::VectorXd & b, Eigen::VectorXd & x) const
+{
+    assert(factorized);
+    assert(b.rows() == A.rows());
+
+    switch(solver_type)
+    {
+        case SIMPLICIAL_LLT:  x = llt.solve(b).eval();      break;
+        case SIMPLICIAL_LDLT: x = ldlt.solve(b).eval();     break;
+        case SparseLU:        x = lu.solve(b).eval();       break;
+        case BiCGSTAB:        x = bicgstab.solve(b).eval(); break;
+        default: assert(false && "Unknown Solver");
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void LinearSolverCache::solve(const Eigen::MatrixXd & B, Eigen::MatrixXd & X) const
+{
+    assert(factorized);
+    assert(B.rows() == A.rows());
+
+    switch(solver_type)
+    {
+        case SIMPLICIAL_LLT:  X = llt.solve(B).eval();      break;
+        case SIMPLICIAL_LDLT: X = ldlt.solve(B).eval();     break;
+        case SparseLU:        X = lu.solve(B).eval();       break;
+        case BiCGSTAB:        X = bicgstab.solve(B).eval(); break;
+        default: assert(false && "Unknown Solver");
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// one-shot factorization, for calls without a cache (no copy of A, one solver object only)
+template<class Rhs>
+CINO_INLINE
+void solve_square_system_uncached(const Eigen::SparseMatrix<double> & A,
+                                  const Rhs                         & B,
+                                        Rhs                         & X,
+                                  int   solver)
+{
     switch (solver)
     {
         case SIMPLICIAL_LLT:
         {
             Eigen::SimplicialLLT< Eigen::SparseMatrix<double> > solver(A);
             assert(solver.info() == Eigen::Success);
-            x = solver.solve(b).eval();
+            X = solver.solve(B).eval();
             break;
         }
 
@@ -65,29 +205,36 @@ void solve_square_system(const Eigen::SparseMatrix<double> & A,
         {
             Eigen::SimplicialLDLT< Eigen::SparseMatrix<double> > solver(A);
             assert(solver.info() == Eigen::Success);
-            x = solver.solve(b).eval();
+            X = solver.solve(B).eval();
             break;
         }
 
         case BiCGSTAB:
         {
             Eigen::BiCGSTAB< Eigen::SparseMatrix<double> , Eigen::IncompleteLUT<double> > solver;
-            //solver.setMaxIterations(100);
             solver.setTolerance(1e-5);
             solver.compute(A);
             assert(solver.info() == Eigen::Success);
-            x = solver.solve(b).eval();
+            X = solver.solve(B).eval();
             break;
         }
 
         case SparseLU:
         {
-            Eigen::SparseMatrix<double> Ac = A;
-            Ac.makeCompressed();
             Eigen::SparseLU<Eigen::SparseMatrix<double>, Eigen::COLAMDOrdering<int> > solver;
-            solver.analyzePattern(Ac);
-            solver.factorize(Ac);
-            x = solver.solve(b);
+            if(A.isCompressed())
+            {
+                solver.analyzePattern(A);
+                solver.factorize(A);
+            }
+            else
+            {
+                Eigen::SparseMatrix<double> Ac = A;
+                Ac.makeCompressed();
+                solver.analyzePattern(Ac);
+                solver.factorize(Ac);
+            }
+            X = solver.solve(B);
             break;
         }
 
@@ -98,11 +245,65 @@ void solve_square_system(const Eigen::SparseMatrix<double> & A,
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
 CINO_INLINE
-void solve_square_system_with_bc(const Eigen::SparseMatrix<double> & A,
-                                 const Eigen::VectorXd             & b,
-                                       Eigen::VectorXd             & x,
-                                 const std::map<uint,double>       & bc, // Dirichlet boundary conditions
-                                 int   solver)
+void solve_square_system(const Eigen::SparseMatrix<double> & A,
+                         const Eigen::VectorXd             & b,
+                               Eigen::VectorXd             & x,
+                         int                 solver,
+                         LinearSolverCache * cache)
+{
+    assert(A.rows() == A.cols());
+
+    if(cache==nullptr)
+    {
+        solve_square_system_uncached(A, b, x, solver);
+        return;
+    }
+
+    cache->set_solver(solver);
+    bool ok = cache->factorize(A);
+    assert(ok); (void)ok;
+    cache->solve(b,x);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void solve_square_system(const Eigen::SparseMatrix<double> & A,
+                         const Eigen::MatrixXd             & B,
+                               Eigen::MatrixXd             & X,
+                         int                 solver,
+                         LinearSolverCache * cache)
+{
+    assert(A.rows() == A.cols());
+
+    if(cache==nullptr)
+    {
+        solve_square_system_uncached(A, B, X, solver);
+        return;
+    }
+
+    cache->set_solver(solver);
+    bool ok = cache->factorize(A);
+    assert(ok); (void)ok;
+    cache->solve(B,X);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// value of the c-th right hand side for a Dirichlet condition (scalar or one per right hand side)
+CINO_INLINE double bc_value(const double            v, const uint  ) { return v;    }
+CINO_INLINE double bc_value(const Eigen::VectorXd & v, const uint c) { return v[c]; }
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Rhs, class BC>
+CINO_INLINE
+void solve_square_system_with_bc_impl(const Eigen::SparseMatrix<double> & A,
+                                      const Rhs                         & B,
+                                            Rhs                         & X,
+                                      const std::map<uint,BC>           & bc, // Dirichlet boundary conditions
+                                      int                 solver,
+                                      LinearSolverCache * cache)
 {
     std::vector<int> col_map(A.rows(), -1);
     uint fresh_id = 0;
@@ -117,13 +318,13 @@ void solve_square_system_with_bc(const Eigen::SparseMatrix<double> & A,
     uint size = A.rows() - bc.size();
 
     std::vector<Entry> Aprime_entries;
-    Eigen::VectorXd    bprime(size);
+    Rhs                Bprime(size, B.cols());
 
     for(uint row=0; row<A.rows(); ++row)
     {
         if (col_map[row] >= 0)
         {
-            bprime[ col_map[row] ] = b[row];
+            Bprime.row(col_map[row]) = B.row(row);
         }
     }
 
@@ -143,7 +344,8 @@ void solve_square_system_with_bc(const Eigen::SparseMatrix<double> & A,
 
             if (col_map[col] < 0)
             {
-                bprime[ col_map[row] ] -= bc.at(col) * val;
+                const BC & v = bc.at(col);
+                for(uint c=0; c<B.cols(); ++c) Bprime(col_map[row],c) -= bc_value(v,c) * val;
             }
             else
             {
@@ -155,37 +357,65 @@ void solve_square_system_with_bc(const Eigen::SparseMatrix<double> & A,
     Eigen::SparseMatrix<double> Aprime(size, size);
     Aprime.setFromTriplets(Aprime_entries.begin(), Aprime_entries.end());
 
-    Eigen::VectorXd tmp_x(size);
+    Rhs tmp_X(size, B.cols());
 
-    solve_square_system(Aprime, bprime, tmp_x, solver);
+    solve_square_system(Aprime, Bprime, tmp_X, solver, cache);
 
-    x.resize(A.cols());
+    X.resize(A.cols(), B.cols());
     for(uint col=0; col<A.cols(); ++col)
     {
         if (col_map[col] >= 0)
         {
-            x[col] = tmp_x[ col_map[col] ];
+            X.row(col) = tmp_X.row(col_map[col]);
         }
         else
         {
-            x[col] = bc.at(col);
+            const BC & v = bc.at(col);
+            for(uint c=0; c<B.cols(); ++c) X(col,c) = bc_value(v,c);
         }
     }
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+CINO_INLINE
+void solve_square_system_with_bc(const Eigen::SparseMatrix<double> & A,
+                                 const Eigen::VectorXd             & b,
+                                       Eigen::VectorXd             & x,
+                                 const std::map<uint,double>       & bc, // Dirichlet boundary conditions
+                                 int                 solver,
+                                 LinearSolverCache * cache)
+{
+    solve_square_system_with_bc_impl(A, b, x, bc, solver, cache);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void solve_square_system_with_bc(const Eigen::SparseMatrix<double>    & A,
+                                 const Eigen::MatrixXd                & B,
+                                       Eigen::MatrixXd                & X,
+                                 const std::map<uint,Eigen::VectorXd> & bc, // Dirichlet boundary conditions
+                                 int                 solver,
+                                 LinearSolverCache * cache)
+{
+    solve_square_system_with_bc_impl(A, B, X, bc, solver, cache);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 CINO_INLINE
 void solve_least_squares(const Eigen::SparseMatrix<double> & A,
                          const Eigen::VectorXd             & b,
                                Eigen::VectorXd             & x,
-                         int   solver)
+                         int                 solver,
+                         LinearSolverCache * cache)
 {
     Eigen::SparseMatrix<double> At  = A.transpose();
     Eigen::SparseMatrix<double> AtA = At * A;
     Eigen::VectorXd             Atb = At * b;
 
-    solve_square_system(AtA, Atb, x, solver);
+    solve_square_system(AtA, Atb, x, solver, cache);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -195,13 +425,14 @@ void solve_least_squares_with_bc(const Eigen::SparseMatrix<double> & A,
                                  const Eigen::VectorXd             & b,
                                        Eigen::VectorXd             & x,
                                  const std::map<uint,double>       & bc, // Dirichlet boundary conditions
-                                 int   solver)
+                                 int                 solver,
+                                 LinearSolverCache * cache)
 {
     Eigen::SparseMatrix<double> At  = A.transpose();
     Eigen::SparseMatrix<double> AtA = At * A;
     Eigen::VectorXd             Atb = At * b;
 
-    solve_square_system_with_bc(AtA, Atb, x, bc, solver);
+    solve_square_system_with_bc(AtA, Atb, x, bc, solver, cache);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -211,13 +442,14 @@ void solve_weighted_least_squares(const Eigen::SparseMatrix<double> & A,
                                   const Eigen::VectorXd             & w,
                                   const Eigen::VectorXd             & b,
                                         Eigen::VectorXd             & x,
-                                  int   solver)
+                                  int                 solver,
+                                  LinearSolverCache * cache)
 {
     Eigen::SparseMatrix<double> At   = A.transpose();
     Eigen::SparseMatrix<double> AtWA = At * w.asDiagonal() * A;
     Eigen::VectorXd             AtWb = At * w.asDiagonal() * b;
 
-    solve_square_system(AtWA, AtWb, x, solver);
+    solve_square_system(AtWA, AtWb, x, solver, cache);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -228,15 +460,14 @@ void solve_weighted_least_squares_with_bc(const Eigen::SparseMatrix<double> & A,
                                           const Eigen::VectorXd             & b,
                                                 Eigen::VectorXd             & x,
                                           const std::map<uint,double>       & bc, // Dirichlet boundary conditions
-                                          int   solver)
+                                          int                 solver,
+                                          LinearSolverCache * cache)
 {
     Eigen::SparseMatrix<double> At   = A.transpose();
     Eigen::SparseMatrix<double> AtWA = At * w.asDiagonal() * A;
     Eigen::VectorXd             AtWb = At * w.asDiagonal() * b;
 
-    solve_square_system_with_bc(AtWA, AtWb, x, bc, solver);
+    solve_square_system_with_bc(AtWA, AtWb, x, bc, solver, cache);
 }
 
-
-
 }
@@ -38,6 +38,7 @@
 
 #include <string>
 #include <map>
+#include <vector>
 #include <sys/types.h>
 #include <cinolib/cino_inline.h>
 #include <Eigen/Sparse>
@@ -78,11 +79,78 @@ static const std::string txt[4] =
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+/* Keeps the factorization of a sparse matrix, so that it can be reused across solves.
+ * Factorizing a matrix identical to the cached one costs just a comparison. If only
+ * the values changed (same sparsity pattern) the symbolic analysis (fill reducing
+ * ordering, elimination tree) is reused, and only the numeric factorization is redone.
+ * Any other change triggers a full factorization.
+ *
+ * Pass a cache to the solve_* functions below to amortize factorizations across calls
+ * (e.g. iterative pipelines, or multiple solves with the same operator). Caches cannot
+ * be copied, and should not be shared between concurrent solves.
+*/
+class LinearSolverCache
+{
+    public:
+
+        explicit LinearSolverCache(const int solver = SIMPLICIAL_LLT);
+
+        void clear();
+
+        // switching to a different solver clears the cache
+        void set_solver(const int s);
+        int  solver() const { return solver_type; }
+
+        // (re)factorizes A, reusing whatever possible from the previous call.
+        // Returns false if the factorization failed
+        bool factorize(const Eigen::SparseMatrix<double> & A);
+        bool is_factorized() const { return factorized; }
+
+        // solves for a single right hand side, or for many (one per column of B)
+        void solve(const Eigen::VectorXd & b, Eigen::VectorXd & x) const;
+        void solve(const Eigen::MatrixXd & B, Eigen::MatrixXd & X) const;
+
+        // counters, useful to check how many factorizations are actually computed
+        uint num_analyses()       const { return n_analyses;       }
+        uint num_factorizations() const { return n_factorizations; }
+
+    protected:
+
+        int  solver_type;
+        bool factorized       = false;
+        uint n_analyses       = 0;
+        uint n_factorizations = 0;
+
+        // copy of the factorized matrix (needed also by the iterative solver, which keeps a reference to it)
+        Eigen::SparseMatrix<double> A;
+
+        Eigen::SimplicialLLT <Eigen::SparseMatrix<double>>                             llt;
+        Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>>                             ldlt;
+        Eigen::SparseLU      <Eigen::SparseMatrix<double>, Eigen::COLAMDOrdering<int>> lu;
+        Eigen::BiCGSTAB      <Eigen::SparseMatrix<double>, Eigen::IncompleteLUT<double>> bicgstab;
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// NOTE: all the solvers below accept an optional cache. If given, it is set to use the
+// requested solver, and factorizations are reused as described above
+
 CINO_INLINE
 void solve_square_system(const Eigen::SparseMatrix<double> & A,
                          const Eigen::VectorXd             & b,
                                Eigen::VectorXd             & x,
-                         int   solver = SIMPLICIAL_LLT);
+                         int                 solver = SIMPLICIAL_LLT,
+                         LinearSolverCache * cache  = nullptr);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// multiple right hand sides (one per column of B)
+CINO_INLINE
+void solve_square_system(const Eigen::SparseMatrix<double> & A,
+                         const Eigen::MatrixXd             & B,
+                               Eigen::MatrixXd             & X,
+                         int                 solver = SIMPLICIAL_LLT,
+                         LinearSolverCache * cache  = nullptr);
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
@@ -91,7 +159,20 @@ void solve_square_system_with_bc(const Eigen::SparseMatrix<double> & A,
                                  const Eigen::VectorXd             & b,
                                        Eigen::VectorXd             & x,
                                  const std::map<uint,double>       & bc, // Dirichlet boundary conditions
-                                 int   solver = SIMPLICIAL_LLT);
+                                 int                 solver = SIMPLICIAL_LLT,
+                                 LinearSolverCache * cache  = nullptr);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// multiple right hand sides (one per column of B). Each boundary condition
+// prescribes a value for each of the columns of the solution X
+CINO_INLINE
+void solve_square_system_with_bc(const Eigen::SparseMatrix<double>    & A,
+                                 const Eigen::MatrixXd                & B,
+                                       Eigen::MatrixXd                & X,
+                                 const std::map<uint,Eigen::VectorXd> & bc, // Dirichlet boundary conditions
+                                 int                 solver = SIMPLICIAL_LLT,
+                                 LinearSolverCache * cache  = nullptr);
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
@@ -99,7 +180,8 @@ CINO_INLINE
 void solve_least_squares(const Eigen::SparseMatrix<double> & A,
                          const Eigen::VectorXd             & b,
                                Eigen::VectorXd             & x,
-                         int   solver = SIMPLICIAL_LLT);
+                         int                 solver = SIMPLICIAL_LLT,
+                         LinearSolverCache * cache  = nullptr);
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
@@ -108,7 +190,8 @@ void solve_least_squares_with_bc(const Eigen::SparseMatrix<double> & A,
                                  const Eigen::VectorXd             & b,
                                        Eigen::VectorXd             & x,
                                  const std::map<uint,double>       & bc, // Dirichlet boundary conditions
-                                 int   solver = SIMPLICIAL_LLT);
+                                 int                 solver = SIMPLICIAL_LLT,
+                                 LinearSolverCache * cache  = nullptr);
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
@@ -117,7 +200,8 @@ void solve_weighted_least_squares(const Eigen::SparseMatrix<double> & A,
                                   const Eigen::VectorXd             & w,
                                   const Eigen::VectorXd             & b,
                                         Eigen::VectorXd             & x,
-                                  int   solver = SIMPLICIAL_LLT);
+                                  int                 solver = SIMPLICIAL_LLT,
+                                  LinearSolverCache * cache  = nullptr);
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
@@ -127,7 +211,8 @@ void solve_weighted_least_squares_with_bc(const Eigen::SparseMatrix<double> & A,
                                           const Eigen::VectorXd             & b,
                                                 Eigen::VectorXd             & x,
                                           const std::map<uint,double>       & bc, // Dirichlet boundary conditions
-                                          int   solver = SIMPLICIAL_LLT);
+                                          int                 solver = SIMPLICIAL_LLT,
+                                          LinearSolverCache * cache  = nullptr);
 
 }
 
@@ -44,7 +44,8 @@ namespace cinolib
 template<class M, class V, class E, class P>
 CINO_INLINE
 ScalarField LSCM(const Trimesh<M,V,E,P>     & m,
-                 const std::map<uint,vec2d> & bc)
+                 const std::map<uint,vec2d> & bc,
+                       LinearSolverCache    * cache)
 {
     std::map<uint,double> bc_uv;
     if(!bc.empty())
@@ -72,7 +73,7 @@ ScalarField LSCM(const Trimesh<M,V,E,P>     & m,
     Eigen::VectorXd             rhs = Eigen::VectorXd::Zero(2*m.num_verts());
 
     ScalarField f_uv;
-    solve_square_system_with_bc(-L+2*A, rhs, f_uv, bc_uv, SIMPLICIAL_LDLT);
+    solve_square_system_with_bc(-L+2*A, rhs, f_uv, bc_uv, SIMPLICIAL_LDLT, cache);
     return f_uv;
 }
 
@@ -38,6 +38,7 @@
 
 #include <cinolib/meshes/trimesh.h>
 #include <cinolib/scalar_field.h>
+#include <cinolib/linear_solvers.h>
 
 namespace cinolib
 {
@@ -61,12 +62,16 @@ namespace cinolib
  * NOTE: if the (at least two) required Dirichlet boundary conditions are
  * not provided in input by the user, they will be automatically selected
  * as the furthest pair of points along the boundary of the shape.
+ *
+ * If a cache is provided, repeated calls on the same mesh with the same boundary
+ * vertices (e.g. with different boundary values) reuse the matrix factorization
 */
 
 template<class M, class V, class E, class P>
 CINO_INLINE
 ScalarField LSCM(const Trimesh<M,V,E,P>     & m,
-                 const std::map<uint,vec2d> & bc = std::map<uint,vec2d>());
+                 const std::map<uint,vec2d> & bc = std::map<uint,vec2d>(),
+                       LinearSolverCache    * cache = nullptr);
 }
 
 #ifndef  CINO_STATIC_LIB
@@ -51,6 +51,7 @@ void map_to_tetrahedron(const Trimesh<M,V,E,P> & m,
     std::vector<vec3d> verts;
     map_to_tetrahedron(m, verts);
     for(uint vid=0; vid<m_out.num_verts(); ++vid) m_out.vert(vid) = verts.at(vid);
+    m_out.mark_changed(CHANGES_VERT_POS);
     m_out.update_bbox();
     m_out.update_normals();
 }
@@ -43,6 +43,10 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/marching_tets.h>
+#include <cinolib/parallel_for.h>
+#include <algorithm>
+#include <numeric>
+#include <atomic>
 #include <array>
 
 namespace cinolib
@@ -70,27 +74,57 @@ enum // Look-up Table
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-template<class M, class V, class E, class F, class P>
 CINO_INLINE
-void make_triangle(const Tetmesh<M,V,E,F,P> & m,
-                   const double               isovalue,
-                   const uint                 vids[],
-                   const double               func[],
-                   const std::array<uint,3> & e,
-                   std::map<ipair,uint>     & e2v_map,
-                   std::vector<vec3d>       & verts,
-                   std::vector<uint>        & tris,
-                   std::vector<vec3d>       & norms);
+unsigned char marching_tets_raw_config(const double func[],
+                                       const double isovalue,
+                                             bool & swapped)
+{
+    unsigned char c = 0x0;
+    if (isovalue >= func[0]) c |= C_1000;
+    if (isovalue >= func[1]) c |= C_0100;
+    if (isovalue >= func[2]) c |= C_0010;
+    if (isovalue >= func[3]) c |= C_0001;
+
+    /* If the isosurface does not intersect the tet,
+     * one should get C_1111 using ">=", and C_0000
+     * inverting to "<=".
+     *
+     * This does not happen if the isosurface passes
+     * exhactly through one face. In this case one will
+     * get C_1111 using ">=", and something like
+     * C_0111 using "<=".
+     *
+     * Normally this does not create any trouble, as the
+     * face-adjacent tet will trigger the generation of
+     * that triangle. But if the tet is exposed on the
+     * surface, then that triangle will be missing in the
+     * final iso-surface.
+     *
+     * To avoid these missing triangles, whenever I get
+     * a C_1111 I invert the sign, and assign to the tet
+     * the configuration produced using "<="
+    */
+    swapped = (c == C_1111);
+    if (swapped)
+    {
+        c = 0x0;
+        if (isovalue <= func[0]) c |= C_1000;
+        if (isovalue <= func[1]) c |= C_0100;
+        if (isovalue <= func[2]) c |= C_0010;
+        if (isovalue <= func[3]) c |= C_0001;
+    }
+    return c;
+}
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
 template<class M, class V, class E, class F, class P>
 CINO_INLINE
-void marching_tets(const Tetmesh<M,V,E,F,P> & m,
-                   const double               isovalue,
-                   std::vector<vec3d>       & verts,
-                   std::vector<uint>        & tris,
-                   std::vector<vec3d>       & norms)
+unsigned char marching_tets_config(const Tetmesh<M,V,E,F,P> & m,
+                                   const uint                 pid,
+                                   const double               func[],
+                                   const double               isovalue,
+                                         bool               & swapped)
 {
     /* FIXME: for all configurations where two verts >= isoval
      * and the other two are < isoval, this method will try to
@@ -103,151 +137,136 @@ void marching_tets(const Tetmesh<M,V,E,F,P> & m,
      * vertex (<,>,=). In this case each configuration will be 100% correct
     */
 
-    std::vector<unsigned char> c(m.num_polys(),0x0);
-    std::vector<bool> swapped(m.num_polys(), false);
+    unsigned char c = marching_tets_raw_config(func, isovalue, swapped);
 
-    for(uint pid=0; pid<m.num_polys(); ++pid)
+    bool v_on_iso[] =
     {
-        double func[] =
-        {
-            m.vert_data(m.poly_vert_id(pid,0)).uvw[0],
-            m.vert_data(m.poly_vert_id(pid,1)).uvw[0],
-            m.vert_data(m.poly_vert_id(pid,2)).uvw[0],
-            m.vert_data(m.poly_vert_id(pid,3)).uvw[0]
-        };
-
-        if (isovalue >= func[0]) c.at(pid) |= C_1000;
-        if (isovalue >= func[1]) c.at(pid) |= C_0100;
-        if (isovalue >= func[2]) c.at(pid) |= C_0010;
-        if (isovalue >= func[3]) c.at(pid) |= C_0001;
-
-        /* If the isosurface does not intersect the tet,
-         * one should get C_1111 using ">=", and C_0000
-         * inverting to "<=".
-         *
-         * This does not happen if the isosurface passes
-         * exhactly through one face. In this case one will
-         * get C_1111 using ">=", and something like
-         * C_0111 using "<=".
-         *
-         * Normally this does not create any trouble, as the
-         * face-adjacent tet will trigger the generation of
-         * that triangle. But if the tet is exposed on the
-         * surface, then that triangle will be missing in the
-         * final iso-surface.
-         *
-         * To avoid these missing triangles, whenever I get
-         * a C_1111 I invert the sign, and assign to the tet
-         * the configuration produced using "<="
-        */
-        if (c.at(pid) == C_1111)
-        {
-            swapped.at(pid) = true;
-            c.at(pid) = 0x0;
-            if (isovalue <= func[0]) c.at(pid) |= C_1000;
-            if (isovalue <= func[1]) c.at(pid) |= C_0100;
-            if (isovalue <= func[2]) c.at(pid) |= C_0010;
-            if (isovalue <= func[3]) c.at(pid) |= C_0001;
-        }
+        func[0] == isovalue,
+        func[1] == isovalue,
+        func[2] == isovalue,
+        func[3] == isovalue
+    };
+
+    // tells whether the tet adjacent through the i-th face is collapsed (C_1111). Tets
+    // are visited in parallel, hence its configuration is computed here rather than read
+    auto adj_is_collapsed = [&](const uint i) -> bool
+    {
+        int adj = m.poly_adj_through_face(pid, m.poly_face_id(pid,i));
+        double adj_func[4];
+        for(uint j=0; j<4; ++j) adj_func[j] = m.vert_data(m.poly_vert_id(adj,j)).uvw[0];
+        bool adj_swapped;
+        return marching_tets_raw_config(adj_func, isovalue, adj_swapped) == C_1111;
+    };
+
+    // tells whether the tet adjacent through the i-th face exists and has higher id
+    auto adj_follows = [&](const uint i) -> bool
+    {
+        return (int)pid < m.poly_adj_through_face(pid, m.poly_face_id(pid,i));
+    };
+
+    // Avoid triangle duplication and collapsed triangle generation when the iso-surface
+    // passes EXACTLY through a vertex/edge/face shared between many tetrahedra.
+    //
+    switch (c)
+    {
+        // iso-surface passes on a face : make sure only one tet (MUST BE the one with higher id) triggers triangle generation...
+        // Notice that if the adjacent tet is collapsed (C_1111), then it make sense to use the current one regardless the tid order
+        case C_1110 : if (v_on_iso[0] && v_on_iso[1] && v_on_iso[2] && adj_follows(0) && !adj_is_collapsed(0)) c = C_0000; break;
+        case C_1101 : if (v_on_iso[0] && v_on_iso[1] && v_on_iso[3] && adj_follows(1) && !adj_is_collapsed(1)) c = C_0000; break;
+        case C_1011 : if (v_on_iso[0] && v_on_iso[2] && v_on_iso[3] && adj_follows(2) && !adj_is_collapsed(2)) c = C_0000; break;
+        case C_0111 : if (v_on_iso[1] && v_on_iso[2] && v_on_iso[3] && adj_follows(3) && !adj_is_collapsed(3)) c = C_0000; break;
+
+        // iso-surface passes on a edge : do nothing
+        case C_0101 : if (v_on_iso[1] && v_on_iso[3]) c = C_0000; break;
+        case C_1010 : if (v_on_iso[0] && v_on_iso[2]) c = C_0000; break;
+        case C_0011 : if (v_on_iso[2] && v_on_iso[3]) c = C_0000; break;
+        case C_1100 : if (v_on_iso[0] && v_on_iso[1]) c = C_0000; break;
+        case C_1001 : if (v_on_iso[0] && v_on_iso[3]) c = C_0000; break;
+        case C_0110 : if (v_on_iso[1] && v_on_iso[2]) c = C_0000; break;
+
+        // iso-surface passes on a vertex : do nothing
+        case C_1000 : if (v_on_iso[0]) c = C_0000; break;
+        case C_0100 : if (v_on_iso[1]) c = C_0000; break;
+        case C_0010 : if (v_on_iso[2]) c = C_0000; break;
+        case C_0001 : if (v_on_iso[3]) c = C_0000; break;
+
+        default : break;
     }
+    return c;
+}
 
-    std::map<ipair,uint> e2v_map;
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-    for(uint pid=0; pid<m.num_polys(); ++pid)
+// triangles generated by a tet with configuration c, as triplets of
+// tet edges (see TET_EDGES). Returns the number of triangles (0, 1 or 2)
+CINO_INLINE
+uint marching_tets_triangles(const unsigned char        c,
+                             const bool                 swapped,
+                                   std::array<uint,3>   t[2])
+{
+    switch (c)
     {
-        uint vids[] =
-        {
-            m.poly_vert_id(pid,0),
-            m.poly_vert_id(pid,1),
-            m.poly_vert_id(pid,2),
-            m.poly_vert_id(pid,3)
-        };
+        case C_1000 : t[0] = {2,0,4}; return 1;
+        case C_0111 : t[0] = swapped ? std::array<uint,3>{2,0,4} : std::array<uint,3>{0,2,4}; return 1;
+        case C_1011 : t[0] = swapped ? std::array<uint,3>{1,2,3} : std::array<uint,3>{2,1,3}; return 1;
+        case C_0100 : t[0] = {1,2,3}; return 1;
+        case C_1101 : t[0] = swapped ? std::array<uint,3>{0,1,5} : std::array<uint,3>{1,0,5}; return 1;
+        case C_0010 : t[0] = {0,1,5}; return 1;
+        case C_0001 : t[0] = {5,3,4}; return 1;
+        case C_1110 : t[0] = swapped ? std::array<uint,3>{5,3,4} : std::array<uint,3>{3,5,4}; return 1;
+        case C_0101 : t[0] = {5,2,4}; t[1] = {2,5,1}; return 2;
+        case C_1010 : t[0] = {2,5,4}; t[1] = {5,2,1}; return 2;
+        case C_0011 : t[0] = {3,4,1}; t[1] = {1,4,0}; return 2;
+        case C_1100 : t[0] = {4,3,1}; t[1] = {4,1,0}; return 2;
+        case C_1001 : t[0] = {3,2,0}; t[1] = {5,3,0}; return 2;
+        case C_0110 : t[0] = {2,3,0}; t[1] = {3,5,0}; return 2;
+        default : return 0;
+    }
+}
 
-        double func[] =
-        {
-            m.vert_data(vids[0]).uvw[0],
-            m.vert_data(vids[1]).uvw[0],
-            m.vert_data(vids[2]).uvw[0],
-            m.vert_data(vids[3]).uvw[0]
-        };
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-        bool v_on_iso[] =
-        {
-            func[0] == isovalue,
-            func[1] == isovalue,
-            func[2] == isovalue,
-            func[3] == isovalue
-        };
+// calls func(s,slots) for each triangle generated by tet pid for the s-th (sorted)
+// iso-value, where slots are the edge slots that carry the triangle vertices
+template<class M, class V, class E, class F, class P, class Func>
+CINO_INLINE
+void marching_tets_visit(const Tetmesh<M,V,E,F,P> & m,
+                         const uint                 pid,
+                         const std::vector<double> & iso,
+                         const std::vector<uint>   & slot_beg,
+                         const std::vector<uint>   & slot_iso,
+                         const Func                & func)
+{
+    uint   vids[4];
+    double f[4];
+    for(uint i=0; i<4; ++i)
+    {
+        vids[i] = m.poly_vert_id(pid,i);
+        f[i]    = m.vert_data(vids[i]).uvw[0];
+    }
+    auto beg = std::lower_bound(iso.begin(), iso.end(), *std::min_element(f,f+4));
+    auto end = std::upper_bound(beg,         iso.end(), *std::max_element(f,f+4));
+    if(beg==end) return;
 
-        int adj_tet[] // not uint because it may be -1 if there is no adjacent tet!
-        {
-            m.poly_adj_through_face(pid, m.poly_face_id(pid,0)),
-            m.poly_adj_through_face(pid, m.poly_face_id(pid,1)),
-            m.poly_adj_through_face(pid, m.poly_face_id(pid,2)),
-            m.poly_adj_through_face(pid, m.poly_face_id(pid,3)),
-        };
-
-        // Avoid triangle duplication and collapsed triangle generation when the iso-surface
-        // passes EXACTLY through a vertex/edge/face shared between many tetrahedra.
-        //
-        switch (c.at(pid))
-        {
-            // iso-surface passes on a face : make sure only one tet (MUST BE the one with higher id) triggers triangle generation...
-            // Notice that if the adjacent tet is collapsed (C_1111), then it make sense to use the current one regardless the tid order
-            case C_1110 : if (v_on_iso[0] && v_on_iso[1] && v_on_iso[2] && (int)pid < adj_tet[0] && c.at(adj_tet[0]) != C_1111) c.at(pid) = C_0000; break;
-            case C_1101 : if (v_on_iso[0] && v_on_iso[1] && v_on_iso[3] && (int)pid < adj_tet[1] && c.at(adj_tet[1]) != C_1111) c.at(pid) = C_0000; break;
-            case C_1011 : if (v_on_iso[0] && v_on_iso[2] && v_on_iso[3] && (int)pid < adj_tet[2] && c.at(adj_tet[2]) != C_1111) c.at(pid) = C_0000; break;
-            case C_0111 : if (v_on_iso[1] && v_on_iso[2] && v_on_iso[3] && (int)pid < adj_tet[3] && c.at(adj_tet[3]) != C_1111) c.at(pid) = C_0000; break;
-
-            // iso-surface passes on a edge : do nothing
-            case C_0101 : if (v_on_iso[1] && v_on_iso[3]) c.at(pid) = C_0000; break;
-            case C_1010 : if (v_on_iso[0] && v_on_iso[2]) c.at(pid) = C_0000; break;
-            case C_0011 : if (v_on_iso[2] && v_on_iso[3]) c.at(pid) = C_0000; break;
-            case C_1100 : if (v_on_iso[0] && v_on_iso[1]) c.at(pid) = C_0000; break;
-            case C_1001 : if (v_on_iso[0] && v_on_iso[3]) c.at(pid) = C_0000; break;
-            case C_0110 : if (v_on_iso[1] && v_on_iso[2]) c.at(pid) = C_0000; break;
-
-            // iso-surface passes on a vertex : do nothing
-            case C_1000 : if (v_on_iso[0]) c.at(pid) = C_0000; break;
-            case C_0100 : if (v_on_iso[1]) c.at(pid) = C_0000; break;
-            case C_0010 : if (v_on_iso[2]) c.at(pid) = C_0000; break;
-            case C_0001 : if (v_on_iso[3]) c.at(pid) = C_0000; break;
-
-            default : break;
-        }
+    uint eids[6];
+    for(uint i=0; i<6; ++i) eids[i] = m.poly_edge_id(pid, vids[TET_EDGES[i][0]], vids[TET_EDGES[i][1]]);
 
-        // triangle generation
-        switch (c.at(pid))
+    for(uint s=beg-iso.begin(); s<uint(end-iso.begin()); ++s)
+    {
+        bool swapped;
+        unsigned char c = marching_tets_config(m, pid, f, iso.at(s), swapped);
+        std::array<uint,3> t[2];
+        uint n = marching_tets_triangles(c, swapped, t);
+        for(uint i=0; i<n; ++i)
         {
-            case C_1000 : { make_triangle(m, isovalue, vids, func, {2,0,4}, e2v_map, verts, tris, norms); break; }
-            case C_0111 : { swapped.at(pid)?
-                            make_triangle(m, isovalue, vids, func, {2,0,4}, e2v_map, verts, tris, norms) :
-                            make_triangle(m, isovalue, vids, func, {0,2,4}, e2v_map, verts, tris, norms); break; }
-            case C_1011 : { swapped.at(pid)?
-                            make_triangle(m, isovalue, vids, func, {1,2,3}, e2v_map, verts, tris, norms) :
-                            make_triangle(m, isovalue, vids, func, {2,1,3}, e2v_map, verts, tris, norms); break; }
-            case C_0100 : { make_triangle(m, isovalue, vids, func, {1,2,3}, e2v_map, verts, tris, norms); break; }
-            case C_1101 : { swapped.at(pid)?
-                            make_triangle(m, isovalue, vids, func, {0,1,5}, e2v_map, verts, tris, norms) :
-                            make_triangle(m, isovalue, vids, func, {1,0,5}, e2v_map, verts, tris, norms); break; }
-            case C_0010 : { make_triangle(m, isovalue, vids, func, {0,1,5}, e2v_map, verts, tris, norms); break; }
-            case C_0001 : { make_triangle(m, isovalue, vids, func, {5,3,4}, e2v_map, verts, tris, norms); break; }
-            case C_1110 : { swapped.at(pid)?
-                            make_triangle(m, isovalue, vids, func, {5,3,4}, e2v_map, verts, tris, norms) :
-                            make_triangle(m, isovalue, vids, func, {3,5,4}, e2v_map, verts, tris, norms); break; }
-            case C_0101 : { make_triangle(m, isovalue, vids, func, {5,2,4}, e2v_map, verts, tris, norms);
-                            make_triangle(m, isovalue, vids, func, {2,5,1}, e2v_map, verts, tris, norms); break; }
-            case C_1010 : { make_triangle(m, isovalue, vids, func, {2,5,4}, e2v_map, verts, tris, norms);
-                            make_triangle(m, isovalue, vids, func, {5,2,1}, e2v_map, verts, tris, norms); break; }
-            case C_0011 : { make_triangle(m, isovalue, vids, func, {3,4,1}, e2v_map, verts, tris, norms);
-                            make_triangle(m, isovalue, vids, func, {1,4,0}, e2v_map, verts, tris, norms); break; }
-            case C_1100 : { make_triangle(m, isovalue, vids, func, {4,3,1}, e2v_map, verts, tris, norms);
-                            make_triangle(m, isovalue, vids, func, {4,1,0}, e2v_map, verts, tris, norms); break; }
-            case C_1001 : { make_triangle(m, isovalue, vids, func, {3,2,0}, e2v_map, verts, tris, norms);
-                            make_triangle(m, isovalue, vids, func, {5,3,0}, e2v_map, verts, tris, norms); break; }
-            case C_0110 : { make_triangle(m, isovalue, vids, func, {2,3,0}, e2v_map, verts, tris, norms);
-                            make_triangle(m, isovalue, vids, func, {3,5,0}, e2v_map, verts, tris, norms); break; }
-            default : break;
+            uint slots[3];
+            for(uint j=0; j<3; ++j)
+            {
+                uint eid = eids[t[i][j]];
+                assert(s>=slot_iso.at(eid) && s-slot_iso.at(eid)<slot_beg.at(eid+1)-slot_beg.at(eid));
+                slots[j] = slot_beg.at(eid) + s - slot_iso.at(eid);
+            }
+            func(s, slots);
         }
     }
 }
@@ -256,66 +275,156 @@ void marching_tets(const Tetmesh<M,V,E,F,P> & m,
 
 template<class M, class V, class E, class F, class P>
 CINO_INLINE
-void make_triangle(const Tetmesh<M,V,E,F,P> & m,
+void marching_tets(const Tetmesh<M,V,E,F,P> & m,
                    const double               isovalue,
-                   const uint                 vids[],
-                   const double               func[],
-                   const std::array<uint,3> & e,
-                   std::map<ipair,uint>     & e2v_map,
                    std::vector<vec3d>       & verts,
                    std::vector<uint>        & tris,
                    std::vector<vec3d>       & norms)
 {
-    assert(isovalue >= *std::min_element(func, func+4));
-    assert(isovalue <= *std::max_element(func, func+4));
+    std::vector<std::vector<vec3d>> all_verts, all_norms;
+    std::vector<std::vector<uint>>  all_tris;
+    marching_tets(m, std::vector<double>(1,isovalue), all_verts, all_tris, all_norms);
+    verts.swap(all_verts.front());
+    tris.swap (all_tris.front());
+    norms.swap(all_norms.front());
+}
 
-    vec3d tri_verts[3];
-    uint  fresh_vid = verts.size();
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-    for(uint i=0; i<3; ++i)
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void marching_tets(const Tetmesh<M,V,E,F,P>         & m,
+                   const std::vector<double>        & isovalues,
+                   std::vector<std::vector<vec3d>>  & verts,
+                   std::vector<std::vector<uint>>   & tris,
+                   std::vector<std::vector<vec3d>>  & norms)
+{
+    uint n_iso = isovalues.size();
+    verts.assign(n_iso, std::vector<vec3d>());
+    tris.assign (n_iso, std::vector<uint>());
+    norms.assign(n_iso, std::vector<vec3d>());
+    if(n_iso==0) return;
+
+    // iso-values are processed in increasing order, so that the ones
+    // spanned by a tet (or by an edge) form a contiguous range
+    std::vector<uint> iso_order(n_iso);
+    std::iota(iso_order.begin(), iso_order.end(), 0);
+    std::stable_sort(iso_order.begin(), iso_order.end(), [&](const uint i, const uint j)
     {
-        uint v_a = vids[TET_EDGES[e[i]][0]];
-        uint v_b = vids[TET_EDGES[e[i]][1]];
-
-        // avoid duplicated vertices. If an edge has already
-        // been visited retrieve its id and coordinates
-        //
-        ipair pair  = unique_pair(v_a, v_b);
-        auto  query = e2v_map.find(pair);
+        return isovalues.at(i) < isovalues.at(j);
+    });
+    std::vector<double> iso(n_iso);
+    for(uint i=0; i<n_iso; ++i) iso.at(i) = isovalues.at(iso_order.at(i));
+
+    // EDGE SLOTS
+    // each edge may carry a vertex for each iso-value in the range of its endpoints.
+    // The slots of edge eid are slot_beg[eid] ... slot_beg[eid+1]-1, and the first
+    // one refers to the iso-value slot_iso[eid]
+    std::vector<uint> slot_beg(m.num_edges()+1, 0);
+    std::vector<uint> slot_iso(m.num_edges());
+    PARALLEL_FOR(0, m.num_edges(), 10000, [&](const uint eid)
+    {
+        double f0 = m.vert_data(m.edge_vert_id(eid,0)).uvw[0];
+        double f1 = m.vert_data(m.edge_vert_id(eid,1)).uvw[0];
+        auto beg = std::lower_bound(iso.begin(), iso.end(), std::min(f0,f1));
+        auto end = std::upper_bound(beg,         iso.end(), std::max(f0,f1));
+        slot_iso.at(eid)   = beg - iso.begin();
+        slot_beg.at(eid+1) = end - beg;
+    });
+    std::partial_sum(slot_beg.begin(), slot_beg.end(), slot_beg.begin());
+    std::vector<std::atomic<unsigned char>> slot_used(slot_beg.back());
+
+    // FIRST PASS
+    // count the triangles generated by each block of tets (for each iso-value)
+    // and mark the edge slots that are actually used
+    const uint block_size = 1024;
+    uint n_blocks = (m.num_polys()+block_size-1)/block_size;
+    std::vector<uint> block_count(n_blocks*n_iso, 0);
+    PARALLEL_FOR(0, n_blocks, 1, SCHEDULE_DYNAMIC, 4, [&](const uint b)
+    {
+        uint *count = &block_count.at(b*n_iso);
+        for(uint pid=b*block_size; pid<std::min((b+1)*block_size, m.num_polys()); ++pid)
+        {
+            marching_tets_visit(m, pid, iso, slot_beg, slot_iso, [&](const uint s, const uint slots[])
+            {
+                ++count[s];
+                for(uint j=0; j<3; ++j) slot_used[slots[j]].store(1, std::memory_order_relaxed);
+            });
+        }
+    });
 
-        if (query != e2v_map.end())
+    // VERTICES
+    // number the used slots of each iso-value in edge order, then place them along the edges
+    std::vector<uint> slot_vid(slot_beg.back(), 0);
+    std::vector<uint> n_verts(n_iso, 0);
+    for(uint eid=0; eid<m.num_edges(); ++eid)
+    {
+        for(uint slot=slot_beg.at(eid); slot<slot_beg.at(eid+1); ++slot)
         {
-            uint vid = query->second;
-            tri_verts[i] = vec3d(verts.at(vid));
-            tris.push_back(vid);
+            if(slot_used[slot]) slot_vid.at(slot) = n_verts.at(slot_iso.at(eid) + slot - slot_beg.at(eid))++;
         }
-        else
+    }
+    for(uint s=0; s<n_iso; ++s) verts.at(iso_order.at(s)).resize(n_verts.at(s));
+    PARALLEL_FOR(0, m.num_edges(), 10000, [&](const uint eid)
+    {
+        for(uint slot=slot_beg.at(eid); slot<slot_beg.at(eid+1); ++slot)
         {
-            double f_a = func[TET_EDGES[e[i]][0]];
-            double f_b = func[TET_EDGES[e[i]][1]];
-
+            if(!slot_used[slot]) continue;
+            uint   s   = slot_iso.at(eid) + slot - slot_beg.at(eid);
+            uint   v_a = m.edge_vert_id(eid,0);
+            uint   v_b = m.edge_vert_id(eid,1);
+            double f_a = m.vert_data(v_a).uvw[0];
+            double f_b = m.vert_data(v_b).uvw[0];
             if (f_a < f_b)
             {
                 std::swap(v_a, v_b);
                 std::swap(f_a, f_b);
             }
+            double alpha = (f_a!=f_b) ? (iso.at(s) - f_a) / (f_b - f_a) : 0.0;
+            verts.at(iso_order.at(s)).at(slot_vid.at(slot)) = (1.0 - alpha) * m.vert(v_a) + alpha * m.vert(v_b);
+        }
+    });
 
-            double alpha = (isovalue - f_a) / (f_b - f_a);
-
-            tri_verts[i] = (1.0 - alpha) * m.vert(v_a) + alpha * m.vert(v_b);
-
-            verts.push_back(tri_verts[i]);
-
-            tris.push_back(fresh_vid);
-            e2v_map[pair] = fresh_vid++;
+    // exclusive prefix sum of the block counts (for each iso-value)
+    for(uint s=0; s<n_iso; ++s)
+    {
+        uint n_tris = 0;
+        for(uint b=0; b<n_blocks; ++b)
+        {
+            uint count = block_count.at(b*n_iso+s);
+            block_count.at(b*n_iso+s) = n_tris;
+            n_tris += count;
         }
+        tris .at(iso_order.at(s)).resize(3*n_tris);
+        norms.at(iso_order.at(s)).resize(n_tris);
     }
 
-    vec3d u  = tri_verts[1] - tri_verts[0]; u.normalize();
-    vec3d w  = tri_verts[2] - tri_verts[0]; w.normalize();
-    vec3d n = u.cross(w);
-    n.normalize();
-    norms.push_back(n);
+    // SECOND PASS
+    // write the triangles of each block at its own offset
+    PARALLEL_FOR(0, n_blocks, 1, SCHEDULE_DYNAMIC, 4, [&](const uint b)
+    {
+        uint *offset = &block_count.at(b*n_iso);
+        for(uint pid=b*block_size; pid<std::min((b+1)*block_size, m.num_polys()); ++pid)
+        {
+            marching_tets_visit(m, pid, iso, slot_beg, slot_iso, [&](const uint s, const uint slots[])
+            {
+                uint i = iso_order.at(s);
+                uint t = offset[s]++;
+                vec3d tri_verts[3];
+                for(uint j=0; j<3; ++j)
+                {
+                    uint vid = slot_vid.at(slots[j]);
+                    tris.at(i).at(3*t+j) = vid;
+                    tri_verts[j] = verts.at(i).at(vid);
+                }
+                vec3d u  = tri_verts[1] - tri_verts[0]; u.normalize();
+                vec3d w  = tri_verts[2] - tri_verts[0]; w.normalize();
+                vec3d n = u.cross(w);
+                n.normalize();
+                norms.at(i).at(t) = n;
+            });
+        }
+    });
 }
 
 }
@@ -37,7 +37,6 @@
 #define CINO_MARCHING_TETS_H
 
 #include <vector>
-#include <map>
 #include <sys/types.h>
 #include <cinolib/cino_inline.h>
 #include <cinolib/ipair.h>
@@ -46,6 +45,17 @@
 namespace cinolib
 {
 
+/* Extracts the iso-surface of the scalar field stored in the first component
+ * of the vertex uvw coordinates (i.e. m.vert_data(vid).uvw[0]).
+ *
+ * Tets are visited in parallel, in two passes: the first counts the triangles
+ * generated by each block of tets (and marks the edges that carry a vertex of
+ * the iso-surface), the second writes them at the offsets given by a prefix
+ * sum of the counts. Iso-vertices are indexed by the edges of the tetmesh, hence
+ * vertices shared by adjacent tets are created once, without any hash or map.
+ * Vertices are sorted by edge id, triangles by tet id.
+*/
+
 template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void marching_tets(const Tetmesh<M,V,E,F,P> & m,
@@ -53,6 +63,20 @@ void marching_tets(const Tetmesh<M,V,E,F,P> & m,
                    std::vector<vec3d>       & verts,
                    std::vector<uint>        & tris,
                    std::vector<vec3d>       & norms);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// Extracts the iso-surfaces of many iso-values in a single sweep over the tets. The
+// iso-surface of isovalues[i] is returned in verts[i], tris[i] and norms[i]
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void marching_tets(const Tetmesh<M,V,E,F,P>         & m,
+                   const std::vector<double>        & isovalues,
+                   std::vector<std::vector<vec3d>>  & verts,
+                   std::vector<std::vector<uint>>   & tris,
+                   std::vector<std::vector<vec3d>>  & norms);
+
 }
 
 #ifndef  CINO_STATIC_LIB
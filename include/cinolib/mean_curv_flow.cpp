@@ -57,8 +57,11 @@ void MCF(AbstractPolygonMesh<M,V,E,P> & m,
     time *= time;
     time *= time_scalar;
 
-    Eigen::SparseMatrix<double> L  = laplacian(m, COTANGENT);
-    Eigen::SparseMatrix<double> MM = mass_matrix(m);
+    // the connectivity does not change, hence the sparsity patterns are computed
+    // only once, and the matrices are updated in place at each iteration
+    SparseAssembler L_assembler, M_assembler;
+    const Eigen::SparseMatrix<double> & L  = laplacian(m, COTANGENT, L_assembler);
+    const Eigen::SparseMatrix<double> & MM = mass_matrix(m, M_assembler);
 
     for(uint i=1; i<=n_iters; ++i)
     {
@@ -93,13 +96,14 @@ void MCF(AbstractPolygonMesh<M,V,E,P> & m,
             residual += (m.vert(vid) - new_pos).norm();
             m.vert(vid) = new_pos;
         }
+        m.mark_changed(CHANGES_VERT_POS);
 
         std::cout << "MCF iter: " << i << " residual: " << residual << std::endl;
 
         if (i<n_iters) // update matrices for the next iteration
         {
-            MM = mass_matrix(m);
-            if (!conformalized) L = laplacian(m, COTANGENT);
+            mass_matrix(m, M_assembler);
+            if (!conformalized) laplacian(m, COTANGENT, L_assembler);
         }
     }
 
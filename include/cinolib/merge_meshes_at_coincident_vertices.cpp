@@ -34,7 +34,7 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/merge_meshes_at_coincident_vertices.h>
-#include <cinolib/octree.h>
+#include <cinolib/spatial_hash.h>
 
 namespace cinolib
 {
@@ -46,31 +46,28 @@ void merge_meshes_at_coincident_vertices(const AbstractPolyhedralMesh<M,V,E,F,P>
                                                AbstractPolyhedralMesh<M,V,E,F,P> & res,
                                          const double                              proximity_thresh)
 {
-    Octree o;
-    for(uint vid=0; vid<m1.num_verts(); ++vid) o.push_sphere(vid, m1.vert(vid), proximity_thresh);
-    o.build();
+    SpatialHash grid(proximity_thresh);
+    grid.build(m1.vector_verts());
 
     res = m1;
 
-    std::map<uint,uint> vmap;
+    std::vector<uint> vmap(m2.num_verts());
     for(uint vid=0; vid<m2.num_verts(); ++vid)
     {
-        vec3d p = m2.vert(vid);
-        std::unordered_set<uint> ids;
-        if(o.contains(p, false, ids))
+        vec3d p  = m2.vert(vid);
+        int   id = grid.query_closest(p);
+        if(id>=0)
         {
-            // WARNING: I am assuming that the mapping is one to one at most
-            assert(ids.size()==1);
-            vmap[vid] = *ids.begin();
+            vmap.at(vid) = id;
         }
         else
         {
             uint fresh_id = res.vert_add(p);
-            vmap[vid] = fresh_id;
+            vmap.at(vid) = fresh_id;
         }
     }
 
-    std::map<uint,uint> fmap;
+    std::vector<uint> fmap(m2.num_faces());
     for(uint fid=0; fid<m2.num_faces(); ++fid)
     {
         auto f = m2.face_verts_id(fid);
@@ -79,12 +76,12 @@ void merge_meshes_at_coincident_vertices(const AbstractPolyhedralMesh<M,V,E,F,P>
         int test_id = res.face_id(f);
         if(test_id>=0)
         {
-            fmap[fid] = test_id;
+            fmap.at(fid) = test_id;
         }
         else
         {
             uint fresh_id = res.face_add(f);
-            fmap[fid] = fresh_id;
+            fmap.at(fid) = fresh_id;
         }
     }
 
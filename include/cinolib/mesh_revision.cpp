@@ -0,0 +1,157 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/mesh_revision.h>
+#include <algorithm>
+#include <atomic>
+
+namespace cinolib
+{
+
+CINO_INLINE
+MeshRevision::MeshRevision(const MeshRevision & r)
+{
+    std::lock_guard<std::mutex> lock(r.mtx);
+    stamp = r.stamp;
+    key   = r.key;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+MeshRevision & MeshRevision::operator=(const MeshRevision & r)
+{
+    if(this == &r) return *this;
+    uint64_t s, k;
+    {
+        std::lock_guard<std::mutex> lock(r.mtx);
+        s = r.stamp;
+        k = r.key;
+    }
+    std::lock_guard<std::mutex> lock(mtx);
+    stamp = s;
+    key   = k;
+    return *this;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint64_t MeshRevision::validate(const uint64_t key) const
+{
+    static std::atomic<uint64_t> global_counter(0);
+
+    std::lock_guard<std::mutex> lock(mtx);
+    if(stamp==0 || key!=this->key)
+    {
+        stamp     = ++global_counter;
+        this->key = key;
+    }
+    return stamp;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void MeshRevision::invalidate()
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    stamp = 0;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+MeshChangeLog::MeshChangeLog(const MeshChangeLog & l)
+{
+    // revisions carry on, hence consumers of the original see a global change
+    base = l.base + l.log.size() + 1;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+MeshChangeLog & MeshChangeLog::operator=(const MeshChangeLog & l)
+{
+    // consumers of this log must see a global change, whatever the revision of l
+    base = std::max(base + log.size(), l.base + l.log.size()) + 1;
+    log.clear();
+    return *this;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void MeshChangeLog::mark(const uint id)
+{
+    if(!recording || log.size()>=max_size) mark_all();
+    else log.push_back(id);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void MeshChangeLog::mark(const std::vector<uint> & ids)
+{
+    if(ids.empty()) return;
+    if(!recording || log.size()+ids.size()>max_size) mark_all();
+    else log.insert(log.end(), ids.begin(), ids.end());
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void MeshChangeLog::mark_all()
+{
+    base += log.size() + 1;
+    log.clear();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool MeshChangeLog::changed_since(const uint64_t rev, std::vector<uint> & ids) const
+{
+    recording = true;
+    ids.clear();
+    if(rev<base) return false;
+    if(rev>=revision()) return true;
+    ids.assign(log.begin() + (rev-base), log.end());
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    return true;
+}
+
+}
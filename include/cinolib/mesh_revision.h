@@ -0,0 +1,158 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_MESH_REVISION_H
+#define CINO_MESH_REVISION_H
+
+#include <mutex>
+#include <vector>
+#include <stdint.h>
+#include <sys/types.h>
+#include <cinolib/cino_inline.h>
+
+namespace cinolib
+{
+
+/* Revision stamp of some mesh data (e.g. vertex positions, or connectivity).
+ * Stamps are drawn from a global counter, hence two equal stamps always refer
+ * to the same state of the data, either in the same mesh or in one of its copies.
+ * Data derived from a mesh (e.g. differential operators) can therefore be tagged
+ * with the stamps of the data they were computed from, and checked for validity
+ * with a single comparison.
+ *
+ * Each time the stamp is queried it is validated against a key that changes
+ * whenever the data change (the revisions of the mesh change logs, see below),
+ * and a new stamp is issued if the key differs from the one seen at the previous
+ * query. Validation is O(1). Edits done directly on the mesh data (e.g. through
+ * the non const vert() accessor) must therefore be recorded with mark_changed().
+*/
+class MeshRevision
+{
+    public:
+
+        MeshRevision() {}
+        MeshRevision(const MeshRevision & r);
+        MeshRevision & operator=(const MeshRevision & r);
+
+        // returns the current stamp, issuing a new one if
+        // key differs from the one seen at the previous call
+        uint64_t validate(const uint64_t key) const;
+
+        // forces a new stamp at the next validation
+        void invalidate();
+
+    protected:
+
+        mutable std::mutex mtx;
+        mutable uint64_t   stamp = 0; // 0 means no stamp issued yet
+        mutable uint64_t   key   = 0;
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// Mesh attributes whose changes are logged (see AbstractMesh::changes()).
+// Topological changes (ids of elements added, removed, renumbered or
+// whose incident elements changed) imply that positions and attributes
+// of these elements may have changed as well
+enum
+{
+    CHANGES_VERT_POS,  // vertex positions
+    CHANGES_VERTS,     // vertex connectivity
+    CHANGES_EDGES,     // edge connectivity
+    CHANGES_FACES,     // face connectivity (volume meshes only)
+    CHANGES_POLYS,     // polygon/polyhedra connectivity
+    CHANGES_VERT_DATA, // vertex attributes (color, label, flags, uvw,...)
+    CHANGES_EDGE_DATA, // edge attributes
+    CHANGES_FACE_DATA, // face attributes (volume meshes only)
+    CHANGES_POLY_DATA, // polygon/polyhedra attributes
+    CHANGES_NUM_LOGS
+};
+
+/* Log of the elements changed in some mesh attribute. Each change bumps the revision
+ * of the log by one. Consumers of the data (e.g. normals, tessellations, GPU buffers,
+ * spatial indices) keep the revision they are in sync with, and ask for the elements
+ * changed since then, so that they can update incrementally:
+ *
+ *   std::vector<uint> ids;
+ *   if(log.changed_since(my_rev, ids)) update(ids); else update_all();
+ *   my_rev = log.revision();
+ *
+ * Global changes (e.g. translating the mesh) are recorded with a single mark_all().
+ * Recording is opt-in: until the log is queried for the first time (i.e. until it
+ * has a consumer) each change only bumps the revision, without storing any id.
+ * The log is also bounded: if it grows too much it is reset, and consumers that
+ * are too far behind get a global update. Copies of a log start empty (consumers
+ * are bound to the original log). Logs are NOT thread safe, like all the other
+ * mesh editing operators.
+*/
+class MeshChangeLog
+{
+    public:
+
+        MeshChangeLog() {}
+        MeshChangeLog(const MeshChangeLog & l);
+        MeshChangeLog & operator=(const MeshChangeLog & l);
+
+        uint64_t revision() const { recording = true; return base + log.size(); }
+
+        // same as revision(), but does not turn on the recording of ids. For
+        // consumers that only need to know whether something changed, not what
+        uint64_t peek_revision() const { return base + log.size(); }
+
+        void mark(const uint id);
+        void mark(const std::vector<uint> & ids);
+        void mark_all();
+
+        // writes in ids the list of (unique) elements changed after revision rev and returns true,
+        // or returns false if all elements should be considered changed. Ids may refer to elements
+        // that do not exist anymore (e.g. removed after the change)
+        bool changed_since(const uint64_t rev, std::vector<uint> & ids) const;
+
+    protected:
+
+        uint64_t          base      = 1;     // revision of log[0]. Revisions before it are not covered
+        std::vector<uint> log;
+        mutable bool      recording = false; // ids are stored only after the first query
+
+        static const size_t max_size = 1 << 16;
+};
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "mesh_revision.cpp"
+#endif
+
+#endif // CINO_MESH_REVISION_H
@@ -38,6 +38,8 @@
 #include <cinolib/gl/draw_lines_tris.h>
 #include <cinolib/textures/textures.h>
 #include <cinolib/color.h>
+#include <cinolib/parallel_for.h>
+#include <algorithm>
 
 namespace cinolib
 {
@@ -126,6 +128,18 @@ void AbstractDrawablePolygonMesh<Mesh>::updateGL_marked()
         drawlist_marked.seg_colors.push_back(marked_edge_color.b);
         drawlist_marked.seg_colors.push_back(marked_edge_color.a);
     }
+
+    render_data_changed(drawlist_marked);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void AbstractDrawablePolygonMesh<Mesh>::updateGL_incremental()
+{
+    if(!updateGL_mesh_changes()) updateGL_mesh();
+    updateGL_marked();
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -135,214 +149,305 @@ CINO_INLINE
 void AbstractDrawablePolygonMesh<Mesh>::updateGL_mesh()
 {
     drawlist.material = material_;
-    drawlist.tri_coords.clear();
-    drawlist.tris.clear();
-    drawlist.tri_v_norms.clear();
-    drawlist.tri_v_colors.clear();
-    drawlist.tri_text.clear();
-    drawlist.segs.clear();
-    drawlist.seg_coords.clear();
-    drawlist.seg_colors.clear();
 
     if (this->num_polys() == 0) // for point clouds
     {
-        drawlist.tri_coords.reserve(this->num_verts()*3);
-        drawlist.tri_v_colors.reserve(this->num_verts()*4);
-        for(uint vid=0; vid<this->num_verts(); ++vid)
+        drawlist.tris.clear();
+        drawlist.tri_v_norms.clear();
+        drawlist.tri_text.clear();
+        drawlist.segs.clear();
+        drawlist.seg_coords.clear();
+        drawlist.seg_colors.clear();
+        drawlist.tri_coords.resize(this->num_verts()*3);
+        drawlist.tri_v_colors.resize(this->num_verts()*4);
+        PARALLEL_FOR(0, this->num_verts(), 1000, [&](const uint vid)
         {
-            drawlist.tri_coords.push_back(this->vert(vid).x());
-            drawlist.tri_coords.push_back(this->vert(vid).y());
-            drawlist.tri_coords.push_back(this->vert(vid).z());
-
-            drawlist.tri_v_colors.push_back(this->vert_data(vid).color.r);
-            drawlist.tri_v_colors.push_back(this->vert_data(vid).color.g);
-            drawlist.tri_v_colors.push_back(this->vert_data(vid).color.b);
-            drawlist.tri_v_colors.push_back(this->vert_data(vid).color.a);
-        }
+            drawlist.tri_coords[3*vid  ] = this->vert(vid).x();
+            drawlist.tri_coords[3*vid+1] = this->vert(vid).y();
+            drawlist.tri_coords[3*vid+2] = this->vert(vid).z();
+
+            drawlist.tri_v_colors[4*vid  ] = this->vert_data(vid).color.r;
+            drawlist.tri_v_colors[4*vid+1] = this->vert_data(vid).color.g;
+            drawlist.tri_v_colors[4*vid+2] = this->vert_data(vid).color.b;
+            drawlist.tri_v_colors[4*vid+3] = this->vert_data(vid).color.a;
+        });
+        layout.tri_offset.clear();
+        layout.seg_offset.clear();
+        render_data_changed(drawlist);
     }
     else
     {
+        // assign to each visible poly (edge) a contiguous range of triangles (a segment),
+        // so that buffers can be allocated once with their exact size, and filled in parallel
+        uint n_tris = 0;
+        layout.tri_offset.resize(this->num_polys());
         for(uint pid=0; pid<this->num_polys(); ++pid)
         {
-            if (this->poly_data(pid).flags[HIDDEN]) continue;
-
-            vec3d n = this->poly_data(pid).normal;
-
-            for(uint i=0; i<this->poly_tessellation(pid).size()/3; ++i)
+            if (this->poly_data(pid).flags[HIDDEN])
             {
-                uint vid0 = this->poly_tessellation(pid).at(3*i+0);
-                uint vid1 = this->poly_tessellation(pid).at(3*i+1);
-                uint vid2 = this->poly_tessellation(pid).at(3*i+2);
-
-                // average AO with adjacent visible faces having dihedral angle lower than 60 degrees
-                auto  vid0_vis_pids = this->vert_adj_visible_polys(vid0, n, 60.0);
-                auto  vid1_vis_pids = this->vert_adj_visible_polys(vid1, n, 60.0);
-                auto  vid2_vis_pids = this->vert_adj_visible_polys(vid2, n, 60.0);
-                float AO_vid0 = 0.0;
-                float AO_vid1 = 0.0;
-                float AO_vid2 = 0.0;
-                for(uint pid : vid0_vis_pids) AO_vid0 += this->poly_data(pid).AO*AO_alpha + (1.0 - AO_alpha);
-                for(uint pid : vid1_vis_pids) AO_vid1 += this->poly_data(pid).AO*AO_alpha + (1.0 - AO_alpha);
-                for(uint pid : vid2_vis_pids) AO_vid2 += this->poly_data(pid).AO*AO_alpha + (1.0 - AO_alpha);
-                AO_vid0 /= static_cast<float>(vid0_vis_pids.size());
-                AO_vid1 /= static_cast<float>(vid1_vis_pids.size());
-                AO_vid2 /= static_cast<float>(vid2_vis_pids.size());
-
-                uint base_addr = drawlist.tri_coords.size()/3;
-
-                drawlist.tris.push_back(base_addr    );
-                drawlist.tris.push_back(base_addr + 1);
-                drawlist.tris.push_back(base_addr + 2);
-
-                drawlist.tri_coords.push_back(this->vert(vid0).x());
-                drawlist.tri_coords.push_back(this->vert(vid0).y());
-                drawlist.tri_coords.push_back(this->vert(vid0).z());
-                drawlist.tri_coords.push_back(this->vert(vid1).x());
-                drawlist.tri_coords.push_back(this->vert(vid1).y());
-                drawlist.tri_coords.push_back(this->vert(vid1).z());
-                drawlist.tri_coords.push_back(this->vert(vid2).x());
-                drawlist.tri_coords.push_back(this->vert(vid2).y());
-                drawlist.tri_coords.push_back(this->vert(vid2).z());
-
-                if (drawlist.draw_mode & DRAW_TRI_SMOOTH)
-                {
-                    // average normals with adjacent visible faces having dihedral angle lower than 60 degrees
-                    vec3d n_vid0(0,0,0);
-                    vec3d n_vid1(0,0,0);
-                    vec3d n_vid2(0,0,0);
-                    for(uint pid : vid0_vis_pids) n_vid0 += this->poly_data(pid).normal;
-                    for(uint pid : vid1_vis_pids) n_vid1 += this->poly_data(pid).normal;
-                    for(uint pid : vid2_vis_pids) n_vid2 += this->poly_data(pid).normal;
-                    n_vid0 /= static_cast<double>(vid0_vis_pids.size());
-                    n_vid1 /= static_cast<double>(vid1_vis_pids.size());
-                    n_vid2 /= static_cast<double>(vid2_vis_pids.size());
-
-                    drawlist.tri_v_norms.push_back(n_vid0.x());
-                    drawlist.tri_v_norms.push_back(n_vid0.y());
-                    drawlist.tri_v_norms.push_back(n_vid0.z());
-                    drawlist.tri_v_norms.push_back(n_vid1.x());
-                    drawlist.tri_v_norms.push_back(n_vid1.y());
-                    drawlist.tri_v_norms.push_back(n_vid1.z());
-                    drawlist.tri_v_norms.push_back(n_vid2.x());
-                    drawlist.tri_v_norms.push_back(n_vid2.y());
-                    drawlist.tri_v_norms.push_back(n_vid2.z());
-                }
-                else if (drawlist.draw_mode & DRAW_TRI_FLAT)
-                {
-                    drawlist.tri_v_norms.push_back(n.x());
-                    drawlist.tri_v_norms.push_back(n.y());
-                    drawlist.tri_v_norms.push_back(n.z());
-                    drawlist.tri_v_norms.push_back(n.x());
-                    drawlist.tri_v_norms.push_back(n.y());
-                    drawlist.tri_v_norms.push_back(n.z());
-                    drawlist.tri_v_norms.push_back(n.x());
-                    drawlist.tri_v_norms.push_back(n.y());
-                    drawlist.tri_v_norms.push_back(n.z());
-                }
-
-                if (drawlist.draw_mode & DRAW_TRI_TEXTURE1D)
-                {
-                    drawlist.tri_text.push_back(this->vert_data(vid0).uvw[0]);
-                    drawlist.tri_text.push_back(this->vert_data(vid1).uvw[0]);
-                    drawlist.tri_text.push_back(this->vert_data(vid2).uvw[0]);
-                }
-                else if (drawlist.draw_mode & DRAW_TRI_TEXTURE2D)
-                {
-                    drawlist.tri_text.push_back(this->vert_data(vid0).uvw[0]*drawlist.texture.scaling_factor);
-                    drawlist.tri_text.push_back(this->vert_data(vid0).uvw[1]*drawlist.texture.scaling_factor);
-                    drawlist.tri_text.push_back(this->vert_data(vid1).uvw[0]*drawlist.texture.scaling_factor);
-                    drawlist.tri_text.push_back(this->vert_data(vid1).uvw[1]*drawlist.texture.scaling_factor);
-                    drawlist.tri_text.push_back(this->vert_data(vid2).uvw[0]*drawlist.texture.scaling_factor);
-                    drawlist.tri_text.push_back(this->vert_data(vid2).uvw[1]*drawlist.texture.scaling_factor);
-                }
-
-                if (drawlist.draw_mode & DRAW_TRI_FACECOLOR) // replicate f color on each vertex
-                {
-                    drawlist.tri_v_colors.push_back(this->poly_data(pid).color.r*AO_vid0);
-                    drawlist.tri_v_colors.push_back(this->poly_data(pid).color.g*AO_vid0);
-                    drawlist.tri_v_colors.push_back(this->poly_data(pid).color.b*AO_vid0);
-                    drawlist.tri_v_colors.push_back(this->poly_data(pid).color.a);
-                    drawlist.tri_v_colors.push_back(this->poly_data(pid).color.r*AO_vid1);
-                    drawlist.tri_v_colors.push_back(this->poly_data(pid).color.g*AO_vid1);
-                    drawlist.tri_v_colors.push_back(this->poly_data(pid).color.b*AO_vid1);
-                    drawlist.tri_v_colors.push_back(this->poly_data(pid).color.a);
-                    drawlist.tri_v_colors.push_back(this->poly_data(pid).color.r*AO_vid2);
-                    drawlist.tri_v_colors.push_back(this->poly_data(pid).color.g*AO_vid2);
-                    drawlist.tri_v_colors.push_back(this->poly_data(pid).color.b*AO_vid2);
-                    drawlist.tri_v_colors.push_back(this->poly_data(pid).color.a);
-                }
-                else if (drawlist.draw_mode & DRAW_TRI_VERTCOLOR)
-                {
-                    drawlist.tri_v_colors.push_back(this->vert_data(vid0).color.r*AO_vid0);
-                    drawlist.tri_v_colors.push_back(this->vert_data(vid0).color.g*AO_vid0);
-                    drawlist.tri_v_colors.push_back(this->vert_data(vid0).color.b*AO_vid0);
-                    drawlist.tri_v_colors.push_back(this->vert_data(vid0).color.a);
-                    drawlist.tri_v_colors.push_back(this->vert_data(vid1).color.r*AO_vid1);
-                    drawlist.tri_v_colors.push_back(this->vert_data(vid1).color.g*AO_vid1);
-                    drawlist.tri_v_colors.push_back(this->vert_data(vid1).color.b*AO_vid1);
-                    drawlist.tri_v_colors.push_back(this->vert_data(vid1).color.a);
-                    drawlist.tri_v_colors.push_back(this->vert_data(vid2).color.r*AO_vid2);
-                    drawlist.tri_v_colors.push_back(this->vert_data(vid2).color.g*AO_vid2);
-                    drawlist.tri_v_colors.push_back(this->vert_data(vid2).color.b*AO_vid2);
-                    drawlist.tri_v_colors.push_back(this->vert_data(vid2).color.a);
-                }
-                else if (drawlist.draw_mode & DRAW_TRI_QUALITY)
-                {
-                    float q = this->poly_data(pid).quality;
-                    Color c = Color::red_white_blue_ramp_01(q);
-                    drawlist.tri_v_colors.push_back(c.r*AO_vid0);
-                    drawlist.tri_v_colors.push_back(c.g*AO_vid0);
-                    drawlist.tri_v_colors.push_back(c.b*AO_vid0);
-                    drawlist.tri_v_colors.push_back(c.a);
-                    drawlist.tri_v_colors.push_back(c.r*AO_vid1);
-                    drawlist.tri_v_colors.push_back(c.g*AO_vid1);
-                    drawlist.tri_v_colors.push_back(c.b*AO_vid1);
-                    drawlist.tri_v_colors.push_back(c.a);
-                    drawlist.tri_v_colors.push_back(c.r*AO_vid2);
-                    drawlist.tri_v_colors.push_back(c.g*AO_vid2);
-                    drawlist.tri_v_colors.push_back(c.b*AO_vid2);
-                    drawlist.tri_v_colors.push_back(c.a);
-                }
+                layout.tri_offset[pid] = -1;
+                continue;
             }
+            layout.tri_offset[pid] = n_tris;
+            n_tris += this->poly_tessellation(pid).size()/3;
         }
 
+        uint n_segs = 0;
+        layout.seg_offset.resize(this->num_edges());
         for(uint eid=0; eid<this->num_edges(); ++eid)
         {
-            bool hidden = true;
-            for(uint pid : this->adj_e2p(eid))
+            layout.seg_offset[eid] = edge_is_rendered(eid) ? n_segs++ : -1;
+        }
+
+        render_data_resize(drawlist, n_tris, n_segs);
+        layout.clear_free_slots();
+
+        PARALLEL_FOR(0, this->num_polys(), 1000, [&](const uint pid)
+        {
+            if(layout.tri_offset[pid]>=0) updateGL_poly(pid);
+        });
+        PARALLEL_FOR(0, this->num_edges(), 1000, [&](const uint eid)
+        {
+            if(layout.seg_offset[eid]>=0) updateGL_edge(eid);
+        });
+    }
+
+    updateGL_layout_sync();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+bool AbstractDrawablePolygonMesh<Mesh>::updateGL_mesh_changes()
+{
+    if(this->num_polys()==0                                     ||
+       layout.revisions.size()  != CHANGES_NUM_LOGS             ||
+       layout.tri_offset.size() != this->num_polys()            ||
+       layout.seg_offset.size() != this->num_edges()            ||
+       layout.draw_mode         != drawlist.draw_mode           ||
+       layout.AO_alpha          != AO_alpha                     ||
+       layout.tex_scale         != drawlist.texture.scaling_factor) return false;
+
+    std::vector<uint> ids[CHANGES_NUM_LOGS];
+    for(int i=0; i<CHANGES_NUM_LOGS; ++i)
+    {
+        if(!this->changes(i).changed_since(layout.revisions.at(i), ids[i])) return false;
+    }
+    if(!ids[CHANGES_VERTS].empty() || !ids[CHANGES_EDGES].empty() || !ids[CHANGES_POLYS].empty()) return false;
+
+    // dirty elements are listed as they are found, so that the cost of the
+    // update depends on the amount of changes, not on the size of the mesh
+    std::vector<bool> dirty_p(this->num_polys(), false);
+    std::vector<bool> dirty_e(this->num_edges(), false);
+    std::vector<uint> polys, edges;
+    auto mark_p = [&](const uint pid) { if(!dirty_p[pid]) { dirty_p[pid] = true; polys.push_back(pid); } };
+    auto mark_e = [&](const uint eid) { if(!dirty_e[eid]) { dirty_e[eid] = true; edges.push_back(eid); } };
+
+    // polys changing visibility (e.g. slicing) take (release) slots in the buffers, and so
+    // do their edges. The normals averaged at their verts are updated with the attributes
+    std::vector<bool> checked_e(this->num_edges(), false);
+    for(uint pid : ids[CHANGES_POLY_DATA])
+    {
+        if(pid>=this->num_polys()) continue;
+        bool rendered = !this->poly_data(pid).flags[HIDDEN];
+        if(rendered == (layout.tri_offset[pid]>=0)) continue;
+        if(drawlist.draw_mode & DRAW_TRI_POINTS) return false;
+        uint n_tris = this->poly_tessellation(pid).size()/3;
+        if(rendered) layout.tri_offset[pid] = render_data_alloc_tris(drawlist, layout, n_tris);
+        else
+        {
+            render_data_free_tris(drawlist, layout, layout.tri_offset[pid], n_tris);
+            layout.tri_offset[pid] = -1;
+        }
+        for(uint eid : this->adj_p2e(pid))
+        {
+            if(checked_e[eid]) continue;
+            checked_e[eid] = true;
+            bool e_rendered = edge_is_rendered(eid);
+            if(e_rendered == (layout.seg_offset[eid]>=0)) continue;
+            if(e_rendered)
+            {
+                layout.seg_offset[eid] = render_data_alloc_seg(drawlist, layout);
+                mark_e(eid);
+            }
+            else
             {
-                if(!this->poly_data(pid).flags[HIDDEN])
-                {
-                    hidden = false;
-                    break;
-                }
+                render_data_free_seg(drawlist, layout, layout.seg_offset[eid]);
+                layout.seg_offset[eid] = -1;
             }
-            if(hidden) continue;
-
-            int base_addr = drawlist.seg_coords.size()/3;
-            drawlist.segs.push_back(base_addr    );
-            drawlist.segs.push_back(base_addr + 1);
-
-            vec3d vid0 = this->edge_vert(eid,0);
-            vec3d vid1 = this->edge_vert(eid,1);
-
-            drawlist.seg_coords.push_back(vid0.x());
-            drawlist.seg_coords.push_back(vid0.y());
-            drawlist.seg_coords.push_back(vid0.z());
-            drawlist.seg_coords.push_back(vid1.x());
-            drawlist.seg_coords.push_back(vid1.y());
-            drawlist.seg_coords.push_back(vid1.z());
-
-            drawlist.seg_colors.push_back(this->edge_data(eid).color.r);
-            drawlist.seg_colors.push_back(this->edge_data(eid).color.g);
-            drawlist.seg_colors.push_back(this->edge_data(eid).color.b);
-            drawlist.seg_colors.push_back(this->edge_data(eid).color.a);
-            drawlist.seg_colors.push_back(this->edge_data(eid).color.r);
-            drawlist.seg_colors.push_back(this->edge_data(eid).color.g);
-            drawlist.seg_colors.push_back(this->edge_data(eid).color.b);
-            drawlist.seg_colors.push_back(this->edge_data(eid).color.a);
         }
     }
+    // too many free slots: rather compact the buffers
+    if(layout.n_free_tris     > drawlist.tris.size()/6 + 1024 ||
+       layout.free_segs.size() > drawlist.segs.size()/4 + 1024) return false;
+
+    // moved verts change the position of their polys and edges, and the normals of
+    // their polys, which are averaged at the verts of these polys (smooth shading)
+    for(uint vid : ids[CHANGES_VERT_POS])
+    {
+        if(vid>=this->num_verts()) continue;
+        for(uint eid : this->adj_v2e(vid)) mark_e(eid);
+        for(uint pid : this->adj_v2p(vid))
+        for(uint nbr : this->adj_p2v(pid))
+        for(uint p   : this->adj_v2p(nbr)) mark_p(p);
+    }
+    // vert attributes (color, uvw) are copied at the corners of their polys
+    for(uint vid : ids[CHANGES_VERT_DATA])
+    {
+        if(vid>=this->num_verts()) continue;
+        for(uint pid : this->adj_v2p(vid)) mark_p(pid);
+    }
+    // poly attributes (color, quality, AO) change the poly, and the AO averaged at its verts
+    for(uint pid : ids[CHANGES_POLY_DATA])
+    {
+        if(pid>=this->num_polys()) continue;
+        for(uint vid : this->adj_p2v(pid))
+        for(uint p   : this->adj_v2p(vid)) mark_p(p);
+    }
+    for(uint eid : ids[CHANGES_EDGE_DATA])
+    {
+        if(eid<this->num_edges()) mark_e(eid);
+    }
+
+    // not rendered elements have nothing to update
+    polys.erase(std::remove_if(polys.begin(), polys.end(), [&](const uint pid) { return layout.tri_offset[pid]<0; }), polys.end());
+    edges.erase(std::remove_if(edges.begin(), edges.end(), [&](const uint eid) { return layout.seg_offset[eid]<0; }), edges.end());
+
+    drawlist.material = material_;
+    PARALLEL_FOR(0, polys.size(), 1000, [&](const uint i) { updateGL_poly(polys[i]); });
+    PARALLEL_FOR(0, edges.size(), 1000, [&](const uint i) { updateGL_edge(edges[i]); });
+    for(uint pid : polys) render_data_changed_tris(drawlist, layout.tri_offset[pid], this->poly_tessellation(pid).size()/3);
+    for(uint eid : edges) render_data_changed_segs(drawlist, layout.seg_offset[eid], 1);
+
+    updateGL_layout_sync();
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void AbstractDrawablePolygonMesh<Mesh>::updateGL_layout_sync()
+{
+    layout.revisions.resize(CHANGES_NUM_LOGS);
+    for(int i=0; i<CHANGES_NUM_LOGS; ++i) layout.revisions[i] = this->changes(i).revision();
+    layout.draw_mode = drawlist.draw_mode;
+    layout.AO_alpha  = AO_alpha;
+    layout.tex_scale = drawlist.texture.scaling_factor;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+bool AbstractDrawablePolygonMesh<Mesh>::edge_is_rendered(const uint eid) const
+{
+    for(uint pid : this->adj_e2p(eid))
+    {
+        if(!this->poly_data(pid).flags[HIDDEN]) return true;
+    }
+    return false;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void AbstractDrawablePolygonMesh<Mesh>::updateGL_poly(const uint pid)
+{
+    const std::vector<uint> & tris = this->poly_tessellation(pid);
+    const vec3d & n = this->poly_data(pid).normal;
+    const Color & c = this->poly_data(pid).color;
+    Color q;
+    if (drawlist.draw_mode & DRAW_TRI_QUALITY) q = Color::red_white_blue_ramp_01(this->poly_data(pid).quality);
+
+    uint off = 3*layout.tri_offset[pid];
+    for(uint i=0; i<tris.size(); ++i)
+    {
+        uint vid = tris[i];
+        uint j   = off + i;
+
+        // average AO and normals with adjacent visible polys having dihedral angle lower than 60 degrees
+        float AO = 0.0;
+        vec3d vn(0,0,0);
+        uint  count = 0;
+        for(uint nbr : this->adj_v2p(vid))
+        {
+            if(this->poly_data(nbr).flags[HIDDEN] || n.angle_deg(this->poly_data(nbr).normal) >= 60.0) continue;
+            AO += this->poly_data(nbr).AO*AO_alpha + (1.0 - AO_alpha);
+            vn += this->poly_data(nbr).normal;
+            ++count;
+        }
+        AO /= static_cast<float>(count);
+        vn /= static_cast<double>(count);
+
+        drawlist.tri_coords[3*j  ] = this->vert(vid).x();
+        drawlist.tri_coords[3*j+1] = this->vert(vid).y();
+        drawlist.tri_coords[3*j+2] = this->vert(vid).z();
+
+        if (drawlist.draw_mode & DRAW_TRI_SMOOTH)
+        {
+            drawlist.tri_v_norms[3*j  ] = vn.x();
+            drawlist.tri_v_norms[3*j+1] = vn.y();
+            drawlist.tri_v_norms[3*j+2] = vn.z();
+        }
+        else if (drawlist.draw_mode & DRAW_TRI_FLAT)
+        {
+            drawlist.tri_v_norms[3*j  ] = n.x();
+            drawlist.tri_v_norms[3*j+1] = n.y();
+            drawlist.tri_v_norms[3*j+2] = n.z();
+        }
+
+        if (drawlist.draw_mode & DRAW_TRI_TEXTURE1D)
+        {
+            drawlist.tri_text[j] = this->vert_data(vid).uvw[0];
+        }
+        else if (drawlist.draw_mode & DRAW_TRI_TEXTURE2D)
+        {
+            drawlist.tri_text[2*j  ] = this->vert_data(vid).uvw[0]*drawlist.texture.scaling_factor;
+            drawlist.tri_text[2*j+1] = this->vert_data(vid).uvw[1]*drawlist.texture.scaling_factor;
+        }
+
+        const Color * col = NULL;
+        if      (drawlist.draw_mode & DRAW_TRI_FACECOLOR)  col = &c; // replicate f color on each vertex
+        else if (drawlist.draw_mode & DRAW_TRI_VERTCOLOR)  col = &this->vert_data(vid).color;
+        else if (drawlist.draw_mode & DRAW_TRI_QUALITY)    col = &q;
+        if (col != NULL)
+        {
+            drawlist.tri_v_colors[4*j  ] = col->r*AO;
+            drawlist.tri_v_colors[4*j+1] = col->g*AO;
+            drawlist.tri_v_colors[4*j+2] = col->b*AO;
+            drawlist.tri_v_colors[4*j+3] = col->a;
+        }
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void AbstractDrawablePolygonMesh<Mesh>::updateGL_edge(const uint eid)
+{
+    uint  j   = 2*layout.seg_offset[eid];
+    vec3d v0  = this->edge_vert(eid,0);
+    vec3d v1  = this->edge_vert(eid,1);
+    const Color & c = this->edge_data(eid).color;
+
+    drawlist.seg_coords[3*j  ] = v0.x();
+    drawlist.seg_coords[3*j+1] = v0.y();
+    drawlist.seg_coords[3*j+2] = v0.z();
+    drawlist.seg_coords[3*j+3] = v1.x();
+    drawlist.seg_coords[3*j+4] = v1.y();
+    drawlist.seg_coords[3*j+5] = v1.z();
+
+    for(uint i=0; i<2; ++i)
+    {
+        drawlist.seg_colors[4*(j+i)  ] = c.r;
+        drawlist.seg_colors[4*(j+i)+1] = c.g;
+        drawlist.seg_colors[4*(j+i)+2] = c.b;
+        drawlist.seg_colors[4*(j+i)+3] = c.a;
+    }
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -351,8 +456,10 @@ template<class Mesh>
 CINO_INLINE
 void AbstractDrawablePolygonMesh<Mesh>::slice(const SlicerState & s)
 {
-    slicer.update(*this, s); // update per element visibility flags
-    updateGL();
+    // update per element visibility flags (and log the changed ones). If the slicer
+    // had to rebuild its cache the mesh changed, and is uploaded from scratch
+    if(slicer.update(*this, s)) updateGL_incremental();
+    else                        updateGL();
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
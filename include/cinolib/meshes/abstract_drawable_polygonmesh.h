@@ -56,6 +56,7 @@ class AbstractDrawablePolygonMesh : public virtual Mesh, public DrawableObject
         RenderData       drawlist_marked; // rendering info about marked edges (can be extended to handle marked verts/faces too)
         Color            marked_edge_color;
         float            AO_alpha = 1.0;
+        RenderDataLayout layout; // where polys and edges are stored in drawlist (see updateGL_incremental())
 
     public:
 
@@ -83,9 +84,25 @@ class AbstractDrawablePolygonMesh : public virtual Mesh, public DrawableObject
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-        void updateGL();        // regenerates rendering data for both mesh and marked elements
-        void updateGL_mesh();   // regenerates rendering data for mesh elements
-        void updateGL_marked(); // regenerates rendering data for marked mesh elements
+        void updateGL();             // regenerates rendering data for both mesh and marked elements
+        void updateGL_mesh();        // regenerates rendering data for mesh elements
+        void updateGL_marked();      // regenerates rendering data for marked mesh elements
+        void updateGL_incremental(); // as updateGL(), but mesh elements are updated only if changed since the last update
+
+    protected:
+
+        // Incremental updates rely on the mesh change logs (see AbstractMesh::changes()), hence
+        // they miss changes done by writing directly into the mesh, unless recorded by the caller.
+        // Changes in connectivity or render settings require a full update. Polys changing
+        // visibility (e.g. slicing) reuse the slots of the buffers freed by hidden polys
+        //
+        bool updateGL_mesh_changes(); // returns false if a full update is needed
+        bool edge_is_rendered(const uint eid) const;
+        void updateGL_poly(const uint pid);
+        void updateGL_edge(const uint eid);
+        void updateGL_layout_sync();
+
+    public:
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
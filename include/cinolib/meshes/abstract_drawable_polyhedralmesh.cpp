@@ -38,7 +38,8 @@
 #include <cinolib/gl/draw_lines_tris.h>
 #include <cinolib/textures/textures.h>
 #include <cinolib/color.h>
-#include <unordered_set>
+#include <cinolib/parallel_for.h>
+#include <algorithm>
 
 namespace cinolib
 {
@@ -174,6 +175,8 @@ void AbstractDrawablePolyhedralMesh<Mesh>::updateGL_marked()
         drawlist_marked.seg_colors.push_back(marked_edge_color.b);
         drawlist_marked.seg_colors.push_back(marked_edge_color.a);
     }
+
+    render_data_changed(drawlist_marked);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -182,439 +185,351 @@ template<class Mesh>
 CINO_INLINE
 void AbstractDrawablePolyhedralMesh<Mesh>::updateGL_out()
 {
-    drawlist_out.material = material_;
-    drawlist_out.tris.clear();
-    drawlist_out.tri_coords.clear();
-    drawlist_out.tri_v_norms.clear();
-    drawlist_out.tri_v_colors.clear();
-    drawlist_out.tri_text.clear();
-    drawlist_out.segs.clear();
-    drawlist_out.seg_coords.clear();
-    drawlist_out.seg_colors.clear();
+    updateGL_faces(drawlist_out, layout_out, true);
+}
 
-    for(uint fid=0; fid<this->num_faces(); ++fid)
-    {
-        if (!this->face_is_on_srf(fid)) continue;
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-        uint pid_beneath;
-        if(!this->face_is_visible(fid,pid_beneath)) continue;
+template<class Mesh>
+CINO_INLINE
+void AbstractDrawablePolyhedralMesh<Mesh>::updateGL_in()
+{
+    updateGL_faces(drawlist_in, layout_in, false);
+}
 
-        vec3d n = this->poly_face_normal(pid_beneath, fid);
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-        for(uint i=0; i<this->face_tessellation(fid).size()/3; ++i)
+template<class Mesh>
+CINO_INLINE
+void AbstractDrawablePolyhedralMesh<Mesh>::updateGL_incremental()
+{
+    updateGL_marked();
+    if(!updateGL_faces_changes(drawlist_in,  layout_in,  false)) updateGL_in();
+    if(!updateGL_faces_changes(drawlist_out, layout_out, true )) updateGL_out();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+bool AbstractDrawablePolyhedralMesh<Mesh>::face_is_rendered(const uint fid, const bool srf, uint & pid_beneath) const
+{
+    return this->face_is_on_srf(fid)==srf && this->face_is_visible(fid, pid_beneath);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+bool AbstractDrawablePolyhedralMesh<Mesh>::edge_is_rendered(const uint eid, const bool srf) const
+{
+    if(this->edge_is_on_srf(eid)!=srf) return false;
+    if(srf)
+    {
+        for(uint pid : this->adj_e2p(eid))
         {
-            uint vid0 = this->face_tessellation(fid).at(3*i+0);
-            uint vid1 = this->face_tessellation(fid).at(3*i+1);
-            uint vid2 = this->face_tessellation(fid).at(3*i+2);
+            if(!this->poly_data(pid).flags[HIDDEN]) return true;
+        }
+        return false;
+    }
+    // inner edges are rendered if they bound some visible inner face
+    uint pid;
+    for(uint fid : this->adj_e2f(eid))
+    {
+        if(this->face_is_visible(fid, pid)) return true;
+    }
+    return false;
+}
 
-            // average AO with adjacent visible faces having dihedral angle lower than 60 degrees
-            auto  vid0_vis_fids = this->vert_adj_visible_faces(vid0, n, 60.0);
-            auto  vid1_vis_fids = this->vert_adj_visible_faces(vid1, n, 60.0);
-            auto  vid2_vis_fids = this->vert_adj_visible_faces(vid2, n, 60.0);
-            float AO_vid0 = 0.0;
-            float AO_vid1 = 0.0;
-            float AO_vid2 = 0.0;
-            for(auto fp : vid0_vis_fids) AO_vid0 += this->face_data(fp.first).AO*AO_alpha + (1.0 - AO_alpha);
-            for(auto fp : vid1_vis_fids) AO_vid1 += this->face_data(fp.first).AO*AO_alpha + (1.0 - AO_alpha);
-            for(auto fp : vid2_vis_fids) AO_vid2 += this->face_data(fp.first).AO*AO_alpha + (1.0 - AO_alpha);
-            AO_vid0 /= static_cast<float>(vid0_vis_fids.size());
-            AO_vid1 /= static_cast<float>(vid1_vis_fids.size());
-            AO_vid2 /= static_cast<float>(vid2_vis_fids.size());
-
-            int base_addr = drawlist_out.tri_coords.size()/3;
-
-            drawlist_out.tris.push_back(base_addr    );
-            drawlist_out.tris.push_back(base_addr + 1);
-            drawlist_out.tris.push_back(base_addr + 2);
-
-            drawlist_out.tri_coords.push_back(this->vert(vid0).x());
-            drawlist_out.tri_coords.push_back(this->vert(vid0).y());
-            drawlist_out.tri_coords.push_back(this->vert(vid0).z());
-            drawlist_out.tri_coords.push_back(this->vert(vid1).x());
-            drawlist_out.tri_coords.push_back(this->vert(vid1).y());
-            drawlist_out.tri_coords.push_back(this->vert(vid1).z());
-            drawlist_out.tri_coords.push_back(this->vert(vid2).x());
-            drawlist_out.tri_coords.push_back(this->vert(vid2).y());
-            drawlist_out.tri_coords.push_back(this->vert(vid2).z());
-
-            if (drawlist_out.draw_mode & DRAW_TRI_SMOOTH)
-            {
-                // average normals with adjacent visible faces having dihedral angle lower than 60 degrees
-                vec3d n_vid0(0,0,0);
-                vec3d n_vid1(0,0,0);
-                vec3d n_vid2(0,0,0);
-                for(auto fp : vid0_vis_fids) n_vid0 += this->poly_face_normal(fp.second, fp.first);
-                for(auto fp : vid1_vis_fids) n_vid1 += this->poly_face_normal(fp.second, fp.first);
-                for(auto fp : vid2_vis_fids) n_vid2 += this->poly_face_normal(fp.second, fp.first);
-                n_vid0 /= static_cast<double>(vid0_vis_fids.size());
-                n_vid1 /= static_cast<double>(vid1_vis_fids.size());
-                n_vid2 /= static_cast<double>(vid2_vis_fids.size());
-
-                drawlist_out.tri_v_norms.push_back(n_vid0.x());
-                drawlist_out.tri_v_norms.push_back(n_vid0.y());
-                drawlist_out.tri_v_norms.push_back(n_vid0.z());
-                drawlist_out.tri_v_norms.push_back(n_vid1.x());
-                drawlist_out.tri_v_norms.push_back(n_vid1.y());
-                drawlist_out.tri_v_norms.push_back(n_vid1.z());
-                drawlist_out.tri_v_norms.push_back(n_vid2.x());
-                drawlist_out.tri_v_norms.push_back(n_vid2.y());
-                drawlist_out.tri_v_norms.push_back(n_vid2.z());
-            }
-            else if (drawlist_out.draw_mode & DRAW_TRI_FLAT)
-            {
-                drawlist_out.tri_v_norms.push_back(n.x());
-                drawlist_out.tri_v_norms.push_back(n.y());
-                drawlist_out.tri_v_norms.push_back(n.z());
-                drawlist_out.tri_v_norms.push_back(n.x());
-                drawlist_out.tri_v_norms.push_back(n.y());
-                drawlist_out.tri_v_norms.push_back(n.z());
-                drawlist_out.tri_v_norms.push_back(n.x());
-                drawlist_out.tri_v_norms.push_back(n.y());
-                drawlist_out.tri_v_norms.push_back(n.z());
-            }
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-            if (drawlist_out.draw_mode & DRAW_TRI_TEXTURE1D)
-            {
-                drawlist_out.tri_text.push_back(this->vert_data(vid0).uvw[0]);
-                drawlist_out.tri_text.push_back(this->vert_data(vid1).uvw[0]);
-                drawlist_out.tri_text.push_back(this->vert_data(vid2).uvw[0]);
-            }
-            else if (drawlist_out.draw_mode & DRAW_TRI_TEXTURE2D)
-            {
-                drawlist_out.tri_text.push_back(this->vert_data(vid0).uvw[0]*drawlist_out.texture.scaling_factor);
-                drawlist_out.tri_text.push_back(this->vert_data(vid0).uvw[1]*drawlist_out.texture.scaling_factor);
-                drawlist_out.tri_text.push_back(this->vert_data(vid1).uvw[0]*drawlist_out.texture.scaling_factor);
-                drawlist_out.tri_text.push_back(this->vert_data(vid1).uvw[1]*drawlist_out.texture.scaling_factor);
-                drawlist_out.tri_text.push_back(this->vert_data(vid2).uvw[0]*drawlist_out.texture.scaling_factor);
-                drawlist_out.tri_text.push_back(this->vert_data(vid2).uvw[1]*drawlist_out.texture.scaling_factor);
-            }
+template<class Mesh>
+CINO_INLINE
+void AbstractDrawablePolyhedralMesh<Mesh>::updateGL_faces(RenderData & drawlist, RenderDataLayout & layout, const bool srf)
+{
+    drawlist.material = material_;
 
-            if (drawlist_out.draw_mode & DRAW_TRI_FACECOLOR) // replicate f color on each vertex
-            {
-                drawlist_out.tri_v_colors.push_back(this->poly_data(pid_beneath).color.r*AO_vid0);
-                drawlist_out.tri_v_colors.push_back(this->poly_data(pid_beneath).color.g*AO_vid0);
-                drawlist_out.tri_v_colors.push_back(this->poly_data(pid_beneath).color.b*AO_vid0);
-                drawlist_out.tri_v_colors.push_back(this->poly_data(pid_beneath).color.a);
-                drawlist_out.tri_v_colors.push_back(this->poly_data(pid_beneath).color.r*AO_vid1);
-                drawlist_out.tri_v_colors.push_back(this->poly_data(pid_beneath).color.g*AO_vid1);
-                drawlist_out.tri_v_colors.push_back(this->poly_data(pid_beneath).color.b*AO_vid1);
-                drawlist_out.tri_v_colors.push_back(this->poly_data(pid_beneath).color.a);
-                drawlist_out.tri_v_colors.push_back(this->poly_data(pid_beneath).color.r*AO_vid2);
-                drawlist_out.tri_v_colors.push_back(this->poly_data(pid_beneath).color.g*AO_vid2);
-                drawlist_out.tri_v_colors.push_back(this->poly_data(pid_beneath).color.b*AO_vid2);
-                drawlist_out.tri_v_colors.push_back(this->poly_data(pid_beneath).color.a);
-            }
-            else if (drawlist_out.draw_mode & DRAW_TRI_VERTCOLOR)
-            {
-                drawlist_out.tri_v_colors.push_back(this->vert_data(vid0).color.r*AO_vid0);
-                drawlist_out.tri_v_colors.push_back(this->vert_data(vid0).color.g*AO_vid0);
-                drawlist_out.tri_v_colors.push_back(this->vert_data(vid0).color.b*AO_vid0);
-                drawlist_out.tri_v_colors.push_back(this->vert_data(vid0).color.a);
-                drawlist_out.tri_v_colors.push_back(this->vert_data(vid1).color.r*AO_vid1);
-                drawlist_out.tri_v_colors.push_back(this->vert_data(vid1).color.g*AO_vid1);
-                drawlist_out.tri_v_colors.push_back(this->vert_data(vid1).color.b*AO_vid1);
-                drawlist_out.tri_v_colors.push_back(this->vert_data(vid1).color.a);
-                drawlist_out.tri_v_colors.push_back(this->vert_data(vid2).color.r*AO_vid2);
-                drawlist_out.tri_v_colors.push_back(this->vert_data(vid2).color.g*AO_vid2);
-                drawlist_out.tri_v_colors.push_back(this->vert_data(vid2).color.b*AO_vid2);
-                drawlist_out.tri_v_colors.push_back(this->vert_data(vid2).color.a);
-            }
-            else if (drawlist_out.draw_mode & DRAW_TRI_QUALITY)
-            {
-                float q = this->poly_data(pid_beneath).quality;
-                Color c = Color::red_white_blue_ramp_01(q);
-                drawlist_out.tri_v_colors.push_back(c.r*AO_vid0);
-                drawlist_out.tri_v_colors.push_back(c.g*AO_vid0);
-                drawlist_out.tri_v_colors.push_back(c.b*AO_vid0);
-                drawlist_out.tri_v_colors.push_back(c.a);
-                drawlist_out.tri_v_colors.push_back(c.r*AO_vid1);
-                drawlist_out.tri_v_colors.push_back(c.g*AO_vid1);
-                drawlist_out.tri_v_colors.push_back(c.b*AO_vid1);
-                drawlist_out.tri_v_colors.push_back(c.a);
-                drawlist_out.tri_v_colors.push_back(c.r*AO_vid2);
-                drawlist_out.tri_v_colors.push_back(c.g*AO_vid2);
-                drawlist_out.tri_v_colors.push_back(c.b*AO_vid2);
-                drawlist_out.tri_v_colors.push_back(c.a);
-            }
+    // assign to each rendered face (edge) a contiguous range of triangles (a segment),
+    // so that buffers can be allocated once with their exact size, and filled in parallel
+    uint n_tris = 0;
+    layout.tri_offset.resize(this->num_faces());
+    layout.owner.resize(this->num_faces());
+    for(uint fid=0; fid<this->num_faces(); ++fid)
+    {
+        uint pid_beneath;
+        if(!face_is_rendered(fid, srf, pid_beneath))
+        {
+            layout.tri_offset[fid] = -1;
+            layout.owner[fid]      = -1;
+            continue;
         }
+        layout.tri_offset[fid] = n_tris;
+        layout.owner[fid]      = pid_beneath;
+        n_tris += this->face_tessellation(fid).size()/3;
     }
 
+    uint n_segs = 0;
+    layout.seg_offset.resize(this->num_edges());
     for(uint eid=0; eid<this->num_edges(); ++eid)
     {
-        vec3d vid0 = this->edge_vert(eid,0);
-        vec3d vid1 = this->edge_vert(eid,1);
+        layout.seg_offset[eid] = edge_is_rendered(eid, srf) ? n_segs++ : -1;
+    }
 
-        if (this->edge_is_on_srf(eid))
+    render_data_resize(drawlist, n_tris, n_segs);
+    layout.clear_free_slots();
+
+    PARALLEL_FOR(0, this->num_faces(), 1000, [&](const uint fid)
+    {
+        if(layout.tri_offset[fid]>=0) updateGL_face(drawlist, layout, fid, srf);
+    });
+    PARALLEL_FOR(0, this->num_edges(), 1000, [&](const uint eid)
+    {
+        if(layout.seg_offset[eid]>=0) updateGL_edge(drawlist, layout, eid);
+    });
+
+    updateGL_layout_sync(drawlist, layout);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+bool AbstractDrawablePolyhedralMesh<Mesh>::updateGL_faces_changes(RenderData & drawlist, RenderDataLayout & layout, const bool srf)
+{
+    if(layout.revisions.size()  != CHANGES_NUM_LOGS             ||
+       layout.tri_offset.size() != this->num_faces()            ||
+       layout.seg_offset.size() != this->num_edges()            ||
+       layout.draw_mode         != drawlist.draw_mode           ||
+       layout.AO_alpha          != AO_alpha                     ||
+       layout.tex_scale         != drawlist.texture.scaling_factor) return false;
+
+    std::vector<uint> ids[CHANGES_NUM_LOGS];
+    for(int i=0; i<CHANGES_NUM_LOGS; ++i)
+    {
+        if(!this->changes(i).changed_since(layout.revisions.at(i), ids[i])) return false;
+    }
+    if(!ids[CHANGES_VERTS].empty() || !ids[CHANGES_EDGES].empty() ||
+       !ids[CHANGES_FACES].empty() || !ids[CHANGES_POLYS].empty()) return false;
+
+    // dirty elements are listed as they are found, so that the cost of the
+    // update depends on the amount of changes, not on the size of the mesh
+    std::vector<bool> dirty_f(this->num_faces(), false);
+    std::vector<bool> dirty_e(this->num_edges(), false);
+    std::vector<uint> faces, edges;
+    auto mark_f = [&](const uint fid) { if(!dirty_f[fid]) { dirty_f[fid] = true; faces.push_back(fid); } };
+    auto mark_e = [&](const uint eid) { if(!dirty_e[eid]) { dirty_e[eid] = true; edges.push_back(eid); } };
+
+    // polys changing visibility (e.g. slicing) change the set of rendered faces and edges,
+    // which take (release) slots in the buffers, and the poly whose attributes are rendered
+    // on their faces. Visible faces (rendered here or in the other drawlist) also change the
+    // normals averaged at the verts of their neighbors. Poly attributes (color, quality) are
+    // rendered on its faces
+    std::vector<bool> checked_f(this->num_faces(), false);
+    std::vector<bool> checked_e(this->num_edges(), false);
+    for(uint pid : ids[CHANGES_POLY_DATA])
+    {
+        if(pid>=this->num_polys()) continue;
+        for(uint fid : this->adj_p2f(pid))
         {
-            bool hidden = true;
-            for(uint pid : this->adj_e2p(eid))
+            if(checked_f[fid]) continue;
+            checked_f[fid] = true;
+            uint pid_beneath;
+            bool rendered = face_is_rendered(fid, srf, pid_beneath);
+            if(rendered != (layout.tri_offset[fid]>=0))
             {
-                if(!this->poly_data(pid).flags[HIDDEN])
+                if(drawlist.draw_mode & DRAW_TRI_POINTS) return false;
+                uint n_tris = this->face_tessellation(fid).size()/3;
+                if(rendered) layout.tri_offset[fid] = render_data_alloc_tris(drawlist, layout, n_tris);
+                else
                 {
-                    hidden = false;
-                    break;
+                    render_data_free_tris(drawlist, layout, layout.tri_offset[fid], n_tris);
+                    layout.tri_offset[fid] = -1;
                 }
             }
-            if(hidden) continue;
-
-            int base_addr = drawlist_out.seg_coords.size()/3;
-            drawlist_out.segs.push_back(base_addr    );
-            drawlist_out.segs.push_back(base_addr + 1);
-
-            drawlist_out.seg_coords.push_back(vid0.x());
-            drawlist_out.seg_coords.push_back(vid0.y());
-            drawlist_out.seg_coords.push_back(vid0.z());
-            drawlist_out.seg_coords.push_back(vid1.x());
-            drawlist_out.seg_coords.push_back(vid1.y());
-            drawlist_out.seg_coords.push_back(vid1.z());
-
-            drawlist_out.seg_colors.push_back(this->edge_data(eid).color.r);
-            drawlist_out.seg_colors.push_back(this->edge_data(eid).color.g);
-            drawlist_out.seg_colors.push_back(this->edge_data(eid).color.b);
-            drawlist_out.seg_colors.push_back(this->edge_data(eid).color.a);
-            drawlist_out.seg_colors.push_back(this->edge_data(eid).color.r);
-            drawlist_out.seg_colors.push_back(this->edge_data(eid).color.g);
-            drawlist_out.seg_colors.push_back(this->edge_data(eid).color.b);
-            drawlist_out.seg_colors.push_back(this->edge_data(eid).color.a);
+            layout.owner[fid] = (rendered) ? static_cast<int>(pid_beneath) : -1;
+            for(uint vid : this->adj_f2v(fid))
+            for(uint f   : this->adj_v2f(vid)) mark_f(f);
         }
-
-        if (this->edge_data(eid).flags[MARKED])
+        for(uint eid : this->adj_p2e(pid))
         {
-            int base_addr = drawlist_marked.seg_coords.size()/3;
-            drawlist_marked.segs.push_back(base_addr    );
-            drawlist_marked.segs.push_back(base_addr + 1);
-
-            drawlist_marked.seg_coords.push_back(vid0.x());
-            drawlist_marked.seg_coords.push_back(vid0.y());
-            drawlist_marked.seg_coords.push_back(vid0.z());
-            drawlist_marked.seg_coords.push_back(vid1.x());
-            drawlist_marked.seg_coords.push_back(vid1.y());
-            drawlist_marked.seg_coords.push_back(vid1.z());
-
-            drawlist_marked.seg_colors.push_back(marked_edge_color.r);
-            drawlist_marked.seg_colors.push_back(marked_edge_color.g);
-            drawlist_marked.seg_colors.push_back(marked_edge_color.b);
-            drawlist_marked.seg_colors.push_back(marked_edge_color.a);
-            drawlist_marked.seg_colors.push_back(marked_edge_color.r);
-            drawlist_marked.seg_colors.push_back(marked_edge_color.g);
-            drawlist_marked.seg_colors.push_back(marked_edge_color.b);
-            drawlist_marked.seg_colors.push_back(marked_edge_color.a);
+            if(checked_e[eid]) continue;
+            checked_e[eid] = true;
+            bool rendered = edge_is_rendered(eid, srf);
+            if(rendered == (layout.seg_offset[eid]>=0)) continue;
+            if(rendered)
+            {
+                layout.seg_offset[eid] = render_data_alloc_seg(drawlist, layout);
+                mark_e(eid);
+            }
+            else
+            {
+                render_data_free_seg(drawlist, layout, layout.seg_offset[eid]);
+                layout.seg_offset[eid] = -1;
+            }
         }
     }
+    // too many free slots: rather compact the buffers
+    if(layout.n_free_tris     > drawlist.tris.size()/6 + 1024 ||
+       layout.free_segs.size() > drawlist.segs.size()/4 + 1024) return false;
+
+    // moved verts change the position of their faces and edges, and the normals of
+    // their faces, which are averaged at the verts of these faces (smooth shading)
+    for(uint vid : ids[CHANGES_VERT_POS])
+    {
+        if(vid>=this->num_verts()) continue;
+        for(uint eid : this->adj_v2e(vid)) mark_e(eid);
+        for(uint fid : this->adj_v2f(vid))
+        for(uint nbr : this->adj_f2v(fid))
+        for(uint f   : this->adj_v2f(nbr)) mark_f(f);
+    }
+    // vert attributes (color, uvw) are copied at the corners of their faces
+    for(uint vid : ids[CHANGES_VERT_DATA])
+    {
+        if(vid>=this->num_verts()) continue;
+        for(uint fid : this->adj_v2f(vid)) mark_f(fid);
+    }
+    // face AO is averaged at its verts
+    for(uint fid : ids[CHANGES_FACE_DATA])
+    {
+        if(fid>=this->num_faces()) continue;
+        for(uint vid : this->adj_f2v(fid))
+        for(uint f   : this->adj_v2f(vid)) mark_f(f);
+    }
+    for(uint eid : ids[CHANGES_EDGE_DATA])
+    {
+        if(eid<this->num_edges()) mark_e(eid);
+    }
+
+    // not rendered elements have nothing to update
+    faces.erase(std::remove_if(faces.begin(), faces.end(), [&](const uint fid) { return layout.tri_offset[fid]<0; }), faces.end());
+    edges.erase(std::remove_if(edges.begin(), edges.end(), [&](const uint eid) { return layout.seg_offset[eid]<0; }), edges.end());
+
+    drawlist.material = material_;
+    PARALLEL_FOR(0, faces.size(), 1000, [&](const uint i) { updateGL_face(drawlist, layout, faces[i], srf); });
+    PARALLEL_FOR(0, edges.size(), 1000, [&](const uint i) { updateGL_edge(drawlist, layout, edges[i]); });
+    for(uint fid : faces) render_data_changed_tris(drawlist, layout.tri_offset[fid], this->face_tessellation(fid).size()/3);
+    for(uint eid : edges) render_data_changed_segs(drawlist, layout.seg_offset[eid], 1);
+
+    updateGL_layout_sync(drawlist, layout);
+    return true;
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
 template<class Mesh>
 CINO_INLINE
-void AbstractDrawablePolyhedralMesh<Mesh>::updateGL_in()
+void AbstractDrawablePolyhedralMesh<Mesh>::updateGL_layout_sync(const RenderData & drawlist, RenderDataLayout & layout)
 {
-    drawlist_in.material = material_;
-    drawlist_in.tris.clear();
-    drawlist_in.tri_coords.clear();
-    drawlist_in.tri_v_norms.clear();
-    drawlist_in.tri_v_colors.clear();
-    drawlist_in.tri_text.clear();
-    drawlist_in.segs.clear();
-    drawlist_in.seg_coords.clear();
-    drawlist_in.seg_colors.clear();
-
-    std::unordered_set<uint> edges_to_render;
+    layout.revisions.resize(CHANGES_NUM_LOGS);
+    for(int i=0; i<CHANGES_NUM_LOGS; ++i) layout.revisions[i] = this->changes(i).revision();
+    layout.draw_mode = drawlist.draw_mode;
+    layout.AO_alpha  = AO_alpha;
+    layout.tex_scale = drawlist.texture.scaling_factor;
+}
 
-    for(uint fid=0; fid<this->num_faces(); ++fid)
-    {
-        if(this->face_is_on_srf(fid)) continue;
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-        uint pid_beneath;
-        if(!this->face_is_visible(fid, pid_beneath)) continue;
+template<class Mesh>
+CINO_INLINE
+void AbstractDrawablePolyhedralMesh<Mesh>::updateGL_face(RenderData & drawlist, const RenderDataLayout & layout, const uint fid, const bool srf)
+{
+    uint  pid_beneath = layout.owner[fid];
+    bool  flip        = !srf && this->poly_face_is_CW(pid_beneath, fid); // flip inner triangles orientation
+    vec3d n           = this->poly_face_normal(pid_beneath, fid);
+    const std::vector<uint> & tris = this->face_tessellation(fid);
+    const Color & c = this->poly_data(pid_beneath).color;
+    Color q;
+    if (drawlist.draw_mode & DRAW_TRI_QUALITY) q = Color::red_white_blue_ramp_01(this->poly_data(pid_beneath).quality);
 
-        bool is_CW = this->poly_face_is_CW(pid_beneath, fid);
+    uint off = 3*layout.tri_offset[fid];
+    for(uint i=0; i<tris.size(); ++i)
+    {
+        uint vid = tris[i];
+        uint j   = off + i;
+        if (flip && i%3>0) vid = tris[i%3==1 ? i+1 : i-1];
+
+        // average AO and normals with adjacent visible faces having dihedral angle lower than 60 degrees
+        float AO = 0.0;
+        vec3d vn(0,0,0);
+        uint  count = 0;
+        for(uint nbr : this->adj_v2f(vid))
+        {
+            uint pid;
+            if(!this->face_is_visible(nbr, pid)) continue;
+            vec3d nbr_n = this->poly_face_normal(pid, nbr);
+            if(n.angle_deg(nbr_n) >= 60.0) continue;
+            AO += this->face_data(nbr).AO*AO_alpha + (1.0 - AO_alpha);
+            vn += nbr_n;
+            ++count;
+        }
+        AO /= static_cast<float>(count);
+        vn /= static_cast<double>(count);
 
-        vec3d n = this->poly_face_normal(pid_beneath, fid);
+        drawlist.tri_coords[3*j  ] = this->vert(vid).x();
+        drawlist.tri_coords[3*j+1] = this->vert(vid).y();
+        drawlist.tri_coords[3*j+2] = this->vert(vid).z();
 
-        for(uint eid : this->adj_f2e(fid))
+        if (drawlist.draw_mode & DRAW_TRI_SMOOTH)
         {
-            if (this->edge_is_on_srf(eid)) continue; // updateGL_out() will consider it
-            edges_to_render.insert(eid);
+            drawlist.tri_v_norms[3*j  ] = vn.x();
+            drawlist.tri_v_norms[3*j+1] = vn.y();
+            drawlist.tri_v_norms[3*j+2] = vn.z();
         }
-
-        for(uint i=0; i<this->face_tessellation(fid).size()/3; ++i)
+        else if (drawlist.draw_mode & DRAW_TRI_FLAT)
         {
-            uint vid0 = this->face_tessellation(fid).at(3*i+0);
-            uint vid1 = this->face_tessellation(fid).at(3*i+1);
-            uint vid2 = this->face_tessellation(fid).at(3*i+2);
-            if (is_CW) std::swap(vid1,vid2); // flip triangle orientation
-
-            // average AO with adjacent visible faces having dihedral angle lower than 60 degrees
-            auto  vid0_vis_fids = this->vert_adj_visible_faces(vid0, n, 60.0);
-            auto  vid1_vis_fids = this->vert_adj_visible_faces(vid1, n, 60.0);
-            auto  vid2_vis_fids = this->vert_adj_visible_faces(vid2, n, 60.0);
-            float AO_vid0 = 0.0;
-            float AO_vid1 = 0.0;
-            float AO_vid2 = 0.0;
-            for(auto fp : vid0_vis_fids) AO_vid0 += this->face_data(fp.first).AO*AO_alpha + (1.0 - AO_alpha);
-            for(auto fp : vid1_vis_fids) AO_vid1 += this->face_data(fp.first).AO*AO_alpha + (1.0 - AO_alpha);
-            for(auto fp : vid2_vis_fids) AO_vid2 += this->face_data(fp.first).AO*AO_alpha + (1.0 - AO_alpha);
-            AO_vid0 /= static_cast<float>(vid0_vis_fids.size());
-            AO_vid1 /= static_cast<float>(vid1_vis_fids.size());
-            AO_vid2 /= static_cast<float>(vid2_vis_fids.size());
-
-            int base_addr = drawlist_in.tri_coords.size()/3;
-
-            drawlist_in.tris.push_back(base_addr    );
-            drawlist_in.tris.push_back(base_addr + 1);
-            drawlist_in.tris.push_back(base_addr + 2);
-
-            drawlist_in.tri_coords.push_back(this->vert(vid0).x());
-            drawlist_in.tri_coords.push_back(this->vert(vid0).y());
-            drawlist_in.tri_coords.push_back(this->vert(vid0).z());
-            drawlist_in.tri_coords.push_back(this->vert(vid1).x());
-            drawlist_in.tri_coords.push_back(this->vert(vid1).y());
-            drawlist_in.tri_coords.push_back(this->vert(vid1).z());
-            drawlist_in.tri_coords.push_back(this->vert(vid2).x());
-            drawlist_in.tri_coords.push_back(this->vert(vid2).y());
-            drawlist_in.tri_coords.push_back(this->vert(vid2).z());
-
-            if (drawlist_in.draw_mode & DRAW_TRI_SMOOTH)
-            {
-                // average normals with adjacent visible faces having dihedral angle lower than 60 degrees
-                vec3d n_vid0(0,0,0);
-                vec3d n_vid1(0,0,0);
-                vec3d n_vid2(0,0,0);
-                for(auto fp : vid0_vis_fids) n_vid0 += this->poly_face_normal(fp.second, fp.first);
-                for(auto fp : vid1_vis_fids) n_vid1 += this->poly_face_normal(fp.second, fp.first);
-                for(auto fp : vid2_vis_fids) n_vid2 += this->poly_face_normal(fp.second, fp.first);
-                n_vid0 /= static_cast<double>(vid0_vis_fids.size());
-                n_vid1 /= static_cast<double>(vid1_vis_fids.size());
-                n_vid2 /= static_cast<double>(vid2_vis_fids.size());
-
-                drawlist_in.tri_v_norms.push_back(n_vid0.x());
-                drawlist_in.tri_v_norms.push_back(n_vid0.y());
-                drawlist_in.tri_v_norms.push_back(n_vid0.z());
-                drawlist_in.tri_v_norms.push_back(n_vid1.x());
-                drawlist_in.tri_v_norms.push_back(n_vid1.y());
-                drawlist_in.tri_v_norms.push_back(n_vid1.z());
-                drawlist_in.tri_v_norms.push_back(n_vid2.x());
-                drawlist_in.tri_v_norms.push_back(n_vid2.y());
-                drawlist_in.tri_v_norms.push_back(n_vid2.z());
-            }
-            else if (drawlist_in.draw_mode & DRAW_TRI_FLAT)
-            {
-                drawlist_in.tri_v_norms.push_back(n.x());
-                drawlist_in.tri_v_norms.push_back(n.y());
-                drawlist_in.tri_v_norms.push_back(n.z());
-                drawlist_in.tri_v_norms.push_back(n.x());
-                drawlist_in.tri_v_norms.push_back(n.y());
-                drawlist_in.tri_v_norms.push_back(n.z());
-                drawlist_in.tri_v_norms.push_back(n.x());
-                drawlist_in.tri_v_norms.push_back(n.y());
-                drawlist_in.tri_v_norms.push_back(n.z());
-            }
+            drawlist.tri_v_norms[3*j  ] = n.x();
+            drawlist.tri_v_norms[3*j+1] = n.y();
+            drawlist.tri_v_norms[3*j+2] = n.z();
+        }
 
-            if (drawlist_in.draw_mode & DRAW_TRI_TEXTURE1D)
-            {
-                drawlist_in.tri_text.push_back(this->vert_data(vid0).uvw[0]);
-                drawlist_in.tri_text.push_back(this->vert_data(vid1).uvw[0]);
-                drawlist_in.tri_text.push_back(this->vert_data(vid2).uvw[0]);
-            }
-            else if (drawlist_in.draw_mode & DRAW_TRI_TEXTURE2D)
-            {
-                drawlist_in.tri_text.push_back(this->vert_data(vid0).uvw[0]*drawlist_in.texture.scaling_factor);
-                drawlist_in.tri_text.push_back(this->vert_data(vid0).uvw[1]*drawlist_in.texture.scaling_factor);
-                drawlist_in.tri_text.push_back(this->vert_data(vid1).uvw[0]*drawlist_in.texture.scaling_factor);
-                drawlist_in.tri_text.push_back(this->vert_data(vid1).uvw[1]*drawlist_in.texture.scaling_factor);
-                drawlist_in.tri_text.push_back(this->vert_data(vid2).uvw[0]*drawlist_in.texture.scaling_factor);
-                drawlist_in.tri_text.push_back(this->vert_data(vid2).uvw[1]*drawlist_in.texture.scaling_factor);
-            }
+        if (drawlist.draw_mode & DRAW_TRI_TEXTURE1D)
+        {
+            drawlist.tri_text[j] = this->vert_data(vid).uvw[0];
+        }
+        else if (drawlist.draw_mode & DRAW_TRI_TEXTURE2D)
+        {
+            drawlist.tri_text[2*j  ] = this->vert_data(vid).uvw[0]*drawlist.texture.scaling_factor;
+            drawlist.tri_text[2*j+1] = this->vert_data(vid).uvw[1]*drawlist.texture.scaling_factor;
+        }
 
-            if (drawlist_in.draw_mode & DRAW_TRI_FACECOLOR) // replicate f color on each vertex
-            {
-                drawlist_in.tri_v_colors.push_back(this->poly_data(pid_beneath).color.r*AO_vid0);
-                drawlist_in.tri_v_colors.push_back(this->poly_data(pid_beneath).color.g*AO_vid0);
-                drawlist_in.tri_v_colors.push_back(this->poly_data(pid_beneath).color.b*AO_vid0);
-                drawlist_in.tri_v_colors.push_back(this->poly_data(pid_beneath).color.a);
-                drawlist_in.tri_v_colors.push_back(this->poly_data(pid_beneath).color.r*AO_vid1);
-                drawlist_in.tri_v_colors.push_back(this->poly_data(pid_beneath).color.g*AO_vid1);
-                drawlist_in.tri_v_colors.push_back(this->poly_data(pid_beneath).color.b*AO_vid1);
-                drawlist_in.tri_v_colors.push_back(this->poly_data(pid_beneath).color.a);
-                drawlist_in.tri_v_colors.push_back(this->poly_data(pid_beneath).color.r*AO_vid2);
-                drawlist_in.tri_v_colors.push_back(this->poly_data(pid_beneath).color.g*AO_vid2);
-                drawlist_in.tri_v_colors.push_back(this->poly_data(pid_beneath).color.b*AO_vid2);
-                drawlist_in.tri_v_colors.push_back(this->poly_data(pid_beneath).color.a);
-            }
-            else if (drawlist_in.draw_mode & DRAW_TRI_VERTCOLOR)
-            {
-                drawlist_in.tri_v_colors.push_back(this->vert_data(vid0).color.r*AO_vid0);
-                drawlist_in.tri_v_colors.push_back(this->vert_data(vid0).color.g*AO_vid0);
-                drawlist_in.tri_v_colors.push_back(this->vert_data(vid0).color.b*AO_vid0);
-                drawlist_in.tri_v_colors.push_back(this->vert_data(vid0).color.a);
-                drawlist_in.tri_v_colors.push_back(this->vert_data(vid1).color.r*AO_vid1);
-                drawlist_in.tri_v_colors.push_back(this->vert_data(vid1).color.g*AO_vid1);
-                drawlist_in.tri_v_colors.push_back(this->vert_data(vid1).color.b*AO_vid1);
-                drawlist_in.tri_v_colors.push_back(this->vert_data(vid1).color.a);
-                drawlist_in.tri_v_colors.push_back(this->vert_data(vid2).color.r*AO_vid2);
-                drawlist_in.tri_v_colors.push_back(this->vert_data(vid2).color.g*AO_vid2);
-                drawlist_in.tri_v_colors.push_back(this->vert_data(vid2).color.b*AO_vid2);
-                drawlist_in.tri_v_colors.push_back(this->vert_data(vid2).color.a);
-            }
-            else if (drawlist_in.draw_mode & DRAW_TRI_QUALITY)
-            {
-                float q = this->poly_data(pid_beneath).quality;
-                Color c = Color::red_white_blue_ramp_01(q);
-                drawlist_in.tri_v_colors.push_back(c.r*AO_vid0);
-                drawlist_in.tri_v_colors.push_back(c.g*AO_vid0);
-                drawlist_in.tri_v_colors.push_back(c.b*AO_vid0);
-                drawlist_in.tri_v_colors.push_back(c.a);
-                drawlist_in.tri_v_colors.push_back(c.r*AO_vid1);
-                drawlist_in.tri_v_colors.push_back(c.g*AO_vid1);
-                drawlist_in.tri_v_colors.push_back(c.b*AO_vid1);
-                drawlist_in.tri_v_colors.push_back(c.a);
-                drawlist_in.tri_v_colors.push_back(c.r*AO_vid2);
-                drawlist_in.tri_v_colors.push_back(c.g*AO_vid2);
-                drawlist_in.tri_v_colors.push_back(c.b*AO_vid2);
-                drawlist_in.tri_v_colors.push_back(c.a);
-            }
+        const Color * col = NULL;
+        if      (drawlist.draw_mode & DRAW_TRI_FACECOLOR)  col = &c; // replicate f color on each vertex
+        else if (drawlist.draw_mode & DRAW_TRI_VERTCOLOR)  col = &this->vert_data(vid).color;
+        else if (drawlist.draw_mode & DRAW_TRI_QUALITY)    col = &q;
+        if (col != NULL)
+        {
+            drawlist.tri_v_colors[4*j  ] = col->r*AO;
+            drawlist.tri_v_colors[4*j+1] = col->g*AO;
+            drawlist.tri_v_colors[4*j+2] = col->b*AO;
+            drawlist.tri_v_colors[4*j+3] = col->a;
         }
     }
+}
 
-    for(uint eid : edges_to_render)
-    {
-        uint base_addr = drawlist_in.seg_coords.size()/3;
-        drawlist_in.segs.push_back(base_addr    );
-        drawlist_in.segs.push_back(base_addr + 1);
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-        vec3d vid0 = this->edge_vert(eid,0);
-        vec3d vid1 = this->edge_vert(eid,1);
+template<class Mesh>
+CINO_INLINE
+void AbstractDrawablePolyhedralMesh<Mesh>::updateGL_edge(RenderData & drawlist, const RenderDataLayout & layout, const uint eid)
+{
+    uint  j   = 2*layout.seg_offset[eid];
+    vec3d v0  = this->edge_vert(eid,0);
+    vec3d v1  = this->edge_vert(eid,1);
+    const Color & c = this->edge_data(eid).color;
+
+    drawlist.seg_coords[3*j  ] = v0.x();
+    drawlist.seg_coords[3*j+1] = v0.y();
+    drawlist.seg_coords[3*j+2] = v0.z();
+    drawlist.seg_coords[3*j+3] = v1.x();
+    drawlist.seg_coords[3*j+4] = v1.y();
+    drawlist.seg_coords[3*j+5] = v1.z();
 
-        drawlist_in.seg_coords.push_back(vid0.x());
-        drawlist_in.seg_coords.push_back(vid0.y());
-        drawlist_in.seg_coords.push_back(vid0.z());
-        drawlist_in.seg_coords.push_back(vid1.x());
-        drawlist_in.seg_coords.push_back(vid1.y());
-        drawlist_in.seg_coords.push_back(vid1.z());
-
-        drawlist_in.seg_colors.push_back(this->edge_data(eid).color.r);
-        drawlist_in.seg_colors.push_back(this->edge_data(eid).color.g);
-        drawlist_in.seg_colors.push_back(this->edge_data(eid).color.b);
-        drawlist_in.seg_colors.push_back(this->edge_data(eid).color.a);
-        drawlist_in.seg_colors.push_back(this->edge_data(eid).color.r);
-        drawlist_in.seg_colors.push_back(this->edge_data(eid).color.g);
-        drawlist_in.seg_colors.push_back(this->edge_data(eid).color.b);
-        drawlist_in.seg_colors.push_back(this->edge_data(eid).color.a);
-
-//        if (this->edge_data(eid).flags[MARKED] && drawlist_in.draw_mode & DRAW_MARKED_SEGS)
-//        {
-//            int base_addr = drawlist_in.flags[MARKED]_seg_coords.size()/3;
-//            drawlist_in.flags[MARKED]_segs.push_back(base_addr    );
-//            drawlist_in.flags[MARKED]_segs.push_back(base_addr + 1);
-
-//            drawlist_in.flags[MARKED]_seg_coords.push_back(vid0.x());
-//            drawlist_in.flags[MARKED]_seg_coords.push_back(vid0.y());
-//            drawlist_in.flags[MARKED]_seg_coords.push_back(vid0.z());
-//            drawlist_in.flags[MARKED]_seg_coords.push_back(vid1.x());
-//            drawlist_in.flags[MARKED]_seg_coords.push_back(vid1.y());
-//            drawlist_in.flags[MARKED]_seg_coords.push_back(vid1.z());
-//        }
+    for(uint i=0; i<2; ++i)
+    {
+        drawlist.seg_colors[4*(j+i)  ] = c.r;
+        drawlist.seg_colors[4*(j+i)+1] = c.g;
+        drawlist.seg_colors[4*(j+i)+2] = c.b;
+        drawlist.seg_colors[4*(j+i)+3] = c.a;
     }
 }
 
@@ -624,8 +539,16 @@ template<class Mesh>
 CINO_INLINE
 void AbstractDrawablePolyhedralMesh<Mesh>::slice(const SlicerState & s)
 {
-    slicer.update(*this, s); // update per element visibility flags
-    updateGL();
+    // update per element visibility flags (and log the changed ones). If the slicer
+    // had to rebuild its cache the mesh changed, and is uploaded from scratch
+    if(!slicer.update(*this, s))
+    {
+        updateGL();
+        return;
+    }
+    // marked elements are rendered regardless of their visibility: only inner/outer faces change
+    if(!updateGL_faces_changes(drawlist_in,  layout_in,  false)) updateGL_in();
+    if(!updateGL_faces_changes(drawlist_out, layout_out, true )) updateGL_out();
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
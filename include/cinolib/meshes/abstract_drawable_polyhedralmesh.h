@@ -58,6 +58,8 @@ class AbstractDrawablePolyhedralMesh : public virtual Mesh, public DrawableObjec
         Color            marked_edge_color;
         Color            marked_face_color;
         float            AO_alpha;
+        RenderDataLayout layout_in;  // where faces and edges are stored in drawlist_in  (see updateGL_incremental())
+        RenderDataLayout layout_out; // where faces and edges are stored in drawlist_out (see updateGL_incremental())
 
     public:
 
@@ -83,10 +85,29 @@ class AbstractDrawablePolyhedralMesh : public virtual Mesh, public DrawableObjec
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-        void updateGL();         // regenerates rendering data for mesh inside/outside and marked elements
-        void updateGL_in();      // regenerates rendering data for mesh inside
-        void updateGL_out();     // regenerates rendering data for mesh outside
-        void updateGL_marked();  // regenerates rendering data for mesh marked elements
+        void updateGL();             // regenerates rendering data for mesh inside/outside and marked elements
+        void updateGL_in();          // regenerates rendering data for mesh inside
+        void updateGL_out();         // regenerates rendering data for mesh outside
+        void updateGL_marked();      // regenerates rendering data for mesh marked elements
+        void updateGL_incremental(); // as updateGL(), but mesh inside/outside are updated only if changed since the last update
+
+    protected:
+
+        // Rendering data for the mesh outside (srf=true) or inside (srf=false). Incremental updates
+        // rely on the mesh change logs (see AbstractMesh::changes()), hence they miss changes done by
+        // writing directly into the mesh, unless recorded by the caller. Changes in connectivity
+        // or render settings require a full update. Faces appearing after changes in visibility
+        // (e.g. slicing) reuse the slots of the buffers freed by the faces disappearing
+        //
+        void updateGL_faces        (RenderData & drawlist, RenderDataLayout & layout, const bool srf);
+        bool updateGL_faces_changes(RenderData & drawlist, RenderDataLayout & layout, const bool srf); // false if a full update is needed
+        void updateGL_face         (RenderData & drawlist, const RenderDataLayout & layout, const uint fid, const bool srf);
+        void updateGL_edge         (RenderData & drawlist, const RenderDataLayout & layout, const uint eid);
+        void updateGL_layout_sync  (const RenderData & drawlist, RenderDataLayout & layout);
+        bool face_is_rendered      (const uint fid, const bool srf, uint & pid_beneath) const;
+        bool edge_is_rendered      (const uint eid, const bool srf) const;
+
+    public:
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
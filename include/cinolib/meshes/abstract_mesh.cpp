@@ -37,6 +37,7 @@
 #include <cinolib/meshes/mesh_attributes.h>
 #include <cinolib/stl_container_utilities.h>
 #include <cinolib/min_max_inf.h>
+#include <cinolib/parallel_for.h>
 #include <map>
 #include <unordered_set>
 #include <unordered_map>
@@ -83,6 +84,7 @@ void AbstractMesh<M,V,E,P>::clear()
     polys.clear();
     //
     M std_M_data;
+    std_M_data.check_duplicates = m_data.check_duplicates; // loading policies survive clear()
     m_data = std_M_data;
     v_data.clear();
     e_data.clear();
@@ -94,6 +96,8 @@ void AbstractMesh<M,V,E,P>::clear()
     e2p.clear();
     p2e.clear();
     p2p.clear();
+    //
+    mark_changed_all();
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -117,6 +121,7 @@ void AbstractMesh<M,V,E,P>::translate(const vec3d & delta)
     for(uint vid=0; vid<num_verts(); ++vid) vert(vid) += delta;
     bb.min += delta;
     bb.max += delta;
+    mark_changed(CHANGES_VERT_POS);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -137,6 +142,7 @@ void AbstractMesh<M,V,E,P>::rotate(const vec3d & axis, const double angle)
     //
     if(m_data.update_bbox)    update_bbox();
     if(m_data.update_normals) update_normals();
+    mark_changed(CHANGES_VERT_POS);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -149,6 +155,7 @@ void AbstractMesh<M,V,E,P>::scale(const double scale_factor)
     translate(-c);
     for(uint vid=0; vid<num_verts(); ++vid) vert(vid) *= scale_factor;
     translate(c);
+    mark_changed(CHANGES_VERT_POS);
     if(m_data.update_bbox) update_bbox();
 }
 
@@ -169,8 +176,11 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 void AbstractMesh<M,V,E,P>::update_bbox()
 {
-    bb.reset();
-    bb.push(this->verts);
+    AABB empty;
+    empty.reset();
+    bb = PARALLEL_REDUCE(0, this->num_verts(), 10000, empty,
+                         [&](const uint vid, AABB & box){ box.push(this->vert(vid)); },
+                         [](AABB a, const AABB & b){ a.push(b); return a; });
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -356,6 +366,7 @@ void AbstractMesh<M,V,E,P>::deserialize_uvw(const std::vector<vec3d> & uvw)
     {
         vert_data(vid).uvw = uvw.at(vid);
     }
+    mark_changed(CHANGES_VERT_DATA);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -383,6 +394,7 @@ void AbstractMesh<M,V,E,P>::copy_xyz_to_uvw(const int mode)
             default: assert(false);
         }
     }
+    mark_changed(CHANGES_VERT_DATA);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -411,6 +423,7 @@ void AbstractMesh<M,V,E,P>::copy_uvw_to_xyz(const int mode)
         }
     }
     if(m_data.update_bbox) update_bbox();
+    mark_changed(CHANGES_VERT_POS);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -423,6 +436,8 @@ void AbstractMesh<M,V,E,P>::swap_xyz_uvw(const bool normals, const bool bbox)
     {
         std::swap(vert(vid),vert_data(vid).uvw);
     }
+    mark_changed(CHANGES_VERT_POS);
+    mark_changed(CHANGES_VERT_DATA);
     if(normals) update_normals();
     if(bbox)    update_bbox();
 }
@@ -454,6 +469,66 @@ std::vector<uint> AbstractMesh<M,V,E,P>::adj_e2e(const uint eid) const
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class P>
+CINO_INLINE
+void AbstractMesh<M,V,E,P>::compact_adjacency()
+{
+    compact(v2v);
+    compact(v2e);
+    compact(v2p);
+    compact(e2p);
+    compact(p2e);
+    compact(p2p);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+size_t AbstractMesh<M,V,E,P>::adjacency_memory_usage_in_bytes() const
+{
+    return memory_usage_in_bytes(v2v) +
+           memory_usage_in_bytes(v2e) +
+           memory_usage_in_bytes(v2p) +
+           memory_usage_in_bytes(e2p) +
+           memory_usage_in_bytes(p2e) +
+           memory_usage_in_bytes(p2p);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void AbstractMesh<M,V,E,P>::mark_changed_all()
+{
+    for(MeshChangeLog & log : change_logs) log.mark_all();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+uint64_t AbstractMesh<M,V,E,P>::geometry_revision() const
+{
+    // revisions only grow, hence their sum changes if any of them does
+    return rev_geometry.validate(change_logs[CHANGES_VERT_POS].peek_revision() +
+                                 change_logs[CHANGES_VERTS   ].peek_revision());
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+uint64_t AbstractMesh<M,V,E,P>::topology_revision() const
+{
+    return rev_topology.validate(change_logs[CHANGES_VERTS].peek_revision() +
+                                 change_logs[CHANGES_EDGES].peek_revision() +
+                                 change_logs[CHANGES_FACES].peek_revision() +
+                                 change_logs[CHANGES_POLYS].peek_revision());
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class P>
 CINO_INLINE
 std::set<uint> AbstractMesh<M,V,E,P>::vert_n_ring(const uint vid, const uint n) const
@@ -514,6 +589,16 @@ void AbstractMesh<M,V,E,P>::vert_weights(const uint vid, const int type, std::ve
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class P>
+CINO_INLINE
+void AbstractMesh<M,V,E,P>::vert_move(const uint vid, const vec3d & pos)
+{
+    verts.at(vid) = pos;
+    mark_changed(CHANGES_VERT_POS, vid);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class P>
 CINO_INLINE
 void AbstractMesh<M,V,E,P>::vert_weights_uniform(const uint vid, std::vector<std::pair<uint,double>> & wgts) const
@@ -662,6 +747,7 @@ void AbstractMesh<M,V,E,P>::vert_set_color(const Color & c)
     {
         vert_data(vid).color = c;
     }
+    mark_changed(CHANGES_VERT_DATA);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -674,6 +760,7 @@ void AbstractMesh<M,V,E,P>::vert_set_alpha(const float alpha)
     {
         vert_data(vid).color.a = alpha;
     }
+    mark_changed(CHANGES_VERT_DATA);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -867,6 +954,7 @@ void AbstractMesh<M,V,E,P>::edge_set_color(const Color & c)
     {
         edge_data(eid).color = c;
     }
+    mark_changed(CHANGES_EDGE_DATA);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -879,6 +967,7 @@ void AbstractMesh<M,V,E,P>::edge_set_alpha(const float alpha)
     {
         edge_data(eid).color.a = alpha;
     }
+    mark_changed(CHANGES_EDGE_DATA);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -1093,6 +1182,7 @@ void AbstractMesh<M,V,E,P>::poly_set_color(const Color & c)
     {
         poly_data(pid).color = c;
     }
+    mark_changed(CHANGES_POLY_DATA);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -1105,6 +1195,7 @@ void AbstractMesh<M,V,E,P>::poly_set_alpha(const float alpha)
     {
         poly_data(pid).color.a = alpha;
     }
+    mark_changed(CHANGES_POLY_DATA);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -1129,6 +1220,7 @@ void AbstractMesh<M,V,E,P>::poly_color_wrt_label(const bool sorted, const float
         if(sorted) this->poly_data(pid).color = Color::hsv_ramp(n_labels, this->poly_data(pid).label);
         else       this->poly_data(pid).color = Color::scatter(n_labels,l_map.at(this->poly_data(pid).label), s, v);
     }
+    mark_changed(CHANGES_POLY_DATA);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -1147,6 +1239,7 @@ void AbstractMesh<M,V,E,P>::poly_label_wrt_color()
     {
         this->poly_data(pid).label = colormap.at(this->poly_data(pid).color);
     }
+    mark_changed(CHANGES_POLY_DATA);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -1206,6 +1299,7 @@ void AbstractMesh<M,V,E,P>::poly_apply_labels(const std::vector<int> & labels)
     {
         poly_data(pid).label = labels.at(pid);
     }
+    mark_changed(CHANGES_POLY_DATA);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -1218,6 +1312,7 @@ void AbstractMesh<M,V,E,P>::poly_apply_label(const int label)
     {
         poly_data(pid).label = label;
     }
+    mark_changed(CHANGES_POLY_DATA);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -1240,6 +1335,7 @@ void AbstractMesh<M,V,E,P>::edge_apply_labels(const std::vector<int> & labels)
     {
         edge_data(eid).label = labels.at(eid);
     }
+    mark_changed(CHANGES_EDGE_DATA);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -1252,6 +1348,7 @@ void AbstractMesh<M,V,E,P>::edge_apply_label(const int label)
     {
         edge_data(eid).label = label;
     }
+    mark_changed(CHANGES_EDGE_DATA);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -1265,6 +1362,7 @@ void AbstractMesh<M,V,E,P>::vert_apply_labels(const std::vector<int> & labels)
     {
         vert_data(vid).label = labels.at(vid);
     }
+    mark_changed(CHANGES_VERT_DATA);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -1277,6 +1375,7 @@ void AbstractMesh<M,V,E,P>::vert_apply_label(const int label)
     {
         vert_data(vid).label = label;
     }
+    mark_changed(CHANGES_VERT_DATA);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -1291,6 +1390,7 @@ void AbstractMesh<M,V,E,P>::edge_mark_sharp_creases(const float thresh)
         {
             this->edge_data(eid).flags[CREASE] = true;
             this->edge_data(eid).flags[MARKED] = true;
+            mark_changed(CHANGES_EDGE_DATA, eid);
         }
     }
 }
@@ -1344,6 +1444,7 @@ void AbstractMesh<M,V,E,P>::vert_set_flag(const int flag, const bool b)
     {
         this->vert_data(vid).flags[flag] = b;
     }
+    mark_changed(CHANGES_VERT_DATA);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -1356,6 +1457,7 @@ void AbstractMesh<M,V,E,P>::vert_set_flag(const int flag, const bool b, const st
     {
         this->vert_data(vid).flags[flag] = b;
     }
+    mark_changed(CHANGES_VERT_DATA, vids);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -1368,6 +1470,7 @@ void AbstractMesh<M,V,E,P>::edge_set_flag(const int flag, const bool b)
     {
         this->edge_data(eid).flags[flag] = b;
     }
+    mark_changed(CHANGES_EDGE_DATA);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -1380,6 +1483,7 @@ void AbstractMesh<M,V,E,P>::edge_set_flag(const int flag, const bool b, const st
     {
         this->edge_data(eid).flags[flag] = b;
     }
+    mark_changed(CHANGES_EDGE_DATA, eids);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -1392,6 +1496,7 @@ void AbstractMesh<M,V,E,P>::poly_set_flag(const int flag, const bool b)
     {
         this->poly_data(pid).flags[flag] = b;
     }
+    mark_changed(CHANGES_POLY_DATA);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -1404,5 +1509,6 @@ void AbstractMesh<M,V,E,P>::poly_set_flag(const int flag, const bool b, const st
     {
         this->poly_data(pid).flags[flag] = b;
     }
+    mark_changed(CHANGES_POLY_DATA, pids);
 }
  }
@@ -37,7 +37,9 @@
 #define CINO_ABSTRACT_MESH_H
 
 #include <set>
+#include <memory>
 #include <vector>
+#include <stdint.h>
 #include <sys/types.h>
 
 #include <cinolib/geometry/aabb.h>
@@ -45,6 +47,8 @@
 #include <cinolib/color.h>
 #include <cinolib/symbols.h>
 #include <cinolib/ipair.h>
+#include <cinolib/mesh_revision.h>
+#include <cinolib/adjacency_lists.h>
 
 typedef enum
 {
@@ -61,6 +65,8 @@ MeshType;
 namespace cinolib
 {
 
+class OperatorCache; // see operator_cache.h
+
 template<class M, // mesh attributes
          class V, // vert attributes
          class E, // edge attributes
@@ -80,12 +86,19 @@ class AbstractMesh
         std::vector<E> e_data;
         std::vector<P> p_data;
 
-        std::vector<std::vector<uint>> v2v; // vert to vert adjacency
-        std::vector<std::vector<uint>> v2e; // vert to edge adjacency
-        std::vector<std::vector<uint>> v2p; // vert to poly adjacency
-        std::vector<std::vector<uint>> e2p; // edge to poly adjacency        
-        std::vector<std::vector<uint>> p2e; // poly to edge adjacency
-        std::vector<std::vector<uint>> p2p; // poly to poly adjacency
+        MeshAdjacency v2v; // vert to vert adjacency
+        MeshAdjacency v2e; // vert to edge adjacency
+        MeshAdjacency v2p; // vert to poly adjacency
+        MeshAdjacency e2p; // edge to poly adjacency
+        MeshAdjacency p2e; // poly to edge adjacency
+        MeshAdjacency p2p; // poly to poly adjacency
+
+        MeshRevision rev_geometry; // revision of vertex positions
+        MeshRevision rev_topology; // revision of the connectivity
+
+        MeshChangeLog change_logs[CHANGES_NUM_LOGS]; // per attribute logs of changed elements
+
+        std::shared_ptr<OperatorCache> op_cache; // optional cache of differential operators
 
     public:
 
@@ -174,22 +187,64 @@ class AbstractMesh
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-                const std::vector<uint> & adj_v2v(const uint vid) const { return v2v.at(vid); }
-                      std::vector<uint> & adj_v2v(const uint vid)       { return v2v.at(vid); }
-                const std::vector<uint> & adj_v2e(const uint vid) const { return v2e.at(vid); }
-                      std::vector<uint> & adj_v2e(const uint vid)       { return v2e.at(vid); }
-                const std::vector<uint> & adj_v2p(const uint vid) const { return v2p.at(vid); }
-                      std::vector<uint> & adj_v2p(const uint vid)       { return v2p.at(vid); }
-                      std::vector<uint>   adj_e2v(const uint eid) const;
-                      std::vector<uint>   adj_e2e(const uint eid) const;
-                const std::vector<uint> & adj_e2p(const uint eid) const { return e2p.at(eid); }
-                      std::vector<uint> & adj_e2p(const uint eid)       { return e2p.at(eid); }
-                const std::vector<uint> & adj_p2e(const uint pid) const { return p2e.at(pid); }
-                      std::vector<uint> & adj_p2e(const uint pid)       { return p2e.at(pid); }
-                const std::vector<uint> & adj_p2p(const uint pid) const { return p2p.at(pid); }
-                      std::vector<uint> & adj_p2p(const uint pid)       { return p2p.at(pid); }
-        virtual const std::vector<uint> & adj_p2v(const uint pid) const = 0;
-        virtual       std::vector<uint> & adj_p2v(const uint pid)       = 0;
+                MeshAdjacency::const_reference adj_v2v(const uint vid) const { return v2v.at(vid); }
+                MeshAdjacency::reference       adj_v2v(const uint vid)       { return v2v.at(vid); }
+                MeshAdjacency::const_reference adj_v2e(const uint vid) const { return v2e.at(vid); }
+                MeshAdjacency::reference       adj_v2e(const uint vid)       { return v2e.at(vid); }
+                MeshAdjacency::const_reference adj_v2p(const uint vid) const { return v2p.at(vid); }
+                MeshAdjacency::reference       adj_v2p(const uint vid)       { return v2p.at(vid); }
+                std::vector<uint>              adj_e2v(const uint eid) const;
+                std::vector<uint>              adj_e2e(const uint eid) const;
+                MeshAdjacency::const_reference adj_e2p(const uint eid) const { return e2p.at(eid); }
+                MeshAdjacency::reference       adj_e2p(const uint eid)       { return e2p.at(eid); }
+                MeshAdjacency::const_reference adj_p2e(const uint pid) const { return p2e.at(pid); }
+                MeshAdjacency::reference       adj_p2e(const uint pid)       { return p2e.at(pid); }
+                MeshAdjacency::const_reference adj_p2p(const uint pid) const { return p2p.at(pid); }
+                MeshAdjacency::reference       adj_p2p(const uint pid)       { return p2p.at(pid); }
+        virtual const std::vector<uint> &      adj_p2v(const uint pid) const = 0;
+        virtual       std::vector<uint> &      adj_p2v(const uint pid)       = 0;
+
+        // relations returned as MeshAdjacency references are stored in CSR format if
+        // CINOLIB_USES_CSR_ADJACENCY is defined (see adjacency_lists.h). Editing operators
+        // may then leave unused memory behind, which compact_adjacency() releases. It is
+        // called at the end of init(), and does nothing with the default storage
+        virtual void   compact_adjacency();
+        virtual size_t adjacency_memory_usage_in_bytes() const;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // Stamps identifying the current state of vertex positions and connectivity.
+        // They change when the change logs below report an edit (O(1) to query), and
+        // are never shared by meshes with different data (see mesh_revision.h)
+        //
+        uint64_t geometry_revision() const;
+        uint64_t topology_revision() const;
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // Logs of the elements changed by the editing operators, one per attribute
+        // (see CHANGES_VERT_POS, CHANGES_POLYS,... in mesh_revision.h). Consumers of mesh
+        // data use them to update incrementally. Changes done by writing directly into
+        // the mesh (e.g. through the non const vert() or poly_data() accessors) must be
+        // recorded by the caller with mark_changed(). Vertex positions can be safely
+        // edited with vert_move(), which records the change. Logs store element ids only
+        // after they have been queried once, hence meshes nobody listens to pay no memory
+        //
+        const MeshChangeLog & changes(const int what) const { return change_logs[what]; }
+              void            mark_changed(const int what, const uint id) { change_logs[what].mark(id); }
+              void            mark_changed(const int what, const std::vector<uint> & ids) { change_logs[what].mark(ids); }
+              void            mark_changed(const int what) { change_logs[what].mark_all(); }
+              void            mark_changed_all();
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // Opt-in cache of differential operators (e.g. laplacian, mass and gradient
+        // matrices), keyed by the revisions above. It is empty by default, and can be
+        // enabled with enable_operator_cache(). Copies of the mesh share the same cache
+        // (see operator_cache.h for details)
+        //
+        const std::shared_ptr<OperatorCache> & operator_cache() const { return op_cache; }
+              void                             operator_cache_set(const std::shared_ptr<OperatorCache> & c) { op_cache = c; }
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
@@ -213,6 +268,7 @@ class AbstractMesh
 
           const vec3d          & vert                       (const uint vid) const { return verts.at(vid); }
                 vec3d          & vert                       (const uint vid)       { return verts.at(vid); }
+                void             vert_move                  (const uint vid, const vec3d & pos);
                 void             vert_weights_uniform       (const uint vid, std::vector<std::pair<uint,double>> & wgts) const;
                 std::set<uint>   vert_n_ring                (const uint vid, const uint n) const;
                 bool             verts_are_adjacent         (const uint vid0, const uint vid1) const;
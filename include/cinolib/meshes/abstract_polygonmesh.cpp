@@ -41,8 +41,12 @@
 #include <cinolib/geometry/polygon_utils.h>
 #include <cinolib/vector_serialization.h>
 #include <cinolib/how_many_seconds.h>
+#include <cinolib/string_utilities.h>
 #include <cinolib/deg_rad.h>
+#include <cinolib/bulk_connectivity.h>
+#include <cinolib/parallel_for.h>
 #include <unordered_set>
+#include <climits>
 #include <cinolib/ANSI_color_codes.h>
 #include <queue>
 
@@ -69,8 +73,14 @@ void AbstractPolygonMesh<M,V,E,P>::load(const char * filename)
     std::string str(filename);
     std::string filetype = str.substr(str.size()-4,4);
 
-    if (filetype.compare(".off") == 0 ||
-        filetype.compare(".OFF") == 0)
+    if (get_file_extension(str).compare("cino") == 0 ||
+        get_file_extension(str).compare("CINO") == 0)
+    {
+        load_CINO(filename);
+        return;
+    }
+    else if (filetype.compare(".off") == 0 ||
+             filetype.compare(".OFF") == 0)
     {
         read_OFF(filename, pos, poly_pos, poly_col);
     }
@@ -134,6 +144,11 @@ void AbstractPolygonMesh<M,V,E,P>::save(const char * filename) const
 
         write_STL(filename, serialized_xyz_from_vec3d(this->vector_verts()), this->polys, normals);
     }
+    else if (get_file_extension(str).compare("cino") == 0 ||
+             get_file_extension(str).compare("CINO") == 0)
+    {
+        save_CINO(filename);
+    }
     else
     {
         std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : write() : file format not supported yet " << std::endl;
@@ -142,6 +157,156 @@ void AbstractPolygonMesh<M,V,E,P>::save(const char * filename) const
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class P>
+CINO_INLINE
+void AbstractPolygonMesh<M,V,E,P>::save_CINO(const char * filename, const bool with_adjacency) const
+{
+    CINO_writer w(filename, this->mesh_type());
+    w.add_array(CINO_VERT_XYZ, this->verts);
+    w.add_lists(CINO_POLYS,    this->polys);
+
+    std::vector<vec3d> uvw(this->num_verts());
+    for(uint vid=0; vid<this->num_verts(); ++vid) uvw.at(vid) = this->vert_data(vid).uvw;
+    w.add_array(CINO_VERT_UVW, uvw);
+
+    // labels and colors are stored only if they are not all set to default
+    V v_def;
+    P p_def;
+    bool has_vert_labels = false, has_poly_labels = false, has_poly_colors = false;
+    for(uint vid=0; vid<this->num_verts(); ++vid) has_vert_labels |= (this->vert_data(vid).label!=v_def.label);
+    for(uint pid=0; pid<this->num_polys(); ++pid) has_poly_labels |= (this->poly_data(pid).label!=p_def.label);
+    for(uint pid=0; pid<this->num_polys(); ++pid) has_poly_colors |= (this->poly_data(pid).color!=p_def.color);
+    if(has_vert_labels) w.add_array(CINO_VERT_LABEL, this->vector_vert_labels());
+    if(has_poly_labels) w.add_array(CINO_POLY_LABEL, this->vector_poly_labels());
+    if(has_poly_colors) w.add_array(CINO_POLY_COLOR, this->vector_poly_colors());
+
+    if(with_adjacency)
+    {
+        w.add_array(CINO_EDGES, this->edges);
+        w.add_lists(CINO_V2V,   this->v2v);
+        w.add_lists(CINO_V2E,   this->v2e);
+        w.add_lists(CINO_V2P,   this->v2p);
+        w.add_lists(CINO_E2P,   this->e2p);
+        w.add_lists(CINO_P2E,   this->p2e);
+        w.add_lists(CINO_P2P,   this->p2p);
+    }
+    w.close();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void AbstractPolygonMesh<M,V,E,P>::load_CINO(const char * filename)
+{
+    std::chrono::high_resolution_clock::time_point t0 = std::chrono::high_resolution_clock::now();
+
+    CINO_reader r(filename);
+    if(!r.is_open()) return;
+
+    // the file can be loaded either in a mesh of the same type or in a general polygon mesh
+    if(r.mesh_type()!=this->mesh_type() && !(this->mesh_type()==POLYGONMESH && r.mesh_type()<POLYGONMESH))
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : load() : " << filename << " contains a different type of mesh" << std::endl;
+        return;
+    }
+
+    std::vector<vec3d>             verts;
+    std::vector<std::vector<uint>> polys;
+    if(!r.get_array(CINO_VERT_XYZ, verts) || !r.get_lists(CINO_POLYS, polys))
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : load() : " << filename << " does not contain a mesh" << std::endl;
+        return;
+    }
+
+    uint nv = verts.size();
+    uint np = polys.size();
+    if(!CINO_ids_in_range(polys, nv))
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : load() : " << filename << " contains polygons referring to non existing vertices" << std::endl;
+        return;
+    }
+
+    // elements must be consistent with the mesh type (e.g. no quads in a Trimesh)
+    uint min_size = 3, max_size = UINT_MAX;
+    if(this->mesh_type()==TRIMESH)  min_size = max_size = 3;
+    if(this->mesh_type()==QUADMESH) min_size = max_size = 4;
+    if(!CINO_sizes_in_range(polys, min_size, max_size))
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : load() : " << filename << " contains polygons with a wrong number of vertices for this mesh type" << std::endl;
+        return;
+    }
+
+    // if the adjacency is stored in the file, copy it rather than recomputing it.
+    // If any list is missing, has the wrong size or refers to non existing elements
+    // the stored adjacency is discarded, and the connectivity is rebuilt from scratch
+    bool ok = r.get_array(CINO_EDGES, this->edges);
+    uint ne = this->edges.size()/2;
+    ok = ok && this->edges.size()==2*ne && CINO_ids_in_range(this->edges, nv)
+            && r.get_lists(CINO_V2V, this->v2v) && this->v2v.size()==nv && CINO_ids_in_range(this->v2v, nv)
+            && r.get_lists(CINO_V2E, this->v2e) && this->v2e.size()==nv && CINO_ids_in_range(this->v2e, ne)
+            && r.get_lists(CINO_V2P, this->v2p) && this->v2p.size()==nv && CINO_ids_in_range(this->v2p, np)
+            && r.get_lists(CINO_E2P, this->e2p) && this->e2p.size()==ne && CINO_ids_in_range(this->e2p, np)
+            && r.get_lists(CINO_P2E, this->p2e) && this->p2e.size()==np && CINO_ids_in_range(this->p2e, ne)
+            && r.get_lists(CINO_P2P, this->p2p) && this->p2p.size()==np && CINO_ids_in_range(this->p2p, np);
+    if(ok)
+    {
+        this->verts.swap(verts);
+        this->polys.swap(polys);
+        this->mark_changed_all();
+        this->v_data.resize(nv);
+        this->e_data.resize(ne);
+        this->p_data.resize(np);
+        if(this->mesh_data().update_bbox) this->update_bbox();
+        this->poly_triangles.resize(np);
+        if(this->mesh_data().update_normals) update_p_normals();
+        update_p_tessellations();
+        if(this->mesh_data().update_normals) update_v_normals();
+        for(uint eid=0; eid<this->num_edges(); ++eid)
+        {
+            this->edge_data(eid).flags[MARKED] = (this->edge_is_boundary(eid) || !this->edge_is_manifold(eid));
+        }
+        std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+
+        std::cout << "load mesh\t"     <<
+                     this->num_verts() << "V / " <<
+                     this->num_edges() << "E / " <<
+                     this->num_polys() << "P  [" <<
+                     how_many_seconds(t0,t1) << "s]" << std::endl;
+    }
+    else
+    {
+        this->clear();
+        this->mesh_data().filename = std::string(filename);
+        init(verts, polys);
+    }
+
+    // attributes
+    std::vector<vec3d> uvw;
+    if(r.get_array(CINO_VERT_UVW, uvw) && uvw.size()==this->num_verts())
+    {
+        for(uint vid=0; vid<this->num_verts(); ++vid) this->vert_data(vid).uvw = uvw.at(vid);
+    }
+    else this->copy_xyz_to_uvw(UVW_param);
+
+    std::vector<int> labels;
+    if(r.get_array(CINO_VERT_LABEL, labels) && labels.size()==this->num_verts())
+    {
+        for(uint vid=0; vid<this->num_verts(); ++vid) this->vert_data(vid).label = labels.at(vid);
+    }
+    if(r.get_array(CINO_POLY_LABEL, labels) && labels.size()==this->num_polys())
+    {
+        for(uint pid=0; pid<this->num_polys(); ++pid) this->poly_data(pid).label = labels.at(pid);
+    }
+    std::vector<Color> colors;
+    if(r.get_array(CINO_POLY_COLOR, colors) && colors.size()==this->num_polys())
+    {
+        for(uint pid=0; pid<this->num_polys(); ++pid) this->poly_data(pid).color = colors.at(pid);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class P>
 CINO_INLINE
 void AbstractPolygonMesh<M,V,E,P>::clear()
@@ -159,27 +324,13 @@ void AbstractPolygonMesh<M,V,E,P>::init(const std::vector<vec3d>             & v
 {
     std::chrono::high_resolution_clock::time_point t0 = std::chrono::high_resolution_clock::now();
 
-    // pre-allocate memory
-    uint nv = verts.size();
-    uint np = polys.size();
-    uint ne = 1.5*np;
-    this->verts.reserve(nv);
-    this->edges.reserve(ne*2);
-    this->polys.reserve(np);
-    this->poly_triangles.reserve(np);
-    this->v2v.reserve(nv);
-    this->v2e.reserve(nv);
-    this->v2p.reserve(nv);
-    this->e2p.reserve(ne);
-    this->p2e.reserve(np);
-    this->p2p.reserve(np);
-    this->v_data.reserve(nv);
-    this->e_data.reserve(ne);
-    this->p_data.reserve(np);
-
-    // initialize mesh connectivity (and normals)
-    for(auto v : verts) this->vert_add(v);
-    for(auto p : polys) this->poly_add(p);
+    if(this->num_verts()>0)
+    {
+        // the mesh is not empty: append the new elements incrementally
+        for(auto v : verts) this->vert_add(v);
+        for(auto p : polys) this->poly_add(p);
+    }
+    else init_connectivity(verts, polys);
 
     if(this->mesh_data().update_normals) this->update_v_normals();
 
@@ -201,6 +352,111 @@ void AbstractPolygonMesh<M,V,E,P>::init(const std::vector<vec3d>             & v
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class P>
+CINO_INLINE
+void AbstractPolygonMesh<M,V,E,P>::init_connectivity(const std::vector<vec3d>             & verts,
+                                                     const std::vector<std::vector<uint>> & polys)
+{
+    // Bulk version of a sequence of vert_add/poly_add, that builds all the mesh
+    // connectivity in a few linear passes (see bulk_connectivity.h). Element ids
+    // and the order of the adjacency lists are the same of the incremental version
+
+    assert(this->num_verts()==0);
+
+    // discard duplicated polygons (as poly_add would do)
+    std::vector<std::vector<uint>> tmp_polys;
+    if(this->mesh_data().check_duplicates)
+    {
+        std::vector<uint> first_occurrence;
+        uint n_dupl = duplicated_elements(polys, first_occurrence);
+        if(n_dupl>0)
+        {
+            std::cout << ANSI_fg_color_red << "WARNING: discarded " << n_dupl << " duplicated polys!" << ANSI_fg_color_default << std::endl;
+            tmp_polys.reserve(polys.size()-n_dupl);
+            for(uint pid=0; pid<polys.size(); ++pid)
+            {
+                if(first_occurrence.at(pid)==pid) tmp_polys.push_back(polys.at(pid));
+            }
+        }
+    }
+    const std::vector<std::vector<uint>> & p_list = tmp_polys.empty() ? polys : tmp_polys;
+#ifndef NDEBUG
+    for(const auto & p : p_list) for(uint vid : p) assert(vid < verts.size());
+#endif
+
+    uint nv = verts.size();
+    uint np = p_list.size();
+
+    this->verts  = verts;
+    this->polys  = p_list;
+    this->v_data.resize(nv);
+    this->p_data.resize(np);
+    if(this->mesh_data().update_bbox) this->update_bbox();
+
+    unique_edges_from_polys(this->polys, nv, this->edges, this->p2e);
+    uint ne = this->num_edges();
+    this->e_data.resize(ne);
+
+    // vert to edge/vert adjacency (in order of edge creation)
+    std::vector<uint> valence(nv,0);
+    for(uint vid : this->edges) ++valence.at(vid);
+    this->v2v.resize(nv);
+    this->v2e.resize(nv);
+    for(uint vid=0; vid<nv; ++vid)
+    {
+        this->v2v.at(vid).reserve(valence.at(vid));
+        this->v2e.at(vid).reserve(valence.at(vid));
+    }
+    for(uint eid=0; eid<ne; ++eid)
+    {
+        uint vid0 = this->edge_vert_id(eid,0);
+        uint vid1 = this->edge_vert_id(eid,1);
+        this->v2v.at(vid1).push_back(vid0);
+        this->v2v.at(vid0).push_back(vid1);
+        this->v2e.at(vid0).push_back(eid);
+        this->v2e.at(vid1).push_back(eid);
+    }
+
+    // vert/edge to poly adjacency (in order of poly creation)
+    std::fill(valence.begin(), valence.end(), 0);
+    for(const auto & p : this->polys) for(uint vid : p) ++valence.at(vid);
+    this->v2p.resize(nv);
+    for(uint vid=0; vid<nv; ++vid) this->v2p.at(vid).reserve(valence.at(vid));
+    std::vector<uint> e_valence(ne,0);
+    for(const auto & list : this->p2e) for(uint eid : list) ++e_valence.at(eid);
+    this->e2p.resize(ne);
+    for(uint eid=0; eid<ne; ++eid) this->e2p.at(eid).reserve(e_valence.at(eid));
+    for(uint pid=0; pid<np; ++pid)
+    {
+        for(uint vid : this->polys.at(pid)) this->v2p.at(vid).push_back(pid);
+        for(uint eid : this->p2e.at(pid))   this->e2p.at(eid).push_back(pid);
+    }
+
+    // poly to poly adjacency. Since e2p lists are sorted by pid, when poly pid
+    // is processed its adjacency with polys having lower ids is already known
+    this->p2p.resize(np);
+    for(uint pid=0; pid<np; ++pid)
+    {
+        this->p2p.at(pid).reserve(this->p2e.at(pid).size());
+        for(uint eid : this->p2e.at(pid))
+        for(uint nbr : this->e2p.at(eid))
+        {
+            if(nbr>=pid) break;
+            if(CONTAINS_VEC(this->p2p.at(pid),nbr)) continue;
+            this->p2p.at(nbr).push_back(pid);
+            this->p2p.at(pid).push_back(nbr);
+        }
+    }
+
+    this->poly_triangles.resize(np);
+    if(this->mesh_data().update_normals) update_p_normals();
+    update_p_tessellations();
+    this->compact_adjacency();
+    this->mark_changed_all();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class P>
 CINO_INLINE
 void AbstractPolygonMesh<M,V,E,P>::init(      std::vector<vec3d>             & pos,       // vertex xyz positions
@@ -289,6 +545,7 @@ void AbstractPolygonMesh<M,V,E,P>::update_p_tessellation(const uint pid)
     // apply earcut algorithm to get a valid triangulation
 
     poly_triangles.at(pid).clear();
+    poly_triangles.at(pid).reserve(3*(this->verts_per_poly(pid)-2));
     std::vector<vec3d> n;
     for(uint i=2; i<this->verts_per_poly(pid); ++i)
     {
@@ -364,10 +621,10 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 void AbstractPolygonMesh<M,V,E,P>::update_p_normals()
 {
-    for(uint pid=0; pid<this->num_polys(); ++pid)
+    PARALLEL_FOR(0, this->num_polys(), 1000, [&](const uint pid)
     {
         update_p_normal(pid);
-    }
+    });
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -376,10 +633,10 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 void AbstractPolygonMesh<M,V,E,P>::update_p_tessellations()
 {
-    for(uint pid=0; pid<this->num_polys(); ++pid)
+    PARALLEL_FOR(0, this->num_polys(), 1000, [&](const uint pid)
     {
         update_p_tessellation(pid);
-    }
+    });
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -388,10 +645,10 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 void AbstractPolygonMesh<M,V,E,P>::update_v_normals()
 {
-    for(uint vid=0; vid<this->num_verts(); ++vid)
+    PARALLEL_FOR(0, this->num_verts(), 1000, [&](const uint vid)
     {
         update_v_normal(vid);
-    }
+    });
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -406,6 +663,48 @@ void AbstractPolygonMesh<M,V,E,P>::update_normals()
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class P>
+CINO_INLINE
+void AbstractPolygonMesh<M,V,E,P>::update_normals_incremental()
+{
+    const int logs[3] = { CHANGES_VERT_POS, CHANGES_VERTS, CHANGES_POLYS };
+    std::vector<uint> ids[3];
+    bool incremental = true;
+    for(int i=0; i<3; ++i)
+    {
+        incremental &= this->changes(logs[i]).changed_since(normals_rev[i], ids[i]);
+        normals_rev[i] = this->changes(logs[i]).revision();
+    }
+    if(!incremental)
+    {
+        update_normals();
+        return;
+    }
+
+    // changed polys, and polys incident to changed verts
+    std::unordered_set<uint> polys;
+    for(uint pid : ids[2]) if(pid<this->num_polys()) polys.insert(pid);
+    for(int i=0; i<2; ++i)
+    for(uint vid : ids[i])
+    {
+        if(vid<this->num_verts()) polys.insert(this->adj_v2p(vid).begin(), this->adj_v2p(vid).end());
+    }
+
+    // verts of the polys above, and changed verts (which may have lost all their polys)
+    std::unordered_set<uint> verts;
+    for(uint pid : polys) verts.insert(this->adj_p2v(pid).begin(), this->adj_p2v(pid).end());
+    for(int i=0; i<2; ++i)
+    for(uint vid : ids[i])
+    {
+        if(vid<this->num_verts()) verts.insert(vid);
+    }
+
+    for(uint pid : polys) update_p_normal(pid);
+    for(uint vid : verts) update_v_normal(vid);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class P>
 CINO_INLINE
 int AbstractPolygonMesh<M,V,E,P>::Euler_characteristic() const
@@ -870,6 +1169,7 @@ uint AbstractPolygonMesh<M,V,E,P>::vert_add(const vec3d & pos)
     uint vid = this->num_verts();
     //
     this->verts.push_back(pos);
+    this->mark_changed(CHANGES_VERTS, vid);
     //
     V data;
     this->v_data.push_back(data);
@@ -922,10 +1222,12 @@ void AbstractPolygonMesh<M,V,E,P>::vert_switch_id(const uint vid0, const uint vi
     if (vid0 == vid1) return;
 
     std::swap(this->verts.at(vid0),  this->verts.at(vid1));
+    this->mark_changed(CHANGES_VERTS, vid0);
+    this->mark_changed(CHANGES_VERTS, vid1);
     std::swap(this->v_data.at(vid0), this->v_data.at(vid1));
-    std::swap(this->v2v.at(vid0),    this->v2v.at(vid1));
-    std::swap(this->v2e.at(vid0),    this->v2e.at(vid1));
-    std::swap(this->v2p.at(vid0),    this->v2p.at(vid1));
+    this->v2v.at(vid0).swap(this->v2v.at(vid1));
+    this->v2e.at(vid0).swap(this->v2e.at(vid1));
+    this->v2p.at(vid0).swap(this->v2p.at(vid1));
 
     std::unordered_set<uint> verts_to_update;
     verts_to_update.insert(this->adj_v2v(vid0).begin(), this->adj_v2v(vid0).end());
@@ -958,6 +1260,9 @@ void AbstractPolygonMesh<M,V,E,P>::vert_switch_id(const uint vid0, const uint vi
         }
     }
 
+    for(uint eid : edges_to_update) this->mark_changed(CHANGES_EDGES, eid);
+    for(uint pid : polys_to_update) this->mark_changed(CHANGES_POLYS, pid);
+
     for(uint pid : polys_to_update)
     {
         for(uint & vid : this->polys.at(pid))
@@ -991,6 +1296,7 @@ void AbstractPolygonMesh<M,V,E,P>::vert_remove_unreferenced(const uint vid)
     this->v2v.at(vid).clear();
     this->v2e.at(vid).clear();
     this->v2p.at(vid).clear();
+    this->mark_changed(CHANGES_VERTS, vid);
     vert_switch_id(vid, this->num_verts()-1);
     this->verts.pop_back();
     this->v_data.pop_back();
@@ -1095,6 +1401,9 @@ uint AbstractPolygonMesh<M,V,E,P>::edge_add(const uint vid0, const uint vid1)
     //
     this->edges.push_back(vid0);
     this->edges.push_back(vid1);
+    this->mark_changed(CHANGES_EDGES, eid);
+    this->mark_changed(CHANGES_VERTS, vid0);
+    this->mark_changed(CHANGES_VERTS, vid1);
     //
     this->e2p.push_back(std::vector<uint>());
     //
@@ -1121,8 +1430,10 @@ void AbstractPolygonMesh<M,V,E,P>::edge_switch_id(const uint eid0, const uint ei
     if (eid0 == eid1) return;
 
     for(uint off=0; off<2; ++off) std::swap(this->edges.at(2*eid0+off), this->edges.at(2*eid1+off));
+    this->mark_changed(CHANGES_EDGES, eid0);
+    this->mark_changed(CHANGES_EDGES, eid1);
 
-    std::swap(this->e2p.at(eid0),    this->e2p.at(eid1));
+    this->e2p.at(eid0).swap(this->e2p.at(eid1));
     std::swap(this->e_data.at(eid0), this->e_data.at(eid1));
 
     std::unordered_set<uint> verts_to_update;
@@ -1170,6 +1481,7 @@ CINO_INLINE
 void AbstractPolygonMesh<M,V,E,P>::edge_remove_unreferenced(const uint eid)
 {
     this->e2p.at(eid).clear();
+    this->mark_changed(CHANGES_EDGES, eid);
     edge_switch_id(eid, this->num_edges()-1);
     this->edges.resize(this->edges.size()-2);
     this->e_data.pop_back();
@@ -1389,9 +1701,11 @@ void AbstractPolygonMesh<M,V,E,P>::poly_switch_id(const uint pid0, const uint pi
 
     std::swap(this->polys.at(pid0),          this->polys.at(pid1));
     std::swap(this->p_data.at(pid0),         this->p_data.at(pid1));
-    std::swap(this->p2e.at(pid0),            this->p2e.at(pid1));
-    std::swap(this->p2p.at(pid0),            this->p2p.at(pid1));
+    this->p2e.at(pid0).swap(this->p2e.at(pid1));
+    this->p2p.at(pid0).swap(this->p2p.at(pid1));
     std::swap(this->poly_triangles.at(pid0), this->poly_triangles.at(pid1));
+    this->mark_changed(CHANGES_POLYS, pid0);
+    this->mark_changed(CHANGES_POLYS, pid1);
 
     std::unordered_set<uint> verts_to_update;
     verts_to_update.insert(this->adj_p2v(pid0).begin(), this->adj_p2v(pid0).end());
@@ -1450,6 +1764,8 @@ uint AbstractPolygonMesh<M,V,E,P>::poly_add(const std::vector<uint> & vlist)
 
     uint pid = this->num_polys();
     this->polys.push_back(vlist);
+    this->mark_changed(CHANGES_POLYS, pid);
+    this->mark_changed(CHANGES_VERTS, vlist);
 
     P data;
     this->p_data.push_back(data);
@@ -1526,6 +1842,7 @@ void AbstractPolygonMesh<M,V,E,P>::poly_remove(const uint pid)
     std::set<uint,std::greater<uint>> dangling_edges; // higher ids first
 
     // disconnect from vertices
+    this->mark_changed(CHANGES_VERTS, this->adj_p2v(pid));
     for(uint vid : this->adj_p2v(pid))
     {
         REMOVE_FROM_VEC(this->v2p.at(vid), pid);
@@ -1575,6 +1892,7 @@ void AbstractPolygonMesh<M,V,E,P>::poly_remove_unreferenced(const uint pid)
     this->polys.at(pid).clear();
     this->p2e.at(pid).clear();
     this->p2p.at(pid).clear();
+    this->mark_changed(CHANGES_POLYS, pid);
     poly_switch_id(pid, this->num_polys()-1);
     this->polys.pop_back();
     this->p_data.pop_back();
@@ -1658,6 +1976,7 @@ CINO_INLINE
 void AbstractPolygonMesh<M,V,E,P>::poly_flip_winding_order(const uint pid)
 {
     std::reverse(this->polys.at(pid).begin(), this->polys.at(pid).end());
+    this->mark_changed(CHANGES_POLYS, pid);
 
     if(this->mesh_data().update_normals)
     {
@@ -55,6 +55,8 @@ class AbstractPolygonMesh : public AbstractMesh<M,V,E,P>
         std::vector<std::vector<uint>> poly_triangles; // triangles covering each quad. Useful for
                                                        // robust normal estimation and rendering
 
+        uint64_t normals_rev[3] = { 0, 0, 0 }; // revisions of the change logs seen by update_normals_incremental
+
     public:
 
         explicit AbstractPolygonMesh() : AbstractMesh<M,V,E,P>() {}
@@ -64,6 +66,7 @@ class AbstractPolygonMesh : public AbstractMesh<M,V,E,P>
 
         void load(const char * filename) override;
         void save(const char * filename) const override;
+        void save_CINO(const char * filename, const bool with_adjacency = true) const;
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
@@ -78,9 +81,19 @@ class AbstractPolygonMesh : public AbstractMesh<M,V,E,P>
                   const std::vector<std::vector<uint>> & poly_nor,  // polygons with references to nor
                   const std::vector<Color>             & poly_col); // per polygon colors
 
+    protected:
+
+        void init_connectivity(const std::vector<vec3d>             & verts,
+                               const std::vector<std::vector<uint>> & polys);
+        void load_CINO(const char * filename);
+
+    public:
+
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
                 void update_normals() override;
+                void update_normals_incremental(); // only updates the normals affected by the changes logged
+                                                   // after the previous call (see AbstractMesh::changes())
                 void update_p_tessellation(const uint pid);
         virtual void update_p_normal(const uint pid);
                 void update_v_normal(const uint vid);
@@ -37,7 +37,11 @@
 #include <cinolib/geometry/triangle.h>
 #include <cinolib/geometry/polygon_utils.h>
 #include <cinolib/how_many_seconds.h>
+#include <cinolib/bulk_connectivity.h>
+#include <cinolib/parallel_for.h>
+#include <cinolib/io/read_write.h>
 #include <unordered_set>
+#include <climits>
 #include <unordered_map>
 #include <cinolib/ANSI_color_codes.h>
 #include <queue>
@@ -67,6 +71,34 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::clear()
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void AbstractPolyhedralMesh<M,V,E,F,P>::compact_adjacency()
+{
+    AbstractMesh<M,V,E,P>::compact_adjacency();
+    compact(v2f);
+    compact(e2f);
+    compact(f2e);
+    compact(f2f);
+    compact(f2p);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+size_t AbstractPolyhedralMesh<M,V,E,F,P>::adjacency_memory_usage_in_bytes() const
+{
+    return AbstractMesh<M,V,E,P>::adjacency_memory_usage_in_bytes() +
+           memory_usage_in_bytes(v2f) +
+           memory_usage_in_bytes(e2f) +
+           memory_usage_in_bytes(f2e) +
+           memory_usage_in_bytes(f2f) +
+           memory_usage_in_bytes(f2p);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void AbstractPolyhedralMesh<M,V,E,F,P>::init(const std::vector<vec3d>             & verts,
@@ -104,9 +136,53 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::init(const std::vector<vec3d>
     this->face_triangles.reserve(nf);
     this->polys_face_winding.reserve(np);
 
-    for(auto v : verts) vert_add(v);
-    for(auto f : faces) face_add(f);
-    for(uint pid=0; pid<polys.size(); ++pid) this->poly_add(polys.at(pid), polys_face_winding.at(pid));
+    if(this->num_verts()>0)
+    {
+        // the mesh is not empty: append the new elements incrementally
+        for(auto v : verts) vert_add(v);
+        for(auto f : faces) face_add(f);
+        for(uint pid=0; pid<polys.size(); ++pid) this->poly_add(polys.at(pid), polys_face_winding.at(pid));
+    }
+    else
+    {
+        std::vector<uint> first_occurrence;
+        if(this->mesh_data().check_duplicates && duplicated_elements(faces, first_occurrence)>0)
+        {
+            // discard duplicated faces, and update poly faces (and windings) accordingly
+            std::cout << ANSI_fg_color_red << "WARNING: discarded duplicated faces!" << ANSI_fg_color_default << std::endl;
+            std::vector<std::vector<uint>> tmp_faces;
+            std::vector<uint> new_fid(faces.size());
+            for(uint fid=0; fid<faces.size(); ++fid)
+            {
+                if(first_occurrence.at(fid)==fid)
+                {
+                    new_fid.at(fid) = tmp_faces.size();
+                    tmp_faces.push_back(faces.at(fid));
+                }
+                else new_fid.at(fid) = new_fid.at(first_occurrence.at(fid));
+            }
+            init_connectivity(verts, tmp_faces);
+            std::vector<std::vector<uint>> tmp_polys   = polys;
+            std::vector<std::vector<bool>> tmp_winding = polys_face_winding;
+            for(uint pid=0; pid<polys.size(); ++pid)
+            {
+                std::vector<uint> & flist = tmp_polys.at(pid);
+                std::vector<bool> & w     = tmp_winding.at(pid);
+                for(uint i=0; i<flist.size(); ++i)
+                {
+                    const std::vector<uint> & f = faces.at(flist.at(i));
+                    flist.at(i) = new_fid.at(flist.at(i));
+                    if(!face_verts_are_CCW(flist.at(i), f.at(1), f.at(0))) w.at(i) = !w.at(i);
+                }
+            }
+            init_poly_connectivity(tmp_polys, tmp_winding);
+        }
+        else
+        {
+            init_connectivity(verts, faces);
+            init_poly_connectivity(polys, polys_face_winding);
+        }
+    }
     if(this->mesh_data().update_normals) this->update_v_normals();
 
     this->copy_xyz_to_uvw(UVW_param);
@@ -146,8 +222,58 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::init(const std::vector<vec3d>
     this->p_data.reserve(np);
     this->polys_face_winding.reserve(np);
 
-    for(auto v : verts) vert_add(v);
-    for(auto p : polys) poly_add(p);
+    bool bulk = (this->num_verts()==0);
+    for(const auto & p : polys) if(p.size()!=4 && p.size()!=8) bulk = false;
+
+    if(!bulk)
+    {
+        for(auto v : verts) vert_add(v);
+        for(auto p : polys) poly_add(p);
+    }
+    else
+    {
+        // bulk version of poly_add(vlist) for tets and hexes: extract all faces
+        // at once, assign ids to unique faces in order of first appearance, and
+        // then create polyhedra from faces
+        std::vector<std::vector<uint>> all_faces;
+        for(const auto & p : polys)
+        {
+            if(p.size()==4) for(uint i=0; i<4; ++i) all_faces.push_back({p.at(TET_FACES[i][0]), p.at(TET_FACES[i][1]), p.at(TET_FACES[i][2])});
+            else            for(uint i=0; i<6; ++i) all_faces.push_back({p.at(HEXA_FACES[i][0]), p.at(HEXA_FACES[i][1]), p.at(HEXA_FACES[i][2]), p.at(HEXA_FACES[i][3])});
+        }
+        std::vector<uint> first_occurrence;
+        duplicated_elements(all_faces, first_occurrence);
+        std::vector<std::vector<uint>> faces;
+        std::vector<uint> fids(all_faces.size());
+        for(uint i=0; i<all_faces.size(); ++i)
+        {
+            if(first_occurrence.at(i)==i)
+            {
+                fids.at(i) = faces.size();
+                faces.push_back(all_faces.at(i));
+            }
+            else fids.at(i) = fids.at(first_occurrence.at(i));
+        }
+        init_connectivity(verts, faces);
+
+        std::vector<std::vector<uint>> flists(polys.size());
+        std::vector<std::vector<bool>> windings(polys.size());
+        uint off = 0;
+        for(uint pid=0; pid<polys.size(); ++pid)
+        {
+            uint nf = (polys.at(pid).size()==4) ? 4 : 6;
+            flists.at(pid).resize(nf);
+            windings.at(pid).resize(nf);
+            for(uint i=0; i<nf; ++i, ++off)
+            {
+                const std::vector<uint> & f = all_faces.at(off);
+                flists.at(pid).at(i)   = fids.at(off);
+                windings.at(pid).at(i) = face_verts_are_CCW(fids.at(off), f.at(1), f.at(0));
+            }
+        }
+        init_poly_connectivity(flists, windings);
+        update_quality();
+    }
     if(this->mesh_data().update_normals) this->update_v_normals();
 
     this->copy_xyz_to_uvw(UVW_param);
@@ -195,6 +321,379 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::init(const std::vector<vec3d>
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void AbstractPolyhedralMesh<M,V,E,F,P>::save_CINO(const char * filename, const bool with_adjacency) const
+{
+    CINO_writer w(filename, this->mesh_type());
+    w.add_array(CINO_VERT_XYZ,     this->verts);
+    w.add_lists(CINO_FACES,        this->faces);
+    w.add_lists(CINO_POLYS,        this->polys);
+    w.add_lists(CINO_POLY_WINDING, this->polys_face_winding);
+
+    std::vector<vec3d> uvw(this->num_verts());
+    for(uint vid=0; vid<this->num_verts(); ++vid) uvw.at(vid) = this->vert_data(vid).uvw;
+    w.add_array(CINO_VERT_UVW, uvw);
+
+    // labels and colors are stored only if they are not all set to default
+    V v_def;
+    P p_def;
+    bool has_vert_labels = false, has_poly_labels = false, has_poly_colors = false;
+    for(uint vid=0; vid<this->num_verts(); ++vid) has_vert_labels |= (this->vert_data(vid).label!=v_def.label);
+    for(uint pid=0; pid<this->num_polys(); ++pid) has_poly_labels |= (this->poly_data(pid).label!=p_def.label);
+    for(uint pid=0; pid<this->num_polys(); ++pid) has_poly_colors |= (this->poly_data(pid).color!=p_def.color);
+    if(has_vert_labels) w.add_array(CINO_VERT_LABEL, this->vector_vert_labels());
+    if(has_poly_labels) w.add_array(CINO_POLY_LABEL, this->vector_poly_labels());
+    if(has_poly_colors) w.add_array(CINO_POLY_COLOR, this->vector_poly_colors());
+
+    if(with_adjacency)
+    {
+        w.add_array(CINO_EDGES, this->edges);
+        w.add_lists(CINO_V2V,   this->v2v);
+        w.add_lists(CINO_V2E,   this->v2e);
+        w.add_lists(CINO_V2F,   this->v2f);
+        w.add_lists(CINO_V2P,   this->v2p);
+        w.add_lists(CINO_E2F,   this->e2f);
+        w.add_lists(CINO_E2P,   this->e2p);
+        w.add_lists(CINO_F2E,   this->f2e);
+        w.add_lists(CINO_F2F,   this->f2f);
+        w.add_lists(CINO_F2P,   this->f2p);
+        w.add_lists(CINO_P2V,   this->p2v);
+        w.add_lists(CINO_P2E,   this->p2e);
+        w.add_lists(CINO_P2P,   this->p2p);
+    }
+    w.close();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void AbstractPolyhedralMesh<M,V,E,F,P>::load_CINO(const char * filename)
+{
+    std::chrono::high_resolution_clock::time_point t0 = std::chrono::high_resolution_clock::now();
+
+    CINO_reader r(filename);
+    if(!r.is_open()) return;
+
+    // the file can be loaded either in a mesh of the same type or in a general polyhedral mesh
+    if(r.mesh_type()!=this->mesh_type() && !(this->mesh_type()==POLYHEDRALMESH && r.mesh_type()>=TETMESH))
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : load() : " << filename << " contains a different type of mesh" << std::endl;
+        return;
+    }
+
+    std::vector<vec3d>             verts;
+    std::vector<std::vector<uint>> faces;
+    std::vector<std::vector<uint>> polys;
+    std::vector<std::vector<bool>> winding;
+    if(!r.get_array(CINO_VERT_XYZ, verts) || !r.get_lists(CINO_FACES, faces) ||
+       !r.get_lists(CINO_POLYS, polys)    || !r.get_lists(CINO_POLY_WINDING, winding))
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : load() : " << filename << " does not contain a mesh" << std::endl;
+        return;
+    }
+
+    uint nv = verts.size();
+    uint nf = faces.size();
+    uint np = polys.size();
+    bool valid = CINO_ids_in_range(faces, nv) && CINO_ids_in_range(polys, nf) && winding.size()==np;
+    for(uint pid=0; valid && pid<np; ++pid) valid = (winding[pid].size()==polys[pid].size());
+    if(!valid)
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : load() : " << filename << " contains elements referring to non existing vertices or faces" << std::endl;
+        return;
+    }
+
+    // elements must be consistent with the mesh type (e.g. tets made of four triangles)
+    uint f_min = 3, f_max = UINT_MAX;
+    uint p_min = 4, p_max = UINT_MAX;
+    if(this->mesh_type()==TETMESH) { f_min = f_max = 3; p_min = p_max = 4; }
+    if(this->mesh_type()==HEXMESH) { f_min = f_max = 4; p_min = p_max = 6; }
+    if(!CINO_sizes_in_range(faces, f_min, f_max) || !CINO_sizes_in_range(polys, p_min, p_max))
+    {
+        std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : load() : " << filename << " contains faces or polyhedra with a wrong number of elements for this mesh type" << std::endl;
+        return;
+    }
+
+    // if the adjacency is stored in the file, copy it rather than recomputing it.
+    // If any list is missing, has the wrong size or refers to non existing elements
+    // the stored adjacency is discarded, and the connectivity is rebuilt from scratch
+    bool ok = r.get_array(CINO_EDGES, this->edges);
+    uint ne = this->edges.size()/2;
+    ok = ok && this->edges.size()==2*ne && CINO_ids_in_range(this->edges, nv)
+            && r.get_lists(CINO_V2V, this->v2v) && this->v2v.size()==nv && CINO_ids_in_range(this->v2v, nv)
+            && r.get_lists(CINO_V2E, this->v2e) && this->v2e.size()==nv && CINO_ids_in_range(this->v2e, ne)
+            && r.get_lists(CINO_V2F, this->v2f) && this->v2f.size()==nv && CINO_ids_in_range(this->v2f, nf)
+            && r.get_lists(CINO_V2P, this->v2p) && this->v2p.size()==nv && CINO_ids_in_range(this->v2p, np)
+            && r.get_lists(CINO_E2F, this->e2f) && this->e2f.size()==ne && CINO_ids_in_range(this->e2f, nf)
+            && r.get_lists(CINO_E2P, this->e2p) && this->e2p.size()==ne && CINO_ids_in_range(this->e2p, np)
+            && r.get_lists(CINO_F2E, this->f2e) && this->f2e.size()==nf && CINO_ids_in_range(this->f2e, ne)
+            && r.get_lists(CINO_F2F, this->f2f) && this->f2f.size()==nf && CINO_ids_in_range(this->f2f, nf)
+            && r.get_lists(CINO_F2P, this->f2p) && this->f2p.size()==nf && CINO_ids_in_range(this->f2p, np)
+            && r.get_lists(CINO_P2V, this->p2v) && this->p2v.size()==np && CINO_ids_in_range(this->p2v, nv)
+            && r.get_lists(CINO_P2E, this->p2e) && this->p2e.size()==np && CINO_ids_in_range(this->p2e, ne)
+            && r.get_lists(CINO_P2P, this->p2p) && this->p2p.size()==np && CINO_ids_in_range(this->p2p, np);
+    if(ok)
+    {
+        this->verts.swap(verts);
+        this->faces.swap(faces);
+        this->polys.swap(polys);
+        this->polys_face_winding.swap(winding);
+        this->mark_changed_all();
+        this->v_data.resize(nv);
+        this->e_data.resize(ne);
+        this->f_data.resize(nf);
+        this->p_data.resize(np);
+        if(this->mesh_data().update_bbox) this->update_bbox();
+        this->face_triangles.resize(nf);
+        PARALLEL_FOR(0, nf, 1000, [&](const uint fid)
+        {
+            this->update_f_normal(fid);
+            update_f_tessellation(fid);
+        });
+        if(this->mesh_type()!=POLYHEDRALMESH) update_quality();
+        if(this->mesh_data().update_normals) this->update_v_normals();
+        std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+
+        std::cout << "load mesh\t"     <<
+                     this->num_verts() << "V / " <<
+                     this->num_edges() << "E / " <<
+                     this->num_faces() << "F / " <<
+                     this->num_polys() << "P  [" <<
+                     how_many_seconds(t0,t1) << "s]" << std::endl;
+    }
+    else
+    {
+        this->clear();
+        this->mesh_data().filename = std::string(filename);
+        init(verts, faces, polys, winding);
+        if(this->mesh_type()!=POLYHEDRALMESH) update_quality();
+    }
+
+    // attributes
+    std::vector<vec3d> uvw;
+    if(r.get_array(CINO_VERT_UVW, uvw) && uvw.size()==this->num_verts())
+    {
+        for(uint vid=0; vid<this->num_verts(); ++vid) this->vert_data(vid).uvw = uvw.at(vid);
+    }
+    else this->copy_xyz_to_uvw(UVW_param);
+
+    std::vector<int> labels;
+    if(r.get_array(CINO_VERT_LABEL, labels) && labels.size()==this->num_verts())
+    {
+        for(uint vid=0; vid<this->num_verts(); ++vid) this->vert_data(vid).label = labels.at(vid);
+    }
+    if(r.get_array(CINO_POLY_LABEL, labels) && labels.size()==this->num_polys())
+    {
+        for(uint pid=0; pid<this->num_polys(); ++pid) this->poly_data(pid).label = labels.at(pid);
+    }
+    std::vector<Color> colors;
+    if(r.get_array(CINO_POLY_COLOR, colors) && colors.size()==this->num_polys())
+    {
+        for(uint pid=0; pid<this->num_polys(); ++pid) this->poly_data(pid).color = colors.at(pid);
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void AbstractPolyhedralMesh<M,V,E,F,P>::init_connectivity(const std::vector<vec3d>             & verts,
+                                                          const std::vector<std::vector<uint>> & faces)
+{
+    // Bulk version of a sequence of vert_add/face_add, that builds all the vert,
+    // edge and face connectivity in a few linear passes (see bulk_connectivity.h).
+    // Element ids and the order of the adjacency lists are the same of the
+    // incremental version. Polyhedra must be added afterwards, with init_poly_connectivity
+
+    assert(this->num_verts()==0);
+#ifndef NDEBUG
+    for(const auto & f : faces) for(uint vid : f) assert(vid < verts.size());
+#endif
+
+    uint nv = verts.size();
+    uint nf = faces.size();
+
+    this->verts  = verts;
+    this->faces  = faces;
+    this->v_data.resize(nv);
+    this->f_data.resize(nf);
+    if(this->mesh_data().update_bbox) this->update_bbox();
+
+    unique_edges_from_polys(this->faces, nv, this->edges, this->f2e);
+    uint ne = this->num_edges();
+    this->e_data.resize(ne);
+
+    // vert to edge/vert adjacency (in order of edge creation)
+    std::vector<uint> valence(nv,0);
+    for(uint vid : this->edges) ++valence.at(vid);
+    this->v2v.resize(nv);
+    this->v2e.resize(nv);
+    for(uint vid=0; vid<nv; ++vid)
+    {
+        this->v2v.at(vid).reserve(valence.at(vid));
+        this->v2e.at(vid).reserve(valence.at(vid));
+    }
+    for(uint eid=0; eid<ne; ++eid)
+    {
+        uint vid0 = this->edge_vert_id(eid,0);
+        uint vid1 = this->edge_vert_id(eid,1);
+        this->v2v.at(vid1).push_back(vid0);
+        this->v2v.at(vid0).push_back(vid1);
+        this->v2e.at(vid0).push_back(eid);
+        this->v2e.at(vid1).push_back(eid);
+    }
+
+    // vert/edge to face adjacency (in order of face creation)
+    std::fill(valence.begin(), valence.end(), 0);
+    for(const auto & f : this->faces) for(uint vid : f) ++valence.at(vid);
+    this->v2f.resize(nv);
+    for(uint vid=0; vid<nv; ++vid) this->v2f.at(vid).reserve(valence.at(vid));
+    std::vector<uint> e_valence(ne,0);
+    for(const auto & list : this->f2e) for(uint eid : list) ++e_valence.at(eid);
+    this->e2f.resize(ne);
+    for(uint eid=0; eid<ne; ++eid) this->e2f.at(eid).reserve(e_valence.at(eid));
+    for(uint fid=0; fid<nf; ++fid)
+    {
+        for(uint vid : this->faces.at(fid)) this->v2f.at(vid).push_back(fid);
+        for(uint eid : this->f2e.at(fid))   this->e2f.at(eid).push_back(fid);
+    }
+
+    // face to face adjacency. Since e2f lists are sorted by fid, when face fid
+    // is processed its adjacency with faces having lower ids is already known
+    this->f2f.resize(nf);
+    for(uint fid=0; fid<nf; ++fid)
+    {
+        this->f2f.at(fid).reserve(this->f2e.at(fid).size());
+        for(uint eid : this->f2e.at(fid))
+        for(uint nbr : this->e2f.at(eid))
+        {
+            if(nbr>=fid) break;
+            if(CONTAINS_VEC(this->f2f.at(fid),nbr)) continue;
+            this->f2f.at(nbr).push_back(fid);
+            this->f2f.at(fid).push_back(nbr);
+        }
+    }
+
+    // poly adjacency will be filled by poly_add
+    this->v2p.resize(nv);
+    this->e2p.resize(ne);
+    this->f2p.resize(nf);
+
+    this->face_triangles.resize(nf);
+    PARALLEL_FOR(0, nf, 1000, [&](const uint fid)
+    {
+        this->update_f_normal(fid);
+        update_f_tessellation(fid);
+    });
+    this->mark_changed_all();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void AbstractPolyhedralMesh<M,V,E,F,P>::init_poly_connectivity(const std::vector<std::vector<uint>> & polys,
+                                                               const std::vector<std::vector<bool>> & polys_face_winding)
+{
+    // Bulk version of a sequence of poly_add(flist,winding), to be called right after
+    // init_connectivity. Poly edges are read from f2e rather than searched with edge_id,
+    // duplicated vertices/edges within a poly are detected with per-element stamps,
+    // and the poly adjacency of vertices/edges is reserved to its final size. Element
+    // ids and the order of the adjacency lists are the same of the incremental version
+
+    assert(this->num_polys()==0);
+    assert(polys.size()==polys_face_winding.size());
+#ifndef NDEBUG
+    for(const auto & p : polys) for(uint fid : p) assert(fid < this->num_faces());
+#endif
+
+    // discard duplicated polyhedra (as poly_add would do)
+    std::vector<uint> first_occurrence;
+    bool check = this->mesh_data().check_duplicates && duplicated_elements(polys, first_occurrence)>0;
+    if(check) std::cout << ANSI_fg_color_red << "WARNING: discarded duplicated polys!" << ANSI_fg_color_default << std::endl;
+    for(uint i=0; i<polys.size(); ++i)
+    {
+        if(check && first_occurrence.at(i)!=i) continue;
+        this->polys.push_back(polys.at(i));
+        this->polys_face_winding.push_back(polys_face_winding.at(i));
+    }
+
+    uint nv = this->num_verts();
+    uint ne = this->num_edges();
+    uint nf = this->num_faces();
+    uint np = this->polys.size();
+    this->p_data.resize(np);
+
+    // poly to vert/edge adjacency (in order of first appearance in the poly faces)
+    std::vector<uint> v_stamp(nv,UINT_MAX), v_valence(nv,0);
+    std::vector<uint> e_stamp(ne,UINT_MAX), e_valence(ne,0);
+    std::vector<uint> f_valence(nf,0);
+    this->p2v.resize(np);
+    this->p2e.resize(np);
+    for(uint pid=0; pid<np; ++pid)
+    {
+        for(uint fid : this->polys.at(pid))
+        {
+            ++f_valence.at(fid);
+            const std::vector<uint> & f = this->faces.at(fid);
+            for(uint i=0; i<f.size(); ++i)
+            {
+                uint vid = f.at(i);
+                uint eid = this->f2e.at(fid).at(i);
+                if(e_stamp.at(eid)!=pid)
+                {
+                    e_stamp.at(eid) = pid;
+                    ++e_valence.at(eid);
+                    this->p2e.at(pid).push_back(eid);
+                }
+                if(v_stamp.at(vid)!=pid)
+                {
+                    v_stamp.at(vid) = pid;
+                    ++v_valence.at(vid);
+                    this->p2v.at(pid).push_back(vid);
+                }
+            }
+        }
+    }
+
+    // vert/edge/face to poly adjacency (in order of poly creation)
+    for(uint vid=0; vid<nv; ++vid) this->v2p.at(vid).reserve(v_valence.at(vid));
+    for(uint eid=0; eid<ne; ++eid) this->e2p.at(eid).reserve(e_valence.at(eid));
+    for(uint fid=0; fid<nf; ++fid) this->f2p.at(fid).reserve(f_valence.at(fid));
+    for(uint pid=0; pid<np; ++pid)
+    {
+        for(uint vid : this->p2v.at(pid))   this->v2p.at(vid).push_back(pid);
+        for(uint eid : this->p2e.at(pid))   this->e2p.at(eid).push_back(pid);
+        for(uint fid : this->polys.at(pid)) this->f2p.at(fid).push_back(pid);
+    }
+
+    // poly to poly adjacency. Since f2p lists are sorted by pid, when poly pid
+    // is processed its adjacency with polys having lower ids is already known
+    this->p2p.resize(np);
+    for(uint pid=0; pid<np; ++pid)
+    {
+        for(uint fid : this->polys.at(pid))
+        for(uint nbr : this->f2p.at(fid))
+        {
+            if(nbr>=pid) break;
+            if(CONTAINS_VEC(this->p2p.at(pid),nbr)) continue;
+            this->p2p.at(nbr).push_back(pid);
+            this->p2p.at(pid).push_back(nbr);
+        }
+    }
+
+    PARALLEL_FOR(0, np, 1000, [&](const uint pid)
+    {
+        if(this->poly_is_hexahedron(pid) || this->poly_is_tetrahedron(pid)) this->poly_reorder_p2v(pid);
+    });
+    compact_adjacency();
+    this->mark_changed_all();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class F, class P>
 CINO_INLINE
 double AbstractPolyhedralMesh<M,V,E,F,P>::mesh_srf_area() const
@@ -355,10 +854,10 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void AbstractPolyhedralMesh<M,V,E,F,P>::update_f_normals()
 {
-    for(uint fid=0; fid<num_faces(); ++fid)
+    PARALLEL_FOR(0, num_faces(), 1000, [&](const uint fid)
     {
         update_f_normal(fid);
-    }
+    });
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -368,10 +867,10 @@ CINO_INLINE
 void AbstractPolyhedralMesh<M,V,E,F,P>::update_f_tessellation()
 {
     this->face_triangles.resize(this->num_faces());
-    for(uint fid=0; fid<this->num_faces(); ++fid)
+    PARALLEL_FOR(0, this->num_faces(), 1000, [&](const uint fid)
     {
         update_f_tessellation(fid);
-    }
+    });
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -383,6 +882,8 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::update_f_tessellation(const uint fid)
     // Assume convexity and try trivial tessellation first. If something flips
     // apply earcut algorithm to get a valid triangulation
 
+    face_triangles.at(fid).clear();
+    face_triangles.at(fid).reserve(3*(this->verts_per_face(fid)-2));
     std::vector<vec3d> n;
     for (uint i=2; i<this->verts_per_face(fid); ++i)
     {
@@ -427,10 +928,10 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void AbstractPolyhedralMesh<M,V,E,F,P>::update_v_normals()
 {
-    for(uint vid=0; vid<this->num_verts(); ++vid)
+    PARALLEL_FOR(0, this->num_verts(), 1000, [&](const uint vid)
     {
         if(vert_is_on_srf(vid)) update_v_normal(vid);
-    }
+    });
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -465,10 +966,11 @@ template<class M, class V, class E, class F, class P>
 CINO_INLINE
 void AbstractPolyhedralMesh<M,V,E,F,P>::update_quality()
 {
-    for(uint pid=0; pid<this->num_polys(); ++pid)
+    PARALLEL_FOR(0, this->num_polys(), 1000, [&](const uint pid)
     {
         update_p_quality(pid);
-    }
+    });
+    this->mark_changed(CHANGES_POLY_DATA);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -493,6 +995,48 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::update_v_normal(const uint vid)
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
+template<class M, class V, class E, class F, class P>
+CINO_INLINE
+void AbstractPolyhedralMesh<M,V,E,F,P>::update_normals_incremental()
+{
+    const int logs[3] = { CHANGES_VERT_POS, CHANGES_VERTS, CHANGES_FACES };
+    std::vector<uint> ids[3];
+    bool incremental = true;
+    for(int i=0; i<3; ++i)
+    {
+        incremental &= this->changes(logs[i]).changed_since(normals_rev[i], ids[i]);
+        normals_rev[i] = this->changes(logs[i]).revision();
+    }
+    if(!incremental)
+    {
+        update_normals();
+        return;
+    }
+
+    // changed faces (e.g. faces exposed by a poly removal), and faces incident to changed verts
+    std::unordered_set<uint> faces;
+    for(uint fid : ids[2]) if(fid<this->num_faces()) faces.insert(fid);
+    for(int i=0; i<2; ++i)
+    for(uint vid : ids[i])
+    {
+        if(vid<this->num_verts()) faces.insert(this->adj_v2f(vid).begin(), this->adj_v2f(vid).end());
+    }
+
+    // verts of the faces above, and changed verts (which may have lost all their faces)
+    std::unordered_set<uint> verts;
+    for(uint fid : faces) verts.insert(this->adj_f2v(fid).begin(), this->adj_f2v(fid).end());
+    for(int i=0; i<2; ++i)
+    for(uint vid : ids[i])
+    {
+        if(vid<this->num_verts()) verts.insert(vid);
+    }
+
+    for(uint fid : faces) this->update_f_normal(fid);
+    for(uint vid : verts) update_v_normal(vid);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class M, class V, class E, class F, class P>
 CINO_INLINE
 int AbstractPolyhedralMesh<M,V,E,F,P>::Euler_characteristic() const
@@ -518,7 +1062,7 @@ int AbstractPolyhedralMesh<M,V,E,F,P>::genus() const
 
 template<class M, class V, class E, class F, class P>
 CINO_INLINE
-std::vector<uint> AbstractPolyhedralMesh<M,V,E,F,P>::face_tessellation(const uint fid) const
+const std::vector<uint> & AbstractPolyhedralMesh<M,V,E,F,P>::face_tessellation(const uint fid) const
 {
     return face_triangles.at(fid);
 }
@@ -1074,6 +1618,7 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::poly_face_flip_winding(const uint pid, c
 {
     uint off = poly_face_offset(pid, fid);
     polys_face_winding.at(pid).at(off) = !polys_face_winding.at(pid).at(off);
+    this->mark_changed(CHANGES_POLYS, pid);
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
@@ -1982,10 +2527,12 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::vert_switch_id(const uint vid0, const ui
     if(vid0 == vid1) return;
 
     std::swap(this->verts.at(vid0),   this->verts.at(vid1));
-    std::swap(this->v2v.at(vid0),     this->v2v.at(vid1));
-    std::swap(this->v2e.at(vid0),     this->v2e.at(vid1));
-    std::swap(this->v2f.at(vid0),     this->v2f.at(vid1));
-    std::swap(this->v2p.at(vid0),     this->v2p.at(vid1));
+    this->mark_changed(CHANGES_VERTS, vid0);
+    this->mark_changed(CHANGES_VERTS, vid1);
+    this->v2v.at(vid0).swap(this->v2v.at(vid1));
+    this->v2e.at(vid0).swap(this->v2e.at(vid1));
+    this->v2f.at(vid0).swap(this->v2f.at(vid1));
+    this->v2p.at(vid0).swap(this->v2p.at(vid1));
     std::swap(this->v_data.at(vid0),  this->v_data.at(vid1));
 
     std::unordered_set<uint> verts_to_update;
@@ -2023,6 +2570,10 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::vert_switch_id(const uint vid0, const ui
         }
     }
 
+    for(uint eid : edges_to_update) this->mark_changed(CHANGES_EDGES, eid);
+    for(uint fid : faces_to_update) this->mark_changed(CHANGES_FACES, fid);
+    for(uint pid : polys_to_update) this->mark_changed(CHANGES_POLYS, pid);
+
     for(uint fid : faces_to_update)
     {
         for(uint & vid : this->faces.at(fid))
@@ -2066,6 +2617,7 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::vert_remove_unreferenced(const uint vid)
     this->v2e.at(vid).clear();
     this->v2f.at(vid).clear();
     this->v2p.at(vid).clear();
+    this->mark_changed(CHANGES_VERTS, vid);
     vert_switch_id(vid, this->num_verts()-1);
     this->verts.pop_back();
     this->v_data.pop_back();
@@ -2084,6 +2636,7 @@ uint AbstractPolyhedralMesh<M,V,E,F,P>::vert_add(const vec3d & pos)
     uint vid = this->num_verts();
     //
     this->verts.push_back(pos);
+    this->mark_changed(CHANGES_VERTS, vid);
     //
     V data;
     this->v_data.push_back(data);
@@ -2109,9 +2662,11 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::edge_switch_id(const uint eid0, const ui
     if (eid0 == eid1) return;
 
     for(uint off=0; off<2; ++off) std::swap(this->edges.at(2*eid0+off), this->edges.at(2*eid1+off));
+    this->mark_changed(CHANGES_EDGES, eid0);
+    this->mark_changed(CHANGES_EDGES, eid1);
 
-    std::swap(this->e2f.at(eid0),     this->e2f.at(eid1));
-    std::swap(this->e2p.at(eid0),     this->e2p.at(eid1));
+    this->e2f.at(eid0).swap(this->e2f.at(eid1));
+    this->e2p.at(eid0).swap(this->e2p.at(eid1));
     std::swap(this->e_data.at(eid0),  this->e_data.at(eid1));
 
     std::unordered_set<uint> verts_to_update;
@@ -2172,6 +2727,9 @@ uint AbstractPolyhedralMesh<M,V,E,F,P>::edge_add(const uint vid0, const uint vid
     //
     this->edges.push_back(vid0);
     this->edges.push_back(vid1);
+    this->mark_changed(CHANGES_EDGES, eid);
+    this->mark_changed(CHANGES_VERTS, vid0);
+    this->mark_changed(CHANGES_VERTS, vid1);
     //
     this->e2f.push_back(std::vector<uint>());
     this->e2p.push_back(std::vector<uint>());
@@ -2206,6 +2764,7 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::edge_remove_unreferenced(const uint eid)
 {
     this->e2f.at(eid).clear();
     this->e2p.at(eid).clear();
+    this->mark_changed(CHANGES_EDGES, eid);
     edge_switch_id(eid, this->num_edges()-1);
     this->edges.resize(this->edges.size()-2);
     this->e_data.pop_back();
@@ -2225,10 +2784,12 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::face_switch_id(const uint fid0, const ui
 
     std::swap(this->faces.at(fid0),          this->faces.at(fid1));
     std::swap(this->f_data.at(fid0),         this->f_data.at(fid1));
-    std::swap(this->f2e.at(fid0),            this->f2e.at(fid1));
-    std::swap(this->f2f.at(fid0),            this->f2f.at(fid1));
-    std::swap(this->f2p.at(fid0),            this->f2p.at(fid1));
+    this->f2e.at(fid0).swap(this->f2e.at(fid1));
+    this->f2f.at(fid0).swap(this->f2f.at(fid1));
+    this->f2p.at(fid0).swap(this->f2p.at(fid1));
     std::swap(this->face_triangles.at(fid0), this->face_triangles.at(fid1));
+    this->mark_changed(CHANGES_FACES, fid0);
+    this->mark_changed(CHANGES_FACES, fid1);
 
     std::unordered_set<uint> verts_to_update;
     verts_to_update.insert(this->adj_f2v(fid0).begin(), this->adj_f2v(fid0).end());
@@ -2300,6 +2861,8 @@ uint AbstractPolyhedralMesh<M,V,E,F,P>::face_add(const std::vector<uint> & f)
 
     uint fid = this->num_faces();
     this->faces.push_back(f);
+    this->mark_changed(CHANGES_FACES, fid);
+    this->mark_changed(CHANGES_VERTS, f);
 
     F data;
     this->f_data.push_back(data);
@@ -2370,6 +2933,7 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::face_remove_unreferenced(const uint fid)
     this->f2f.at(fid).clear();
     this->f2p.at(fid).clear();
     this->face_triangles.at(fid).clear();
+    this->mark_changed(CHANGES_FACES, fid);
     face_switch_id(fid, this->num_faces()-1);
     this->faces.pop_back();
     this->f_data.pop_back();
@@ -2390,9 +2954,11 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::poly_switch_id(const uint pid0, const ui
     std::swap(this->polys.at(pid0),              this->polys.at(pid1));
     std::swap(this->p_data.at(pid0),             this->p_data.at(pid1));
     std::swap(this->p2v.at(pid0),                this->p2v.at(pid1));
-    std::swap(this->p2e.at(pid0),                this->p2e.at(pid1));
-    std::swap(this->p2p.at(pid0),                this->p2p.at(pid1));
+    this->p2e.at(pid0).swap(this->p2e.at(pid1));
+    this->p2p.at(pid0).swap(this->p2p.at(pid1));
     std::swap(this->polys_face_winding.at(pid0), this->polys_face_winding.at(pid1));
+    this->mark_changed(CHANGES_POLYS, pid0);
+    this->mark_changed(CHANGES_POLYS, pid1);
 
     std::unordered_set<uint> verts_to_update;
     verts_to_update.insert(this->adj_p2v(pid0).begin(), this->adj_p2v(pid0).end());
@@ -2518,6 +3084,11 @@ uint AbstractPolyhedralMesh<M,V,E,F,P>::poly_add(const std::vector<uint> & flist
         this->poly_reorder_p2v(pid);
     }
 
+    // faces of the new poly may have become internal
+    this->mark_changed(CHANGES_POLYS, pid);
+    this->mark_changed(CHANGES_FACES, flist);
+    this->mark_changed(CHANGES_VERTS, this->adj_p2v(pid));
+
     return pid;
 }
 
@@ -2735,6 +3306,7 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::poly_remove_unreferenced(const uint pid)
     this->p2e.at(pid).clear();
     this->p2p.at(pid).clear();
     this->polys_face_winding.at(pid).clear();
+    this->mark_changed(CHANGES_POLYS, pid);
     poly_switch_id(pid, this->num_polys()-1);
     this->polys.pop_back();
     this->p_data.pop_back();
@@ -2785,6 +3357,11 @@ void AbstractPolyhedralMesh<M,V,E,F,P>::poly_remove(const uint pid, const bool d
     // disconnect from other polyhedra
     for(uint nbr : this->adj_p2p(pid)) REMOVE_FROM_VEC(this->p2p.at(nbr), pid);
 
+    // faces of the removed poly may have become boundary faces
+    this->mark_changed(CHANGES_VERTS, verts_to_update);
+    this->mark_changed(CHANGES_EDGES, edges_to_update);
+    this->mark_changed(CHANGES_FACES, faces_to_update);
+
     // disconnect dangling faces
     for(uint fid : dangling_faces)
     {
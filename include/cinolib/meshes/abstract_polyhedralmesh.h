@@ -57,11 +57,13 @@ class AbstractPolyhedralMesh : public AbstractMesh<M,V,E,P>
 
         std::vector<F> f_data;
 
-        std::vector<std::vector<uint>> v2f; // vert to face adjacency
-        std::vector<std::vector<uint>> e2f; // edge to face adjacency
-        std::vector<std::vector<uint>> f2e; // face to edge adjacency
-        std::vector<std::vector<uint>> f2f; // face to face adjacency (through edges)
-        std::vector<std::vector<uint>> f2p; // face to poly adjacency
+        uint64_t normals_rev[3] = { 0, 0, 0 }; // revisions of the change logs seen by update_normals_incremental
+
+        MeshAdjacency                  v2f; // vert to face adjacency
+        MeshAdjacency                  e2f; // edge to face adjacency
+        MeshAdjacency                  f2e; // face to edge adjacency
+        MeshAdjacency                  f2f; // face to face adjacency (through edges)
+        MeshAdjacency                  f2p; // face to poly adjacency
         std::vector<std::vector<uint>> p2v; // poly to vert adjacency
 
         std::vector<std::vector<uint>> face_triangles; // per face serialized triangulation (e.g., for rendering)
@@ -76,6 +78,8 @@ class AbstractPolyhedralMesh : public AbstractMesh<M,V,E,P>
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
         void clear() override;
+        void compact_adjacency() override;
+        size_t adjacency_memory_usage_in_bytes() const override;
 
         void init(const std::vector<vec3d>             & verts,
                   const std::vector<std::vector<uint>> & faces,
@@ -90,6 +94,18 @@ class AbstractPolyhedralMesh : public AbstractMesh<M,V,E,P>
                   const std::vector<int>               & vert_labels,
                   const std::vector<int>               & poly_labels);
 
+        void save_CINO(const char * filename, const bool with_adjacency = true) const;
+
+    protected:
+
+        void init_connectivity(const std::vector<vec3d>             & verts,
+                               const std::vector<std::vector<uint>> & faces);
+        void init_poly_connectivity(const std::vector<std::vector<uint>> & polys,
+                                    const std::vector<std::vector<bool>> & polys_face_winding);
+        void load_CINO(const char * filename);
+
+    public:
+
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
         double mesh_srf_area() const;
@@ -107,6 +123,8 @@ class AbstractPolyhedralMesh : public AbstractMesh<M,V,E,P>
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
                 void update_normals() override;
+                void update_normals_incremental(); // only updates the normals affected by the changes logged
+                                                   // after the previous call (see AbstractMesh::changes())
                 void update_f_normals();
         virtual void update_f_normal(const uint fid) = 0;
                 void update_f_tessellation();
@@ -147,22 +165,22 @@ class AbstractPolyhedralMesh : public AbstractMesh<M,V,E,P>
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-        const std::vector<uint> & adj_v2f(const uint vid) const          { return v2f.at(vid);         }
-              std::vector<uint> & adj_v2f(const uint vid)                { return v2f.at(vid);         }
-        const std::vector<uint> & adj_e2f(const uint eid) const          { return e2f.at(eid);         }
-              std::vector<uint> & adj_e2f(const uint eid)                { return e2f.at(eid);         }
-        const std::vector<uint> & adj_f2v(const uint fid) const          { return this->faces.at(fid); }
-              std::vector<uint> & adj_f2v(const uint fid)                { return this->faces.at(fid); }
-        const std::vector<uint> & adj_f2e(const uint fid) const          { return f2e.at(fid);         }
-              std::vector<uint> & adj_f2e(const uint fid)                { return f2e.at(fid);         }
-        const std::vector<uint> & adj_f2f(const uint fid) const          { return f2f.at(fid);         }
-              std::vector<uint> & adj_f2f(const uint fid)                { return f2f.at(fid);         }
-        const std::vector<uint> & adj_f2p(const uint fid) const          { return f2p.at(fid);         }
-              std::vector<uint> & adj_f2p(const uint fid)                { return f2p.at(fid);         }
-        const std::vector<uint> & adj_p2f(const uint pid) const          { return this->polys.at(pid); }
-              std::vector<uint> & adj_p2f(const uint pid)                { return this->polys.at(pid); }
-        const std::vector<uint> & adj_p2v(const uint pid) const override { return p2v.at(pid);         }
-              std::vector<uint> & adj_p2v(const uint pid)       override { return p2v.at(pid);         }
+        MeshAdjacency::const_reference adj_v2f(const uint vid) const          { return v2f.at(vid);         }
+        MeshAdjacency::reference       adj_v2f(const uint vid)                { return v2f.at(vid);         }
+        MeshAdjacency::const_reference adj_e2f(const uint eid) const          { return e2f.at(eid);         }
+        MeshAdjacency::reference       adj_e2f(const uint eid)                { return e2f.at(eid);         }
+        const std::vector<uint> &      adj_f2v(const uint fid) const          { return this->faces.at(fid); }
+              std::vector<uint> &      adj_f2v(const uint fid)                { return this->faces.at(fid); }
+        MeshAdjacency::const_reference adj_f2e(const uint fid) const          { return f2e.at(fid);         }
+        MeshAdjacency::reference       adj_f2e(const uint fid)                { return f2e.at(fid);         }
+        MeshAdjacency::const_reference adj_f2f(const uint fid) const          { return f2f.at(fid);         }
+        MeshAdjacency::reference       adj_f2f(const uint fid)                { return f2f.at(fid);         }
+        MeshAdjacency::const_reference adj_f2p(const uint fid) const          { return f2p.at(fid);         }
+        MeshAdjacency::reference       adj_f2p(const uint fid)                { return f2p.at(fid);         }
+        const std::vector<uint> &      adj_p2f(const uint pid) const          { return this->polys.at(pid); }
+              std::vector<uint> &      adj_p2f(const uint pid)                { return this->polys.at(pid); }
+        const std::vector<uint> &      adj_p2v(const uint pid) const override { return p2v.at(pid);         }
+              std::vector<uint> &      adj_p2v(const uint pid)       override { return p2v.at(pid);         }
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
@@ -254,7 +272,7 @@ class AbstractPolyhedralMesh : public AbstractMesh<M,V,E,P>
                 uint               face_add                   (const std::vector<uint> & f);
                 void               face_remove                (const uint fid);
                 void               face_remove_unreferenced   (const uint fid);
-                std::vector<uint>  face_tessellation          (const uint fid) const;
+         const std::vector<uint> & face_tessellation          (const uint fid) const;
                 bool               face_is_visible            (const uint fid, uint & pid_beneath) const;
                 void               face_apply_labels          (const std::vector<int> & labels);
                 void               face_apply_label           (const int label);
@@ -125,8 +125,9 @@ enum
 struct Mesh_std_attributes
 {
     std::string filename;
-    bool        update_normals = true;
-    bool        update_bbox    = true;
+    bool        update_normals   = true;
+    bool        update_bbox      = true;
+    bool        check_duplicates = true; // discard duplicated elements at loading time
 };
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
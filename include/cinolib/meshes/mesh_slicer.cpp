@@ -36,6 +36,11 @@
 #include <cinolib/meshes/mesh_slicer.h>
 #include <cinolib/geometry/vec_mat.h>
 #include <cinolib/meshes/mesh_attributes.h>
+#include <cinolib/mesh_revision.h>
+#include <cinolib/parallel_for.h>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
 
 namespace cinolib
 {
@@ -56,38 +61,273 @@ CINO_INLINE
 void MeshSlicer<Mesh>::reset(Mesh & m)
 {    
     m.poly_set_flag(HIDDEN,false); // show all
+    valid = false;
 }
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
 template<class Mesh>
 CINO_INLINE
-void MeshSlicer<Mesh>::update(Mesh & m, const SlicerState & s)
+bool MeshSlicer<Mesh>::update(Mesh & m, const SlicerState & s)
 {
-    float eps      = m.bbox().diag()/1000.f;
-    float X_thresh = m.bbox().min[0] + m.bbox().delta()[0] * (s.X_thresh + eps);
-    float Y_thresh = m.bbox().min[1] + m.bbox().delta()[1] * (s.Y_thresh + eps);
-    float Z_thresh = m.bbox().min[2] + m.bbox().delta()[2] * (s.Z_thresh + eps);
+    std::vector<uint> changed_polys;
+    return update(m, s, changed_polys);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-    for(uint pid=0; pid<m.num_polys(); ++pid)
+template<class Mesh>
+CINO_INLINE
+bool MeshSlicer<Mesh>::update(Mesh & m, const SlicerState & s, std::vector<uint> & changed_polys)
+{
+    changed_polys.clear();
+
+    double t[4];
+    thresholds(m, s, t);
+
+    // polys whose filters changed (all_touched: all polys)
+    std::vector<uint> touched;
+    bool all_touched = false;
+
+    if(cache_is_valid(m))
     {
-        vec3d  c = m.poly_centroid(pid);
-        float  q = m.poly_data(pid).quality;
-        int    l = m.poly_data(pid).label;
+        // poly attributes edited since the last update: the cache is stale if their
+        // quality or label changed. Otherwise just check their flags (e.g. overwritten)
+        if(!m.changes(CHANGES_POLY_DATA).changed_since(rev_poly_data, touched))
+        {
+            touched.resize(m.num_polys());
+            std::iota(touched.begin(), touched.end(), 0);
+        }
+        for(uint pid : touched)
+        {
+            if(pid>=m.num_polys()) continue;
+            double q = m.poly_data(pid).quality;
+            if((q!=key[Q].at(pid) && !(std::isnan(q) && std::isnan(key[Q].at(pid)))) || m.poly_data(pid).label!=label.at(pid))
+            {
+                valid = false;
+                break;
+            }
+        }
+    }
 
-        bool pass_X = (s.X_sign == LEQ) ? (c.x() <=   X_thresh) : (c.x() >=   X_thresh);
-        bool pass_Y = (s.Y_sign == LEQ) ? (c.y() <=   Y_thresh) : (c.y() >=   Y_thresh);
-        bool pass_Z = (s.Z_sign == LEQ) ? (c.z() <=   Z_thresh) : (c.z() >=   Z_thresh);
-        bool pass_Q = (s.Q_sign == LEQ) ? (q     <= s.Q_thresh) : (q     >= s.Q_thresh);
-        bool pass_L = (s.L_mode == IS ) ? (l == -1 || l == s.L_filter) : (l == -1 || l != s.L_filter);
+    bool incremental = cache_is_valid(m);
+    if(!incremental)
+    {
+        build_cache(m);
+        PARALLEL_FOR(0, m.num_polys(), 1000, [&](const uint pid)
+        {
+            for(int f : {X,Y,Z,Q,L}) update_filter(pid, f, s, t);
+        });
+        all_touched = true;
+    }
+    else
+    {
+        int sign_old[4] = { state.X_sign, state.Y_sign, state.Z_sign, state.Q_sign };
+        int sign_new[4] = { s.X_sign,     s.Y_sign,     s.Z_sign,     s.Q_sign     };
+        for(int f : {X,Y,Z,Q})
+        {
+            if(sign_old[f]!=sign_new[f])
+            {
+                PARALLEL_FOR(0, m.num_polys(), 1000, [&](const uint pid) { update_filter(pid, f, s, t); });
+                all_touched = true;
+            }
+            else if(thresh[f]!=t[f])
+            {
+                update_range(f, thresh[f], t[f], s, t, touched);
+            }
+        }
+        if(state.L_mode!=s.L_mode)
+        {
+            PARALLEL_FOR(0, m.num_polys(), 1000, [&](const uint pid) { update_filter(pid, L, s, t); });
+            all_touched = true;
+        }
+        else if(state.L_filter!=s.L_filter)
+        {
+            for(int l : {state.L_filter, s.L_filter})
+            {
+                auto it = label_polys.find(l);
+                if(it==label_polys.end()) continue;
+                for(uint pid : it->second) update_filter(pid, L, s, t);
+                touched.insert(touched.end(), it->second.begin(), it->second.end());
+            }
+        }
+        if(state.mode!=s.mode) all_touched = true;
+    }
 
-        bool b = (s.mode == AND) ? ( pass_X &&  pass_Y &&  pass_Z &&  pass_L &&  pass_Q)
-                                 : (!pass_X || !pass_Y || !pass_Z || !pass_L || !pass_Q);
+    auto update_flag = [&](const uint pid)
+    {
+        const uint8_t all = (1<<X) | (1<<Y) | (1<<Z) | (1<<Q) | (1<<L);
+        bool show = (s.mode == AND) ? (pass[pid] == all) : (pass[pid] != all);
+        if(m.poly_data(pid).flags[HIDDEN] == show)
+        {
+            m.poly_data(pid).flags[HIDDEN] = !show;
+            changed_polys.push_back(pid);
+        }
+    };
+    if(all_touched)
+    {
+        for(uint pid=0; pid<m.num_polys(); ++pid) update_flag(pid);
+    }
+    else
+    {
+        for(uint pid : touched) if(pid<m.num_polys()) update_flag(pid);
+    }
 
-        m.poly_data(pid).flags[HIDDEN] = !b;
+    m.mark_changed(CHANGES_POLY_DATA, changed_polys);
+    rev_poly_data = m.changes(CHANGES_POLY_DATA).revision();
+    state = s;
+    std::copy(t, t+4, thresh);
+    return incremental;
+}
 
-        //std::cout << pass_X << " " << pass_Y << " " << pass_Z << " " << pass_Q << " " << pass_L << std::endl;
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+bool MeshSlicer<Mesh>::cache_is_valid(const Mesh & m) const
+{
+    if(!valid                                                  ||
+       pass.size()                            != m.num_polys() ||
+       m.changes(CHANGES_VERT_POS).revision() != rev_pos       ||
+       m.changes(CHANGES_POLYS).revision()    != rev_polys)
+    {
+        return false;
+    }
+    std::vector<vec3d> curr;
+    geometry_stamp(m, curr);
+    return curr==stamp;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// bounding box and a sparse sample of (at most 64) vertex positions
+template<class Mesh>
+CINO_INLINE
+void MeshSlicer<Mesh>::geometry_stamp(const Mesh & m, std::vector<vec3d> & stamp) const
+{
+    uint nv   = m.num_verts();
+    uint step = std::max(1u, nv/64);
+    stamp.clear();
+    stamp.push_back(m.bbox().min);
+    stamp.push_back(m.bbox().max);
+    for(uint vid=0; vid<nv; vid+=step) stamp.push_back(m.vert(vid));
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void MeshSlicer<Mesh>::build_cache(const Mesh & m)
+{
+    uint np = m.num_polys();
+    for(int f : {X,Y,Z,Q}) key[f].resize(np);
+    label.resize(np);
+    pass.assign(np, 0);
+
+    PARALLEL_FOR(0, np, 1000, [&](const uint pid)
+    {
+        vec3d c = m.poly_centroid(pid);
+        key[X][pid] = c.x();
+        key[Y][pid] = c.y();
+        key[Z][pid] = c.z();
+        key[Q][pid] = m.poly_data(pid).quality;
+        label[pid]  = m.poly_data(pid).label;
+    });
+
+    PARALLEL_FOR(0, 4, 1, [&](const uint f)
+    {
+        sorted[f].clear();
+        sorted[f].reserve(np);
+        for(uint pid=0; pid<np; ++pid) if(!std::isnan(key[f][pid])) sorted[f].push_back(pid);
+        std::sort(sorted[f].begin(), sorted[f].end(), [&](const uint a, const uint b) { return key[f][a] < key[f][b]; });
+    });
+
+    label_polys.clear();
+    for(uint pid=0; pid<np; ++pid) label_polys[label[pid]].push_back(pid);
+
+    rev_pos       = m.changes(CHANGES_VERT_POS).revision();
+    rev_polys     = m.changes(CHANGES_POLYS).revision();
+    rev_poly_data = m.changes(CHANGES_POLY_DATA).revision();
+    valid         = true;
+    geometry_stamp(m, stamp);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void MeshSlicer<Mesh>::thresholds(const Mesh & m, const SlicerState & s, double t[4]) const
+{
+    float eps = m.bbox().diag()/1000.f;
+    t[X] = static_cast<float>(m.bbox().min[0] + m.bbox().delta()[0] * (s.X_thresh + eps));
+    t[Y] = static_cast<float>(m.bbox().min[1] + m.bbox().delta()[1] * (s.Y_thresh + eps));
+    t[Z] = static_cast<float>(m.bbox().min[2] + m.bbox().delta()[2] * (s.Z_thresh + eps));
+    t[Q] = s.Q_thresh;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+bool MeshSlicer<Mesh>::passes(const uint pid, const int filter, const SlicerState & s, const double t[4]) const
+{
+    int sign = LEQ;
+    switch(filter)
+    {
+        case X : sign = s.X_sign; break;
+        case Y : sign = s.Y_sign; break;
+        case Z : sign = s.Z_sign; break;
+        case Q : sign = s.Q_sign; break;
+        case L : { int l = label[pid];
+                   return (s.L_mode == IS) ? (l == -1 || l == s.L_filter) : (l == -1 || l != s.L_filter); }
+    }
+    return (sign == LEQ) ? (key[filter][pid] <= t[filter]) : (key[filter][pid] >= t[filter]);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void MeshSlicer<Mesh>::update_filter(const uint pid, const int filter, const SlicerState & s, const double t[4])
+{
+    if(passes(pid, filter, s, t)) pass[pid] |=  (1<<filter);
+    else                          pass[pid] &= ~(1<<filter);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// updates the polys with key between the old and the new threshold, which
+// form a contiguous range of the polys sorted by key (the sign is the same)
+template<class Mesh>
+CINO_INLINE
+void MeshSlicer<Mesh>::update_range(const int                 filter,
+                                    const double              t_old,
+                                    const double              t_new,
+                                    const SlicerState       & s,
+                                    const double              t[4],
+                                          std::vector<uint> & touched)
+{
+    const std::vector<double> & k  = key[filter];
+    const std::vector<uint>   & ps = sorted[filter];
+    double lo = std::min(t_old, t_new);
+    double hi = std::max(t_old, t_new);
+    int sign  = (filter==X) ? s.X_sign : ((filter==Y) ? s.Y_sign : ((filter==Z) ? s.Z_sign : s.Q_sign));
+
+    std::vector<uint>::const_iterator beg, end;
+    if(sign == LEQ) // passes iff key <= t
+    {
+        auto cmp = [&](const double v, const uint pid) { return v < k[pid]; };
+        beg = std::upper_bound(ps.begin(), ps.end(), lo, cmp);
+        end = std::upper_bound(beg,        ps.end(), hi, cmp);
+    }
+    else // passes iff key >= t
+    {
+        auto cmp = [&](const uint pid, const double v) { return k[pid] < v; };
+        beg = std::lower_bound(ps.begin(), ps.end(), lo, cmp);
+        end = std::lower_bound(beg,        ps.end(), hi, cmp);
     }
+    for(auto it=beg; it!=end; ++it) update_filter(*it, filter, s, t);
+    touched.insert(touched.end(), beg, end);
 }
 
 }
@@ -37,6 +37,10 @@
 #define CINO_MESH_SLICER_H
 
 #include <cinolib/symbols.h>
+#include <cinolib/geometry/vec_mat.h>
+#include <map>
+#include <vector>
+#include <stdint.h>
 
 namespace cinolib
 {
@@ -61,6 +65,18 @@ struct SlicerState
 /* Filter mesh elements according to a number of different criteria.
  * Useful to inspect the interior of volume meshes, or to isolate
  * interesting portions of a complex surface mesh.
+ *
+ * Poly centroids and qualities are cached, sorted along each axis (and
+ * by quality), and so are the polys having each label. When a threshold
+ * moves, only the polys between the old and the new threshold are
+ * visited, and only the polys whose HIDDEN flag actually changes are
+ * written (and recorded in the CHANGES_POLY_DATA log of the mesh, so
+ * that drawables can update incrementally). The cache is rebuilt when
+ * the mesh change logs report edits to positions, connectivity, poly
+ * qualities or labels. Vertex positions are also checked against a cheap
+ * stamp (bounding box and a sparse sample of vertices), which catches most
+ * of the global edits not recorded in the logs (e.g. smoothing). Other
+ * edits not recorded in the logs require a reset().
 */
 template<class Mesh>
 class MeshSlicer
@@ -77,7 +93,33 @@ class MeshSlicer
 
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-        void update(Mesh & m, const SlicerState & s);
+        // returns true if the update was incremental, false if the cache had to be rebuilt
+        // (e.g. because the mesh changed), and all the polys have been filtered again
+        bool update(Mesh & m, const SlicerState & s);
+        bool update(Mesh & m, const SlicerState & s, std::vector<uint> & changed_polys);
+
+    protected:
+
+        enum { X, Y, Z, Q, L }; // filters (bits of pass)
+
+        void build_cache(const Mesh & m);
+        bool cache_is_valid(const Mesh & m) const;
+        void geometry_stamp(const Mesh & m, std::vector<vec3d> & stamp) const;
+        void thresholds(const Mesh & m, const SlicerState & s, double t[4]) const;
+        bool passes(const uint pid, const int filter, const SlicerState & s, const double t[4]) const;
+        void update_filter(const uint pid, const int filter, const SlicerState & s, const double t[4]);
+        void update_range(const int filter, const double t_old, const double t_new, const SlicerState & s, const double t[4], std::vector<uint> & touched);
+
+        bool                              valid = false;
+        SlicerState                       state;        // state the HIDDEN flags reflect
+        double                            thresh[4];    // absolute thresholds of state
+        std::vector<double>               key[4];       // per poly X,Y,Z centroid coordinates and quality
+        std::vector<uint>                 sorted[4];    // polys sorted by key (NaN keys excluded)
+        std::vector<int>                  label;        // per poly label
+        std::map<int,std::vector<uint>>   label_polys;  // polys having each label
+        std::vector<uint8_t>              pass;         // per poly bitmask of passed filters
+        uint64_t                          rev_pos, rev_polys, rev_poly_data; // revisions of the mesh change logs the cache reflects
+        std::vector<vec3d>                stamp;        // geometry stamp the cache reflects
 };
 
 }
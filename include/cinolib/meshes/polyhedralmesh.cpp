@@ -88,8 +88,14 @@ void Polyhedralmesh<M,V,E,F,P>::load(const char * filename)
     std::string str(filename);
     std::string filetype = "." + get_file_extension(str);
 
-    if (filetype.compare(".hybrid") == 0 ||
-        filetype.compare(".HYBRID") == 0)
+    if (filetype.compare(".cino") == 0 ||
+        filetype.compare(".CINO") == 0)
+    {
+        this->load_CINO(filename);
+        return;
+    }
+    else if (filetype.compare(".hybrid") == 0 ||
+             filetype.compare(".HYBRID") == 0)
     {
         read_HYBDRID(filename, tmp_verts, tmp_faces, tmp_polys, tmp_polys_face_winding);
         this->init(tmp_verts, tmp_faces, tmp_polys, tmp_polys_face_winding);
@@ -138,6 +144,11 @@ void Polyhedralmesh<M,V,E,F,P>::save(const char * filename) const
     {
         write_HEDRA(filename, this->verts, this->faces, this->polys, this->polys_face_winding);
     }
+    else if (get_file_extension(str).compare("cino") == 0 ||
+             get_file_extension(str).compare("CINO") == 0)
+    {
+        this->save_CINO(filename);
+    }
     else
     {
         std::cerr << "ERROR : " << __FILE__ << ", line " << __LINE__ << " : write() : file format not supported yet " << std::endl;
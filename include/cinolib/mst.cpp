@@ -34,6 +34,8 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/mst.h>
+#include <cinolib/min_max_inf.h>
+#include <queue>
 
 namespace cinolib
 {
@@ -50,19 +52,31 @@ void MST_on_dual_mask_on_edges(const AbstractPolygonMesh<M,V,E,P> & m,
     std::vector<int>   prev(m.num_polys(), -1);
     std::vector<float> cost(m.num_polys(), inf_float);
     std::vector<bool>  dequeued(m.num_polys(), false);
-    cost.at(0) = 0.f; // start with poly #0
 
-    // enqueue all elements
-    std::set<std::pair<float,uint>> q;
-    for(uint pid=0; pid<m.num_polys(); ++pid) q.insert(std::make_pair(cost.at(pid), pid));
+    // Priority updates are handled with lazy deletion: a new copy of a poly is pushed each
+    // time its cost decreases, and dead copies are skipped. Polys that are not reached are
+    // not enqueued at all: when the queue empties, the next tree starts from the unvisited
+    // poly with lowest id, exactly as if all polys were enqueued with infinite cost
+    typedef std::pair<float,uint> Item;
+    std::priority_queue<Item,std::vector<Item>,std::greater<Item>> q;
 
     // initialize an empty MST
     tree = std::vector<bool>(m.num_edges(), false);
 
-    while(!q.empty())
+    uint next_root = 0;
+    while(true)
     {
-        uint pid = q.begin()->second;
-        q.erase(q.begin());
+        if(q.empty())
+        {
+            while(next_root<m.num_polys() && dequeued.at(next_root)) ++next_root;
+            if(next_root==m.num_polys()) break;
+            if(next_root==0) cost.at(0) = 0.f; // start with poly #0
+            q.push(std::make_pair(cost.at(next_root), next_root));
+        }
+
+        uint pid = q.top().second;
+        q.pop();
+        if(dequeued.at(pid)) continue; // dead copy
         dequeued.at(pid) = true;
 
         if(prev.at(pid)!=-1) // add an edge to the MST
@@ -79,15 +93,9 @@ void MST_on_dual_mask_on_edges(const AbstractPolygonMesh<M,V,E,P> & m,
                 if(mask.at(eid)) continue;
                 if(cost.at(nbr) > weights.at(eid))
                 {
-                    // remove previous entry from queue
-                    auto it = q.find(std::make_pair(cost.at(nbr),nbr));
-                    assert(it!=q.end());
-                    q.erase(it);
-
-                    // update values and queue
                     cost.at(nbr) = weights.at(eid);
                     prev.at(nbr) = pid;
-                    q.insert(std::make_pair(weights.at(eid),nbr));
+                    q.push(std::make_pair(weights.at(eid),nbr));
                 }
             }
         }
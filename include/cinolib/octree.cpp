@@ -512,7 +512,7 @@ bool Octree::intersects_ray(const vec3d & p, const vec3d & dir, double & min_t,
                 {
                     for(uint i : child->item_indices)
                     {
-                        if(items.at(i)->intersects_ray(p, dir, t, pos))
+                        if(items.at(i)->intersects_ray(p, dir, t, pos) && t>=0) // ignore hits behind p
                         {
                             Obj obj;
                             obj.node  = child;
@@ -534,7 +534,7 @@ bool Octree::intersects_ray(const vec3d & p, const vec3d & dir, double & min_t,
 
     if(q.empty()) return false;
     assert(q.top().index>=0);
-    id    = items.at(q.top().index)->id;
+    id    = q.top().index; // already an item ID
     min_t = q.top().dist;
     return true;
 }
@@ -578,7 +578,7 @@ bool Octree::intersects_ray(const vec3d & p, const vec3d & dir, std::set<std::pa
                 {
                     for(uint i : child->item_indices)
                     {
-                        if(items.at(i)->intersects_ray(p, dir, t, pos))
+                        if(items.at(i)->intersects_ray(p, dir, t, pos) && t>=0) // ignore hits behind p
                         {
                             all_hits.insert(std::make_pair(t,items.at(i)->id));
                         }
@@ -714,4 +714,43 @@ bool Octree::intersects_box(const AABB & b, std::unordered_set<uint> & ids) cons
     return !ids.empty();
 }
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void Octree::closest_point(const std::vector<vec3d>  & p,
+                                 std::vector<uint>   & ids,
+                                 std::vector<vec3d>  & pos,
+                                 std::vector<double> & dist) const
+{
+    ids.resize(p.size());
+    pos.resize(p.size());
+    dist.resize(p.size());
+
+    PARALLEL_FOR(0, p.size(), 64, SCHEDULE_DYNAMIC, 64, [&](const uint i)
+    {
+        closest_point(p[i], ids[i], pos[i], dist[i]);
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void Octree::intersects_ray(const std::vector<vec3d>  & p,
+                            const std::vector<vec3d>  & dir,
+                                  std::vector<double> & min_t,
+                                  std::vector<int>    & ids) const
+{
+    assert(p.size()==dir.size());
+
+    min_t.assign(p.size(), inf_double);
+    ids.assign(p.size(), -1);
+
+    PARALLEL_FOR(0, p.size(), 64, SCHEDULE_DYNAMIC, 64, [&](const uint i)
+    {
+        uint id;
+        if(intersects_ray(p[i], dir[i], min_t[i], id)) ids[i] = id;
+        else min_t[i] = inf_double;
+    });
+}
+
 }
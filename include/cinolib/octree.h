@@ -180,7 +180,7 @@ class Octree
         bool contains(const vec3d & p, const bool strict, std::unordered_set<uint> & ids) const;
 
         // returns respectively the first and the full list of intersections
-        // between items in the octree and a ray R(t) := p + t * dir
+        // between items in the octree and a ray R(t) := p + t * dir (with t >= 0)
         bool intersects_ray(const vec3d & p, const vec3d & dir, double & min_t, uint & id) const; // first hit
         bool intersects_ray(const vec3d & p, const vec3d & dir, std::set<std::pair<double,uint>> & all_hits) const;
 
@@ -190,6 +190,13 @@ class Octree
         bool intersects_triangle(const vec3d t[], const bool ignore_if_valid_complex, std::unordered_set<uint> & ids) const;
         bool intersects_box     (const AABB  & b, std::unordered_set<uint> & ids) const;
 
+        // BATCHED QUERIES :::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // answer many independent queries at once, in parallel (one single query per
+        // element). ids[i] is -1 if the i-th ray does not hit anything
+        void closest_point (const std::vector<vec3d> & p, std::vector<uint> & ids, std::vector<vec3d> & pos, std::vector<double> & dist) const;
+        void intersects_ray(const std::vector<vec3d> & p, const std::vector<vec3d> & dir, std::vector<double> & min_t, std::vector<int> & ids) const;
+
         //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
         // all items live here, and leaf nodes only store indices to items
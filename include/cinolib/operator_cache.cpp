@@ -0,0 +1,155 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/operator_cache.h>
+#include <cinolib/laplacian.h>
+#include <cinolib/vertex_mass.h>
+#include <cinolib/gradient.h>
+
+namespace cinolib
+{
+
+template<class Mesh, class Assemble>
+CINO_INLINE
+OperatorCache::Handle OperatorCache::get(const Mesh & m, const Key & key, const Assemble & assemble)
+{
+    uint64_t topology = m.topology_revision();
+    uint64_t geometry = m.geometry_revision();
+
+    std::lock_guard<std::mutex> lock(mtx);
+    Item & item = items[key];
+    if(item.A==nullptr) item.A = std::make_shared<SparseAssembler>();
+
+    if(item.topology!=topology || item.geometry!=geometry)
+    {
+        // new handles are only created under the lock, hence if the count is
+        // one nobody else can be reading the matrix, and it can be overwritten
+        if(item.A.use_count()>1) item.A = std::make_shared<SparseAssembler>(*item.A);
+
+        if(item.topology!=topology)
+        {
+            item.A->clear();
+            assemble(*item.A);
+            ++assemblies;
+        }
+        else
+        {
+            assemble(*item.A); // the pattern is still valid: only values are recomputed
+            ++updates;
+        }
+    }
+    else ++hits;
+
+    item.topology = topology;
+    item.geometry = geometry;
+    return Handle(item.A, &item.A->matrix());
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+OperatorCache::Handle OperatorCache::laplacian(const Mesh & m, const int mode, const int n)
+{
+    return get(m, Key(LAPLACIAN, mode, n), [&](SparseAssembler & A)
+    {
+        cinolib::laplacian(m, mode, A, n);
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+OperatorCache::Handle OperatorCache::mass_matrix(const Mesh & m, const int n)
+{
+    return get(m, Key(MASS, 0, n), [&](SparseAssembler & A)
+    {
+        cinolib::mass_matrix(m, A, n);
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+OperatorCache::Handle OperatorCache::gradient_matrix(const Mesh & m, const bool per_poly)
+{
+    return get(m, Key(GRADIENT, per_poly, 1), [&](SparseAssembler & A)
+    {
+        cinolib::gradient_matrix(m, A, per_poly);
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void OperatorCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    items.clear();
+    hits       = 0;
+    updates    = 0;
+    assemblies = 0;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint OperatorCache::num_entries() const
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    return items.size();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void enable_operator_cache(Mesh & m)
+{
+    if(!m.operator_cache()) m.operator_cache_set(std::make_shared<OperatorCache>());
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void disable_operator_cache(Mesh & m)
+{
+    m.operator_cache_set(nullptr);
+}
+
+}
@@ -0,0 +1,147 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_OPERATOR_CACHE_H
+#define CINO_OPERATOR_CACHE_H
+
+#include <map>
+#include <mutex>
+#include <memory>
+#include <tuple>
+#include <stdint.h>
+#include <sys/types.h>
+#include <cinolib/cino_inline.h>
+#include <cinolib/sparse_assembler.h>
+#include <Eigen/Sparse>
+
+namespace cinolib
+{
+
+/* Per mesh cache of differential operators (laplacian, mass matrix, gradient).
+ * Operators are keyed by their type and parameters, and tagged with the geometry
+ * and topology revisions of the mesh they were computed from (see mesh_revision.h),
+ * which are O(1) to query. When an operator is requested again:
+ *
+ *  - if neither vertex positions nor connectivity changed, the cached matrix is returned;
+ *  - if only vertex positions changed, values are re-assembled in the cached sparsity pattern;
+ *  - if connectivity changed, the operator is assembled from scratch.
+ *
+ * The cache is opt-in: once enabled on a mesh, the plain operator functions
+ * (laplacian(m,mode), mass_matrix(m), gradient_matrix(m)) use it transparently,
+ * hence all the algorithms built on top of them (e.g. geodesics, heat flow,
+ * harmonic maps, smoothing) amortize the operators they share across calls.
+ *
+ * Usage:
+ *
+ *  enable_operator_cache(m);
+ *  ScalarField d0 = compute_geodesics(m, {0});  // assembles L, M and G
+ *  ScalarField d1 = compute_geodesics(m, {10}); // reuses them
+ *
+ * Operators are returned as shared handles to immutable matrices, hence a cache hit
+ * costs no copy, and a handle stays valid (and unchanged) even if the operator is
+ * re-assembled afterwards. Copies of a mesh share its cache (entries are tagged with
+ * revisions, so sharing is safe). Operators can be requested concurrently from
+ * multiple threads.
+*/
+class OperatorCache
+{
+    public:
+
+        typedef std::shared_ptr<const Eigen::SparseMatrix<double>> Handle;
+
+        OperatorCache() {}
+
+        template<class Mesh>
+        Handle laplacian(const Mesh & m, const int mode, const int n = 1);
+
+        template<class Mesh>
+        Handle mass_matrix(const Mesh & m, const int n = 1);
+
+        template<class Mesh>
+        Handle gradient_matrix(const Mesh & m, const bool per_poly = true);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        void clear();
+        uint num_entries() const;
+
+        // statistics: operators returned as they were, re-assembled in the
+        // cached pattern (geometry changed), and assembled from scratch
+        uint num_hits()        const { return hits;        }
+        uint num_updates()     const { return updates;     }
+        uint num_assemblies()  const { return assemblies;  }
+
+    protected:
+
+        enum { LAPLACIAN, MASS, GRADIENT };
+
+        typedef std::tuple<int,int,int> Key; // operator, parameter, replicas
+
+        struct Item
+        {
+            uint64_t                         geometry = 0;
+            uint64_t                         topology = 0;
+            std::shared_ptr<SparseAssembler> A; // handles alias its matrix
+        };
+
+        // returns the matrix cached at key, calling assemble(A) to (re)compute it if needed.
+        // If handles to the cached matrix are still around, values are written in a copy
+        template<class Mesh, class Assemble>
+        Handle get(const Mesh & m, const Key & key, const Assemble & assemble);
+
+        mutable std::mutex mtx;
+        std::map<Key,Item> items;
+        uint hits       = 0;
+        uint updates    = 0;
+        uint assemblies = 0;
+};
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Mesh>
+CINO_INLINE
+void enable_operator_cache(Mesh & m);
+
+template<class Mesh>
+CINO_INLINE
+void disable_operator_cache(Mesh & m);
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "operator_cache.cpp"
+#endif
+
+#endif // CINO_OPERATOR_CACHE_H
@@ -56,8 +56,8 @@ void padding(AbstractPolyhedralMesh<M,V,E,F,P> & m, const bool inwards)
         {
             uint  new_vid = m.vert_add(m.vert(vid));       // update position;
             vec3d off     = m.vert_data(vid).normal*l*0.5;
-            if(inwards) m.vert(  vid  ) -= off;
-            else        m.vert(new_vid) += off;
+            if(inwards) m.vert_move(  vid  , m.vert(  vid  ) - off);
+            else        m.vert_move(new_vid, m.vert(new_vid) + off);
             vmap[vid] = new_vid;
         }
     }
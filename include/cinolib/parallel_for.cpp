@@ -34,13 +34,34 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/parallel_for.h>
-#include <thread>
+#include <cinolib/thread_pool.h>
+#include <algorithm>
+#include <atomic>
 #include <vector>
-#include <cmath>
 
 namespace cinolib
 {
 
+CINO_INLINE
+void parallel_for_set_num_threads(const uint n_threads)
+{
+    ThreadPool::instance().set_num_threads(n_threads);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint parallel_for_num_threads()
+{
+#ifndef SERIALIZE_PARALLEL_FOR
+    return ThreadPool::instance().num_threads();
+#else
+    return 1;
+#endif
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<typename Func>
 CINO_INLINE
 static void PARALLEL_FOR(      uint   beg,
@@ -48,52 +69,124 @@ static void PARALLEL_FOR(      uint   beg,
                          const uint   serial_if_less_than,
                          const Func & func)
 {
+    PARALLEL_FOR(beg, end, serial_if_less_than, SCHEDULE_STATIC, 1, func);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<typename Func>
+CINO_INLINE
+static void PARALLEL_FOR(      uint              beg,
+                               uint              end,
+                         const uint              serial_if_less_than,
+                         const ParallelSchedule  schedule,
+                         const uint              grain_size,
+                         const Func            & func)
+{
+    if(end<=beg) return;
+
 #ifndef SERIALIZE_PARALLEL_FOR
 
-    uint n = end - beg + 1;
+    uint n = end - beg;
+    ThreadPool & pool = ThreadPool::instance();
 
-    if(n<serial_if_less_than)
+    if(n<serial_if_less_than || pool.num_threads()<2)
     {
         for(uint i=beg; i<end; ++i) func(i);
+        return;
     }
-    else
-    {
-        // estimate number of threads in the pool
-        const static unsigned n_threads_hint = std::thread::hardware_concurrency();
-        const static unsigned n_threads      = (n_threads_hint==0u) ? 8u : n_threads_hint;
 
-        // split the full range into sub ranges of equal size
-        uint slice = (uint)std::round(n/static_cast<double>(n_threads));
-        slice = std::max(slice,uint(1));
+    const size_t n_threads = pool.num_threads();
+    const size_t grain     = std::max(grain_size, uint(1));
+    std::atomic<size_t> next(beg);
 
-        // helper function that handles a sub range
-        auto subrange_helper = [&func](uint k1, uint k2)
-        {
-            for(uint k=k1; k<k2; ++k) func(k);
-        };
-
-        // create pool and launch jobs
-        std::vector<std::thread> pool;
-        pool.reserve(n_threads);
-        uint i1 = beg;
-        uint i2 = std::min(beg + slice, end);
-        for(uint i=0; i+1<n_threads && i1<end; ++i)
+    auto job = [&](const uint thread_id)
+    {
+        switch(schedule)
         {
-            pool.emplace_back(subrange_helper, i1, i2);
-            i1 = i2;
-            i2 = std::min(i2+slice, end);
-        }
-        if(i1<end) pool.emplace_back(subrange_helper, i1, end);
+            case SCHEDULE_STATIC:
+            {
+                // split the full range into sub ranges of equal size
+                size_t slice = (n + n_threads - 1) / n_threads;
+                size_t i1    = std::min(size_t(beg) + thread_id*slice, size_t(end));
+                size_t i2    = std::min(i1 + slice, size_t(end));
+                for(size_t i=i1; i<i2; ++i) func(uint(i));
+                break;
+            }
 
-        // Wait for jobs to finish
-        for(std::thread & t : pool)
-        {
-            if(t.joinable()) t.join();
+            case SCHEDULE_DYNAMIC:
+            {
+                for(;;)
+                {
+                    size_t i1 = next.fetch_add(grain);
+                    if(i1>=end) break;
+                    size_t i2 = std::min(i1+grain, size_t(end));
+                    for(size_t i=i1; i<i2; ++i) func(uint(i));
+                }
+                break;
+            }
+
+            case SCHEDULE_GUIDED:
+            {
+                size_t i1 = next.load();
+                for(;;)
+                {
+                    if(i1>=end) break;
+                    size_t chunk = std::max(grain, (end-i1)/(2*n_threads));
+                    size_t i2    = std::min(i1+chunk, size_t(end));
+                    if(next.compare_exchange_weak(i1,i2))
+                    {
+                        for(size_t i=i1; i<i2; ++i) func(uint(i));
+                        i1 = next.load();
+                    }
+                }
+                break;
+            }
         }
+    };
+
+    // the pool is already busy (e.g. nested loop): go serial
+    if(!pool.run(job))
+    {
+        for(uint i=beg; i<end; ++i) func(i);
     }
 #else
+    (void)serial_if_less_than;
+    (void)schedule;
+    (void)grain_size;
     for(uint i=beg; i<end; ++i) func(i);
 #endif
 }
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<typename T, typename Func, typename Reduce>
+CINO_INLINE
+static T PARALLEL_REDUCE(      uint     beg,
+                               uint     end,
+                         const uint     serial_if_less_than,
+                         const T      & identity,
+                         const Func   & func,
+                         const Reduce & reduce)
+{
+    if(end<=beg) return identity;
+
+    // blocks have fixed size, so that partial results (and the
+    // order in which they are merged) do not depend on threads
+    const uint block    = 1024;
+    const uint n_blocks = (end - beg + block - 1) / block;
+
+    std::vector<T> partials(n_blocks, identity);
+    PARALLEL_FOR(0, n_blocks, std::max(serial_if_less_than/block, uint(2)), SCHEDULE_DYNAMIC, 1, [&](const uint b)
+    {
+        uint i1 = beg + b*block;
+        uint i2 = std::min(i1+block, end);
+        for(uint i=i1; i<i2; ++i) func(i, partials[b]);
+    });
+
+    T res = identity;
+    for(const T & p : partials) res = reduce(res, p);
+    return res;
+}
+
 }
@@ -45,11 +45,10 @@ namespace cinolib
 /* OpenMP-like parallel for loop realized in plain C++11
  * Thanks to Jeremy Dumas for his code (https://ideone.com/Z7zldb)
  *
- * DISCLAIMER: this routine is as good as OpenMP with STATIC scheduling.
- * That is, it works best when computational cost is equally distributed
- * across all threads. In case of unbalanced distribution, performances
- * may degrade, and using the DYNAMIC scheduling of a library such as OpenMP
- * will greatly benefit performances.
+ * Loops are executed by a persistent pool of threads (see thread_pool.h),
+ * hence there is no thread creation overhead at each call, and parallel
+ * loops can be safely used inside iterative algorithms. Nested parallel
+ * loops are executed serially by the thread that issues them.
  *
  * PARALLEL_FOR has three arguments
  *
@@ -75,16 +74,74 @@ namespace cinolib
  *    m.update_p_normal(pid);
  * });
  *
+ * The basic version uses STATIC scheduling, which works best when the
+ * computational cost is equally distributed across all iterations. For
+ * unbalanced loops the scheduling policy and grain size can be specified
+ * as in OpenMP:
+ *
+ *     SCHEDULE_STATIC  : the range is split in as many slices as threads
+ *     SCHEDULE_DYNAMIC : threads grab chunks of grain_size iterations on demand
+ *     SCHEDULE_GUIDED  : as dynamic, but chunks start big and shrink to grain_size
+ *
+ * PARALLEL_FOR(0, o.leaves.size(), 1, SCHEDULE_DYNAMIC, 4, [&](uint i) { ... });
+ *
+ * PARALLEL_REDUCE computes partial results on fixed size blocks of the range,
+ * and then merges them in block order. Results are therefore deterministic,
+ * regardless of the number of threads and of how blocks are scheduled:
+ *
+ * double area = PARALLEL_REDUCE(0, m.num_polys(), 1000, 0.0,
+ *                               [&](uint pid, double & sum)   { sum += m.poly_area(pid); },
+ *                               [ ](double a, double b)       { return a+b; });
+ *
  * NOTE: if symbol SERIALIZE_PARALLEL_FOR is defined at compilation time,
- * the loop will be executed in standard serial mode.
+ * all loops will be executed in standard serial mode.
 */
 
+typedef enum
+{
+    SCHEDULE_STATIC,
+    SCHEDULE_DYNAMIC,
+    SCHEDULE_GUIDED,
+}
+ParallelSchedule;
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// global control of the number of threads used by parallel loops
+// (zero means: use all the available hardware threads)
+CINO_INLINE void parallel_for_set_num_threads(const uint n_threads);
+CINO_INLINE uint parallel_for_num_threads();
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<typename Func>
 CINO_INLINE
 static void PARALLEL_FOR(      uint   beg,
                                uint   end,
                          const uint   serial_if_less_than,
                          const Func & func);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<typename Func>
+CINO_INLINE
+static void PARALLEL_FOR(      uint              beg,
+                               uint              end,
+                         const uint              serial_if_less_than,
+                         const ParallelSchedule  schedule,
+                         const uint              grain_size,
+                         const Func            & func);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<typename T, typename Func, typename Reduce>
+CINO_INLINE
+static T PARALLEL_REDUCE(      uint     beg,
+                               uint     end,
+                         const uint     serial_if_less_than,
+                         const T      & identity,
+                         const Func   & func,    // void func(uint i, T & partial)
+                         const Reduce & reduce); // T reduce(const T & a, const T & b)
 }
 
 #ifndef  CINO_STATIC_LIB
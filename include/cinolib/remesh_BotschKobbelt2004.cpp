@@ -35,33 +35,24 @@
 *********************************************************************************/
 #include <cinolib/remesh_BotschKobbelt2004.h>
 #include <cinolib/tangential_smoothing.h>
+#include <cinolib/parallel_for.h>
 
 namespace cinolib
 {
 
-/* This method implements one iteration of the remeshing algorithm
- * described in:
- *
- * A Remeshing Approach to Multiresolution Modeling
- * M.Botsch, L.Kobbelt
- * Symposium on Geomtry Processing, 2004
-*/
-
+// 1) split too long edges
+//
 template<class M, class V, class E, class P>
 CINO_INLINE
-void remesh_Botsch_Kobbelt_2004(DrawableTrimesh<M,V,E,P> & m,
-                                const double               target_edge_length,
-                                const bool                 preserve_marked_features)
+uint remesh_split_long_edges(Trimesh<M,V,E,P> & m,
+                             const double       max_length,
+                             const bool         preserve_marked_features)
 {
-    double l = (target_edge_length>0) ? target_edge_length : m.edge_avg_length();
-
-    // 1) split too long edges
-    //
     uint count = 0;
     uint ne = m.num_edges();
     for(uint eid=0; eid<ne; ++eid)
     {
-        if (m.edge_length(eid) > 4./3.*l)
+        if (m.edge_length(eid) > max_length)
         {
             bool mark_children = (preserve_marked_features && m.edge_data(eid).flags[MARKED]);
             uint vid0 = m.edge_vert_id(eid, 0);
@@ -78,11 +69,20 @@ void remesh_Botsch_Kobbelt_2004(DrawableTrimesh<M,V,E,P> & m,
             }
         }
     }
-    std::cout << "\t" << count << " edges longer than " << 4./3.*l << " were split." << std::endl;
+    return count;
+}
 
-    // 2) collapse too short edges
-    //
-    count = 0;
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// 2) collapse too short edges
+//
+template<class M, class V, class E, class P>
+CINO_INLINE
+uint remesh_collapse_short_edges(Trimesh<M,V,E,P> & m,
+                                 const double       min_length,
+                                 const bool         preserve_marked_features)
+{
+    uint count = 0;
     for(uint eid=0; eid<m.num_edges(); ++eid)
     {
         bool inc_to_marked = false;
@@ -95,17 +95,24 @@ void remesh_Botsch_Kobbelt_2004(DrawableTrimesh<M,V,E,P> & m,
         }
         if (preserve_marked_features && inc_to_marked) continue;
 
-        if (m.edge_length(eid) < 4./5.*l)
+        if (m.edge_length(eid) < min_length)
         {
-            m.edge_collapse(eid, 0.5);
-            ++count;
+            if(m.edge_collapse(eid, 0.5)>=0) ++count;
         }
     }
-    std::cout << "\t" << count << " edges shorter than " << 4./5.*l << " were collapsed." << std::endl;
+    return count;
+}
 
-    // 3) optimize per vert valence
-    //
-    count = 0;
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// 3) optimize per vert valence
+//
+template<class M, class V, class E, class P>
+CINO_INLINE
+uint remesh_equalize_valences(Trimesh<M,V,E,P> & m,
+                              const bool         preserve_marked_features)
+{
+    uint count = 0;
     for(uint eid=0; eid<m.num_edges(); ++eid)
     {
         if (preserve_marked_features && m.edge_data(eid).flags[MARKED]) continue;
@@ -159,8 +166,27 @@ void remesh_Botsch_Kobbelt_2004(DrawableTrimesh<M,V,E,P> & m,
             ++count;
         }
     }
-    std::cout << "\t" << count << " edge flip were performed to normalize vertex valence to 6" << std::endl;
+    return count;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class M, class V, class E, class P>
+CINO_INLINE
+void remesh_Botsch_Kobbelt_2004(Trimesh<M,V,E,P> & m,
+                                const double       target_edge_length,
+                                const bool         preserve_marked_features)
+{
+    double l = (target_edge_length>0) ? target_edge_length : m.edge_avg_length();
+
+    uint count = remesh_split_long_edges(m, 4./3.*l, preserve_marked_features);
+    std::cout << "\t" << count << " edges longer than " << 4./3.*l << " were split." << std::endl;
 
+    count = remesh_collapse_short_edges(m, 4./5.*l, preserve_marked_features);
+    std::cout << "\t" << count << " edges shorter than " << 4./5.*l << " were collapsed." << std::endl;
+
+    count = remesh_equalize_valences(m, preserve_marked_features);
+    std::cout << "\t" << count << " edge flip were performed to normalize vertex valence to 6" << std::endl;
 
     // 4) relocate vertices by tangential smoothing
     //
@@ -176,4 +202,145 @@ void remesh_Botsch_Kobbelt_2004(DrawableTrimesh<M,V,E,P> & m,
     std::cout << "\ttangential smoothing" << std::endl;
 }
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class SpatialIndex, class M, class V, class E, class P>
+CINO_INLINE
+void remesh_Botsch_Kobbelt_2004(Trimesh<M,V,E,P>      & m,
+                                const RemesherOptions & opt)
+{
+    double l = (opt.target_edge_length>0) ? opt.target_edge_length : m.edge_avg_length();
+
+    auto is_feature = [&](const uint eid) -> bool
+    {
+        return m.edge_is_boundary(eid) || (opt.preserve_marked_features && m.edge_data(eid).flags[MARKED]);
+    };
+
+    // spatial indices of the input surface and of its feature lines
+    SpatialIndex o_srf;
+    SpatialIndex o_line;
+    bool has_features = false;
+    if(opt.reproject_on_target)
+    {
+        for(uint eid=0; eid<m.num_edges(); ++eid)
+        {
+            if(is_feature(eid))
+            {
+                o_line.push_segment(eid, m.edge_verts(eid));
+                has_features = true;
+            }
+        }
+        o_srf.build_from_mesh_polys(m);
+        o_line.build();
+    }
+
+    enum { REGULAR, FEATURE, CORNER };
+    std::vector<int>   type;
+    std::vector<vec3d> pos;
+    std::vector<uint>  srf_verts,  line_verts;
+    std::vector<vec3d> srf_points, line_points;
+    std::vector<uint>  ids;
+    std::vector<vec3d> proj;
+    std::vector<double> dist;
+
+    for(uint i=0; i<opt.n_iters; ++i)
+    {
+        uint n_split    = remesh_split_long_edges    (m, 4./3.*l, opt.preserve_marked_features);
+        uint n_collapse = remesh_collapse_short_edges(m, 4./5.*l, opt.preserve_marked_features);
+        uint n_flip     = remesh_equalize_valences   (m, opt.preserve_marked_features);
+
+        // classify vertices w.r.t. the number of incident feature edges
+        uint nv = m.num_verts();
+        type.resize(nv);
+        PARALLEL_FOR(0, nv, 1000, [&](const uint vid)
+        {
+            uint count = 0;
+            for(uint eid : m.adj_v2e(vid)) if(is_feature(eid)) ++count;
+            switch(count)
+            {
+                case 0  : type.at(vid) = REGULAR; break;
+                case 2  : type.at(vid) = FEATURE; break;
+                default : type.at(vid) = CORNER;  break;
+            }
+        });
+
+        // Jacobi-style tangential smoothing: regular vertices move towards the
+        // barycenter of their neighbors in the tangent plane, feature vertices
+        // move towards the barycenter of their two feature neighbors along the line
+        pos.resize(nv);
+        PARALLEL_FOR(0, nv, 1000, [&](const uint vid)
+        {
+            const vec3d & p = m.vert(vid);
+            pos.at(vid) = p;
+            if(type.at(vid)==REGULAR)
+            {
+                if(m.adj_v2v(vid).empty()) return;
+                vec3d delta(0,0,0);
+                for(uint nbr : m.adj_v2v(vid)) delta += m.vert(nbr);
+                delta /= static_cast<double>(m.adj_v2v(vid).size());
+                delta -= p;
+                const vec3d & n = m.vert_data(vid).normal;
+                pos.at(vid) += delta - n * delta.dot(n);
+            }
+            else if(type.at(vid)==FEATURE)
+            {
+                vec3d nbrs[2];
+                uint  count = 0;
+                for(uint eid : m.adj_v2e(vid))
+                {
+                    if(is_feature(eid)) nbrs[count++] = m.vert(m.vert_opposite_to(eid,vid));
+                }
+                vec3d dir = nbrs[1] - nbrs[0];
+                if(dir.norm()==0) return;
+                dir.normalize();
+                vec3d delta = 0.5*(nbrs[0] + nbrs[1]) - p;
+                pos.at(vid) += dir * delta.dot(dir);
+            }
+        });
+
+        // project smoothed vertices onto the input surface (or feature lines)
+        if(opt.reproject_on_target)
+        {
+            srf_verts.clear(); srf_points.clear();
+            line_verts.clear(); line_points.clear();
+            for(uint vid=0; vid<nv; ++vid)
+            {
+                switch(type.at(vid))
+                {
+                    case REGULAR : srf_verts.push_back(vid);  srf_points.push_back(pos.at(vid));  break;
+                    case FEATURE : line_verts.push_back(vid); line_points.push_back(pos.at(vid)); break;
+                    default      : break;
+                }
+            }
+            if(!srf_points.empty())
+            {
+                o_srf.closest_point(srf_points, ids, proj, dist);
+                for(uint j=0; j<srf_verts.size(); ++j) pos.at(srf_verts.at(j)) = proj.at(j);
+            }
+            if(has_features && !line_points.empty())
+            {
+                o_line.closest_point(line_points, ids, proj, dist);
+                for(uint j=0; j<line_verts.size(); ++j) pos.at(line_verts.at(j)) = proj.at(j);
+            }
+        }
+
+        PARALLEL_FOR(0, nv, 1000, [&](const uint vid)
+        {
+            m.vert(vid) = pos.at(vid);
+        });
+        m.mark_changed(CHANGES_VERT_POS);
+        m.update_normals();
+
+        if(opt.verbose)
+        {
+            std::cout << "iter " << i << ": "
+                      << n_split    << " splits, "
+                      << n_collapse << " collapses, "
+                      << n_flip     << " flips ("
+                      << m.num_verts() << " verts, "
+                      << m.num_polys() << " polys)" << std::endl;
+        }
+    }
+}
+
 }
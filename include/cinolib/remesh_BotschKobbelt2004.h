@@ -36,8 +36,9 @@
 #ifndef CINO_REMESH_BOTSCH_KOBBELT_2004_H
 #define CINO_REMESH_BOTSCH_KOBBELT_2004_H
 
-#include <cinolib/meshes/drawable_trimesh.h>
-#include <cinolib/gui/qt/glcanvas.h>
+#include <cinolib/meshes/trimesh.h>
+#include <cinolib/octree.h>
+#include <cinolib/bvh.h>
 
 namespace cinolib
 {
@@ -52,9 +53,41 @@ namespace cinolib
 
 template<class M, class V, class E, class P>
 CINO_INLINE
-void remesh_Botsch_Kobbelt_2004(DrawableTrimesh<M,V,E,P> & m,
-                                const double               target_edge_length = -1,
-                                const bool                 preserve_marked_features = true);
+void remesh_Botsch_Kobbelt_2004(Trimesh<M,V,E,P> & m,
+                                const double       target_edge_length = -1,
+                                const bool         preserve_marked_features = true);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+typedef struct
+{
+    uint   n_iters                  = 5;     // # of remeshing iterations (split, collapse, flip, smooth)
+    double target_edge_length       = -1;    // if not positive, the average edge length of the input mesh is used
+    bool   preserve_marked_features = true;  // marked edges are never flipped or collapsed, and their vertices only slide along them
+    bool   reproject_on_target      = true;  // project smoothed vertices back onto the input surface
+    bool   verbose                  = false; // print per iteration statistics
+}
+RemesherOptions;
+
+/* Runs opt.n_iters iterations of the same algorithm, with no dependency
+ * from the GUI. Differently from the method above, the target edge length
+ * is computed once, on the input mesh, and vertices are relocated with a
+ * Jacobi-style tangential smoothing, followed by a projection onto the
+ * input surface. Both stages are computed in parallel. Regular vertices
+ * are smoothed in the tangent plane and projected on the closest input
+ * triangle. Vertices along feature lines (marked edges if
+ * opt.preserve_marked_features, plus the mesh boundary) are smoothed
+ * along the line and projected on the closest input feature edge.
+ * Vertices where feature lines meet or terminate are held in place.
+ *
+ * SpatialIndex is the data structure used to reproject on the input
+ * surface (e.g. Octree or BVH).
+*/
+
+template<class SpatialIndex = BVH, class M, class V, class E, class P>
+CINO_INLINE
+void remesh_Botsch_Kobbelt_2004(Trimesh<M,V,E,P>      & m,
+                                const RemesherOptions & opt);
 }
 
 #ifndef  CINO_STATIC_LIB
@@ -36,22 +36,22 @@
 #include <cinolib/smoother.h>
 #include <cinolib/laplacian.h>
 #include <cinolib/linear_solvers.h>
-#include <cinolib/octree.h>
 
 namespace cinolib
 {
 
-template<class M1, class V1, class E1, class P1,
+template<class SpatialIndex,
+         class M1, class V1, class E1, class P1,
          class M2, class V2, class E2, class P2>
 CINO_INLINE
 void mesh_smoother(      AbstractPolygonMesh<M1,V1,E1,P1> & m,
                    const AbstractPolygonMesh<M2,V2,E2,P2> & target,
                    const SmootherOptions                  & opt)
 {
-    // BUILD OCTREES
-    Octree o_srf;    // for general surface
-    Octree o_line;   // for feature lines
-    Octree o_corner; // for feature corners (i.e. points where feature lines meet or terminate)
+    // BUILD SPATIAL INDICES
+    SpatialIndex o_srf;    // for general surface
+    SpatialIndex o_line;   // for feature lines
+    SpatialIndex o_corner; // for feature corners (i.e. points where feature lines meet or terminate)
     //
     for(uint eid=0; eid<target.num_edges(); ++eid)
     {
@@ -223,6 +223,10 @@ void mesh_smoother(      AbstractPolygonMesh<M1,V1,E1,P1> & m,
         ++row;
     };
 
+    // as long as vertices do not change category the system keeps the same
+    // sparsity pattern, and each iteration only refactorizes numerically
+    LinearSolverCache cache;
+
     // SMOOTHING ITERATIONS
     for(uint i=0; i<opt.n_iters; ++i)
     {
@@ -243,7 +247,7 @@ void mesh_smoother(      AbstractPolygonMesh<M1,V1,E1,P1> & m,
         Eigen::VectorXd RHS = Eigen::Map<Eigen::VectorXd>(rhs.data(), rhs.size());
         Eigen::VectorXd W   = Eigen::Map<Eigen::VectorXd>(w.data(), w.size());
         Eigen::VectorXd res;
-        solve_weighted_least_squares(A, W, RHS, res);
+        solve_weighted_least_squares(A, W, RHS, res, SIMPLICIAL_LLT, &cache);
 
         uint nv = m.num_verts();
         for(uint vid=0; vid<nv; ++vid)
@@ -264,6 +268,7 @@ void mesh_smoother(      AbstractPolygonMesh<M1,V1,E1,P1> & m,
                 default: assert(false && "unknown vertex type");
             }
         }
+        m.mark_changed(CHANGES_VERT_POS);
 
         if(i<opt.n_iters)
         {
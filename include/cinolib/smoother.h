@@ -37,6 +37,7 @@
 #define CINO_SMOOTHER_H
 
 #include <cinolib/meshes/meshes.h>
+#include <cinolib/octree.h>
 
 namespace cinolib
 {
@@ -104,7 +105,9 @@ SmootherOptions;
 
 //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-template<class M1, class V1, class E1, class P1,
+// SpatialIndex is the data structure used to reproject on target (e.g. Octree or BVH)
+template<class SpatialIndex = Octree,
+         class M1, class V1, class E1, class P1,
          class M2, class V2, class E2, class P2>
 CINO_INLINE
 void mesh_smoother(      AbstractPolygonMesh<M1,V1,E1,P1> & m,
@@ -0,0 +1,175 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/sparse_assembler.h>
+#include <cinolib/parallel_for.h>
+#include <algorithm>
+#include <cassert>
+
+namespace cinolib
+{
+
+template<class ColRows>
+CINO_INLINE
+void SparseAssembler::init_pattern(const uint n_rows, const uint n_cols, const ColRows & col_rows, const uint64_t key)
+{
+    A.resize(n_rows, n_cols);
+
+    auto sorted_rows = [&](const uint col, std::vector<uint> & rows)
+    {
+        rows.clear();
+        col_rows(col, rows);
+        std::sort(rows.begin(), rows.end());
+        rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+    };
+
+    // count the non zeros of each column...
+    std::vector<int> count(n_cols);
+    PARALLEL_FOR(0, n_cols, 1000, [&](const uint col)
+    {
+        thread_local std::vector<uint> rows;
+        sorted_rows(col, rows);
+        count.at(col) = rows.size();
+    });
+
+    int * outer = A.outerIndexPtr();
+    outer[0] = 0;
+    for(uint col=0; col<n_cols; ++col) outer[col+1] = outer[col] + count.at(col);
+    A.resizeNonZeros(outer[n_cols]);
+
+    // ...and fill the inner indices
+    int    * inner = A.innerIndexPtr();
+    double * val   = A.valuePtr();
+    PARALLEL_FOR(0, n_cols, 1000, [&](const uint col)
+    {
+        thread_local std::vector<uint> rows;
+        sorted_rows(col, rows);
+        for(uint i=0; i<rows.size(); ++i)
+        {
+            assert(rows.at(i) < n_rows);
+            inner[outer[col]+i] = rows.at(i);
+            val  [outer[col]+i] = 0.0;
+        }
+    });
+
+    ready     = true;
+    this->key = key;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class ColRows, class Fill>
+CINO_INLINE
+void SparseAssembler::assemble(const uint n_rows, const uint n_cols, const uint64_t key, const ColRows & col_rows, const Fill & fill)
+{
+    if(!has_pattern(n_rows, n_cols, key)) init_pattern(n_rows, n_cols, col_rows, key);
+    set_zero();
+    if(fill()) return;
+
+    clear();
+    init_pattern(n_rows, n_cols, col_rows, key);
+    set_zero();
+    bool ok = fill();
+    assert(ok && "entries not listed by col_rows");
+    (void)ok;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void SparseAssembler::clear()
+{
+    A     = Eigen::SparseMatrix<double>();
+    ready = false;
+    key   = 0;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool SparseAssembler::has_pattern(const uint n_rows, const uint n_cols, const uint64_t key) const
+{
+    return ready && num_rows()==n_rows && num_cols()==n_cols && this->key==key;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+int SparseAssembler::slot(const uint row, const uint col) const
+{
+    assert(col < num_cols());
+    const int * inner = A.innerIndexPtr();
+    const int * beg   = inner + A.outerIndexPtr()[col];
+    const int * end   = inner + A.outerIndexPtr()[col+1];
+    const int * it    = std::lower_bound(beg, end, static_cast<int>(row));
+    if(it==end || *it!=static_cast<int>(row)) return -1;
+    return it - inner;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void SparseAssembler::set_zero()
+{
+    double * val = A.valuePtr();
+    PARALLEL_FOR(0, num_nonzeros(), 100000, [val](const uint i)
+    {
+        val[i] = 0.0;
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool SparseAssembler::add(const uint row, const uint col, const double val)
+{
+    int s = slot(row,col);
+    if(s<0) return false;
+    A.valuePtr()[s] += val;
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool SparseAssembler::set(const uint row, const uint col, const double val)
+{
+    int s = slot(row,col);
+    if(s<0) return false;
+    A.valuePtr()[s] = val;
+    return true;
+}
+
+}
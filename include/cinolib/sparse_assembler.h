@@ -0,0 +1,126 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_SPARSE_ASSEMBLER_H
+#define CINO_SPARSE_ASSEMBLER_H
+
+#include <cinolib/cino_inline.h>
+#include <sys/types.h>
+#include <vector>
+#include <stdint.h>
+#include <Eigen/Sparse>
+
+namespace cinolib
+{
+
+/* Assembles a sparse matrix directly into (column major) compressed storage.
+ * The sparsity pattern is computed once, column by column, and in parallel.
+ * Values are then written in place, looking up the position of each entry
+ * in its column, with no intermediate list of triplets to sort and compress.
+ * Re-assembling the values of a matrix with the same pattern (e.g. an operator
+ * of a mesh whose vertices moved) therefore only costs the value computation.
+ *
+ * Usage:
+ *
+ *  i)   call init_pattern, with a function that lists the (row) indices of the
+ *       non zero entries of each column (duplicates are allowed)
+ *  ii)  call set_zero, and accumulate values with add (or overwrite them with set)
+ *  iii) get the assembled matrix with matrix()
+ *
+ * or do all of the above with assemble(). add/set can be called concurrently, as long
+ * as no two threads touch the same entry. Patterns can be tagged with a key identifying
+ * the data they were computed from. The mesh operators built on top of this class
+ * (laplacian, mass_matrix, gradient_matrix) accept an assembler, and use the topology
+ * revision of the mesh as key, hence they recompute the pattern only the first time
+ * they are called, or after the mesh connectivity changed. Use one assembler per operator.
+*/
+class SparseAssembler
+{
+    public:
+
+        SparseAssembler() {}
+
+        // col_rows(col, rows) appends to rows the row indices of the non zeros of column col.
+        // It is called twice per column, concurrently
+        template<class ColRows>
+        void init_pattern(const uint n_rows, const uint n_cols, const ColRows & col_rows, const uint64_t key = 0);
+
+        void clear();
+        bool has_pattern() const { return ready; }
+        bool has_pattern(const uint n_rows, const uint n_cols, const uint64_t key = 0) const;
+
+        // (re)computes the pattern if it does not match size and key, zeroes the values and
+        // calls fill(), which writes them and returns false if some entry was not in the pattern
+        // (e.g. because the data it was computed from changed without changing the key). In that
+        // case the pattern is computed from scratch, and fill() is called once more
+        template<class ColRows, class Fill>
+        void assemble(const uint n_rows, const uint n_cols, const uint64_t key, const ColRows & col_rows, const Fill & fill);
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        // index of entry (row,col) in the value array (-1 if it is not in the pattern)
+        int slot(const uint row, const uint col) const;
+
+        // add/set return false (and write nothing) if the entry is not in the pattern
+        void set_zero();
+        bool add(const uint row, const uint col, const double val);
+        bool set(const uint row, const uint col, const double val);
+
+        double       * values()       { return A.valuePtr(); }
+        const double * values() const { return A.valuePtr(); }
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        uint num_rows()     const { return A.rows();      }
+        uint num_cols()     const { return A.cols();      }
+        uint num_nonzeros() const { return A.nonZeros();  }
+
+        const Eigen::SparseMatrix<double> & matrix() const { return A; }
+              Eigen::SparseMatrix<double> & matrix()       { return A; }
+
+    protected:
+
+        bool     ready = false;
+        uint64_t key   = 0;
+        Eigen::SparseMatrix<double> A;
+};
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "sparse_assembler.cpp"
+#endif
+
+#endif // CINO_SPARSE_ASSEMBLER_H
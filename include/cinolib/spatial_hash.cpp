@@ -0,0 +1,288 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/spatial_hash.h>
+#include <cinolib/parallel_for.h>
+#include <cinolib/min_max_inf.h>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+
+namespace cinolib
+{
+
+CINO_INLINE
+SpatialHash::Key SpatialHash::key_of(const vec3d & p) const
+{
+    Key k;
+    for(int i=0; i<3; ++i)
+    {
+        if(h>0)
+        {
+            k.v[i] = int64_t(std::floor(p[i]/h));
+        }
+        else
+        {
+            double x = (p[i]==0) ? 0.0 : p[i]; // -0 and +0 are the same position
+            memcpy(&k.v[i], &x, sizeof(double));
+        }
+    }
+    return k;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint64_t SpatialHash::hash(const Key & k) const
+{
+    uint64_t x = uint64_t(k.v[0]) * 0x9e3779b97f4a7c15ULL;
+    x ^= uint64_t(k.v[1]) * 0xc2b2ae3d27d4eb4fULL;
+    x ^= uint64_t(k.v[2]) * 0x165667b19e3779f9ULL;
+    x ^= x >> 31;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 29;
+    return x;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+int SpatialHash::cell(const Key & k) const
+{
+    if(table.empty()) return -1;
+    size_t mask = table.size()-1;
+    size_t slot = hash(k) & mask;
+    while(table[slot]!=max_uint)
+    {
+        if(cell_keys[table[slot]]==k) return table[slot];
+        slot = (slot+1) & mask;
+    }
+    return -1;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool SpatialHash::close(const vec3d & p, const vec3d & q) const
+{
+    return (h>0) ? p.dist(q)<h : p==q;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void SpatialHash::build(const std::vector<vec3d> & points)
+{
+    assert(h>=0);
+    this->points = points;
+    uint n = points.size();
+
+    std::vector<Key>      keys(n);
+    std::vector<uint64_t> hashes(n);
+    PARALLEL_FOR(0, n, 10000, [&](const uint i)
+    {
+        keys[i]   = key_of(points[i]);
+        hashes[i] = hash(keys[i]);
+    });
+
+    // assign points to cells
+    size_t size = 16;
+    while(size<2*size_t(n)) size <<= 1;
+    table.assign(size, max_uint);
+    cell_keys.clear();
+    point_cell.resize(n);
+    for(uint i=0; i<n; ++i)
+    {
+        size_t slot = hashes[i] & (size-1);
+        while(table[slot]!=max_uint && !(cell_keys[table[slot]]==keys[i])) slot = (slot+1) & (size-1);
+        if(table[slot]==max_uint)
+        {
+            table[slot] = cell_keys.size();
+            cell_keys.push_back(keys[i]);
+        }
+        point_cell[i] = table[slot];
+    }
+
+    // counting sort of points by cell
+    cell_beg.assign(cell_keys.size()+1, 0);
+    for(uint i=0; i<n; ++i) ++cell_beg[point_cell[i]+1];
+    for(uint c=0; c<cell_keys.size(); ++c) cell_beg[c+1] += cell_beg[c];
+    std::vector<uint> pos(cell_beg.begin(), cell_beg.end()-1);
+    cell_pts.resize(n);
+    for(uint i=0; i<n; ++i) cell_pts[pos[point_cell[i]]++] = i;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Func>
+CINO_INLINE
+void SpatialHash::for_each_nbr_cell(const Key & k, const Func & func) const
+{
+    if(h==0)
+    {
+        int c = cell(k);
+        if(c>=0) func(uint(c));
+        return;
+    }
+    for(int i=-1; i<=1; ++i)
+    for(int j=-1; j<=1; ++j)
+    for(int l=-1; l<=1; ++l)
+    {
+        Key nbr = {{ k.v[0]+i, k.v[1]+j, k.v[2]+l }};
+        int c = cell(nbr);
+        if(c>=0) func(uint(c));
+    }
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void SpatialHash::query(const vec3d & p, std::vector<uint> & ids) const
+{
+    ids.clear();
+    for_each_nbr_cell(key_of(p), [&](const uint c)
+    {
+        for(uint i=cell_beg[c]; i<cell_beg[c+1]; ++i)
+        {
+            if(close(p, points[cell_pts[i]])) ids.push_back(cell_pts[i]);
+        }
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+int SpatialHash::query_closest(const vec3d & p) const
+{
+    int    best      = -1;
+    double best_dist = inf_double;
+    for_each_nbr_cell(key_of(p), [&](const uint c)
+    {
+        for(uint i=cell_beg[c]; i<cell_beg[c+1]; ++i)
+        {
+            uint   id = cell_pts[i];
+            double d  = p.dist(points[id]);
+            if(close(p, points[id]) && (d<best_dist || (d==best_dist && int(id)<best)))
+            {
+                best      = id;
+                best_dist = d;
+            }
+        }
+    });
+    return best;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Func>
+CINO_INLINE
+void SpatialHash::for_each_close_pair(const Func & func) const
+{
+    PARALLEL_FOR(0, points.size(), 10000, [&](const uint i)
+    {
+        for_each_nbr_cell(cell_keys[point_cell[i]], [&](const uint c)
+        {
+            for(uint k=cell_beg[c]; k<cell_beg[c+1]; ++k)
+            {
+                uint j = cell_pts[k];
+                if(j>i && close(points[i], points[j])) func(i,j);
+            }
+        });
+    });
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+uint SpatialHash::clusters(std::vector<uint> & cluster_id) const
+{
+    uint n = points.size();
+    std::vector<uint> root(n);
+
+    if(h==0)
+    {
+        // coincident points share the same cell (whose first point has the lowest id)
+        PARALLEL_FOR(0, n, 10000, [&](const uint i)
+        {
+            root[i] = cell_pts[cell_beg[point_cell[i]]];
+        });
+    }
+    else
+    {
+        // concurrent union find. Trees are always linked under the root with lowest id,
+        // hence the root of each cluster is its first point, regardless of the order in
+        // which pairs are processed by the threads
+        std::vector<std::atomic<uint>> parent(n);
+        PARALLEL_FOR(0, n, 10000, [&](const uint i) { parent[i].store(i); });
+
+        auto find = [&](uint x)
+        {
+            while(true)
+            {
+                uint p = parent[x].load();
+                if(p==x) return x;
+                uint gp = parent[p].load();
+                if(gp!=p) parent[x].compare_exchange_weak(p, gp); // path halving
+                x = gp;
+            }
+        };
+
+        for_each_close_pair([&](uint a, uint b)
+        {
+            while(true)
+            {
+                a = find(a);
+                b = find(b);
+                if(a==b) return;
+                if(a<b) std::swap(a,b);
+                uint expected = a;
+                if(parent[a].compare_exchange_strong(expected, b)) return;
+            }
+        });
+
+        PARALLEL_FOR(0, n, 10000, [&](const uint i) { root[i] = find(i); });
+    }
+
+    // number clusters in order of first appearance (roots come first in their cluster)
+    cluster_id.resize(n);
+    uint count = 0;
+    for(uint i=0; i<n; ++i)
+    {
+        cluster_id[i] = (root[i]==i) ? count++ : cluster_id[root[i]];
+    }
+    return count;
+}
+
+}
@@ -0,0 +1,122 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_SPATIAL_HASH_H
+#define CINO_SPATIAL_HASH_H
+
+#include <vector>
+#include <stdint.h>
+#include <sys/types.h>
+#include <cinolib/cino_inline.h>
+#include <cinolib/geometry/vec_mat.h>
+
+namespace cinolib
+{
+
+/* Uniform grid for proximity queries on point sets. Only non empty cells are stored,
+ * and they are retrieved with a hash table, hence memory is linear in the number of
+ * points regardless of the extent of the grid. Points are stored cell by cell (CSR
+ * layout), in increasing order of id inside each cell.
+ *
+ * The cell size equals the proximity threshold: points closer than it to a query
+ * point are all found in the 27 cells around it. With cell size zero the grid finds
+ * exactly coincident points only (one cell per distinct position), which is what is
+ * needed to weld the vertices of a triangle soup (e.g. an STL file).
+ *
+ * Construction is linear (cell keys are computed in parallel), and so are the
+ * expected costs of all-pairs proximity queries, as long as the number of points
+ * falling in the same neighborhood is bounded.
+*/
+class SpatialHash
+{
+    public:
+
+        explicit SpatialHash(const double cell_size = 0.0) : h(cell_size) {}
+
+        void build(const std::vector<vec3d> & points);
+
+        uint   num_points() const { return points.size();    }
+        uint   num_cells()  const { return cell_keys.size(); }
+        double cell_size()  const { return h;                }
+
+        // ids of the points closer than cell_size to p (or coincident with p, if cell_size is zero)
+        void query(const vec3d & p, std::vector<uint> & ids) const;
+
+        // the closest among the points found by query (-1 if none)
+        int query_closest(const vec3d & p) const;
+
+        // groups points in clusters, i.e. connected components of the graph linking points that
+        // are closer than cell_size (or coincident, if cell_size is zero). Clusters are numbered
+        // in order of first appearance. Returns the number of clusters
+        uint clusters(std::vector<uint> & cluster_id) const;
+
+        // calls func(i,j) for each pair of points i<j closer than cell_size (or coincident, if
+        // cell_size is zero). Pairs are visited in parallel, hence func must be thread safe
+        template<class Func>
+        void for_each_close_pair(const Func & func) const;
+
+    protected:
+
+        struct Key
+        {
+            int64_t v[3];
+            bool operator==(const Key & k) const { return v[0]==k.v[0] && v[1]==k.v[1] && v[2]==k.v[2]; }
+        };
+
+        Key      key_of(const vec3d & p) const;
+        uint64_t hash  (const Key & k)   const;
+        int      cell  (const Key & k)   const;
+        bool     close (const vec3d & p, const vec3d & q) const;
+
+        // calls func(cell) for each cell that may contain points close to a point with key k
+        template<class Func>
+        void for_each_nbr_cell(const Key & k, const Func & func) const;
+
+        double             h;
+        std::vector<vec3d> points;
+        std::vector<Key>   cell_keys;
+        std::vector<uint>  cell_beg;  // points of cell c are cell_pts[cell_beg[c]] ... cell_pts[cell_beg[c+1]-1]
+        std::vector<uint>  cell_pts;
+        std::vector<uint>  point_cell;
+        std::vector<uint>  table;     // open addressing hash table (cell ids)
+};
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "spatial_hash.cpp"
+#endif
+
+#endif // CINO_SPATIAL_HASH_H
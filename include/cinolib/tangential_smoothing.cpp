@@ -63,7 +63,7 @@ void tangential_smoothing(Trimesh<M,V,E,P> & m, const uint vid)
     delta /= norm_fact;
     delta -= m.vert(vid);
     delta -= m.vert_data(vid).normal * delta.dot(m.vert_data(vid).normal);
-    m.vert(vid) += delta;
+    m.vert_move(vid, m.vert(vid) + delta);
 
     // update normals
     for(uint pid : m.adj_v2p(vid)) m.update_p_normal(pid);
@@ -0,0 +1,184 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#include <cinolib/thread_pool.h>
+
+namespace cinolib
+{
+
+CINO_INLINE
+ThreadPool & ThreadPool::instance()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool & ThreadPool::inside_job()
+{
+    // true for the threads that are executing a job (workers, and the thread that issued it)
+    static thread_local bool b = false;
+    return b;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+ThreadPool::ThreadPool(const uint n_threads) : busy(false)
+{
+    start(n_threads);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+ThreadPool::~ThreadPool()
+{
+    stop();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void ThreadPool::set_num_threads(const uint n_threads)
+{
+    if(inside_job()) return; // the pool cannot be resized by its own job
+
+    // wait for the current job to finish
+    bool expected = false;
+    while(!busy.compare_exchange_weak(expected, true))
+    {
+        expected = false;
+        std::this_thread::yield();
+    }
+    stop();
+    start(n_threads);
+    busy = false;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void ThreadPool::start(const uint n_threads)
+{
+    uint n = n_threads;
+    if(n==0)
+    {
+        n = std::thread::hardware_concurrency();
+        if(n==0) n = 8;
+    }
+    quit = false;
+    workers.reserve(n-1);
+    for(uint i=1; i<n; ++i) workers.emplace_back(&ThreadPool::worker_loop, this, i, generation);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void ThreadPool::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+    }
+    cv_job.notify_all();
+    for(std::thread & t : workers) if(t.joinable()) t.join();
+    workers.clear();
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+bool ThreadPool::run(const std::function<void(const uint thread_id)> & f)
+{
+    bool expected = false;
+    if(inside_job() || !busy.compare_exchange_strong(expected, true)) return false;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job     = &f;
+        pending = workers.size();
+        ++generation;
+    }
+    cv_job.notify_all();
+
+    // waits for the workers and releases the pool also if f(0) throws
+    struct JobGuard
+    {
+        ThreadPool * pool;
+        JobGuard(ThreadPool * p) : pool(p) { inside_job() = true; }
+        ~JobGuard()
+        {
+            inside_job() = false;
+            std::unique_lock<std::mutex> lock(pool->mutex);
+            pool->cv_done.wait(lock, [this]{ return pool->pending==0; });
+            pool->job  = nullptr;
+            pool->busy = false;
+        }
+    }
+    guard(this);
+
+    f(0); // the calling thread does its share of work too
+    return true;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+CINO_INLINE
+void ThreadPool::worker_loop(const uint thread_id, uint64_t last_generation)
+{
+    for(;;)
+    {
+        const std::function<void(const uint)> * f = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv_job.wait(lock, [&]{ return quit || generation!=last_generation; });
+            if(quit) return;
+            last_generation = generation;
+            f = job;
+        }
+
+        inside_job() = true;
+        (*f)(thread_id);
+        inside_job() = false;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if(--pending==0) cv_done.notify_one();
+    }
+}
+
+}
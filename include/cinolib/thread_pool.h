@@ -0,0 +1,109 @@
+/********************************************************************************
+*  This file is part of CinoLib                                                 *
+*  Copyright(C) 2016: Marco Livesu                                              *
+*                                                                               *
+*  The MIT License                                                              *
+*                                                                               *
+*  Permission is hereby granted, free of charge, to any person obtaining a      *
+*  copy of this software and associated documentation files (the "Software"),   *
+*  to deal in the Software without restriction, including without limitation    *
+*  the rights to use, copy, modify, merge, publish, distribute, sublicense,     *
+*  and/or sell copies of the Software, and to permit persons to whom the        *
+*  Software is furnished to do so, subject to the following conditions:         *
+*                                                                               *
+*  The above copyright notice and this permission notice shall be included in   *
+*  all copies or substantial portions of the Software.                          *
+*                                                                               *
+*  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR   *
+*  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,     *
+*  FITNESS FOR A PARTICULAR PURPOSE AND NON INFRINGEMENT. IN NO EVENT SHALL THE *
+*  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER       *
+*  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      *
+*  FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS *
+*  IN THE SOFTWARE.                                                             *
+*                                                                               *
+*  Author(s):                                                                   *
+*                                                                               *
+*     Marco Livesu (marco.livesu@gmail.com)                                     *
+*     http://pers.ge.imati.cnr.it/livesu/                                       *
+*                                                                               *
+*     Italian National Research Council (CNR)                                   *
+*     Institute for Applied Mathematics and Information Technologies (IMATI)    *
+*     Via de Marini, 6                                                          *
+*     16149 Genoa,                                                              *
+*     Italy                                                                     *
+*********************************************************************************/
+#ifndef CINO_THREAD_POOL_H
+#define CINO_THREAD_POOL_H
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cinolib/cino_inline.h>
+
+namespace cinolib
+{
+
+/* Persistent pool of worker threads used by PARALLEL_FOR (see parallel_for.h).
+ * Threads are created once (at first use) and then sleep until a new job is
+ * submitted, hence parallel loops do not pay the cost of thread creation at
+ * each call. A job is a function that takes as input the id of the thread
+ * that executes it (in [0,num_threads()) ) and it is executed by all the
+ * workers, plus the calling thread, which acts as thread zero.
+ *
+ * The pool executes one job at a time. If a job is submitted while another
+ * one is running (e.g. nested parallel loops, or parallel loops issued by
+ * concurrent threads) run() returns false, and the caller is expected to
+ * execute its work serially. If the job throws on the calling thread, run()
+ * still waits for the workers before propagating the exception.
+*/
+
+class ThreadPool
+{
+    public:
+
+        static ThreadPool & instance();
+
+        explicit ThreadPool(const uint n_threads = 0); // zero means: use all hardware threads
+        ~ThreadPool();
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        void set_num_threads(const uint n_threads); // ignored if called from inside a job
+        uint num_threads() const { return workers.size()+1; }
+
+        //::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+        bool run(const std::function<void(const uint thread_id)> & job);
+
+    private:
+
+        static bool & inside_job();
+
+        void start(const uint n_threads);
+        void stop();
+        void worker_loop(const uint thread_id, uint64_t last_generation);
+
+        std::vector<std::thread>                   workers;
+        std::atomic<bool>                          busy;      // true while a job is running
+        std::mutex                                 mutex;
+        std::condition_variable                    cv_job;
+        std::condition_variable                    cv_done;
+        const std::function<void(const uint)>    * job        = nullptr;
+        uint64_t                                   generation = 0;
+        uint                                       pending    = 0;
+        bool                                       quit       = false;
+};
+
+}
+
+#ifndef  CINO_STATIC_LIB
+#include "thread_pool.cpp"
+#endif
+
+#endif // CINO_THREAD_POOL_H
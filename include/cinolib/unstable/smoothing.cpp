@@ -102,6 +102,7 @@ void smooth_taubin(AbstractMesh<M,V,E,P> & m,
             for(auto w : wgts) delta += (m.vert(w.first) - m.vert(vid)) * w.first;
             m.vert(vid) = m.vert(vid) + delta * mu;
         }
+        m.mark_changed(CHANGES_VERT_POS);
    }
 }
 
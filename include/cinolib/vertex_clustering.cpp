@@ -34,48 +34,74 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/vertex_clustering.h>
-#include <cinolib/bfs.h>
+#include <cinolib/spatial_hash.h>
 
 namespace cinolib
 {
 
+template<uint d, class T>
+CINO_INLINE
+vec3d vertex_clustering_xyz(const mat<d,1,T> & p)
+{
+    vec3d xyz(0,0,0);
+    for(uint i=0; i<std::min(d,3u); ++i) xyz[i] = p[i];
+    return xyz;
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+template<class Vertex>
+CINO_INLINE
+uint vertex_clustering(const std::vector<Vertex> & points,
+                       const double                proximity_thresh,
+                       std::vector<uint>         & cluster_id)
+{
+    std::vector<vec3d> xyz(points.size());
+    for(uint vid=0; vid<points.size(); ++vid) xyz.at(vid) = vertex_clustering_xyz(points.at(vid));
+
+    SpatialHash grid(proximity_thresh);
+    grid.build(xyz);
+    return grid.clusters(cluster_id);
+}
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
 template<class Vertex>
 CINO_INLINE
 void vertex_clustering(const std::vector<Vertex>             & points,
                        const double                            proximity_thresh,
                        std::vector<std::unordered_set<uint>> & clusters)
 {
-    // build v2v connectivity based on point proximity
-    std::vector<std::vector<uint>> v2v(points.size());
-    for(uint vid0=0;      vid0<points.size()-1; ++vid0)
-    for(uint vid1=vid0+1; vid1<points.size();   ++vid1)
+    std::vector<uint> cluster_id;
+    uint n = vertex_clustering(points, proximity_thresh, cluster_id);
+
+    uint first = clusters.size();
+    clusters.resize(first+n);
+    for(uint vid=0; vid<points.size(); ++vid)
     {
-        if (points.at(vid0).dist(points.at(vid1)) < proximity_thresh)
-        {
-            v2v.at(vid0).push_back(vid1);
-            v2v.at(vid1).push_back(vid0);
-        }
+        clusters.at(first+cluster_id.at(vid)).insert(vid);
     }
+}
 
-    // visit the resulting graph with BFS to
-    // isolate clusters of adjacent vertices
-    uint nv   = points.size();
-    uint seed = 0;
-    std::vector<bool> visited(nv, false);
-    do
-    {
-        std::unordered_set<uint> cluster;
-        bfs(v2v, seed, cluster);
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-        clusters.push_back(cluster);
-        for(uint vid : cluster) visited.at(vid) = true;
+template<class Vertex>
+CINO_INLINE
+void weld_vertices(const std::vector<Vertex> & points,
+                   const double                proximity_thresh,
+                   std::vector<Vertex>       & welded,
+                   std::vector<uint>         & vmap)
+{
+    uint n = vertex_clustering(points, proximity_thresh, vmap);
 
-        seed = 0;
-        while (seed < nv && visited.at(seed)) ++seed;
+    // clusters are numbered in order of first appearance
+    welded.clear();
+    welded.reserve(n);
+    for(uint vid=0; vid<points.size(); ++vid)
+    {
+        if(vmap.at(vid)==welded.size()) welded.push_back(points.at(vid));
     }
-    while (seed < nv);
+    assert(welded.size()==n);
 }
 
-
 }
-
@@ -40,6 +40,7 @@
 #include <vector>
 #include <sys/types.h>
 #include <cinolib/cino_inline.h>
+#include <cinolib/geometry/vec_mat.h>
 
 
 namespace cinolib
@@ -48,7 +49,12 @@ namespace cinolib
 /* Groups a list of vertices in clusters of elements closer
  * to each other less than a given proximity threshold
  *
- * NOTE: class Vertex should implement the dist() operator
+ * Proximity queries are answered by a uniform grid with cell
+ * size equal to the threshold (see spatial_hash.h), and clusters
+ * are merged with a union find, hence the expected cost is linear.
+ * Clusters are sorted by their first vertex.
+ *
+ * NOTE: class Vertex should be a vec2 or a vec3
 */
 
 template<class Vertex>
@@ -57,6 +63,30 @@ void vertex_clustering(const std::vector<Vertex>             & points,
                        const double                            proximity_thresh,
                        std::vector<std::unordered_set<uint>> & clusters);
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// Same as above, but returns a per vertex cluster id (clusters are numbered
+// in order of first appearance) and the number of clusters. If the proximity
+// threshold is zero, only exactly coincident vertices are clustered
+
+template<class Vertex>
+CINO_INLINE
+uint vertex_clustering(const std::vector<Vertex> & points,
+                       const double                proximity_thresh,
+                       std::vector<uint>         & cluster_id);
+
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// Collapses each cluster of vertices (see above) into its first vertex.
+// The new id of each input vertex is returned in vmap
+
+template<class Vertex>
+CINO_INLINE
+void weld_vertices(const std::vector<Vertex> & points,
+                   const double                proximity_thresh,
+                   std::vector<Vertex>       & welded,
+                   std::vector<uint>         & vmap);
+
 }
 
 #ifndef  CINO_STATIC_LIB
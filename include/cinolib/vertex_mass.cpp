@@ -34,6 +34,8 @@
 *     Italy                                                                     *
 *********************************************************************************/
 #include <cinolib/vertex_mass.h>
+#include <cinolib/operator_cache.h>
+#include <cinolib/parallel_for.h>
 
 namespace cinolib
 {
@@ -42,26 +44,39 @@ template<class M, class V, class E, class P>
 CINO_INLINE
 Eigen::SparseMatrix<double> mass_matrix(const AbstractMesh<M,V,E,P> & m, const int n)
 {
-    typedef Eigen::Triplet<double> Entry;
+    if(m.operator_cache()) return *m.operator_cache()->mass_matrix(m, n);
 
-    uint nv = m.num_verts();
-    uint base[n];
-    for(int i=0; i<n; ++i) base[i] = nv*i;
+    SparseAssembler A;
+    mass_matrix(m, A, n);
+    return std::move(A.matrix());
+}
 
-    std::vector<Entry>  entries;
-    for(uint vid=0; vid<m.num_verts(); ++vid)
-    {
-        double mass = m.vert_mass(vid);
-        for(int i=0; i<n; ++i) entries.push_back(Entry(base[i] + vid, base[i] + vid, mass));
-    }
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
 
-    nv = n*m.num_verts();
-    Eigen::SparseMatrix<double> MM(nv, nv);
-    MM.setFromTriplets(entries.begin(), entries.end());
+template<class M, class V, class E, class P>
+CINO_INLINE
+const Eigen::SparseMatrix<double> & mass_matrix(const AbstractMesh<M,V,E,P> & m,
+                                                SparseAssembler             & A,
+                                                const int                     n)
+{
+    uint nv = m.num_verts();
+    A.assemble(n*nv, n*nv, m.topology_revision(), [](const uint col, std::vector<uint> & rows)
+    {
+        rows.push_back(col);
+    },
+    [&]() -> bool
+    {
+        // the matrix is diagonal, hence entry (i,i) is the i-th value
+        double * val = A.values();
+        PARALLEL_FOR(0, nv, 1000, [&](const uint vid)
+        {
+            double mass = m.vert_mass(vid);
+            for(int i=0; i<n; ++i) val[i*nv + vid] = mass;
+        });
+        return true;
+    });
 
-    return MM;
+    return A.matrix();
 }
 
-
 }
-
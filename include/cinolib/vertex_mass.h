@@ -37,6 +37,7 @@
 #define CINO_VERTEX_MASS_H
 
 #include <cinolib/meshes/abstract_mesh.h>
+#include <cinolib/sparse_assembler.h>
 #include <Eigen/Sparse>
 
 namespace cinolib
@@ -52,6 +53,16 @@ Eigen::SparseMatrix<double> mass_matrix(const AbstractMesh<M,V,E,P> & m,
                                                           //          | 0 M |   | 0 M 0 |
                                                           //                    | 0 0 M |
 
+//::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::::
+
+// same as above, but assembled with (and stored in) A. The sparsity pattern is computed
+// only if A does not have one for the current connectivity of m, otherwise only values are updated
+template<class M, class V, class E, class P>
+CINO_INLINE
+const Eigen::SparseMatrix<double> & mass_matrix(const AbstractMesh<M,V,E,P> & m,
+                                                SparseAssembler             & A,
+                                                const int                     n = 1);
+
 }
 
 #ifndef  CINO_STATIC_LIB